@@ -0,0 +1,57 @@
+//
+//  FPColumnKernels.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "FPFixedPoint.h"
+
+/**
+ The count, total, min and max of the non-null values of a column.  The total
+ is exact; min and max are NSDecimals so that the min or max of a product of
+ two columns is exact too.  min and max are meaningless when sum.count is 0.
+ */
+typedef struct {
+  FPSum sum;
+  NSDecimal min;
+  NSDecimal max;
+} FPColumnSummary;
+
+/**
+ Summary kernels over plain C arrays of micro-unit values, where nullValue
+ marks a missing value.
+
+ Where the compiler supports vector extensions (clang and gcc, on any target),
+ the kernels work several rows at a time, accumulating in 64-bit integer lanes,
+ and reconcile the lanes into an exact FPSum.  If the column's values are large
+ enough that a lane could have overflowed, the result is thrown away and the
+ scalar kernel is used instead; the products kernel instead folds its lanes
+ into the FPSum as often as its values require, block by block.  Either way
+ the answer is always the scalar kernel's.  Defining FP_COLUMN_KERNELS_SCALAR builds the scalar
+ kernels only.  The scalar kernels are exported for testing and benchmarking.
+ */
+FOUNDATION_EXPORT FPColumnSummary FPColumnSummarizeMicros(const FPMicros *values,
+                                                          NSUInteger count,
+                                                          FPMicros nullValue);
+
+/**
+ Summarizes lhs[i] * rhs[i] over the rows on which neither is null (e.g., num
+ gallons * gallon price).
+ */
+FOUNDATION_EXPORT FPColumnSummary FPColumnSummarizeMicrosProducts(const FPMicros *lhs,
+                                                                  const FPMicros *rhs,
+                                                                  NSUInteger count,
+                                                                  FPMicros nullValue);
+
+FOUNDATION_EXPORT FPColumnSummary FPColumnSummarizeMicrosScalar(const FPMicros *values,
+                                                                NSUInteger count,
+                                                                FPMicros nullValue);
+
+FOUNDATION_EXPORT FPColumnSummary FPColumnSummarizeMicrosProductsScalar(const FPMicros *lhs,
+                                                                        const FPMicros *rhs,
+                                                                        NSUInteger count,
+                                                                        FPMicros nullValue);
@@ -0,0 +1,387 @@
+//
+//  FPColumnKernels.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPColumnKernels.h"
+
+#import <string.h>
+
+#if (defined(__clang__) || defined(__GNUC__)) && !defined(FP_COLUMN_KERNELS_SCALAR)
+#define FP_COLUMN_KERNELS_VECTOR 1
+#else
+#define FP_COLUMN_KERNELS_VECTOR 0
+#endif
+
+#pragma mark - Helpers
+
+static FPColumnSummary FPColumnSummaryMake(void) {
+  FPColumnSummary summary;
+  summary.sum = FPSumMake();
+  summary.min = FPDecimalFromMicros(0);
+  summary.max = FPDecimalFromMicros(0);
+  return summary;
+}
+
+static NSDecimal FPDecimalProductOfMicros(FPMicros lhs, FPMicros rhs) {
+  NSDecimal lhsDecimal = FPDecimalFromMicros(lhs);
+  NSDecimal rhsDecimal = FPDecimalFromMicros(rhs);
+  NSDecimal product;
+  NSDecimalMultiply(&product, &lhsDecimal, &rhsDecimal, NSRoundPlain);
+  return product;
+}
+
+/*
+ Orders the products of two rows; products that are exact in micro-units
+ (nearly all of them) are compared as integers, anything else as decimals.
+ */
+static NSComparisonResult FPCompareProducts(const FPMicros *lhs, const FPMicros *rhs, NSUInteger i, NSUInteger j) {
+  FPMicros iProduct, jProduct;
+  if (FPMicrosMultiply(lhs[i], rhs[i], &iProduct) && FPMicrosMultiply(lhs[j], rhs[j], &jProduct)) {
+    if (iProduct == jProduct) {
+      return NSOrderedSame;
+    }
+    return iProduct < jProduct ? NSOrderedAscending : NSOrderedDescending;
+  }
+  NSDecimal iDecimal = FPDecimalProductOfMicros(lhs[i], rhs[i]);
+  NSDecimal jDecimal = FPDecimalProductOfMicros(lhs[j], rhs[j]);
+  return NSDecimalCompare(&iDecimal, &jDecimal);
+}
+
+#if FP_COLUMN_KERNELS_VECTOR
+
+static const short FPMicrosScale = 6;
+
+// a product of two micro-unit values is in units of 10^-12
+static const short FPProductScale = 12;
+
+/*
+ Whether count values, none larger in magnitude than maxMagnitude, can be
+ summed in an int64 without overflow.
+ */
+static BOOL FPSumFitsInt64(uint64_t maxMagnitude, uint64_t count) {
+  uint64_t bound;
+  return !__builtin_mul_overflow(maxMagnitude, count, &bound) && bound <= (uint64_t)INT64_MAX;
+}
+
+#define FP_VECTOR_LANES 4
+
+typedef int64_t FPInt64Vector __attribute__((vector_size(FP_VECTOR_LANES * sizeof(int64_t))));
+typedef uint64_t FPUInt64Vector __attribute__((vector_size(FP_VECTOR_LANES * sizeof(uint64_t))));
+
+static inline FPInt64Vector FPVectorLoad(const FPMicros *values) {
+  FPInt64Vector vector;
+  memcpy(&vector, values, sizeof(vector));
+  return vector;
+}
+
+static inline FPInt64Vector FPVectorSplat(int64_t value) {
+  return (FPInt64Vector){value, value, value, value};
+}
+
+/* Lanes of mask are all ones or all zeros. */
+static inline FPInt64Vector FPVectorSelect(FPInt64Vector mask, FPInt64Vector a, FPInt64Vector b) {
+  return (a & mask) | (b & ~mask);
+}
+
+static inline FPInt64Vector FPVectorMax(FPInt64Vector a, FPInt64Vector b) {
+  return FPVectorSelect((FPInt64Vector)(a > b), a, b);
+}
+
+/* Callers never pass INT64_MIN (null lanes are zeroed first). */
+static inline FPInt64Vector FPVectorAbs(FPInt64Vector vector) {
+  FPInt64Vector sign = vector >> 63;
+  return (vector ^ sign) - sign;
+}
+
+/*
+ The per-lane state of a summary: sums wrap (they're unsigned) and are only
+ trusted once the magnitudes show no lane could have overflowed.
+ */
+typedef struct {
+  FPUInt64Vector sums;
+  FPInt64Vector counts;
+  FPInt64Vector mins;
+  FPInt64Vector maxs;
+} FPLanes;
+
+static inline FPLanes FPLanesMake(void) {
+  FPLanes lanes;
+  lanes.sums = (FPUInt64Vector){0, 0, 0, 0};
+  lanes.counts = FPVectorSplat(0);
+  lanes.mins = FPVectorSplat(INT64_MAX);
+  lanes.maxs = FPVectorSplat(INT64_MIN);
+  return lanes;
+}
+
+static inline void FPLanesAdd(FPLanes *lanes, FPInt64Vector values, FPInt64Vector present) {
+  lanes->sums += (FPUInt64Vector)(values & present);
+  lanes->counts -= present;
+  lanes->mins = FPVectorSelect(present & (FPInt64Vector)(values < lanes->mins), values, lanes->mins);
+  lanes->maxs = FPVectorSelect(present & (FPInt64Vector)(values > lanes->maxs), values, lanes->maxs);
+}
+
+typedef struct {
+  uint64_t sum;
+  int64_t count;
+  int64_t min;
+  int64_t max;
+} FPLanesTotal;
+
+/*
+ Folds the lanes into a single sum, count, min and max; the rows left over past
+ the last full vector are then added to the total one at a time.
+ */
+static inline FPLanesTotal FPLanesFold(const FPLanes *lanes) {
+  FPLanesTotal total = {0, 0, INT64_MAX, INT64_MIN};
+  for (int lane = 0; lane < FP_VECTOR_LANES; lane++) {
+    total.sum += lanes->sums[lane];
+    total.count += lanes->counts[lane];
+    total.min = MIN(total.min, lanes->mins[lane]);
+    total.max = MAX(total.max, lanes->maxs[lane]);
+  }
+  return total;
+}
+
+static inline void FPLanesTotalAdd(FPLanesTotal *total, int64_t value) {
+  total->sum += (uint64_t)value;
+  total->count++;
+  total->min = MIN(total->min, value);
+  total->max = MAX(total->max, value);
+}
+
+static inline uint64_t FPMagnitude(int64_t value) {
+  return value < 0 ? (uint64_t)(-(value + 1)) + 1 : (uint64_t)value;
+}
+
+static inline uint64_t FPVectorMaxMagnitude(FPInt64Vector magnitudes) {
+  uint64_t max = 0;
+  for (int lane = 0; lane < FP_VECTOR_LANES; lane++) {
+    max = MAX(max, (uint64_t)magnitudes[lane]);
+  }
+  return max;
+}
+
+static FPColumnSummary FPColumnSummaryFromTotal(const FPLanesTotal *total, short scale) {
+  FPColumnSummary summary = FPColumnSummaryMake();
+  if (total->count > 0) {
+    FPSumAddTotal(&summary.sum, FPDecimalFromScaledInteger((int64_t)total->sum, scale), (NSInteger)total->count);
+    summary.min = FPDecimalFromScaledInteger(total->min, scale);
+    summary.max = FPDecimalFromScaledInteger(total->max, scale);
+  }
+  return summary;
+}
+
+/* Widens summary's min and max (taken as unset until hasExtremes) to min and max. */
+static void FPColumnSummaryAddExtremes(FPColumnSummary *summary, BOOL *hasExtremes, NSDecimal min, NSDecimal max) {
+  if (!*hasExtremes || NSDecimalCompare(&min, &summary->min) == NSOrderedAscending) {
+    summary->min = min;
+  }
+  if (!*hasExtremes || NSDecimalCompare(&max, &summary->max) == NSOrderedDescending) {
+    summary->max = max;
+  }
+  *hasExtremes = YES;
+}
+
+/*
+ Products are summarized a block of rows at a time: a first pass over the block
+ bounds its products, which tells how many rows the lanes can add before they
+ have to be folded into the FPSum.  A block with a product too large for an
+ int64 falls back to the scalar kernel on its own.
+ */
+#define FP_PRODUCTS_BLOCK_ROWS 4096
+
+/*
+ Bounds the magnitude of lhs[i] * rhs[i] over the non-null rows in [start, end)
+ by the product of the largest lhs and rhs magnitudes; NO if that doesn't fit
+ in 64 bits.
+ */
+static BOOL FPMaxProductMagnitude(const FPMicros *lhs,
+                                  const FPMicros *rhs,
+                                  NSUInteger start,
+                                  NSUInteger end,
+                                  FPMicros nullValue,
+                                  uint64_t *maxProductMagnitude) {
+  FPInt64Vector nulls = FPVectorSplat(nullValue);
+  FPInt64Vector lhsMagnitudes = FPVectorSplat(0);
+  FPInt64Vector rhsMagnitudes = FPVectorSplat(0);
+  NSUInteger i = start;
+  for (; i + FP_VECTOR_LANES <= end; i += FP_VECTOR_LANES) {
+    FPInt64Vector lhsVector = FPVectorLoad(lhs + i);
+    FPInt64Vector rhsVector = FPVectorLoad(rhs + i);
+    FPInt64Vector present = (FPInt64Vector)(lhsVector != nulls) & (FPInt64Vector)(rhsVector != nulls);
+    lhsMagnitudes = FPVectorMax(lhsMagnitudes, FPVectorAbs(lhsVector & present));
+    rhsMagnitudes = FPVectorMax(rhsMagnitudes, FPVectorAbs(rhsVector & present));
+  }
+  uint64_t maxLhsMagnitude = FPVectorMaxMagnitude(lhsMagnitudes);
+  uint64_t maxRhsMagnitude = FPVectorMaxMagnitude(rhsMagnitudes);
+  for (; i < end; i++) {
+    if (lhs[i] != nullValue && rhs[i] != nullValue) {
+      maxLhsMagnitude = MAX(maxLhsMagnitude, FPMagnitude(lhs[i]));
+      maxRhsMagnitude = MAX(maxRhsMagnitude, FPMagnitude(rhs[i]));
+    }
+  }
+  return !__builtin_mul_overflow(maxLhsMagnitude, maxRhsMagnitude, maxProductMagnitude);
+}
+
+/*
+ The lanes' total of lhs[i] * rhs[i] over the non-null rows in [start, end).
+ The sums wrap, so the total is exact only if the true total fits in an int64.
+ */
+static FPLanesTotal FPLanesTotalOfProducts(const FPMicros *lhs,
+                                           const FPMicros *rhs,
+                                           NSUInteger start,
+                                           NSUInteger end,
+                                           FPMicros nullValue) {
+  FPInt64Vector nulls = FPVectorSplat(nullValue);
+  FPLanes lanes = FPLanesMake();
+  NSUInteger i = start;
+  for (; i + FP_VECTOR_LANES <= end; i += FP_VECTOR_LANES) {
+    FPInt64Vector lhsVector = FPVectorLoad(lhs + i);
+    FPInt64Vector rhsVector = FPVectorLoad(rhs + i);
+    FPInt64Vector present = (FPInt64Vector)(lhsVector != nulls) & (FPInt64Vector)(rhsVector != nulls);
+    // multiplied unsigned, as the products are summed: wrapping
+    FPInt64Vector products = (FPInt64Vector)((FPUInt64Vector)(lhsVector & present) * (FPUInt64Vector)(rhsVector & present));
+    FPLanesAdd(&lanes, products, present);
+  }
+  FPLanesTotal total = FPLanesFold(&lanes);
+  for (; i < end; i++) {
+    if (lhs[i] != nullValue && rhs[i] != nullValue) {
+      FPLanesTotalAdd(&total, (int64_t)((uint64_t)lhs[i] * (uint64_t)rhs[i]));
+    }
+  }
+  return total;
+}
+
+#endif
+
+#pragma mark - Scalar Kernels
+
+FPColumnSummary FPColumnSummarizeMicrosScalar(const FPMicros *values,
+                                              NSUInteger count,
+                                              FPMicros nullValue) {
+  FPColumnSummary summary = FPColumnSummaryMake();
+  FPMicros min = INT64_MAX;
+  FPMicros max = INT64_MIN;
+  for (NSUInteger i = 0; i < count; i++) {
+    if (values[i] != nullValue) {
+      FPSumAddMicros(&summary.sum, values[i]);
+      min = MIN(min, values[i]);
+      max = MAX(max, values[i]);
+    }
+  }
+  if (summary.sum.count > 0) {
+    summary.min = FPDecimalFromMicros(min);
+    summary.max = FPDecimalFromMicros(max);
+  }
+  return summary;
+}
+
+FPColumnSummary FPColumnSummarizeMicrosProductsScalar(const FPMicros *lhs,
+                                                      const FPMicros *rhs,
+                                                      NSUInteger count,
+                                                      FPMicros nullValue) {
+  FPColumnSummary summary = FPColumnSummaryMake();
+  NSUInteger minRow = NSNotFound;
+  NSUInteger maxRow = NSNotFound;
+  for (NSUInteger i = 0; i < count; i++) {
+    if (lhs[i] != nullValue && rhs[i] != nullValue) {
+      FPSumAddMicrosProduct(&summary.sum, lhs[i], rhs[i]);
+      if (minRow == NSNotFound || FPCompareProducts(lhs, rhs, i, minRow) == NSOrderedAscending) {
+        minRow = i;
+      }
+      if (maxRow == NSNotFound || FPCompareProducts(lhs, rhs, i, maxRow) == NSOrderedDescending) {
+        maxRow = i;
+      }
+    }
+  }
+  if (summary.sum.count > 0) {
+    summary.min = FPDecimalProductOfMicros(lhs[minRow], rhs[minRow]);
+    summary.max = FPDecimalProductOfMicros(lhs[maxRow], rhs[maxRow]);
+  }
+  return summary;
+}
+
+#pragma mark - Kernels
+
+FPColumnSummary FPColumnSummarizeMicros(const FPMicros *values,
+                                        NSUInteger count,
+                                        FPMicros nullValue) {
+#if FP_COLUMN_KERNELS_VECTOR
+  FPInt64Vector nulls = FPVectorSplat(nullValue);
+  FPInt64Vector magnitudes = FPVectorSplat(0);
+  FPLanes lanes = FPLanesMake();
+  NSUInteger i = 0;
+  for (; i + FP_VECTOR_LANES <= count; i += FP_VECTOR_LANES) {
+    FPInt64Vector vector = FPVectorLoad(values + i);
+    FPInt64Vector present = (FPInt64Vector)(vector != nulls);
+    FPLanesAdd(&lanes, vector, present);
+    magnitudes = FPVectorMax(magnitudes, FPVectorAbs(vector & present));
+  }
+  FPLanesTotal total = FPLanesFold(&lanes);
+  uint64_t maxMagnitude = FPVectorMaxMagnitude(magnitudes);
+  for (; i < count; i++) {
+    if (values[i] != nullValue) {
+      FPLanesTotalAdd(&total, values[i]);
+      maxMagnitude = MAX(maxMagnitude, FPMagnitude(values[i]));
+    }
+  }
+  if (!FPSumFitsInt64(maxMagnitude, (uint64_t)total.count)) {
+    return FPColumnSummarizeMicrosScalar(values, count, nullValue);
+  }
+  return FPColumnSummaryFromTotal(&total, FPMicrosScale);
+#else
+  return FPColumnSummarizeMicrosScalar(values, count, nullValue);
+#endif
+}
+
+FPColumnSummary FPColumnSummarizeMicrosProducts(const FPMicros *lhs,
+                                                const FPMicros *rhs,
+                                                NSUInteger count,
+                                                FPMicros nullValue) {
+#if FP_COLUMN_KERNELS_VECTOR
+  FPColumnSummary summary = FPColumnSummaryMake();
+  BOOL hasExtremes = NO;
+  NSInteger numLaneRows = 0;
+  int64_t laneMin = INT64_MAX;
+  int64_t laneMax = INT64_MIN;
+  for (NSUInteger block = 0; block < count; block += FP_PRODUCTS_BLOCK_ROWS) {
+    NSUInteger blockEnd = MIN(count, block + FP_PRODUCTS_BLOCK_ROWS);
+    uint64_t maxProductMagnitude;
+    if (!FPMaxProductMagnitude(lhs, rhs, block, blockEnd, nullValue, &maxProductMagnitude) ||
+        maxProductMagnitude > (uint64_t)INT64_MAX) {
+      FPColumnSummary blockSummary = FPColumnSummarizeMicrosProductsScalar(lhs + block, rhs + block, blockEnd - block, nullValue);
+      if (blockSummary.sum.count > 0) {
+        FPSumAddTotal(&summary.sum, FPSumTotal(&blockSummary.sum), blockSummary.sum.count);
+        FPColumnSummaryAddExtremes(&summary, &hasExtremes, blockSummary.min, blockSummary.max);
+      }
+      continue;
+    }
+    // no run of rowsPerFold products can sum past the int64 range
+    uint64_t rowsPerFold = maxProductMagnitude > 0 ? (uint64_t)INT64_MAX / maxProductMagnitude : UINT64_MAX;
+    for (NSUInteger start = block; start < blockEnd; ) {
+      NSUInteger end = (NSUInteger)MIN((uint64_t)blockEnd, (uint64_t)start + rowsPerFold);
+      FPLanesTotal total = FPLanesTotalOfProducts(lhs, rhs, start, end, nullValue);
+      if (total.count > 0) {
+        FPSumAddTotal(&summary.sum, FPDecimalFromScaledInteger((int64_t)total.sum, FPProductScale), (NSInteger)total.count);
+        numLaneRows += (NSInteger)total.count;
+        laneMin = MIN(laneMin, total.min);
+        laneMax = MAX(laneMax, total.max);
+      }
+      start = end;
+    }
+  }
+  if (numLaneRows > 0) {
+    FPColumnSummaryAddExtremes(&summary,
+                               &hasExtremes,
+                               FPDecimalFromScaledInteger(laneMin, FPProductScale),
+                               FPDecimalFromScaledInteger(laneMax, FPProductScale));
+  }
+  return summary;
+#else
+  return FPColumnSummarizeMicrosProductsScalar(lhs, rhs, count, nullValue);
+#endif
+}
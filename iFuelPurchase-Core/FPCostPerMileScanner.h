@@ -0,0 +1,55 @@
+//
+//  FPCostPerMileScanner.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class FPDataset;
+@class FPMonthBoundaries;
+@class FPLogColumns;
+
+/**
+ Computes gas-cost-per-mile figures for a single vehicle from its odometer
+ logs and gas logs.  The odometer logs are sorted by date once, up front (the
+ gas log columns already are), and every figure is then produced by walking
+ the two sorted lists together, so a whole monthly series costs one pass
+ rather than a set of queries per month.
+
+ Over any span, the miles driven are the last odometer reading less the first,
+ and the amount spent is the total of the gas logs purchased after the first
+ odometer log.  costPerMileBlk turns the two into the figure (it's handed a nil
+ amount spent when there are no such gas logs), and may return nil.
+ */
+@interface FPCostPerMileScanner : NSObject
+
+#pragma mark - Initializers
+
+/**
+ envlogs can be in any order; environment logs without an odometer reading (or
+ without a date) are ignored.  Only the gas log rows in gasLogRange are used.
+ */
+- (instancetype)initWithOdometerLogs:(NSArray *)envlogs
+                       gasLogColumns:(FPLogColumns *)gasLogColumns
+                         gasLogRange:(NSRange)gasLogRange
+                      costPerMileBlk:(NSDecimalNumber *(^)(NSDecimalNumber *milesDriven, NSDecimalNumber *spentOnGas))costPerMileBlk;
+
+#pragma mark - Scanning
+
+/** The cost per mile across all of the logs. */
+- (NSDecimalNumber *)costPerMile;
+
+/**
+ Returns a [first day of month, cost per mile] dataset with a datapoint for
+ each month, from onOrAfterDate's month through the last month starting before
+ beforeDate, whose figure is non-nil.  Each month is computed from that
+ month's logs alone.
+ */
+- (FPDataset *)monthlyDataSetWithBoundaries:(FPMonthBoundaries *)boundaries
+                                 beforeDate:(NSDate *)beforeDate
+                              onOrAfterDate:(NSDate *)onOrAfterDate;
+
+@end
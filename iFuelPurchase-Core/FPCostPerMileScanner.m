@@ -0,0 +1,144 @@
+//
+//  FPCostPerMileScanner.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPCostPerMileScanner.h"
+
+#import <PEObjc-Commons/PEUtils.h>
+
+#import "FPDataset.h"
+#import "FPEnvironmentLog.h"
+#import "FPLogColumns.h"
+#import "FPMonthBoundaries.h"
+
+@implementation FPCostPerMileScanner {
+  NSArray *_odometerLogs;
+  NSData *_odometerLogMillis;
+  FPLogColumns *_gasLogColumns;
+  NSRange _gasLogRange;
+  NSDecimalNumber *(^_costPerMileBlk)(NSDecimalNumber *, NSDecimalNumber *);
+}
+
+#pragma mark - Helpers
+
++ (NSArray *)sortedLogs:(NSArray *)logs
+             logDateBlk:(NSDate *(^)(id))logDateBlk
+              millisOut:(NSData **)millisOut {
+  NSMutableArray *datedLogs = [NSMutableArray arrayWithCapacity:logs.count];
+  for (id log in logs) {
+    if (logDateBlk(log)) {
+      [datedLogs addObject:log];
+    }
+  }
+  [datedLogs sortWithOptions:NSSortStable usingComparator:^NSComparisonResult(id log1, id log2) {
+    return [logDateBlk(log1) compare:logDateBlk(log2)];
+  }];
+  NSMutableData *millis = [NSMutableData dataWithLength:datedLogs.count * sizeof(FPEpochMillis)];
+  FPEpochMillis *millisBytes = millis.mutableBytes;
+  for (NSUInteger i = 0; i < datedLogs.count; i++) {
+    millisBytes[i] = FPEpochMillisFromDate(logDateBlk(datedLogs[i]));
+  }
+  *millisOut = millis;
+  return datedLogs;
+}
+
+/*
+ Computes the figure for the odometer logs at [first, last] against the gas
+ logs purchased after the first of them and before endMillis.  *gasLogIndex is
+ where the gas log scan picks up, and is left just past the last gas log
+ consumed; because callers visit spans in date order, each gas log is looked at
+ a bounded number of times across a whole scan.
+ */
+- (NSDecimalNumber *)costPerMileForOdometerLogsFrom:(NSUInteger)first
+                                                 to:(NSUInteger)last
+                                        gasLogIndex:(NSUInteger *)gasLogIndex
+                                          endMillis:(FPEpochMillis)endMillis {
+  const FPEpochMillis *odometerLogMillis = _odometerLogMillis.bytes;
+  const int64_t *gasLogMillis = [_gasLogColumns purchasedAtMillis];
+  NSUInteger endOfGasLogs = NSMaxRange(_gasLogRange);
+  NSUInteger start = *gasLogIndex;
+  while (start < endOfGasLogs && gasLogMillis[start] <= odometerLogMillis[first]) {
+    start++;
+  }
+  NSUInteger end = start;
+  while (end < endOfGasLogs && gasLogMillis[end] < endMillis) {
+    end++;
+  }
+  *gasLogIndex = end;
+  FPSum spent = [_gasLogColumns sumOfMeasure:FPGasLogMeasureSpent inRange:NSMakeRange(start, end - start)];
+  NSDecimalNumber *milesDriven = [[_odometerLogs[last] odometer] decimalNumberBySubtracting:[_odometerLogs[first] odometer]];
+  return _costPerMileBlk(milesDriven, end > start ? FPSumDecimalNumber(&spent) : nil);
+}
+
+#pragma mark - Initializers
+
+- (instancetype)initWithOdometerLogs:(NSArray *)envlogs
+                       gasLogColumns:(FPLogColumns *)gasLogColumns
+                         gasLogRange:(NSRange)gasLogRange
+                      costPerMileBlk:(NSDecimalNumber *(^)(NSDecimalNumber *, NSDecimalNumber *))costPerMileBlk {
+  self = [super init];
+  if (self) {
+    NSData *millis;
+    _odometerLogs = [FPCostPerMileScanner sortedLogs:envlogs
+                                          logDateBlk:^NSDate *(FPEnvironmentLog *envlog) {
+                                            return [PEUtils isNil:envlog.odometer] ? nil : envlog.logDate;
+                                          }
+                                           millisOut:&millis];
+    _odometerLogMillis = millis;
+    _gasLogColumns = gasLogColumns;
+    _gasLogRange = gasLogRange;
+    _costPerMileBlk = costPerMileBlk;
+  }
+  return self;
+}
+
+#pragma mark - Scanning
+
+- (NSDecimalNumber *)costPerMile {
+  NSUInteger numOdometerLogs = _odometerLogs.count;
+  if (numOdometerLogs == 0) {
+    return nil;
+  }
+  NSUInteger gasLogIndex = _gasLogRange.location;
+  return [self costPerMileForOdometerLogsFrom:0 to:numOdometerLogs - 1 gasLogIndex:&gasLogIndex endMillis:INT64_MAX];
+}
+
+- (FPDataset *)monthlyDataSetWithBoundaries:(FPMonthBoundaries *)boundaries
+                                 beforeDate:(NSDate *)beforeDate
+                              onOrAfterDate:(NSDate *)onOrAfterDate {
+  const FPEpochMillis *odometerLogMillis = _odometerLogMillis.bytes;
+  NSUInteger numOdometerLogs = _odometerLogs.count;
+  NSInteger firstMonthKey = [boundaries monthKeyForDate:onOrAfterDate];
+  FPEpochMillis beforeMillis = FPEpochMillisFromDate(beforeDate);
+  FPDataset *dataset = [[FPDataset alloc] init];
+  NSUInteger gasLogIndex = _gasLogRange.location;
+  NSUInteger first = 0;
+  while (first < numOdometerLogs) {
+    NSInteger monthKey = [boundaries monthKeyForMillis:odometerLogMillis[first]];
+    if ([boundaries firstMillisOfMonthKey:monthKey] >= beforeMillis) {
+      break;
+    }
+    FPEpochMillis nextMonthMillis = [boundaries firstMillisOfMonthKey:monthKey + 1];
+    NSUInteger last = first;
+    while (last + 1 < numOdometerLogs && odometerLogMillis[last + 1] < nextMonthMillis) {
+      last++;
+    }
+    if (monthKey >= firstMonthKey) {
+      NSDecimalNumber *costPerMile = [self costPerMileForOdometerLogsFrom:first
+                                                                       to:last
+                                                              gasLogIndex:&gasLogIndex
+                                                                endMillis:nextMonthMillis];
+      if (costPerMile) {
+        [dataset appendValue:[costPerMile decimalValue] atMillis:[boundaries firstMillisOfMonthKey:monthKey]];
+      }
+    }
+    first = last + 1;
+  }
+  return dataset;
+}
+
+@end
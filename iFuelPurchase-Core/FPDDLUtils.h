@@ -92,8 +92,55 @@ FOUNDATION_EXPORT NSString * const COL_ENVL_OUTSIDE_TEMP_READING;
 FOUNDATION_EXPORT NSString * const COL_ENVL_LOG_DT;
 FOUNDATION_EXPORT NSString * const COL_ENVL_DTE;
 
+//##############################################################################
+// Monthly Rollups
+//##############################################################################
+// ----Table names--------------------------------------------------------------
+FOUNDATION_EXPORT NSString * const TBL_VEHICLE_GAS_MONTHLY_ROLLUP;
+FOUNDATION_EXPORT NSString * const TBL_FUELSTATION_GAS_MONTHLY_ROLLUP;
+FOUNDATION_EXPORT NSString * const TBL_VEHICLE_ODOMETER_MONTHLY_ROLLUP;
+FOUNDATION_EXPORT NSString * const TBL_MONTHLY_ROLLUP_DIRTY;
+FOUNDATION_EXPORT NSString * const TBL_MONTHLY_ROLLUP_CALENDAR;
+// ----Columns------------------------------------------------------------------
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_SRC;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_PARENT_ID;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_MONTH_KEY;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_FUEL_KEY;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_NUM_LOGS;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_GALLONS_TOTAL;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_GALLONS_COUNT;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_SPEND_TOTAL;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_SPEND_COUNT;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_PRICE_TOTAL;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_PRICE_COUNT;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_ODOMETER_COUNT;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_ODOMETER_MIN;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_ODOMETER_MAX;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_MPG_TOTAL;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_MPG_COUNT;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_MPH_TOTAL;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_MPH_COUNT;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_TEMP_TOTAL;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_TEMP_COUNT;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_PRICE_SKETCH;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_MPG_SKETCH;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_DIRTY_TABLE;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_DIRTY_LOG_DT;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_CALENDAR_ID;
+FOUNDATION_EXPORT NSString * const COL_ROLLUP_TIME_ZONE_NAME;
+
 @interface FPDDLUtils : NSObject
 
+#pragma mark - Monthly Rollups
+
++ (NSString *)gasMonthlyRollupDDLForTable:(NSString *)table;
+
++ (NSString *)vehicleOdometerMonthlyRollupDDL;
+
++ (NSString *)monthlyRollupDirtyDDL;
+
++ (NSString *)monthlyRollupCalendarDDL;
+
 #pragma mark - Master and Main Environment Log entities
 
 + (NSString *)masterEnvironmentLogDDL;
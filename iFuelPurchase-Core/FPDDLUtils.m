@@ -96,8 +96,143 @@ NSString * const COL_ENVL_DTE = @"dte";
 // ----Aliases used in SELECT statements----------------------------------------
 //NSString * const ENVL_ALIAS_VEHICLE_MAIN_IDENTIFIER = @"envl_vehicle_main_id";
 
+//##############################################################################
+// Monthly Rollups
+//##############################################################################
+// ----Table names--------------------------------------------------------------
+NSString * const TBL_VEHICLE_GAS_MONTHLY_ROLLUP = @"vehicle_gas_monthly_rollup";
+NSString * const TBL_FUELSTATION_GAS_MONTHLY_ROLLUP = @"fuelstation_gas_monthly_rollup";
+NSString * const TBL_VEHICLE_ODOMETER_MONTHLY_ROLLUP = @"vehicle_odometer_monthly_rollup";
+NSString * const TBL_MONTHLY_ROLLUP_DIRTY = @"monthly_rollup_dirty";
+NSString * const TBL_MONTHLY_ROLLUP_CALENDAR = @"monthly_rollup_calendar";
+// ----Columns------------------------------------------------------------------
+NSString * const COL_ROLLUP_SRC = @"src";
+NSString * const COL_ROLLUP_PARENT_ID = @"parent_id";
+NSString * const COL_ROLLUP_MONTH_KEY = @"month_key";
+NSString * const COL_ROLLUP_FUEL_KEY = @"fuel_key";
+NSString * const COL_ROLLUP_NUM_LOGS = @"num_logs";
+NSString * const COL_ROLLUP_GALLONS_TOTAL = @"gallons_total";
+NSString * const COL_ROLLUP_GALLONS_COUNT = @"gallons_count";
+NSString * const COL_ROLLUP_SPEND_TOTAL = @"spend_total";
+NSString * const COL_ROLLUP_SPEND_COUNT = @"spend_count";
+NSString * const COL_ROLLUP_PRICE_TOTAL = @"price_total";
+NSString * const COL_ROLLUP_PRICE_COUNT = @"price_count";
+NSString * const COL_ROLLUP_ODOMETER_COUNT = @"odometer_count";
+NSString * const COL_ROLLUP_ODOMETER_MIN = @"odometer_min";
+NSString * const COL_ROLLUP_ODOMETER_MAX = @"odometer_max";
+NSString * const COL_ROLLUP_MPG_TOTAL = @"mpg_total";
+NSString * const COL_ROLLUP_MPG_COUNT = @"mpg_count";
+NSString * const COL_ROLLUP_MPH_TOTAL = @"mph_total";
+NSString * const COL_ROLLUP_MPH_COUNT = @"mph_count";
+NSString * const COL_ROLLUP_TEMP_TOTAL = @"temp_total";
+NSString * const COL_ROLLUP_TEMP_COUNT = @"temp_count";
+NSString * const COL_ROLLUP_PRICE_SKETCH = @"price_sketch";
+NSString * const COL_ROLLUP_MPG_SKETCH = @"mpg_sketch";
+NSString * const COL_ROLLUP_DIRTY_TABLE = @"rollup_table";
+NSString * const COL_ROLLUP_DIRTY_LOG_DT = @"log_dt";
+NSString * const COL_ROLLUP_CALENDAR_ID = @"calendar_id";
+NSString * const COL_ROLLUP_TIME_ZONE_NAME = @"time_zone_name";
+
 @implementation FPDDLUtils
 
+#pragma mark - Monthly Rollups
+
++ (NSString *)gasMonthlyRollupDDLForTable:(NSString *)table {
+  return [NSString stringWithFormat:@"CREATE TABLE IF NOT EXISTS %@ ( \
+%@ INTEGER NOT NULL, \
+%@ INTEGER NOT NULL, \
+%@ INTEGER NOT NULL, \
+%@ INTEGER NOT NULL, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+PRIMARY KEY (%@, %@, %@, %@))", table,
+                   COL_ROLLUP_SRC,            // col1
+                   COL_ROLLUP_PARENT_ID,      // col2
+                   COL_ROLLUP_MONTH_KEY,      // col3
+                   COL_ROLLUP_FUEL_KEY,       // col4
+                   COL_ROLLUP_NUM_LOGS,       // col5
+                   COL_ROLLUP_GALLONS_TOTAL,  // col6
+                   COL_ROLLUP_GALLONS_COUNT,  // col7
+                   COL_ROLLUP_SPEND_TOTAL,    // col8
+                   COL_ROLLUP_SPEND_COUNT,    // col9
+                   COL_ROLLUP_PRICE_TOTAL,    // col10
+                   COL_ROLLUP_PRICE_COUNT,    // col11
+                   COL_ROLLUP_ODOMETER_COUNT, // col12
+                   COL_ROLLUP_ODOMETER_MIN,   // col13
+                   COL_ROLLUP_ODOMETER_MAX,   // col14
+                   COL_ROLLUP_SRC,            // pk, col1
+                   COL_ROLLUP_PARENT_ID,      // pk, col2
+                   COL_ROLLUP_MONTH_KEY,      // pk, col3
+                   COL_ROLLUP_FUEL_KEY];      // pk, col4
+}
+
++ (NSString *)vehicleOdometerMonthlyRollupDDL {
+  return [NSString stringWithFormat:@"CREATE TABLE IF NOT EXISTS %@ ( \
+%@ INTEGER NOT NULL, \
+%@ INTEGER NOT NULL, \
+%@ INTEGER NOT NULL, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+%@ INTEGER, \
+PRIMARY KEY (%@, %@, %@))", TBL_VEHICLE_ODOMETER_MONTHLY_ROLLUP,
+                   COL_ROLLUP_SRC,            // col1
+                   COL_ROLLUP_PARENT_ID,      // col2
+                   COL_ROLLUP_MONTH_KEY,      // col3
+                   COL_ROLLUP_NUM_LOGS,       // col4
+                   COL_ROLLUP_ODOMETER_COUNT, // col5
+                   COL_ROLLUP_ODOMETER_MIN,   // col6
+                   COL_ROLLUP_ODOMETER_MAX,   // col7
+                   COL_ROLLUP_MPG_TOTAL,      // col8
+                   COL_ROLLUP_MPG_COUNT,      // col9
+                   COL_ROLLUP_MPH_TOTAL,      // col10
+                   COL_ROLLUP_MPH_COUNT,      // col11
+                   COL_ROLLUP_TEMP_TOTAL,     // col12
+                   COL_ROLLUP_TEMP_COUNT,     // col13
+                   COL_ROLLUP_SRC,            // pk, col1
+                   COL_ROLLUP_PARENT_ID,      // pk, col2
+                   COL_ROLLUP_MONTH_KEY];     // pk, col3
+}
+
++ (NSString *)monthlyRollupDirtyDDL {
+  return [NSString stringWithFormat:@"CREATE TABLE IF NOT EXISTS %@ ( \
+%@ TEXT NOT NULL, \
+%@ INTEGER NOT NULL, \
+%@ INTEGER NOT NULL, \
+%@ INTEGER NOT NULL, \
+PRIMARY KEY (%@, %@, %@, %@))", TBL_MONTHLY_ROLLUP_DIRTY,
+                   COL_ROLLUP_DIRTY_TABLE,  // col1
+                   COL_ROLLUP_SRC,          // col2
+                   COL_ROLLUP_PARENT_ID,    // col3
+                   COL_ROLLUP_DIRTY_LOG_DT, // col4
+                   COL_ROLLUP_DIRTY_TABLE,  // pk, col1
+                   COL_ROLLUP_SRC,          // pk, col2
+                   COL_ROLLUP_PARENT_ID,    // pk, col3
+                   COL_ROLLUP_DIRTY_LOG_DT]; // pk, col4
+}
+
++ (NSString *)monthlyRollupCalendarDDL {
+  return [NSString stringWithFormat:@"CREATE TABLE IF NOT EXISTS %@ ( \
+%@ TEXT NOT NULL, \
+%@ TEXT NOT NULL)", TBL_MONTHLY_ROLLUP_CALENDAR,
+                   COL_ROLLUP_CALENDAR_ID,     // col1
+                   COL_ROLLUP_TIME_ZONE_NAME]; // col2
+}
+
 #pragma mark - Master and Main Environment Log entities
 
 + (NSString *)masterEnvironmentLogDDL {
@@ -0,0 +1,81 @@
+//
+//  FPDataset.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "FPMonthBoundaries.h"
+
+/**
+ A [date, value] dataset held as a pair of parallel buffers: each datapoint's
+ date as epoch milliseconds, and its value as an NSDecimal (so values are kept
+ exactly, as NSDecimalNumber datapoints are).  A dataset of n datapoints is 3
+ objects rather than 3n + 1, and reducers and merges read the buffers directly.
+
+ FPDataset is an NSArray, so it can be handed out wherever a legacy dataset is
+ expected: indexing (or enumerating) it as an array boxes the datapoint at that
+ index into an @[NSDate, NSDecimalNumber] pair, on demand and without caching.
+ Code that knows it has an FPDataset should use the typed accessors instead
+ (FPReducer and FPDatasetMerger do).
+
+ A dataset is built by appending datapoints in date order and is then treated
+ as immutable.  Slices share the receiver's buffers, so slicing doesn't copy; a
+ slice can't be appended to, and a dataset that has been sliced shouldn't be.
+ */
+@interface FPDataset : NSArray
+
+#pragma mark - Initializers
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+/**
+ Converts a legacy [date, value] dataset (which may itself be an FPDataset, in
+ which case it's returned as-is); datapoints whose value is nil or NSNull are
+ dropped.
+ */
++ (FPDataset *)datasetWithDatapoints:(NSArray *)datapoints;
+
+#pragma mark - Building
+
+- (void)appendValue:(NSDecimal)value atMillis:(FPEpochMillis)millis;
+
+- (void)appendValue:(NSDecimalNumber *)value date:(NSDate *)date;
+
+#pragma mark - Typed Access
+
+/** The datapoints' dates, as epoch milliseconds; count long. */
+- (const FPEpochMillis *)millis;
+
+/** The datapoints' values; count long. */
+- (const NSDecimal *)values;
+
+- (FPEpochMillis)millisAtIndex:(NSUInteger)index;
+
+- (NSDecimal)decimalValueAtIndex:(NSUInteger)index;
+
+- (NSDate *)dateAtIndex:(NSUInteger)index;
+
+- (NSDecimalNumber *)valueAtIndex:(NSUInteger)index;
+
+/**
+ Calls blk with each datapoint, in order, without boxing; set *stop to YES to
+ end the enumeration early.
+ */
+- (void)enumerateDatapointsUsingBlock:(void(^)(FPEpochMillis millis, NSDecimal value, NSUInteger index, BOOL *stop))blk;
+
+#pragma mark - Slicing
+
+/** A slice sharing the receiver's buffers. */
+- (FPDataset *)subarrayWithRange:(NSRange)range;
+
+/**
+ The slice of the datapoints dated within [onOrAfterDate, beforeDate), found by
+ binary search; a nil date leaves that end of the range open.
+ */
+- (FPDataset *)datasetBeforeDate:(NSDate *)beforeDate onOrAfterDate:(NSDate *)onOrAfterDate;
+
+@end
@@ -0,0 +1,174 @@
+//
+//  FPDataset.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPDataset.h"
+
+#import <PEObjc-Commons/PEUtils.h>
+
+@implementation FPDataset {
+  NSMutableData *_millis;
+  NSMutableData *_values;
+  NSUInteger _offset; // of the receiver's first datapoint within the buffers
+  NSUInteger _count;
+  BOOL _isSlice;
+}
+
+#pragma mark - Initializers
+
+- (instancetype)init {
+  return [self initWithCapacity:0];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+  self = [super init];
+  if (self) {
+    _millis = [NSMutableData dataWithCapacity:capacity * sizeof(FPEpochMillis)];
+    _values = [NSMutableData dataWithCapacity:capacity * sizeof(NSDecimal)];
+  }
+  return self;
+}
+
+- (instancetype)initWithMillis:(NSMutableData *)millis
+                        values:(NSMutableData *)values
+                        offset:(NSUInteger)offset
+                         count:(NSUInteger)count {
+  self = [super init];
+  if (self) {
+    _millis = millis;
+    _values = values;
+    _offset = offset;
+    _count = count;
+    _isSlice = YES;
+  }
+  return self;
+}
+
++ (FPDataset *)datasetWithDatapoints:(NSArray *)datapoints {
+  if ([datapoints isKindOfClass:[FPDataset class]]) {
+    return (FPDataset *)datapoints;
+  }
+  FPDataset *dataset = [[FPDataset alloc] initWithCapacity:datapoints.count];
+  for (NSArray *dp in datapoints) {
+    id value = dp[1];
+    if (![PEUtils isNil:value]) {
+      [dataset appendValue:[value decimalValue] atMillis:FPEpochMillisFromDate(dp[0])];
+    }
+  }
+  return dataset;
+}
+
+#pragma mark - Building
+
+- (void)appendValue:(NSDecimal)value atMillis:(FPEpochMillis)millis {
+  NSAssert(!_isSlice, @"A dataset slice can't be appended to");
+  [_millis appendBytes:&millis length:sizeof(FPEpochMillis)];
+  [_values appendBytes:&value length:sizeof(NSDecimal)];
+  _count++;
+}
+
+- (void)appendValue:(NSDecimalNumber *)value date:(NSDate *)date {
+  [self appendValue:[value decimalValue] atMillis:FPEpochMillisFromDate(date)];
+}
+
+#pragma mark - Typed Access
+
+- (const FPEpochMillis *)millis {
+  return (const FPEpochMillis *)_millis.bytes + _offset;
+}
+
+- (const NSDecimal *)values {
+  return (const NSDecimal *)_values.bytes + _offset;
+}
+
+- (void)checkIndex:(NSUInteger)index {
+  if (index >= _count) {
+    [NSException raise:NSRangeException format:@"index %lu beyond bounds of dataset of %lu datapoints",
+     (unsigned long)index, (unsigned long)_count];
+  }
+}
+
+- (FPEpochMillis)millisAtIndex:(NSUInteger)index {
+  [self checkIndex:index];
+  return [self millis][index];
+}
+
+- (NSDecimal)decimalValueAtIndex:(NSUInteger)index {
+  [self checkIndex:index];
+  return [self values][index];
+}
+
+- (NSDate *)dateAtIndex:(NSUInteger)index {
+  return [NSDate dateWithTimeIntervalSince1970:[self millisAtIndex:index] / 1000.0];
+}
+
+- (NSDecimalNumber *)valueAtIndex:(NSUInteger)index {
+  return [NSDecimalNumber decimalNumberWithDecimal:[self decimalValueAtIndex:index]];
+}
+
+- (void)enumerateDatapointsUsingBlock:(void(^)(FPEpochMillis, NSDecimal, NSUInteger, BOOL *))blk {
+  const FPEpochMillis *millis = [self millis];
+  const NSDecimal *values = [self values];
+  BOOL stop = NO;
+  for (NSUInteger i = 0; i < _count && !stop; i++) {
+    blk(millis[i], values[i], i, &stop);
+  }
+}
+
+#pragma mark - Slicing
+
+- (FPDataset *)subarrayWithRange:(NSRange)range {
+  if (NSMaxRange(range) > _count) {
+    [NSException raise:NSRangeException format:@"range %@ beyond bounds of dataset of %lu datapoints",
+     NSStringFromRange(range), (unsigned long)_count];
+  }
+  return [[FPDataset alloc] initWithMillis:_millis values:_values offset:_offset + range.location count:range.length];
+}
+
+/*
+ The index of the first datapoint dated on or after millis.
+ */
+- (NSUInteger)lowerBoundForMillis:(FPEpochMillis)millis {
+  const FPEpochMillis *dates = [self millis];
+  NSUInteger low = 0;
+  NSUInteger high = _count;
+  while (low < high) {
+    NSUInteger mid = low + ((high - low) / 2);
+    if (dates[mid] < millis) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+- (FPDataset *)datasetBeforeDate:(NSDate *)beforeDate onOrAfterDate:(NSDate *)onOrAfterDate {
+  NSUInteger first = onOrAfterDate ? [self lowerBoundForMillis:FPEpochMillisFromDate(onOrAfterDate)] : 0;
+  NSUInteger last = beforeDate ? [self lowerBoundForMillis:FPEpochMillisFromDate(beforeDate)] : _count;
+  return [self subarrayWithRange:NSMakeRange(first, last > first ? last - first : 0)];
+}
+
+#pragma mark - NSArray
+
+- (NSUInteger)count {
+  return _count;
+}
+
+- (id)objectAtIndex:(NSUInteger)index {
+  return @[[self dateAtIndex:index], [self valueAtIndex:index]];
+}
+
+- (id)copyWithZone:(NSZone *)zone {
+  return [self subarrayWithRange:NSMakeRange(0, _count)];
+}
+
+- (Class)classForCoder {
+  return [NSArray class];
+}
+
+@end
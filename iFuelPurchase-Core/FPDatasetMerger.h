@@ -0,0 +1,31 @@
+//
+//  FPDatasetMerger.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Merges [date, value] datasets (e.g., one per vehicle) into a single dataset.
+ Each input dataset must already be sorted by date, ascending; the merge is a
+ heap-based k-way merge, so the output comes out sorted without a final sort.
+ Datapoints that share a date are averaged: each date carries a (sum, count)
+ pair, so every dataset's datapoint is weighted equally.
+ */
+@interface FPDatasetMerger : NSObject
+
+/**
+ valueBlk maps each input datapoint value to the decimal value to average (it
+ may be nil, in which case the values are taken as-is).  Nil values are
+ skipped; dates with no values are dropped.  Datapoints that share a date are
+ folded in dataset order, so the result does not depend on heap tie-breaking.
+ When valueBlk is nil and every non-empty dataset is an FPDataset, the merge
+ runs on their buffers and the result is an FPDataset too.
+ */
++ (NSArray *)averagedMergeOfDatasets:(NSArray *)datasets
+                            valueBlk:(NSDecimalNumber *(^)(id))valueBlk;
+
+@end
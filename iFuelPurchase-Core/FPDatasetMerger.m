@@ -0,0 +1,195 @@
+//
+//  FPDatasetMerger.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPDatasetMerger.h"
+
+#import <PEObjc-Commons/PEUtils.h>
+
+#import "FPDataset.h"
+#import "FPFixedPoint.h"
+
+typedef struct {
+  NSUInteger dataset;
+  NSUInteger index;
+} FPMergeCursor;
+
+typedef NSComparisonResult (*FPCursorComparator)(const void *datasets, FPMergeCursor c1, FPMergeCursor c2);
+
+static NSComparisonResult FPCompareCursorDatasets(NSComparisonResult result, FPMergeCursor c1, FPMergeCursor c2) {
+  if (result == NSOrderedSame && c1.dataset != c2.dataset) {
+    result = c1.dataset < c2.dataset ? NSOrderedAscending : NSOrderedDescending;
+  }
+  return result;
+}
+
+static NSComparisonResult FPCompareCursors(const void *datasets, FPMergeCursor c1, FPMergeCursor c2) {
+  __unsafe_unretained NSArray *legacyDatasets = (__bridge NSArray *)datasets;
+  NSComparisonResult result = [legacyDatasets[c1.dataset][c1.index][0] compare:legacyDatasets[c2.dataset][c2.index][0]];
+  return FPCompareCursorDatasets(result, c1, c2);
+}
+
+/*
+ datasets is the array of each FPDataset's millis buffer.
+ */
+static NSComparisonResult FPCompareTypedCursors(const void *datasets, FPMergeCursor c1, FPMergeCursor c2) {
+  const FPEpochMillis *const *millis = datasets;
+  FPEpochMillis m1 = millis[c1.dataset][c1.index];
+  FPEpochMillis m2 = millis[c2.dataset][c2.index];
+  NSComparisonResult result = m1 < m2 ? NSOrderedAscending : (m1 > m2 ? NSOrderedDescending : NSOrderedSame);
+  return FPCompareCursorDatasets(result, c1, c2);
+}
+
+static void FPSiftDown(FPCursorComparator compare, const void *datasets, FPMergeCursor *heap, NSUInteger heapSize, NSUInteger i) {
+  while (YES) {
+    NSUInteger smallest = i;
+    NSUInteger left = (2 * i) + 1;
+    NSUInteger right = left + 1;
+    if (left < heapSize && compare(datasets, heap[left], heap[smallest]) == NSOrderedAscending) {
+      smallest = left;
+    }
+    if (right < heapSize && compare(datasets, heap[right], heap[smallest]) == NSOrderedAscending) {
+      smallest = right;
+    }
+    if (smallest == i) {
+      return;
+    }
+    FPMergeCursor tmp = heap[i];
+    heap[i] = heap[smallest];
+    heap[smallest] = tmp;
+    i = smallest;
+  }
+}
+
+static void FPAddAveragedDatapoint(NSMutableArray *dataset, NSDate *date, FPSum *sum) {
+  NSDecimalNumber *avg = FPSumAverage(sum);
+  if (avg) {
+    [dataset addObject:@[date, avg]];
+  }
+}
+
+static void FPAddAveragedTypedDatapoint(FPDataset *dataset, FPEpochMillis millis, FPSum *sum) {
+  NSDecimal avg;
+  if (FPSumAverageDecimal(sum, &avg)) {
+    [dataset appendValue:avg atMillis:millis];
+  }
+}
+
+@implementation FPDatasetMerger
+
+/*
+ The merge of datasets that are all FPDatasets (or empty), with the values
+ taken as-is: the heap compares millis and the sums read the value buffers, so
+ nothing is boxed.
+ */
++ (FPDataset *)averagedMergeOfTypedDatasets:(NSArray *)datasets {
+  NSUInteger numDatasets = datasets.count;
+  FPDataset *mergedDataset = [[FPDataset alloc] init];
+  const FPEpochMillis **millis = malloc(sizeof(FPEpochMillis *) * numDatasets);
+  const NSDecimal **values = malloc(sizeof(NSDecimal *) * numDatasets);
+  NSUInteger *counts = malloc(sizeof(NSUInteger) * numDatasets);
+  FPMergeCursor *heap = malloc(sizeof(FPMergeCursor) * numDatasets);
+  NSUInteger heapSize = 0;
+  for (NSUInteger i = 0; i < numDatasets; i++) {
+    counts[i] = [datasets[i] count];
+    if (counts[i] > 0) {
+      FPDataset *dataset = datasets[i];
+      millis[i] = [dataset millis];
+      values[i] = [dataset values];
+      heap[heapSize++] = (FPMergeCursor){i, 0};
+    }
+  }
+  for (NSInteger i = ((NSInteger)heapSize / 2) - 1; i >= 0; i--) {
+    FPSiftDown(FPCompareTypedCursors, millis, heap, heapSize, i);
+  }
+  FPEpochMillis date = 0;
+  FPSum sum = FPSumMake();
+  while (heapSize > 0) {
+    FPMergeCursor cursor = heap[0];
+    FPEpochMillis datapointMillis = millis[cursor.dataset][cursor.index];
+    if (sum.count == 0 || datapointMillis != date) {
+      FPAddAveragedTypedDatapoint(mergedDataset, date, &sum);
+      date = datapointMillis;
+      sum = FPSumMake();
+    }
+    FPSumAddDecimal(&sum, values[cursor.dataset][cursor.index]);
+    if (cursor.index + 1 < counts[cursor.dataset]) {
+      heap[0].index++;
+    } else {
+      heap[0] = heap[--heapSize];
+    }
+    FPSiftDown(FPCompareTypedCursors, millis, heap, heapSize, 0);
+  }
+  FPAddAveragedTypedDatapoint(mergedDataset, date, &sum);
+  free(heap);
+  free(counts);
+  free(values);
+  free(millis);
+  return mergedDataset;
+}
+
++ (NSArray *)averagedMergeOfDatasets:(NSArray *)datasets
+                            valueBlk:(NSDecimalNumber *(^)(id))valueBlk {
+  NSUInteger numDatasets = datasets.count;
+  if (numDatasets == 0) {
+    return @[];
+  }
+  if (!valueBlk) {
+    BOOL allTyped = YES;
+    for (NSArray *dataset in datasets) {
+      if (dataset.count > 0 && ![dataset isKindOfClass:[FPDataset class]]) {
+        allTyped = NO;
+        break;
+      }
+    }
+    if (allTyped) {
+      return [self averagedMergeOfTypedDatasets:datasets];
+    }
+  }
+  NSMutableArray *mergedDataset = [NSMutableArray array];
+  FPMergeCursor *heap = malloc(sizeof(FPMergeCursor) * numDatasets);
+  NSUInteger heapSize = 0;
+  for (NSUInteger i = 0; i < numDatasets; i++) {
+    if ([datasets[i] count] > 0) {
+      heap[heapSize++] = (FPMergeCursor){i, 0};
+    }
+  }
+  for (NSInteger i = ((NSInteger)heapSize / 2) - 1; i >= 0; i--) {
+    FPSiftDown(FPCompareCursors, (__bridge const void *)datasets, heap, heapSize, i);
+  }
+  NSDate *date = nil;
+  FPSum sum = FPSumMake();
+  while (heapSize > 0) {
+    FPMergeCursor cursor = heap[0];
+    NSArray *dataset = datasets[cursor.dataset];
+    NSArray *datapoint = dataset[cursor.index];
+    if (date == nil || ![datapoint[0] isEqualToDate:date]) {
+      if (date) {
+        FPAddAveragedDatapoint(mergedDataset, date, &sum);
+      }
+      date = datapoint[0];
+      sum = FPSumMake();
+    }
+    id value = valueBlk ? valueBlk(datapoint[1]) : datapoint[1];
+    if (![PEUtils isNil:value]) {
+      FPSumAddDecimal(&sum, [value decimalValue]);
+    }
+    if (cursor.index + 1 < dataset.count) {
+      heap[0].index++;
+    } else {
+      heap[0] = heap[--heapSize];
+    }
+    FPSiftDown(FPCompareCursors, (__bridge const void *)datasets, heap, heapSize, 0);
+  }
+  if (date) {
+    FPAddAveragedDatapoint(mergedDataset, date, &sum);
+  }
+  free(heap);
+  return mergedDataset;
+}
+
+@end
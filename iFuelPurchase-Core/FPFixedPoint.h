@@ -0,0 +1,122 @@
+//
+//  FPFixedPoint.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ Fixed-point money / volume values, in millionths of a unit (e.g., 3.459 is
+ 3459000).  Gallons and prices are stored with at most FPEntryScale (3) decimal
+ places, whether entered, imported or synced (the DAO rounds them with
+ FPDecimalNumberRoundedToEntryScale), so their products and sums are exact in
+ micro-units.
+
+ Rounding: any value needing more than 6 decimal places is rounded to the
+ nearest micro-unit, halves away from zero (NSRoundPlain, i.e., the same as
+ NSDecimalNumber's default behavior), and the conversion reports itself as
+ inexact.  FPSum never rounds: inexact values are carried at full NSDecimal
+ precision instead.
+ */
+typedef int64_t FPMicros;
+
+FOUNDATION_EXPORT const FPMicros FPMicrosPerUnit;
+
+/** The decimal places gallons and prices are stored with. */
+FOUNDATION_EXPORT const short FPEntryScale;
+
+#pragma mark - Conversions
+
+/**
+ Returns NO if the decimal is NaN, out of range, or needed rounding; in the
+ rounding case, micros holds the rounded value.
+ */
+FOUNDATION_EXPORT BOOL FPMicrosFromDecimal(NSDecimal decimal, FPMicros *micros);
+
+FOUNDATION_EXPORT NSDecimal FPDecimalFromMicros(FPMicros micros);
+
+/**
+ value * 10^-scale, exactly (e.g., a product of two micro-unit values is an
+ integer at scale 12).
+ */
+FOUNDATION_EXPORT NSDecimal FPDecimalFromScaledInteger(int64_t value, short scale);
+
+FOUNDATION_EXPORT NSDecimalNumber *FPDecimalNumberFromMicros(FPMicros micros);
+
+/**
+ The value rounded to FPEntryScale decimal places (NSRoundPlain); nil stays nil.
+ */
+FOUNDATION_EXPORT NSDecimalNumber *FPDecimalNumberRoundedToEntryScale(NSDecimalNumber *value);
+
+#pragma mark - Arithmetic
+
+/**
+ Returns NO if the product had to be rounded or is out of range.
+ */
+FOUNDATION_EXPORT BOOL FPMicrosMultiply(FPMicros lhs, FPMicros rhs, FPMicros *product);
+
+#pragma mark - Sums
+
+/**
+ An allocation-free running sum for hot loops.  Exact values accumulate in
+ micro-units; anything else (more than 6 decimal places, or overflow) is
+ accumulated in inexactSum.  Convert to NSDecimalNumber only once at the end.
+ */
+typedef struct {
+  FPMicros exactSum;
+  NSDecimal inexactSum;
+  BOOL hasInexactSum;
+  NSInteger count;
+} FPSum;
+
+FOUNDATION_EXPORT FPSum FPSumMake(void);
+
+FOUNDATION_EXPORT void FPSumAddDecimal(FPSum *sum, NSDecimal value);
+
+FOUNDATION_EXPORT void FPSumAddDecimalNumber(FPSum *sum, NSDecimalNumber *value);
+
+FOUNDATION_EXPORT void FPSumAddInteger(FPSum *sum, NSInteger value);
+
+/**
+ Adds lhs * rhs (e.g., num gallons * gallon price).
+ */
+FOUNDATION_EXPORT void FPSumAddProduct(FPSum *sum, NSDecimalNumber *lhs, NSDecimalNumber *rhs);
+
+FOUNDATION_EXPORT void FPSumAddMicros(FPSum *sum, FPMicros micros);
+
+/**
+ Adds lhs * rhs for values already in micro-units; a product that doesn't fit
+ in micro-units is carried at full precision, like FPSumAddProduct.
+ */
+FOUNDATION_EXPORT void FPSumAddMicrosProduct(FPSum *sum, FPMicros lhs, FPMicros rhs);
+
+/**
+ Take back a value added with FPSumAddMicros or FPSumAddMicrosProduct (e.g.,
+ as it leaves a sliding window); the sum stays exact.
+ */
+FOUNDATION_EXPORT void FPSumRemoveMicros(FPSum *sum, FPMicros micros);
+
+FOUNDATION_EXPORT void FPSumRemoveMicrosProduct(FPSum *sum, FPMicros lhs, FPMicros rhs);
+
+/**
+ Adds the total of count values that were summed elsewhere (e.g., by a
+ vectorized kernel).
+ */
+FOUNDATION_EXPORT void FPSumAddTotal(FPSum *sum, NSDecimal total, NSInteger count);
+
+FOUNDATION_EXPORT NSDecimal FPSumTotal(const FPSum *sum);
+
+FOUNDATION_EXPORT NSDecimalNumber *FPSumDecimalNumber(const FPSum *sum);
+
+/**
+ The total divided by the number of values added; nil if none were added.
+ */
+FOUNDATION_EXPORT NSDecimalNumber *FPSumAverage(const FPSum *sum);
+
+/**
+ As FPSumAverage, into avg; returns NO (leaving avg alone) if none were added.
+ */
+FOUNDATION_EXPORT BOOL FPSumAverageDecimal(const FPSum *sum, NSDecimal *avg);
@@ -0,0 +1,298 @@
+//
+//  FPFixedPoint.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPFixedPoint.h"
+
+const FPMicros FPMicrosPerUnit = 1000000;
+
+const short FPEntryScale = 3;
+
+static const short FPMicrosScale = 6;
+
+#pragma mark - Helpers
+
+static BOOL FPMantissaFromDecimal(const NSDecimal *decimal, uint64_t *mantissa) {
+  if (decimal->_length > 4) {
+    return NO; // wider than 64 bits
+  }
+  uint64_t value = 0;
+  for (int i = decimal->_length - 1; i >= 0; i--) {
+    value = (value << 16) | decimal->_mantissa[i];
+  }
+  *mantissa = value;
+  return YES;
+}
+
+static BOOL FPMicrosFromMantissa(uint64_t mantissa, short exponent, BOOL isNegative, FPMicros *micros) {
+  for (short i = 0; i < exponent; i++) {
+    if (__builtin_mul_overflow(mantissa, 10, &mantissa)) {
+      return NO;
+    }
+  }
+  if (mantissa > (uint64_t)INT64_MAX) {
+    return NO;
+  }
+  *micros = isNegative ? -(FPMicros)mantissa : (FPMicros)mantissa;
+  return YES;
+}
+
+#pragma mark - Conversions
+
+BOOL FPMicrosFromDecimal(NSDecimal decimal, FPMicros *micros) {
+  *micros = 0;
+  if (NSDecimalIsNotANumber(&decimal)) {
+    return NO;
+  }
+  uint64_t mantissa;
+  // fast path: no more than 6 decimal places, so no rounding is needed
+  if (decimal._exponent >= -FPMicrosScale && FPMantissaFromDecimal(&decimal, &mantissa)) {
+    return FPMicrosFromMantissa(mantissa, decimal._exponent + FPMicrosScale, decimal._isNegative, micros);
+  }
+  NSDecimal scaled;
+  if (NSDecimalMultiplyByPowerOf10(&scaled, &decimal, FPMicrosScale, NSRoundPlain) != NSCalculationNoError) {
+    return NO;
+  }
+  NSDecimal rounded;
+  NSDecimalRound(&rounded, &scaled, 0, NSRoundPlain);
+  BOOL exact = NSDecimalCompare(&rounded, &scaled) == NSOrderedSame;
+  NSDecimalCompact(&rounded);
+  if (rounded._exponent < 0 || !FPMantissaFromDecimal(&rounded, &mantissa)) {
+    return NO;
+  }
+  if (!FPMicrosFromMantissa(mantissa, rounded._exponent, rounded._isNegative, micros)) {
+    return NO;
+  }
+  return exact;
+}
+
+NSDecimal FPDecimalFromMicros(FPMicros micros) {
+  return FPDecimalFromScaledInteger(micros, FPMicrosScale);
+}
+
+NSDecimal FPDecimalFromScaledInteger(int64_t value, short scale) {
+  uint64_t magnitude = value < 0 ? (uint64_t)(-(value + 1)) + 1 : (uint64_t)value;
+  NSDecimal decimal;
+  decimal._exponent = -scale;
+  decimal._isNegative = value < 0;
+  decimal._isCompact = NO;
+  decimal._reserved = 0;
+  decimal._length = 0;
+  for (int i = 0; i < 8; i++) {
+    decimal._mantissa[i] = (unsigned short)(magnitude & 0xFFFF);
+    magnitude >>= 16;
+    if (decimal._mantissa[i] != 0) {
+      decimal._length = i + 1;
+    }
+  }
+  if (decimal._length == 0) {
+    decimal._exponent = 0;
+  }
+  NSDecimalCompact(&decimal);
+  return decimal;
+}
+
+NSDecimalNumber *FPDecimalNumberFromMicros(FPMicros micros) {
+  return [NSDecimalNumber decimalNumberWithDecimal:FPDecimalFromMicros(micros)];
+}
+
+NSDecimalNumber *FPDecimalNumberRoundedToEntryScale(NSDecimalNumber *value) {
+  if (!value) {
+    return nil;
+  }
+  NSDecimal decimal = [value decimalValue];
+  if (decimal._exponent >= -FPEntryScale) {
+    return value;
+  }
+  NSDecimal rounded;
+  NSDecimalRound(&rounded, &decimal, FPEntryScale, NSRoundPlain);
+  return [NSDecimalNumber decimalNumberWithDecimal:rounded];
+}
+
+#pragma mark - Arithmetic
+
+BOOL FPMicrosMultiply(FPMicros lhs, FPMicros rhs, FPMicros *product) {
+#if defined(__SIZEOF_INT128__)
+  __int128 wide = (__int128)lhs * rhs;
+  __int128 quotient = wide / FPMicrosPerUnit;
+  __int128 remainder = wide % FPMicrosPerUnit;
+  if (remainder * 2 >= FPMicrosPerUnit) {
+    quotient++;
+  } else if (remainder * 2 <= -FPMicrosPerUnit) {
+    quotient--;
+  }
+  if (quotient > INT64_MAX || quotient < INT64_MIN) {
+    *product = 0;
+    return NO;
+  }
+  *product = (FPMicros)quotient;
+  return remainder == 0;
+#else
+  NSDecimal lhsDecimal = FPDecimalFromMicros(lhs);
+  NSDecimal rhsDecimal = FPDecimalFromMicros(rhs);
+  NSDecimal productDecimal;
+  NSDecimalMultiply(&productDecimal, &lhsDecimal, &rhsDecimal, NSRoundPlain);
+  return FPMicrosFromDecimal(productDecimal, product);
+#endif
+}
+
+#pragma mark - Sums
+
+static void FPSumAddInexact(FPSum *sum, NSDecimal value) {
+  NSDecimal total;
+  NSDecimalAdd(&total, &sum->inexactSum, &value, NSRoundPlain);
+  sum->inexactSum = total;
+  sum->hasInexactSum = YES;
+}
+
+static NSDecimal FPDecimalNegated(NSDecimal value) {
+  NSDecimal zero = FPDecimalFromMicros(0);
+  NSDecimal negated;
+  NSDecimalSubtract(&negated, &zero, &value, NSRoundPlain);
+  return negated;
+}
+
+static void FPSumAccumulateMicros(FPSum *sum, FPMicros micros) {
+  FPMicros total;
+  if (__builtin_add_overflow(sum->exactSum, micros, &total)) {
+    FPSumAddInexact(sum, FPDecimalFromMicros(micros));
+  } else {
+    sum->exactSum = total;
+  }
+}
+
+FPSum FPSumMake(void) {
+  FPSum sum;
+  sum.exactSum = 0;
+  sum.inexactSum = FPDecimalFromMicros(0);
+  sum.hasInexactSum = NO;
+  sum.count = 0;
+  return sum;
+}
+
+static void FPSumAccumulateDecimal(FPSum *sum, NSDecimal value) {
+  FPMicros micros;
+  if (FPMicrosFromDecimal(value, &micros)) {
+    FPSumAccumulateMicros(sum, micros);
+  } else {
+    FPSumAddInexact(sum, value);
+  }
+}
+
+void FPSumAddDecimal(FPSum *sum, NSDecimal value) {
+  FPSumAccumulateDecimal(sum, value);
+  sum->count++;
+}
+
+void FPSumAddDecimalNumber(FPSum *sum, NSDecimalNumber *value) {
+  FPSumAddDecimal(sum, [value decimalValue]);
+}
+
+void FPSumAddInteger(FPSum *sum, NSInteger value) {
+  FPMicros micros;
+  if (__builtin_mul_overflow((FPMicros)value, FPMicrosPerUnit, &micros)) {
+    FPSumAddInexact(sum, [@(value) decimalValue]);
+  } else {
+    FPSumAccumulateMicros(sum, micros);
+  }
+  sum->count++;
+}
+
+void FPSumAddProduct(FPSum *sum, NSDecimalNumber *lhs, NSDecimalNumber *rhs) {
+  NSDecimal lhsDecimal = [lhs decimalValue];
+  NSDecimal rhsDecimal = [rhs decimalValue];
+  FPMicros lhsMicros, rhsMicros, product;
+  if (FPMicrosFromDecimal(lhsDecimal, &lhsMicros) &&
+      FPMicrosFromDecimal(rhsDecimal, &rhsMicros) &&
+      FPMicrosMultiply(lhsMicros, rhsMicros, &product)) {
+    FPSumAccumulateMicros(sum, product);
+  } else {
+    NSDecimal productDecimal;
+    NSDecimalMultiply(&productDecimal, &lhsDecimal, &rhsDecimal, NSRoundPlain);
+    FPSumAddInexact(sum, productDecimal);
+  }
+  sum->count++;
+}
+
+void FPSumAddMicros(FPSum *sum, FPMicros micros) {
+  FPSumAccumulateMicros(sum, micros);
+  sum->count++;
+}
+
+void FPSumAddMicrosProduct(FPSum *sum, FPMicros lhs, FPMicros rhs) {
+  FPMicros product;
+  if (FPMicrosMultiply(lhs, rhs, &product)) {
+    FPSumAccumulateMicros(sum, product);
+  } else {
+    NSDecimal lhsDecimal = FPDecimalFromMicros(lhs);
+    NSDecimal rhsDecimal = FPDecimalFromMicros(rhs);
+    NSDecimal productDecimal;
+    NSDecimalMultiply(&productDecimal, &lhsDecimal, &rhsDecimal, NSRoundPlain);
+    FPSumAddInexact(sum, productDecimal);
+  }
+  sum->count++;
+}
+
+void FPSumRemoveMicros(FPSum *sum, FPMicros micros) {
+  if (micros == INT64_MIN) {
+    FPSumAddInexact(sum, FPDecimalNegated(FPDecimalFromMicros(micros)));
+  } else {
+    FPSumAccumulateMicros(sum, -micros);
+  }
+  sum->count--;
+}
+
+void FPSumRemoveMicrosProduct(FPSum *sum, FPMicros lhs, FPMicros rhs) {
+  FPMicros product;
+  if (FPMicrosMultiply(lhs, rhs, &product) && product != INT64_MIN) {
+    FPSumAccumulateMicros(sum, -product);
+  } else {
+    NSDecimal lhsDecimal = FPDecimalFromMicros(lhs);
+    NSDecimal rhsDecimal = FPDecimalFromMicros(rhs);
+    NSDecimal productDecimal;
+    NSDecimalMultiply(&productDecimal, &lhsDecimal, &rhsDecimal, NSRoundPlain);
+    FPSumAddInexact(sum, FPDecimalNegated(productDecimal));
+  }
+  sum->count--;
+}
+
+void FPSumAddTotal(FPSum *sum, NSDecimal total, NSInteger count) {
+  FPSumAccumulateDecimal(sum, total);
+  sum->count += count;
+}
+
+NSDecimal FPSumTotal(const FPSum *sum) {
+  NSDecimal total = FPDecimalFromMicros(sum->exactSum);
+  if (sum->hasInexactSum) {
+    NSDecimal exactSum = total;
+    NSDecimal inexactSum = sum->inexactSum;
+    NSDecimalAdd(&total, &exactSum, &inexactSum, NSRoundPlain);
+  }
+  return total;
+}
+
+NSDecimalNumber *FPSumDecimalNumber(const FPSum *sum) {
+  return [NSDecimalNumber decimalNumberWithDecimal:FPSumTotal(sum)];
+}
+
+BOOL FPSumAverageDecimal(const FPSum *sum, NSDecimal *avg) {
+  if (sum->count > 0) {
+    NSDecimal total = FPSumTotal(sum);
+    NSDecimal count = [@(sum->count) decimalValue];
+    NSDecimalDivide(avg, &total, &count, NSRoundPlain);
+    return YES;
+  }
+  return NO;
+}
+
+NSDecimalNumber *FPSumAverage(const FPSum *sum) {
+  NSDecimal avg;
+  if (FPSumAverageDecimal(sum, &avg)) {
+    return [NSDecimalNumber decimalNumberWithDecimal:avg];
+  }
+  return nil;
+}
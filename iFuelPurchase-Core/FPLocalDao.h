@@ -7,6 +7,7 @@
 //
 
 #import <PELocal-Data/PELMDefs.h>
+#import "FPLogAggregate.h"
 
 @class CLLocation;
 @protocol PELocalDao;
@@ -16,6 +17,8 @@
 @class FPFuelStationType;
 @class FPFuelPurchaseLog;
 @class FPEnvironmentLog;
+@class FPLogColumns;
+@class FPQuantileSketch;
 
 @protocol FPLocalDao <PELocalDao>
 
@@ -922,4 +925,236 @@
 - (void)markAsSyncCompleteForUpdatedEnvironmentLog:(FPEnvironmentLog *)environmentLog
                                              error:(PELMDaoErrorBlk)errorBlk;
 
+#pragma mark - Aggregates
+
+- (FPLogAggregate *)aggregateOfGasLogMeasure:(FPGasLogMeasure)measure
+                                     forUser:(FPUser *)user
+                                  beforeDate:(NSDate *)beforeDate
+                               onOrAfterDate:(NSDate *)onOrAfterDate
+                                      octane:(NSNumber *)octane
+                                      diesel:(BOOL)diesel
+                                       error:(PELMDaoErrorBlk)errorBlk;
+
+- (FPLogAggregate *)aggregateOfGasLogMeasure:(FPGasLogMeasure)measure
+                                  forVehicle:(FPVehicle *)vehicle
+                                  beforeDate:(NSDate *)beforeDate
+                               onOrAfterDate:(NSDate *)onOrAfterDate
+                                      octane:(NSNumber *)octane
+                                      diesel:(BOOL)diesel
+                                       error:(PELMDaoErrorBlk)errorBlk;
+
+- (FPLogAggregate *)aggregateOfGasLogMeasure:(FPGasLogMeasure)measure
+                              forFuelstation:(FPFuelStation *)fuelstation
+                                  beforeDate:(NSDate *)beforeDate
+                               onOrAfterDate:(NSDate *)onOrAfterDate
+                                      octane:(NSNumber *)octane
+                                      diesel:(BOOL)diesel
+                                       error:(PELMDaoErrorBlk)errorBlk;
+
+/**
+ The aggregate of the measure for each octane (and for diesel) in one grouped
+ query, keyed by octane (see FPOctaneKeyDiesel).  Gas logs with neither an
+ octane nor the diesel flag aren't counted; octanes without any logs in range
+ have no entry.
+ */
+- (NSDictionary *)octaneAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                          forUser:(FPUser *)user
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk;
+
+- (NSDictionary *)octaneAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                       forVehicle:(FPVehicle *)vehicle
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk;
+
+- (NSDictionary *)octaneAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                   forFuelstation:(FPFuelStation *)fuelstation
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk;
+
+- (FPLogAggregate *)aggregateOfOdometerLogMeasure:(FPOdometerLogMeasure)measure
+                                          forUser:(FPUser *)user
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk;
+
+- (FPLogAggregate *)aggregateOfOdometerLogMeasure:(FPOdometerLogMeasure)measure
+                                       forVehicle:(FPVehicle *)vehicle
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk;
+
+/**
+ Returns a [purchased at, days since the previous purchase] dataset, sorted by
+ date, over the vehicle's gas logs purchased within [onOrAfterDate,
+ beforeDate); the first log in the range has no datapoint.  Days are whole
+ calendar days in the given time zone.  Only the purchase dates are read.
+ */
+- (NSArray *)daysBetweenFillupsForVehicle:(FPVehicle *)vehicle
+                               beforeDate:(NSDate *)beforeDate
+                            onOrAfterDate:(NSDate *)onOrAfterDate
+                                 timeZone:(NSTimeZone *)timeZone
+                                    error:(PELMDaoErrorBlk)errorBlk;
+
+#pragma mark - Log Columns
+
+/**
+ Loads the entity's gas logs, sorted by purchase date, into columnar form with
+ a single query that reads only the columns the stats need.
+ */
+- (FPLogColumns *)gasLogColumnsForUser:(FPUser *)user error:(PELMDaoErrorBlk)errorBlk;
+
+- (FPLogColumns *)gasLogColumnsForVehicle:(FPVehicle *)vehicle error:(PELMDaoErrorBlk)errorBlk;
+
+- (FPLogColumns *)gasLogColumnsForFuelstation:(FPFuelStation *)fuelstation error:(PELMDaoErrorBlk)errorBlk;
+
+#pragma mark - Monthly Rollups
+
+/**
+ The monthly rollups are keyed by month key (year * 12 + month, per the current
+ calendar).  Every month that intersects [onOrAfterDate, beforeDate) is
+ aggregated in full; nil dates are unbounded.  Min and max are only rolled up
+ for odometer readings.
+ */
+- (NSDictionary *)monthlyAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                           forUser:(FPUser *)user
+                                        beforeDate:(NSDate *)beforeDate
+                                     onOrAfterDate:(NSDate *)onOrAfterDate
+                                            octane:(NSNumber *)octane
+                                            diesel:(BOOL)diesel
+                                             error:(PELMDaoErrorBlk)errorBlk;
+
+- (NSDictionary *)monthlyAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                        forVehicle:(FPVehicle *)vehicle
+                                        beforeDate:(NSDate *)beforeDate
+                                     onOrAfterDate:(NSDate *)onOrAfterDate
+                                            octane:(NSNumber *)octane
+                                            diesel:(BOOL)diesel
+                                             error:(PELMDaoErrorBlk)errorBlk;
+
+- (NSDictionary *)monthlyAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                    forFuelstation:(FPFuelStation *)fuelstation
+                                        beforeDate:(NSDate *)beforeDate
+                                     onOrAfterDate:(NSDate *)onOrAfterDate
+                                            octane:(NSNumber *)octane
+                                            diesel:(BOOL)diesel
+                                             error:(PELMDaoErrorBlk)errorBlk;
+
+/**
+ The monthly rollups for every octane (and for diesel) at once: octane (see
+ FPOctaneKeyDiesel) -> month key -> aggregate.
+ */
+- (NSDictionary *)octaneMonthlyAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                                 forUser:(FPUser *)user
+                                              beforeDate:(NSDate *)beforeDate
+                                           onOrAfterDate:(NSDate *)onOrAfterDate
+                                                   error:(PELMDaoErrorBlk)errorBlk;
+
+- (NSDictionary *)octaneMonthlyAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                              forVehicle:(FPVehicle *)vehicle
+                                              beforeDate:(NSDate *)beforeDate
+                                           onOrAfterDate:(NSDate *)onOrAfterDate
+                                                   error:(PELMDaoErrorBlk)errorBlk;
+
+- (NSDictionary *)octaneMonthlyAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                          forFuelstation:(FPFuelStation *)fuelstation
+                                              beforeDate:(NSDate *)beforeDate
+                                           onOrAfterDate:(NSDate *)onOrAfterDate
+                                                   error:(PELMDaoErrorBlk)errorBlk;
+
+- (NSDictionary *)monthlyAggregatesOfOdometerLogMeasure:(FPOdometerLogMeasure)measure
+                                             forVehicle:(FPVehicle *)vehicle
+                                             beforeDate:(NSDate *)beforeDate
+                                          onOrAfterDate:(NSDate *)onOrAfterDate
+                                                  error:(PELMDaoErrorBlk)errorBlk;
+
+/**
+ Rebuilds the monthly rollups from scratch.  Not normally needed: the rollups
+ record the calendar and time zone they're keyed by, and are rebuilt on their
+ own (when the time zone or locale changes, and at initializeDatabaseWithError:
+ for a change made while the app wasn't running) once those no longer match.
+ */
+- (void)rebuildMonthlyRollupsWithError:(PELMDaoErrorBlk)errorBlk;
+
+#pragma mark - Quantile Sketches
+
+/**
+ Each monthly rollup carries a quantile sketch (see FPQuantileSketch) of the
+ month's gallon prices (and of its reported avg MPGs), kept current along with
+ the rest of the rollup.  These merge the month sketches of every month that
+ intersects [onOrAfterDate, beforeDate), so a percentile costs the size of a
+ sketch per month rather than a sort of the logs.  nil dates are unbounded.
+ The returned sketch is empty if there are no values in range.
+ */
+- (FPQuantileSketch *)gallonPriceSketchForUser:(FPUser *)user
+                                    beforeDate:(NSDate *)beforeDate
+                                 onOrAfterDate:(NSDate *)onOrAfterDate
+                                        octane:(NSNumber *)octane
+                                        diesel:(BOOL)diesel
+                                         error:(PELMDaoErrorBlk)errorBlk;
+
+- (FPQuantileSketch *)gallonPriceSketchForVehicle:(FPVehicle *)vehicle
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                           octane:(NSNumber *)octane
+                                           diesel:(BOOL)diesel
+                                            error:(PELMDaoErrorBlk)errorBlk;
+
+- (FPQuantileSketch *)gallonPriceSketchForFuelstation:(FPFuelStation *)fuelstation
+                                           beforeDate:(NSDate *)beforeDate
+                                        onOrAfterDate:(NSDate *)onOrAfterDate
+                                               octane:(NSNumber *)octane
+                                               diesel:(BOOL)diesel
+                                                error:(PELMDaoErrorBlk)errorBlk;
+
+- (FPQuantileSketch *)reportedAvgMpgSketchForUser:(FPUser *)user
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk;
+
+- (FPQuantileSketch *)reportedAvgMpgSketchForVehicle:(FPVehicle *)vehicle
+                                          beforeDate:(NSDate *)beforeDate
+                                       onOrAfterDate:(NSDate *)onOrAfterDate
+                                               error:(PELMDaoErrorBlk)errorBlk;
+
+#pragma mark - Data Version
+
+/**
+ A counter that moves whenever the store's data changes: after every committed
+ local save or delete, changelog apply and deep save.  Equal versions mean any
+ stats computed from the logs are still current.  Reading it doesn't touch the
+ database, so it's cheap to check on every stats lookup.
+ */
+- (int64_t)dataVersion;
+
+#pragma mark - Statement Count
+
+/**
+ The number of SQL statements run so far against the database, across the
+ write queue and the read pool.  Only differences between two readings mean
+ anything (e.g., the number of queries a stats computation issues).
+ */
+- (int64_t)numStatementsExecuted;
+
+/**
+ Of the statements run so far, the number that ran a prepared statement taken
+ from their connection's statement cache, and the number that had to be
+ prepared first (the first run of their SQL on the connection, or a run while
+ the cached statement for it was still in use).  Like numStatementsExecuted,
+ only differences between readings mean anything.
+ */
+- (int64_t)numStatementCacheHits;
+
+- (int64_t)numStatementCacheMisses;
+
+/**
+ When set, called with the SQL of each statement run (its parameters left as
+ placeholders), on the thread that ran it; for tests and diagnostics (e.g.,
+ collecting the queries to check their plans).
+ */
+@property (atomic, copy) void (^statementObserver)(NSString *sql);
+
 @end
@@ -9,9 +9,12 @@
 @import CoreLocation;
 
 #import <FMDB/FMDatabaseQueue.h>
+#import <FMDB/FMDatabasePool.h>
 #import <FMDB/FMDatabaseAdditions.h>
 #import <FMDB/FMDatabase.h>
 #import <FMDB/FMResultSet.h>
+#import <libkern/OSAtomic.h>
+#import <objc/runtime.h>
 #import <CocoaLumberjack/DDLog.h>
 #import <PEObjc-Commons/PEUtils.h>
 #import <PEObjc-Commons/NSString+PEAdditions.h>
@@ -32,13 +35,142 @@
 #import "FPEnvironmentLog.h"
 #import "FPFuelPurchaseLog.h"
 #import "FPLogging.h"
+#import "FPLogAggregate.h"
+#import "FPMonthBoundaries.h"
+#import "FPLogColumns.h"
+#import "FPFixedPoint.h"
+#import "FPQuantileSketch.h"
 
 typedef void(^FPAddColumnBlk)(NSString *, NSString *, NSString *);
 
-uint32_t const FP_REQUIRED_SCHEMA_VERSION = 4;
+typedef NSString *(^FPWhereBlk)(NSString *);
+
+/*
+ Formats whereBlk's clause for the master and main tables' column prefixes once,
+ and returns a where-template that hands back those same strings, rather than
+ rebuilding them with stringWithFormat: on every query.  Any other prefix is
+ formatted on the call.
+ */
+static FPWhereBlk FPWhereTemplate(FPWhereBlk whereBlk) {
+  NSString *masterWhere = whereBlk(@"mstr.");
+  NSString *mainWhere = whereBlk(@"man.");
+  return ^(NSString *colPrefix) {
+    if ([colPrefix isEqualToString:@"mstr."]) {
+      return masterWhere;
+    } else if ([colPrefix isEqualToString:@"man."]) {
+      return mainWhere;
+    }
+    return whereBlk(colPrefix);
+  };
+}
+
+/*
+ The where-templates made by templateBlk for each comparison operator, keyed by
+ the operator.
+ */
+static NSDictionary *FPWhereTemplatesByCompareDirection(FPWhereBlk (^templateBlk)(NSString *)) {
+  NSMutableDictionary *whereBlks = [NSMutableDictionary dictionary];
+  for (NSString *direction in @[@"<", @"<=", @">", @">="]) {
+    whereBlks[direction] = templateBlk(direction);
+  }
+  return whereBlks;
+}
+
+uint32_t const FP_REQUIRED_SCHEMA_VERSION = 9;
+
+static NSInteger const FP_ROLLUP_SRC_MASTER = 0;
+static NSInteger const FP_ROLLUP_SRC_MAIN = 1;
+static NSInteger const FP_ROLLUP_FUEL_KEY_UNSPECIFIED = -2;
+
+/* Which table (FP_ROLLUP_SRC_MASTER or _MAIN) an effective entity's row is from. */
+static NSString * const FP_EFFECTIVE_SRC = @"effective_src";
+
+/* At most this many threads read through the read pool at once. */
+static long const FP_MAX_READ_CONNECTIONS = 4;
+
+/*
+ The most host parameters a statement may have (SQLite's default
+ SQLITE_MAX_VARIABLE_NUMBER); a multi-row insert carries as many rows as fit.
+ */
+static NSUInteger const FP_MAX_STATEMENT_ARGS = 999;
+
+/*
+ A bulk insert of at least this many rows into an empty table drops the table's
+ secondary indexes first, and builds them once the rows are in.
+ */
+static NSUInteger const FP_BULK_INSERT_DEFER_INDEXES_MIN_ROWS = 1000;
+
+static NSString * const FPReadSlotThreadKey = @"FPLocalDaoImpl.readSlot";
+
+/*
+ The write-ahead log size (in pages) past which a commit checkpoints it: SQLite's
+ own default, which FPWalDidCommit takes over.
+ */
+static int const FP_WAL_AUTOCHECKPOINT_PAGES = 1000;
+
+@class FPLocalDaoImpl;
+
+/*
+ The DAO's bookkeeping for one of its connections: per SQL, the number of the
+ statements in the connection's statement cache that have been counted as
+ prepared.  Only touched by the thread the connection is running on; it's
+ attached to the connection's FMDatabase, and so goes away with it.
+ */
+@interface FPConnectionStatements : NSObject
+@property (nonatomic, weak) FPLocalDaoImpl *dao;
+@property (nonatomic, weak) FMDatabase *db;
+@property (nonatomic, readonly) NSMutableDictionary *numPreparedBySql;
+@end
+
+@implementation FPConnectionStatements
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _numPreparedBySql = [NSMutableDictionary dictionary];
+  }
+  return self;
+}
+@end
+
+static char FPConnectionStatementsKey;
+
+@interface FPLocalDaoImpl ()
+- (void)statementDidRun:(const char *)sql onConnection:(FPConnectionStatements *)connection;
+- (void)dataDidCommit;
+@end
+
+/*
+ SQLite calls this as each statement finishes running; ctx is the connection's
+ FPConnectionStatements.
+ */
+static void FPProfileStatement(void *ctx, const char *sql, sqlite3_uint64 nanos) {
+  FPConnectionStatements *connection = (__bridge FPConnectionStatements *)ctx;
+  [connection.dao statementDidRun:sql onConnection:connection];
+}
+
+/*
+ SQLite calls this on databaseQueue's connection once each write transaction
+ has committed; ctx is the DAO.  Registering it replaces SQLite's automatic
+ checkpointing of the write-ahead log, so it checkpoints the same way.
+ */
+static int FPWalDidCommit(void *ctx, sqlite3 *db, const char *dbName, int numPages) {
+  FPLocalDaoImpl *dao = (__bridge FPLocalDaoImpl *)ctx;
+  [dao dataDidCommit];
+  if (numPages >= FP_WAL_AUTOCHECKPOINT_PAGES) {
+    sqlite3_wal_checkpoint_v2(db, dbName, SQLITE_CHECKPOINT_PASSIVE, NULL, NULL);
+  }
+  return SQLITE_OK;
+}
 
 @implementation FPLocalDaoImpl {
   NSArray *_fuelstationTypeJoinTables;
+  volatile int64_t _dataVersion;
+  FMDatabasePool *_readPool;
+  dispatch_semaphore_t _readSlots;
+  volatile int64_t _numStatementsExecuted;
+  volatile int64_t _numStatementCacheHits;
+  volatile int64_t _numStatementCacheMisses;
+  NSCache *_tableColumns;
 }
 
 #pragma mark - Initializers
@@ -48,10 +180,91 @@ uint32_t const FP_REQUIRED_SCHEMA_VERSION = 4;
                          concreteUserClass:[FPUser class]];
   if (self) {
     _fuelstationTypeJoinTables = @[@[@"typ", TBL_FUEL_STATION_TYPE, COL_FUELST_TYPE_ID, COL_FUELSTTYP_ID]];
+    _tableColumns = [[NSCache alloc] init];
+    _readPool = [FMDatabasePool databasePoolWithPath:sqliteDataFilePath flags:SQLITE_OPEN_READONLY];
+    _readPool.delegate = self;
+    _readSlots = dispatch_semaphore_create(FP_MAX_READ_CONNECTIONS);
+    [self.databaseQueue inDatabase:^(FMDatabase *db) {
+      // with a write-ahead log, the read pool's connections read the last
+      // committed state while databaseQueue writes, rather than waiting on it
+      // (and it on them); the mode sticks to the database file
+      FMResultSet *rs = [db executeQuery:@"PRAGMA journal_mode = WAL"];
+      if ([rs next]) {
+        DDLogDebug(@"in FPLocalDao/initWithSqliteDataFilePath:, journal mode: %@", [rs stringForColumnIndex:0]);
+      }
+      [rs close];
+      [self countStatementsOfDb:db];
+      sqlite3_wal_hook([db sqliteHandle], FPWalDidCommit, (__bridge void *)self);
+    }];
+    NSNotificationCenter *notificationCenter = [NSNotificationCenter defaultCenter];
+    [notificationCenter addObserver:self
+                           selector:@selector(monthBoundariesMayHaveMoved:)
+                               name:NSSystemTimeZoneDidChangeNotification
+                             object:nil];
+    [notificationCenter addObserver:self
+                           selector:@selector(monthBoundariesMayHaveMoved:)
+                               name:NSCurrentLocaleDidChangeNotification
+                             object:nil];
   }
   return self;
 }
 
+- (void)dealloc {
+  [[NSNotificationCenter defaultCenter] removeObserver:self];
+}
+
+/*
+ The stats reads only read the rollups, so a move of the month boundaries has
+ to be caught here rather than by them: the refresh finds the rollups' calendar
+ no longer current and rebuilds them.  It's done off the posting thread (the
+ main one, normally), as a rebuild goes through every log and first waits out
+ any write already on databaseQueue; its commit bumps the data version, which
+ is what drops the stats' memos of the old rollups.
+ */
+- (void)monthBoundariesMayHaveMoved:(NSNotification *)notification {
+  dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_BACKGROUND, 0), ^{
+    [self.databaseQueue inTransaction:^(FMDatabase *db, BOOL *rollback) {
+      [self refreshMonthlyRollupsWithDb:db error:^(NSError *error, int code, NSString *desc) {
+        DDLogDebug(@"in FPLocalDao/monthBoundariesMayHaveMoved:, rollup rebuild failed: %@", desc);
+      }];
+    }];
+  });
+}
+
+#pragma mark - Read Pool
+
+/*
+ Read-only connections for every DAO method that only reads (entity and log
+ fetches, counts, the stats queries, exports); they never write, so, the
+ database being in WAL mode, they run alongside each other and alongside
+ databaseQueue instead of queuing up behind its writes (a changelog apply, a
+ deep save).  databaseQueue is left to the writes, and to the reads that must
+ see a write of their own first.
+
+ At most FP_MAX_READ_CONNECTIONS threads hold a connection at once; others
+ wait for one to come free.  A read nested in another on the same thread
+ doesn't wait on a slot of its own (it would deadlock once every slot was held
+ by such an outer read).
+ */
+- (void)inReadDatabase:(void (^)(FMDatabase *db))block {
+  NSMutableDictionary *threadDictionary = [[NSThread currentThread] threadDictionary];
+  BOOL holdsSlot = threadDictionary[FPReadSlotThreadKey] != nil;
+  if (!holdsSlot) {
+    dispatch_semaphore_wait(_readSlots, DISPATCH_TIME_FOREVER);
+    threadDictionary[FPReadSlotThreadKey] = @YES;
+  }
+  [_readPool inDatabase:block];
+  if (!holdsSlot) {
+    [threadDictionary removeObjectForKey:FPReadSlotThreadKey];
+    dispatch_semaphore_signal(_readSlots);
+  }
+}
+
+// FMDatabasePool delegate
+- (void)databasePool:(FMDatabasePool *)pool didAddDatabase:(FMDatabase *)database {
+  [self countStatementsOfDb:database];
+}
+
 #pragma mark - Schema Helpers
 
 - (FPAddColumnBlk)makeAddColumnBlkWithDb:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk {
@@ -83,16 +296,213 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
       case 3:
         [self applyVersion3SchemaEditsWithDb:db error:errorBlk];
         DDLogDebug(@"in FPLocalDao/initializeDatabaseWithError:, applied schema updates for version 3.");
+      case 4:
+        [self applyVersion4SchemaEditsWithDb:db error:errorBlk];
+        DDLogDebug(@"in FPLocalDao/initializeDatabaseWithError:, applied schema updates for version 4.");
+      case 5:
+        [self applyVersion5SchemaEditsWithDb:db error:errorBlk];
+        DDLogDebug(@"in FPLocalDao/initializeDatabaseWithError:, applied schema updates for version 5.");
+      case 6:
+        [self applyVersion6SchemaEditsWithDb:db error:errorBlk];
+        DDLogDebug(@"in FPLocalDao/initializeDatabaseWithError:, applied schema updates for version 6.");
+      case 7:
+        [self applyVersion7SchemaEditsWithDb:db error:errorBlk];
+        DDLogDebug(@"in FPLocalDao/initializeDatabaseWithError:, applied schema updates for version 7.");
+      case 8:
+        [self applyVersion8SchemaEditsWithDb:db error:errorBlk];
+        DDLogDebug(@"in FPLocalDao/initializeDatabaseWithError:, applied schema updates for version 8.");
       case FP_REQUIRED_SCHEMA_VERSION:
         // great, nothing needed to do except update the db's schema version
         [db setUserVersion:FP_REQUIRED_SCHEMA_VERSION];
         break;
     }
+    // settles months left dirty by a write that didn't get to refresh them, and
+    // rebuilds the rollups if the month boundaries moved since they were keyed
+    // (or no boundaries were ever recorded for them)
+    [self refreshMonthlyRollupsWithDb:db error:errorBlk];
   }];
+  [_tableColumns removeAllObjects];
 }
 
 #pragma mark - Schema version: FUTURE VERSION
 
+#pragma mark - Schema version: version 8
+
+- (void)applyVersion8SchemaEditsWithDb:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk {
+  // Gallons and prices are now rounded to FPEntryScale decimal places as they're
+  // saved (see FPDecimalNumberRoundedToEntryScale); bring the logs saved before
+  // in line.  The rollup triggers mark the months of the logs changed dirty, and
+  // the refresh at the end of initializeDatabaseWithError: recomputes them.
+  for (NSString *table in @[TBL_MASTER_FUELPURCHASE_LOG, TBL_MAIN_FUELPURCHASE_LOG]) {
+    for (NSString *column in @[COL_FUELPL_NUM_GALLONS, COL_FUELPL_PRICE_PER_GALLON]) {
+      [PELMUtils doUpdate:[NSString stringWithFormat:@"UPDATE %@ SET %@ = ROUND(%@, %d) WHERE %@ <> ROUND(%@, %d)",
+                           table, column, column, FPEntryScale, column, column, FPEntryScale]
+                       db:db
+                    error:errorBlk];
+    }
+  }
+}
+
+#pragma mark - Schema version: version 7
+
+- (void)applyVersion7SchemaEditsWithDb:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk {
+  // The calendar (and time zone) the rollups' month keys were computed under.
+  // It starts out empty, so the refresh at the end of initializeDatabaseWithError:
+  // rebuilds the rollups once and records it.
+  [PELMUtils doUpdate:[FPDDLUtils monthlyRollupCalendarDDL] db:db error:errorBlk];
+}
+
+#pragma mark - Schema version: version 6
+
+- (void)applyVersion6SchemaEditsWithDb:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk {
+  void (^makeIndex)(NSString *, NSArray *, NSString *) = ^(NSString *entity, NSArray *cols, NSString *name) {
+    [PELMUtils doUpdate:[PELMDDL indexDDLForEntity:entity unique:NO columns:cols indexName:name] db:db error:errorBlk];
+  };
+  // The log queries all filter by a parent (user, vehicle or fuel station) and,
+  // mostly, a date range; the single-column date and octane indexes of version
+  // 0 leave SQLite choosing between them and scanning for the parent.  The
+  // vehicle and fuel station indexes also carry every column the stats read
+  // (the global ID included, for the master half's shadowing filter), so the
+  // per-vehicle scans never touch the tables themselves.
+  NSArray *fplogCoveredCols = @[COL_FUELPL_PURCHASED_AT,
+                                COL_FUELPL_OCTANE,
+                                COL_FUELPL_IS_DIESEL,
+                                COL_FUELPL_NUM_GALLONS,
+                                COL_FUELPL_PRICE_PER_GALLON,
+                                COL_FUELPL_ODOMETER,
+                                COL_GLOBAL_ID];
+  NSArray *envlogCoveredCols = @[COL_ENVL_LOG_DT,
+                                 COL_ENVL_ODOMETER_READING,
+                                 COL_ENVL_MPG_READING,
+                                 COL_ENVL_MPH_READING,
+                                 COL_ENVL_OUTSIDE_TEMP_READING,
+                                 COL_GLOBAL_ID];
+  // [table, user column, vehicle column, fuel station column (or NSNull), index name prefix]
+  NSArray *logTables = @[@[TBL_MASTER_FUELPURCHASE_LOG, COL_MASTER_USER_ID, COL_MASTER_VEHICLE_ID, COL_MASTER_FUELSTATION_ID, @"idx_mstr_fplog"],
+                         @[TBL_MAIN_FUELPURCHASE_LOG, COL_MAIN_USER_ID, COL_MAIN_VEHICLE_ID, COL_MAIN_FUELSTATION_ID, @"idx_man_fplog"],
+                         @[TBL_MASTER_ENV_LOG, COL_MASTER_USER_ID, COL_MASTER_VEHICLE_ID, [NSNull null], @"idx_mstr_envlog"],
+                         @[TBL_MAIN_ENV_LOG, COL_MAIN_USER_ID, COL_MAIN_VEHICLE_ID, [NSNull null], @"idx_man_envlog"]];
+  for (NSArray *logTable in logTables) {
+    BOOL isGasLogTable = logTable[3] != [NSNull null];
+    NSString *dateCol = isGasLogTable ? COL_FUELPL_PURCHASED_AT : COL_ENVL_LOG_DT;
+    NSArray *coveredCols = isGasLogTable ? fplogCoveredCols : envlogCoveredCols;
+    makeIndex(logTable[0], @[logTable[1], dateCol], [NSString stringWithFormat:@"%@_usr_dt", logTable[4]]);
+    makeIndex(logTable[0], [@[logTable[2]] arrayByAddingObjectsFromArray:coveredCols], [NSString stringWithFormat:@"%@_veh_dt", logTable[4]]);
+    if (isGasLogTable) {
+      makeIndex(logTable[0], [@[logTable[3]] arrayByAddingObjectsFromArray:coveredCols], [NSString stringWithFormat:@"%@_fs_dt", logTable[4]]);
+      // the min / max gallon price lookups: ORDER BY price LIMIT 1 within a
+      // parent's logs of an octane (or of diesel, whose octane is null)
+      for (NSArray *parent in @[@[logTable[1], @"usr"], @[logTable[2], @"veh"], @[logTable[3], @"fs"]]) {
+        makeIndex(logTable[0],
+                  @[parent[0], COL_FUELPL_OCTANE, COL_FUELPL_PRICE_PER_GALLON],
+                  [NSString stringWithFormat:@"%@_%@_price", logTable[4], parent[1]]);
+      }
+    }
+  }
+}
+
+#pragma mark - Schema version: version 5
+
+- (void)applyVersion5SchemaEditsWithDb:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk {
+  FPAddColumnBlk addColumn = [self makeAddColumnBlkWithDb:db error:errorBlk];
+  addColumn(@"BLOB", TBL_VEHICLE_GAS_MONTHLY_ROLLUP, COL_ROLLUP_PRICE_SKETCH);
+  addColumn(@"BLOB", TBL_FUELSTATION_GAS_MONTHLY_ROLLUP, COL_ROLLUP_PRICE_SKETCH);
+  addColumn(@"BLOB", TBL_VEHICLE_ODOMETER_MONTHLY_ROLLUP, COL_ROLLUP_MPG_SKETCH);
+
+  // the rollups (sketches included) are backfilled from the logs already on the
+  // device once the version 7 edits are in (see applyVersion7SchemaEditsWithDb:error:)
+}
+
+#pragma mark - Schema version: version 4
+
+- (void)applyVersion4SchemaEditsWithDb:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk {
+  void (^applyDDL)(NSString *) = ^ (NSString *ddl) {
+    [PELMUtils doUpdate:ddl db:db error:errorBlk];
+  };
+  applyDDL([FPDDLUtils gasMonthlyRollupDDLForTable:TBL_VEHICLE_GAS_MONTHLY_ROLLUP]);
+  applyDDL([FPDDLUtils gasMonthlyRollupDDLForTable:TBL_FUELSTATION_GAS_MONTHLY_ROLLUP]);
+  applyDDL([FPDDLUtils vehicleOdometerMonthlyRollupDDL]);
+  applyDDL([FPDDLUtils monthlyRollupDirtyDDL]);
+
+  // The triggers only record which (rollup, parent, log date) tuples were
+  // touched; the affected months are recomputed by refreshMonthlyRollupsWithDb:error:.
+  // Because master rows are shadowed by their main-table copies, a change to a
+  // main row also dirties the month of the master row it shadows.
+  NSString *(^markDirty)(NSArray *, NSString *) = ^(NSArray *source, NSString *row) {
+    return [NSString stringWithFormat:@"INSERT OR IGNORE INTO %@ (%@, %@, %@, %@) \
+SELECT '%@', %@, %@.%@, %@.%@ WHERE %@.%@ IS NOT NULL AND %@.%@ IS NOT NULL;",
+            TBL_MONTHLY_ROLLUP_DIRTY,
+            COL_ROLLUP_DIRTY_TABLE,
+            COL_ROLLUP_SRC,
+            COL_ROLLUP_PARENT_ID,
+            COL_ROLLUP_DIRTY_LOG_DT,
+            source[0], source[1], row, source[3], row, source[4],
+            row, source[3], row, source[4]];
+  };
+  NSString *(^markShadowedDirty)(NSArray *, NSString *) = ^(NSArray *masterSource, NSString *row) {
+    return [NSString stringWithFormat:@"INSERT OR IGNORE INTO %@ (%@, %@, %@, %@) \
+SELECT '%@', %@, mstr.%@, mstr.%@ FROM %@ mstr WHERE mstr.%@ = %@.%@ AND mstr.%@ IS NOT NULL AND mstr.%@ IS NOT NULL;",
+            TBL_MONTHLY_ROLLUP_DIRTY,
+            COL_ROLLUP_DIRTY_TABLE,
+            COL_ROLLUP_SRC,
+            COL_ROLLUP_PARENT_ID,
+            COL_ROLLUP_DIRTY_LOG_DT,
+            masterSource[0], masterSource[1], masterSource[3], masterSource[4], masterSource[2],
+            COL_GLOBAL_ID, row, COL_GLOBAL_ID,
+            masterSource[3], masterSource[4]];
+  };
+  NSArray *sources = [self monthlyRollupSources];
+  NSDictionary *watchedColumns = @{TBL_MASTER_FUELPURCHASE_LOG : @[COL_MASTER_VEHICLE_ID, COL_MASTER_FUELSTATION_ID],
+                                   TBL_MAIN_FUELPURCHASE_LOG   : @[COL_MAIN_VEHICLE_ID, COL_MAIN_FUELSTATION_ID],
+                                   TBL_MASTER_ENV_LOG          : @[COL_MASTER_VEHICLE_ID],
+                                   TBL_MAIN_ENV_LOG            : @[COL_MAIN_VEHICLE_ID]};
+  NSArray *fplogValueColumns = @[COL_GLOBAL_ID,
+                                 COL_FUELPL_PURCHASED_AT,
+                                 COL_FUELPL_NUM_GALLONS,
+                                 COL_FUELPL_PRICE_PER_GALLON,
+                                 COL_FUELPL_OCTANE,
+                                 COL_FUELPL_IS_DIESEL,
+                                 COL_FUELPL_ODOMETER];
+  NSArray *envlogValueColumns = @[COL_GLOBAL_ID,
+                                  COL_ENVL_LOG_DT,
+                                  COL_ENVL_ODOMETER_READING,
+                                  COL_ENVL_MPG_READING,
+                                  COL_ENVL_MPH_READING,
+                                  COL_ENVL_OUTSIDE_TEMP_READING];
+  void (^makeTriggers)(NSString *, NSArray *) = ^(NSString *logTable, NSArray *valueColumns) {
+    NSString *(^triggerBody)(NSString *) = ^(NSString *row) {
+      NSMutableString *body = [NSMutableString string];
+      for (NSArray *source in sources) {
+        if ([source[2] isEqualToString:logTable]) {
+          [body appendString:markDirty(source, row)];
+          if (source[5] == [NSNull null]) { // main-table source
+            for (NSArray *masterSource in sources) {
+              if ([masterSource[0] isEqualToString:source[0]] && [masterSource[5] isEqual:logTable]) {
+                [body appendString:markShadowedDirty(masterSource, row)];
+              }
+            }
+          }
+        }
+      }
+      return body;
+    };
+    NSArray *updateOfColumns = [watchedColumns[logTable] arrayByAddingObjectsFromArray:valueColumns];
+    applyDDL([NSString stringWithFormat:@"CREATE TRIGGER IF NOT EXISTS trg_%@_ins_rollup AFTER INSERT ON %@ BEGIN %@ END",
+              logTable, logTable, triggerBody(@"NEW")]);
+    applyDDL([NSString stringWithFormat:@"CREATE TRIGGER IF NOT EXISTS trg_%@_upd_rollup AFTER UPDATE OF %@ ON %@ BEGIN %@%@ END",
+              logTable, [updateOfColumns componentsJoinedByString:@", "], logTable, triggerBody(@"OLD"), triggerBody(@"NEW")]);
+    applyDDL([NSString stringWithFormat:@"CREATE TRIGGER IF NOT EXISTS trg_%@_del_rollup AFTER DELETE ON %@ BEGIN %@ END",
+              logTable, logTable, triggerBody(@"OLD")]);
+  };
+  makeTriggers(TBL_MASTER_FUELPURCHASE_LOG, fplogValueColumns);
+  makeTriggers(TBL_MAIN_FUELPURCHASE_LOG, fplogValueColumns);
+  makeTriggers(TBL_MASTER_ENV_LOG, envlogValueColumns);
+  makeTriggers(TBL_MAIN_ENV_LOG, envlogValueColumns);
+
+  // the backfill from the logs already on the device is done once the version 7
+  // edits (which always follow these) are in, the rollup tables being complete
+}
+
 #pragma mark - Schema version: version 3
 
 - (void)applyVersion3SchemaEditsWithDb:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk {
@@ -296,7 +706,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
     }
     return val;
   };
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     // First export the vehicles
     NSArray *records = [self vehiclesForUser:user db:db error:errorBlk];
     CHCSVWriter *csvWriter = [[CHCSVWriter alloc] initForWritingToCSVFile:vehiclesPath];
@@ -432,6 +842,10 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (PEUserDbOpBlk)postDeepSaveUserHook {
   return ^(PELMUser *user, FMDatabase *db, PELMDaoErrorBlk errorBlk) {
     FPUser *fpuser = (FPUser *)user;
+    // the logs' vehicles and fuel stations are resolved through these (global
+    // ID -> local master ID) rather than looked up log by log
+    NSMutableDictionary *vehicleIds = [NSMutableDictionary dictionary];
+    NSMutableDictionary *fuelStationIds = [NSMutableDictionary dictionary];
     NSArray *vehicles = [fpuser vehicles];
     if (vehicles) {
       for (FPVehicle *vehicle in vehicles) {
@@ -439,6 +853,9 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                          forUser:fpuser
                                               db:db
                                            error:errorBlk];
+        if ([vehicle globalIdentifier] && [vehicle localMasterIdentifier]) {
+          vehicleIds[[vehicle globalIdentifier]] = [vehicle localMasterIdentifier];
+        }
       }
     }
     NSArray *fuelStations = [fpuser fuelStations];
@@ -448,26 +865,29 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                              forUser:fpuser
                                                   db:db
                                                error:errorBlk];
+        if ([fuelStation globalIdentifier] && [fuelStation localMasterIdentifier]) {
+          fuelStationIds[[fuelStation globalIdentifier]] = [fuelStation localMasterIdentifier];
+        }
       }
     }
     NSArray *fpLogs = [fpuser fuelPurchaseLogs];
     if (fpLogs) {
-      for (FPFuelPurchaseLog *fpLog in fpLogs) {
-        [self persistDeepFuelPurchaseLogFromRemoteMaster:fpLog
-                                                 forUser:fpuser
-                                                      db:db
-                                                   error:errorBlk];
-      }
+      [self bulkPersistDeepFuelPurchaseLogsFromRemoteMaster:fpLogs
+                                                    forUser:fpuser
+                                                 vehicleIds:vehicleIds
+                                             fuelStationIds:fuelStationIds
+                                                         db:db
+                                                      error:errorBlk];
     }
     NSArray *envLogs = [fpuser environmentLogs];
     if (envLogs) {
-      for (FPEnvironmentLog *envLog in envLogs) {
-        [self persistDeepEnvironmentLogFromRemoteMaster:envLog
-                                                forUser:fpuser
-                                                     db:db
-                                                  error:errorBlk];
-      }
+      [self bulkPersistDeepEnvironmentLogsFromRemoteMaster:envLogs
+                                                   forUser:fpuser
+                                                vehicleIds:vehicleIds
+                                                        db:db
+                                                     error:errorBlk];
     }
+    [self refreshMonthlyRollupsWithDb:db error:errorBlk];
   };
 }
 
@@ -492,12 +912,14 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                             TBL_MASTER_FUELPURCHASE_LOG,
                             TBL_MAIN_FUELPURCHASE_LOG,
                             ^(FPFuelPurchaseLog *fplog) { [self deleteFuelPurchaseLog:fplog db:db error:errorBlk]; },
-                            ^(FPFuelPurchaseLog *fplog) { return [self saveNewOrExistingMasterFuelPurchaseLog:fplog forUser:fpuser db:db error:errorBlk]; });},
+                            ^(FPFuelPurchaseLog *fplog) { return [self saveNewOrExistingMasterFuelPurchaseLog:fplog forUser:fpuser db:db error:errorBlk]; });
+              [self refreshMonthlyRollupsWithDb:db error:errorBlk];},
             ^{processingBlk([fpchangelog environmentLogs],
                             TBL_MASTER_ENV_LOG,
                             TBL_MAIN_ENV_LOG,
                             ^(FPEnvironmentLog *envlog) { [self deleteEnvironmentLog:envlog db:db error:errorBlk]; },
-                            ^(FPEnvironmentLog *envlog) { return [self saveNewOrExistingMasterEnvironmentLog:envlog forUser:fpuser db:db error:errorBlk]; });}];
+                            ^(FPEnvironmentLog *envlog) { return [self saveNewOrExistingMasterEnvironmentLog:envlog forUser:fpuser db:db error:errorBlk]; });
+              [self refreshMonthlyRollupsWithDb:db error:errorBlk];}];
 }
 
 #pragma mark - Unsynced and Sync-Needed Counts
@@ -561,7 +983,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                              error:(PELMDaoErrorBlk)errorBlk {
   NSString *vehicleTable = TBL_MASTER_VEHICLE;
   __block FPVehicle *vehicle = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     vehicle = [PELMUtils entityFromQuery:[NSString stringWithFormat:@"SELECT * FROM %@ WHERE %@ = ?", vehicleTable, COL_LOCAL_ID]
                              entityTable:vehicleTable
                            localIdGetter:^NSNumber *(PELMModelSupport *entity) { return [entity localMasterIdentifier]; }
@@ -580,7 +1002,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPVehicle *)masterVehicleWithGlobalId:(NSString *)globalId
                                    error:(PELMDaoErrorBlk)errorBlk {
     __block FPVehicle *vehicle = nil;
-    [self.databaseQueue inDatabase:^(FMDatabase *db) {
+    [self inReadDatabase:^(FMDatabase *db) {
         vehicle = [self masterVehicleWithGlobalId:globalId db:db error:errorBlk];
     }];
     return vehicle;
@@ -643,7 +1065,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSInteger)numVehiclesForUser:(FPUser *)user
                           error:(PELMDaoErrorBlk)errorBlk {
   __block NSInteger numVehicles = 0;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     numVehicles = [PELMUtils numEntitiesForParentEntity:user
                                   parentEntityMainTable:TBL_MAIN_USER
                          addlJoinParentEntityMainTables:nil
@@ -663,7 +1085,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSArray *)vehiclesForUser:(FPUser *)user
                        error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *vehicles = @[];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     vehicles = [self vehiclesForUser:user db:db error:errorBlk];
   }];
   return vehicles;
@@ -671,7 +1093,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 
 - (NSArray *)dieselVehiclesForUser:(FPUser *)user error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *vehicles = @[];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     vehicles = [self dieselVehiclesForUser:user db:db error:errorBlk];
   }];
   return vehicles;
@@ -680,7 +1102,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSArray *)unsyncedVehiclesForUser:(FPUser *)user
                                error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *vehicles = @[];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     vehicles = [self unsyncedVehiclesForUser:user db:db error:errorBlk];
   }];
   return vehicles;
@@ -702,7 +1124,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                     entityMainTable:TBL_MAIN_VEHICLE
                            addlJoinEntityMainTables:nil
                        mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                                  comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPVehicle *)o1 name] compare:[(FPVehicle *)o2 name]];}
                                 orderByDomainColumn:COL_VEH_NAME
                        orderByDomainColumnDirection:@"ASC"
                                                  db:db
@@ -756,7 +1177,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                             entityMainTable:TBL_MAIN_VEHICLE
                    addlJoinEntityMainTables:nil
                mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                          comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPVehicle *)o1 name] compare:[(FPVehicle *)o2 name]];}
                         orderByDomainColumn:COL_VEH_NAME
                orderByDomainColumnDirection:@"ASC"
                                          db:db
@@ -766,7 +1186,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPUser *)userForVehicle:(FPVehicle *)vehicle
                      error:(PELMDaoErrorBlk)errorBlk {
   __block FPUser *user = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     user = [self userForVehicle:vehicle db:db error:errorBlk];
   }];
   return user;
@@ -1007,7 +1427,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 
 - (FPVehicle *)vehicleWithMostRecentLogForUser:(FPUser *)user error:(PELMDaoErrorBlk)errorBlk {
   __block FPVehicle *vehicle = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     FPFuelPurchaseLog *fplog = [self mostRecentFuelPurchaseLogForUser:user db:db error:errorBlk];
     FPEnvironmentLog *envlog = [self mostRecentEnvironmentLogForUser:user db:db error:errorBlk];
     if (fplog && ![PEUtils isNil:fplog.purchasedAt]) {
@@ -1045,7 +1465,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPFuelStation *)masterFuelstationWithId:(NSNumber *)fuelstationId error:(PELMDaoErrorBlk)errorBlk {
   NSString *fuelstationTable = TBL_MASTER_FUEL_STATION;
   __block FPFuelStation *fuelstation = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     NSMutableString *selectClause = [NSMutableString stringWithString:@"SELECT mstr.*"];
     NSMutableString *fromClause   = [NSMutableString stringWithFormat:@" FROM %@ mstr", fuelstationTable];
     NSMutableString *whereClause  = [NSMutableString stringWithFormat:@" WHERE mstr.%@ = ?", COL_LOCAL_ID];
@@ -1068,7 +1488,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 
 - (FPFuelStation *)masterFuelstationWithGlobalId:(NSString *)globalId error:(PELMDaoErrorBlk)errorBlk {
   __block FPFuelStation *fuelstation = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
       fuelstation = [self masterFuelstationWithGlobalId:globalId db:db error:errorBlk];
   }];
   return fuelstation;
@@ -1121,7 +1541,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSInteger)numFuelStationsForUser:(FPUser *)user
                               error:(PELMDaoErrorBlk)errorBlk {
   __block NSInteger numFuelStations = 0;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     numFuelStations = [PELMUtils numEntitiesForParentEntity:user
                                       parentEntityMainTable:TBL_MAIN_USER
                              addlJoinParentEntityMainTables:nil
@@ -1140,7 +1560,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 
 - (NSArray *)fuelStationsForUser:(FPUser *)user error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fuelStations = @[];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     fuelStations = [self fuelStationsForUser:user db:db error:errorBlk];
   }];
   return fuelStations;
@@ -1174,7 +1594,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSArray *)unsyncedFuelStationsForUser:(FPUser *)user
                                    error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fuelstations = @[];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     fuelstations = [self unsyncedFuelStationsForUser:user db:db error:errorBlk];
   }];
   return fuelstations;
@@ -1196,7 +1616,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                     entityMainTable:TBL_MAIN_FUEL_STATION
                            addlJoinEntityMainTables:_fuelstationTypeJoinTables
                        mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelStationFromResultSet:rs];}
-                                  comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelStation *)o1 name] compare:[(FPFuelStation *)o2 name]];}
                                 orderByDomainColumn:COL_FUELST_NAME
                        orderByDomainColumnDirection:@"ASC"
                                                  db:db
@@ -1233,7 +1652,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 
 - (FPUser *)userForFuelStation:(FPFuelStation *)fuelStation error:(PELMDaoErrorBlk)errorBlk {
   __block FPUser *user = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     user = [self userForFuelStation:fuelStation db:db error:errorBlk];
   }];
   return user;
@@ -1485,7 +1904,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPFuelStationType *)fuelstationTypeForIdentifier:(NSNumber *)identifier error:(PELMDaoErrorBlk)errorBlk {
   __block FPFuelStationType *fstype = nil;
   if (identifier) {
-    [self.databaseQueue inDatabase:^(FMDatabase *db) {
+    [self inReadDatabase:^(FMDatabase *db) {
       FMResultSet *rs = [PELMUtils doQuery:[NSString stringWithFormat:@"SELECT * FROM %@ WHERE %@ = ?", TBL_FUEL_STATION_TYPE, COL_FUELSTTYP_ID]
                                  argsArray:@[identifier]
                                         db:db
@@ -1501,7 +1920,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 
 - (NSArray *)fuelstationTypesWithError:(PELMDaoErrorBlk)errorBlk {
   NSMutableArray *fsTypes = [NSMutableArray array];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     FMResultSet *rs = [PELMUtils doQuery:[NSString stringWithFormat:@"SELECT * FROM %@ ORDER BY %@ ASC", TBL_FUEL_STATION_TYPE, COL_FUELSTTYP_SORT_ORDER]
                                argsArray:@[]
                                       db:db
@@ -1516,106 +1935,104 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 
 #pragma mark - Fuel Purchase Log
 
-- (NSArray *)distinctOctanesForLogsBlk:(NSArray *(^)(void))logsBlk {
-  NSArray *fplogs = logsBlk();
-  NSMutableDictionary *octanes = [NSMutableDictionary dictionary];
-  for (FPFuelPurchaseLog *fplog in fplogs) {
-    if (![PEUtils isNil:fplog.octane]) {
-      [octanes setObject:fplog.octane forKey:fplog.octane];
-    }
-  }
-  NSArray *distinctOctanes = [octanes allKeys];
-  return [distinctOctanes sortedArrayUsingComparator:^NSComparisonResult(NSNumber *obj1, NSNumber *obj2) {
-    return [obj1 compare:obj2];
-  }];
-}
-
 - (NSArray *)distinctOctanesForUser:(FPUser *)user
                               error:(PELMDaoErrorBlk)errorBlk {
-  return [self distinctOctanesForLogsBlk:^{return [self unorderedFuelPurchaseLogsForUser:user error:errorBlk];}];
+  return [self distinctOctanesForParentEntity:user
+                            parentMasterTable:TBL_MASTER_USER
+                              parentMainTable:TBL_MAIN_USER
+                   parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                     parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                        error:errorBlk];
 }
 
 - (BOOL)hasDieselLogsForUser:(FPUser *)user
                        error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:user
-                          parentEntityMainTable:TBL_MAIN_USER
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_USER_ID
-                       parentEntityMainIdColumn:COL_MAIN_USER_ID
-                                       pageSize:@(1)
-                                       whereBlk:[self fpLogDieselWhereBlk]
-                                      whereArgs:nil
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:user
+                                  parentMasterTable:TBL_MASTER_USER
+                                    parentMainTable:TBL_MAIN_USER
+                         parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                           parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDieselWhereBlk]
+                                          whereArgs:nil
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:@(1)
+                                                 db:db
+                                              error:errorBlk];
   }];
   return [fplogs count] >= 1;
 }
 
 - (NSArray *)distinctOctanesForVehicle:(FPVehicle *)vehicle
                                  error:(PELMDaoErrorBlk)errorBlk {
-  return [self distinctOctanesForLogsBlk:^{return [self unorderedFuelPurchaseLogsForVehicle:vehicle error:errorBlk];}];
+  return [self distinctOctanesForParentEntity:vehicle
+                            parentMasterTable:TBL_MASTER_VEHICLE
+                              parentMainTable:TBL_MAIN_VEHICLE
+                   parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                     parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                        error:errorBlk];
 }
 
 - (BOOL)hasDieselLogsForVehicle:(FPVehicle *)vehicle
                           error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:vehicle
-                          parentEntityMainTable:TBL_MAIN_VEHICLE
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                       parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                       pageSize:@(1)
-                                       whereBlk:[self fpLogDieselWhereBlk]
-                                      whereArgs:nil
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:vehicle
+                                  parentMasterTable:TBL_MASTER_VEHICLE
+                                    parentMainTable:TBL_MAIN_VEHICLE
+                         parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                           parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDieselWhereBlk]
+                                          whereArgs:nil
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:@(1)
+                                                 db:db
+                                              error:errorBlk];
   }];
   return [fplogs count] >= 1;
 }
 
 - (NSArray *)distinctOctanesForFuelstation:(FPFuelStation *)fuelstation
                                      error:(PELMDaoErrorBlk)errorBlk {
-  return [self distinctOctanesForLogsBlk:^{return [self unorderedFuelPurchaseLogsForFuelstation:fuelstation error:errorBlk];}];
+  return [self distinctOctanesForParentEntity:fuelstation
+                            parentMasterTable:TBL_MASTER_FUEL_STATION
+                              parentMainTable:TBL_MAIN_FUEL_STATION
+                   parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
+                     parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
+                                        error:errorBlk];
 }
 
 - (BOOL)hasDieselLogsForFuelstation:(FPFuelStation *)fuelstation
                               error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:fuelstation
-                          parentEntityMainTable:TBL_MAIN_FUEL_STATION
-                 addlJoinParentEntityMainTables:_fuelstationTypeJoinTables
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainFuelStationFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
-                       parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
-                                       pageSize:@(1)
-                                       whereBlk:[self fpLogDieselWhereBlk]
-                                      whereArgs:nil
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:fuelstation
+                                  parentMasterTable:TBL_MASTER_FUEL_STATION
+                                    parentMainTable:TBL_MAIN_FUEL_STATION
+                         parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
+                           parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDieselWhereBlk]
+                                          whereArgs:nil
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:@(1)
+                                                 db:db
+                                              error:errorBlk];
   }];
   return [fplogs count] >= 1;
 }
@@ -1623,24 +2040,23 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSArray *)unorderedFuelPurchaseLogsForFuelstation:(FPFuelStation *)fuelstation
                                                error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:fuelstation
-                          parentEntityMainTable:TBL_MAIN_FUEL_STATION
-                 addlJoinParentEntityMainTables:_fuelstationTypeJoinTables
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainFuelStationFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
-                       parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
-                                       pageSize:nil
-                                       whereBlk:nil
-                                      whereArgs:nil
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:fuelstation
+                                  parentMasterTable:TBL_MASTER_FUEL_STATION
+                                    parentMainTable:TBL_MAIN_FUEL_STATION
+                         parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
+                           parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:nil
+                                          whereArgs:nil
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -1650,25 +2066,24 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                        onOrAfterDate:(NSDate *)onOrAfterDate
                                                error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:fuelstation
-                          parentEntityMainTable:TBL_MAIN_FUEL_STATION
-                 addlJoinParentEntityMainTables:_fuelstationTypeJoinTables
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainFuelStationFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
-                       parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogDateRangeWhereBlk]
-                                      whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                  [PEUtils millisecondsFromDate:onOrAfterDate]]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:fuelstation
+                                  parentMasterTable:TBL_MASTER_FUEL_STATION
+                                    parentMainTable:TBL_MAIN_FUEL_STATION
+                         parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
+                           parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDateRangeWhereBlk]
+                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                      [PEUtils millisecondsFromDate:onOrAfterDate]]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -1679,26 +2094,25 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                               octane:(NSNumber *)octane
                                                error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:fuelstation
-                          parentEntityMainTable:TBL_MAIN_FUEL_STATION
-                 addlJoinParentEntityMainTables:_fuelstationTypeJoinTables
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainFuelStationFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
-                       parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogDateRangeOctaneWhereBlk]
-                                      whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                  [PEUtils millisecondsFromDate:onOrAfterDate],
-                                                  octane]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:fuelstation
+                                  parentMasterTable:TBL_MASTER_FUEL_STATION
+                                    parentMainTable:TBL_MAIN_FUEL_STATION
+                         parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
+                           parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDateRangeOctaneWhereBlk]
+                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                      [PEUtils millisecondsFromDate:onOrAfterDate],
+                                                      octane]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -1708,25 +2122,24 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                              onOrAfterDate:(NSDate *)onOrAfterDate
                                                      error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:fuelstation
-                          parentEntityMainTable:TBL_MAIN_FUEL_STATION
-                 addlJoinParentEntityMainTables:_fuelstationTypeJoinTables
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainFuelStationFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
-                       parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogDateRangeDieselWhereBlk]
-                                      whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                  [PEUtils millisecondsFromDate:onOrAfterDate]]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:fuelstation
+                                  parentMasterTable:TBL_MASTER_FUEL_STATION
+                                    parentMainTable:TBL_MAIN_FUEL_STATION
+                         parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
+                           parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDateRangeDieselWhereBlk]
+                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                      [PEUtils millisecondsFromDate:onOrAfterDate]]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -1735,24 +2148,23 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                               octane:(NSNumber *)octane
                                                error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:fuelstation
-                          parentEntityMainTable:TBL_MAIN_FUEL_STATION
-                 addlJoinParentEntityMainTables:_fuelstationTypeJoinTables
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainFuelStationFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
-                       parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogOctaneWhereBlk]
-                                      whereArgs:@[octane]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:fuelstation
+                                  parentMasterTable:TBL_MASTER_FUEL_STATION
+                                    parentMainTable:TBL_MAIN_FUEL_STATION
+                         parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
+                           parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogOctaneWhereBlk]
+                                          whereArgs:@[octane]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -1760,24 +2172,23 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSArray *)unorderedDieselFuelPurchaseLogsForFuelstation:(FPFuelStation *)fuelstation
                                                      error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:fuelstation
-                          parentEntityMainTable:TBL_MAIN_FUEL_STATION
-                 addlJoinParentEntityMainTables:_fuelstationTypeJoinTables
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainFuelStationFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
-                       parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogDieselWhereBlk]
-                                      whereArgs:nil
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:fuelstation
+                                  parentMasterTable:TBL_MASTER_FUEL_STATION
+                                    parentMainTable:TBL_MAIN_FUEL_STATION
+                         parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
+                           parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDieselWhereBlk]
+                                          whereArgs:nil
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -1785,13 +2196,11 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPFuelPurchaseLog *)minMaxGallonPriceFuelPurchaseLogForUser:(FPUser *)user
                                                       whereBlk:(NSString *(^)(NSString *))whereBlk
                                                      whereArgs:(NSArray *)whereArgs
-                                             comparatorForSort:(NSComparisonResult(^)(id, id))comparatorForSort
                                   orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
                                                          error:(PELMDaoErrorBlk)errorBlk {
   return [self singleGasLogForUser:user
                           whereBlk:whereBlk
                          whereArgs:whereArgs
-                 comparatorForSort:comparatorForSort
                orderByDomainColumn:COL_FUELPL_PRICE_PER_GALLON
       orderByDomainColumnDirection:orderByDomainColumnDirection
                              error:errorBlk];
@@ -1800,13 +2209,11 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPFuelPurchaseLog *)minMaxGallonPriceFuelPurchaseLogForVehicle:(FPVehicle *)vehicle
                                                          whereBlk:(NSString *(^)(NSString *))whereBlk
                                                         whereArgs:(NSArray *)whereArgs
-                                                comparatorForSort:(NSComparisonResult(^)(id, id))comparatorForSort
                                      orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
                                                             error:(PELMDaoErrorBlk)errorBlk {
   return [self singleGasLogForVehicle:vehicle
                              whereBlk:whereBlk
                             whereArgs:whereArgs
-                    comparatorForSort:comparatorForSort
                   orderByDomainColumn:COL_FUELPL_PRICE_PER_GALLON
          orderByDomainColumnDirection:orderByDomainColumnDirection
                                 error:errorBlk];
@@ -1815,178 +2222,246 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPFuelPurchaseLog *)minMaxGallonPriceFuelPurchaseLogForFuelstation:(FPFuelStation *)fuelstation
                                                              whereBlk:(NSString *(^)(NSString *))whereBlk
                                                             whereArgs:(NSArray *)whereArgs
-                                                    comparatorForSort:(NSComparisonResult(^)(id, id))comparatorForSort
                                          orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
                                                                 error:(PELMDaoErrorBlk)errorBlk {
   return [self singleGasLogForFuelstation:fuelstation
                                  whereBlk:whereBlk
                                 whereArgs:whereArgs
-                        comparatorForSort:comparatorForSort
                       orderByDomainColumn:COL_FUELPL_PRICE_PER_GALLON
              orderByDomainColumnDirection:orderByDomainColumnDirection
                                     error:errorBlk];
 }
 
 - (NSString *(^)(NSString *))fpLogDateRangeOctaneWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ = ?",
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_OCTANE];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ = ?",
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_OCTANE];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogDateRangeDieselWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ is null AND %@%@ = 1",
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_OCTANE,
-            colPrefix,
-            COL_FUELPL_IS_DIESEL];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ is null AND %@%@ = 1",
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_OCTANE,
+              colPrefix,
+              COL_FUELPL_IS_DIESEL];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogDateRangeOctaneNonNilGallonPriceWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ = ? AND %@%@ is not null",
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_OCTANE,
-            colPrefix,
-            COL_FUELPL_PRICE_PER_GALLON];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ = ? AND %@%@ is not null",
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_OCTANE,
+              colPrefix,
+              COL_FUELPL_PRICE_PER_GALLON];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogDateRangeNonNilGallonPriceWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ is not null",
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_PRICE_PER_GALLON];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ is not null",
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_PRICE_PER_GALLON];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogDateRangeDieselNonNilGallonPriceWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ is null AND %@%@ is not null and %@%@ = 1",
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_OCTANE,
-            colPrefix,
-            COL_FUELPL_PRICE_PER_GALLON,
-            colPrefix,
-            COL_FUELPL_IS_DIESEL];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ is null AND %@%@ is not null and %@%@ = 1",
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_OCTANE,
+              colPrefix,
+              COL_FUELPL_PRICE_PER_GALLON,
+              colPrefix,
+              COL_FUELPL_IS_DIESEL];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogStrictDateRangeOctaneWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ > ? AND %@%@ = ?",
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_OCTANE];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ > ? AND %@%@ = ?",
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_OCTANE];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogStrictDateRangeDieselWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ > ? AND %@%@ = is null AND %@%@ = 1",
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_OCTANE,
-            colPrefix,
-            COL_FUELPL_IS_DIESEL];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ > ? AND %@%@ = is null AND %@%@ = 1",
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_OCTANE,
+              colPrefix,
+              COL_FUELPL_IS_DIESEL];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogDateRangeWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ?",
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ?",
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogStrictDateRangeWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ > ?",
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ > ?",
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT,
+              colPrefix,
+              COL_FUELPL_PURCHASED_AT];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogOctaneWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ = ?",
-            colPrefix,
-            COL_FUELPL_OCTANE];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ = ?",
+              colPrefix,
+              COL_FUELPL_OCTANE];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogDieselWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ is null AND %@%@ = 1",
-            colPrefix,
-            COL_FUELPL_OCTANE,
-            colPrefix,
-            COL_FUELPL_IS_DIESEL];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ is null AND %@%@ = 1",
+              colPrefix,
+              COL_FUELPL_OCTANE,
+              colPrefix,
+              COL_FUELPL_IS_DIESEL];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogOctaneNonNilGallonPriceWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ = ? AND %@%@ is not null",
-            colPrefix,
-            COL_FUELPL_OCTANE,
-            colPrefix,
-            COL_FUELPL_PRICE_PER_GALLON];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ = ? AND %@%@ is not null",
+              colPrefix,
+              COL_FUELPL_OCTANE,
+              colPrefix,
+              COL_FUELPL_PRICE_PER_GALLON];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogNonNilGallonPriceWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ is not null",
-            colPrefix,
-            COL_FUELPL_PRICE_PER_GALLON];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ is not null",
+              colPrefix,
+              COL_FUELPL_PRICE_PER_GALLON];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))fpLogDieselNonNilGallonPriceWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ is null AND %@%@ is not null and %@%@ = 1",
-            colPrefix,
-            COL_FUELPL_OCTANE,
-            colPrefix,
-            COL_FUELPL_PRICE_PER_GALLON,
-            colPrefix,
-            COL_FUELPL_IS_DIESEL];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ is null AND %@%@ is not null and %@%@ = 1",
+              colPrefix,
+              COL_FUELPL_OCTANE,
+              colPrefix,
+              COL_FUELPL_PRICE_PER_GALLON,
+              colPrefix,
+              COL_FUELPL_IS_DIESEL];
+    });
+  });
+  return whereBlk;
 }
 
 - (FPFuelPurchaseLog *)maxGallonPriceFuelPurchaseLogForVehicle:(FPVehicle *)vehicle
@@ -1999,7 +2474,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                 whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                             [PEUtils millisecondsFromDate:onOrAfterDate],
                                                             octane]
-                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                              orderByDomainColumnDirection:@"DESC"
                                                     error:errorBlk];
 }
@@ -2012,7 +2486,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                  whereBlk:[self fpLogDateRangeNonNilGallonPriceWhereBlk]
                                                 whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                             [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                              orderByDomainColumnDirection:@"DESC"
                                                     error:errorBlk];
 }
@@ -2025,7 +2498,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                  whereBlk:[self fpLogDateRangeDieselNonNilGallonPriceWhereBlk]
                                                 whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                             [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                              orderByDomainColumnDirection:@"DESC"
                                                     error:errorBlk];
 }
@@ -2040,7 +2512,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                 whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                             [PEUtils millisecondsFromDate:onOrAfterDate],
                                                             octane]
-                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                              orderByDomainColumnDirection:@"ASC"
                                                     error:errorBlk];
 }
@@ -2053,7 +2524,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                  whereBlk:[self fpLogDateRangeNonNilGallonPriceWhereBlk]
                                                 whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                             [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                              orderByDomainColumnDirection:@"ASC"
                                                     error:errorBlk];
 }
@@ -2066,7 +2536,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                  whereBlk:[self fpLogDateRangeDieselNonNilGallonPriceWhereBlk]
                                                 whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                             [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                              orderByDomainColumnDirection:@"ASC"
                                                     error:errorBlk];
 }
@@ -2077,7 +2546,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForVehicle:vehicle
                                                  whereBlk:[self fpLogOctaneNonNilGallonPriceWhereBlk]
                                                 whereArgs:@[octane]
-                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                              orderByDomainColumnDirection:@"DESC"
                                                     error:errorBlk];
 }
@@ -2087,7 +2555,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForVehicle:vehicle
                                                  whereBlk:[self fpLogNonNilGallonPriceWhereBlk]
                                                 whereArgs:nil
-                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                              orderByDomainColumnDirection:@"DESC"
                                                     error:errorBlk];
 }
@@ -2097,7 +2564,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForVehicle:vehicle
                                                  whereBlk:[self fpLogDieselNonNilGallonPriceWhereBlk]
                                                 whereArgs:nil
-                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                              orderByDomainColumnDirection:@"DESC"
                                                     error:errorBlk];
 }
@@ -2108,7 +2574,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForVehicle:vehicle
                                                  whereBlk:[self fpLogOctaneNonNilGallonPriceWhereBlk]
                                                 whereArgs:@[octane]
-                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                              orderByDomainColumnDirection:@"ASC"
                                                     error:errorBlk];
 }
@@ -2118,7 +2583,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForVehicle:vehicle
                                                  whereBlk:[self fpLogNonNilGallonPriceWhereBlk]
                                                 whereArgs:nil
-                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                              orderByDomainColumnDirection:@"ASC"
                                                     error:errorBlk];
 }
@@ -2128,7 +2592,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForVehicle:vehicle
                                                  whereBlk:[self fpLogDieselNonNilGallonPriceWhereBlk]
                                                 whereArgs:nil
-                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                              orderByDomainColumnDirection:@"ASC"
                                                     error:errorBlk];
 }
@@ -2143,7 +2606,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                     whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                                 [PEUtils millisecondsFromDate:onOrAfterDate],
                                                                 octane]
-                                            comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                                  orderByDomainColumnDirection:@"DESC"
                                                         error:errorBlk];
 }
@@ -2156,7 +2618,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                      whereBlk:[self fpLogDateRangeNonNilGallonPriceWhereBlk]
                                                     whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                                 [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                            comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                                  orderByDomainColumnDirection:@"DESC"
                                                         error:errorBlk];
 }
@@ -2169,7 +2630,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                      whereBlk:[self fpLogDateRangeDieselNonNilGallonPriceWhereBlk]
                                                     whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                                 [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                            comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                                  orderByDomainColumnDirection:@"DESC"
                                                         error:errorBlk];
 }
@@ -2184,7 +2644,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                     whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                                 [PEUtils millisecondsFromDate:onOrAfterDate],
                                                                 octane]
-                                            comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                                  orderByDomainColumnDirection:@"ASC"
                                                         error:errorBlk];
 }
@@ -2197,7 +2656,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                      whereBlk:[self fpLogDateRangeOctaneNonNilGallonPriceWhereBlk]
                                                     whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                                 [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                            comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                                  orderByDomainColumnDirection:@"ASC"
                                                         error:errorBlk];
 }
@@ -2210,7 +2668,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                      whereBlk:[self fpLogDateRangeDieselNonNilGallonPriceWhereBlk]
                                                     whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                                 [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                            comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                                  orderByDomainColumnDirection:@"ASC"
                                                         error:errorBlk];
 }
@@ -2221,7 +2678,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForFuelstation:fuelstation
                                                      whereBlk:[self fpLogOctaneNonNilGallonPriceWhereBlk]
                                                     whereArgs:@[octane]
-                                            comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                                  orderByDomainColumnDirection:@"DESC"
                                                         error:errorBlk];
 }
@@ -2231,7 +2687,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForFuelstation:fuelstation
                                                      whereBlk:[self fpLogNonNilGallonPriceWhereBlk]
                                                     whereArgs:nil
-                                            comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                                  orderByDomainColumnDirection:@"DESC"
                                                         error:errorBlk];
 }
@@ -2241,7 +2696,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForFuelstation:fuelstation
                                                      whereBlk:[self fpLogDieselNonNilGallonPriceWhereBlk]
                                                     whereArgs:nil
-                                            comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                                  orderByDomainColumnDirection:@"DESC"
                                                         error:errorBlk];
 }
@@ -2252,7 +2706,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForFuelstation:fuelstation
                                                      whereBlk:[self fpLogOctaneNonNilGallonPriceWhereBlk]
                                                     whereArgs:@[octane]
-                                            comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                                  orderByDomainColumnDirection:@"ASC"
                                                         error:errorBlk];
 }
@@ -2262,7 +2715,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForFuelstation:fuelstation
                                                      whereBlk:[self fpLogNonNilGallonPriceWhereBlk]
                                                     whereArgs:nil
-                                            comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                                  orderByDomainColumnDirection:@"ASC"
                                                         error:errorBlk];
 }
@@ -2272,7 +2724,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForFuelstation:fuelstation
                                                      whereBlk:[self fpLogDieselNonNilGallonPriceWhereBlk]
                                                     whereArgs:nil
-                                            comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                                  orderByDomainColumnDirection:@"ASC"
                                                         error:errorBlk];
 }
@@ -2280,24 +2731,23 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSArray *)unorderedFuelPurchaseLogsForVehicle:(FPVehicle *)vehicle
                                            error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:vehicle
-                          parentEntityMainTable:TBL_MAIN_VEHICLE
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                       parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                       pageSize:nil
-                                       whereBlk:nil
-                                      whereArgs:nil
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:vehicle
+                                  parentMasterTable:TBL_MASTER_VEHICLE
+                                    parentMainTable:TBL_MAIN_VEHICLE
+                         parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                           parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:nil
+                                          whereArgs:nil
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2307,25 +2757,24 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                    onOrAfterDate:(NSDate *)onOrAfterDate
                                            error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:vehicle
-                          parentEntityMainTable:TBL_MAIN_VEHICLE
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                       parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogDateRangeWhereBlk]
-                                      whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                  [PEUtils millisecondsFromDate:onOrAfterDate]]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:vehicle
+                                  parentMasterTable:TBL_MASTER_VEHICLE
+                                    parentMainTable:TBL_MAIN_VEHICLE
+                         parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                           parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDateRangeWhereBlk]
+                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                      [PEUtils millisecondsFromDate:onOrAfterDate]]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2335,25 +2784,24 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                        afterDate:(NSDate *)afterDate
                                            error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:vehicle
-                          parentEntityMainTable:TBL_MAIN_VEHICLE
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                       parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogStrictDateRangeWhereBlk]
-                                      whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                  [PEUtils millisecondsFromDate:afterDate]]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:vehicle
+                                  parentMasterTable:TBL_MASTER_VEHICLE
+                                    parentMainTable:TBL_MAIN_VEHICLE
+                         parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                           parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogStrictDateRangeWhereBlk]
+                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                      [PEUtils millisecondsFromDate:afterDate]]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2364,26 +2812,25 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                           octane:(NSNumber *)octane
                                            error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:vehicle
-                          parentEntityMainTable:TBL_MAIN_VEHICLE
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                       parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogDateRangeOctaneWhereBlk]
-                                      whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                  [PEUtils millisecondsFromDate:onOrAfterDate],
-                                                  octane]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:vehicle
+                                  parentMasterTable:TBL_MASTER_VEHICLE
+                                    parentMainTable:TBL_MAIN_VEHICLE
+                         parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                           parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDateRangeOctaneWhereBlk]
+                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                      [PEUtils millisecondsFromDate:onOrAfterDate],
+                                                      octane]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2393,25 +2840,24 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                          onOrAfterDate:(NSDate *)onOrAfterDate
                                                  error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:vehicle
-                          parentEntityMainTable:TBL_MAIN_VEHICLE
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                       parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogDateRangeDieselWhereBlk]
-                                      whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                  [PEUtils millisecondsFromDate:onOrAfterDate]]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:vehicle
+                                  parentMasterTable:TBL_MASTER_VEHICLE
+                                    parentMainTable:TBL_MAIN_VEHICLE
+                         parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                           parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDateRangeDieselWhereBlk]
+                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                      [PEUtils millisecondsFromDate:onOrAfterDate]]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2422,26 +2868,25 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                           octane:(NSNumber *)octane
                                            error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:vehicle
-                          parentEntityMainTable:TBL_MAIN_VEHICLE
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                       parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogStrictDateRangeOctaneWhereBlk]
-                                      whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                  [PEUtils millisecondsFromDate:afterDate],
-                                                  octane]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:vehicle
+                                  parentMasterTable:TBL_MASTER_VEHICLE
+                                    parentMainTable:TBL_MAIN_VEHICLE
+                         parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                           parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogStrictDateRangeOctaneWhereBlk]
+                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                      [PEUtils millisecondsFromDate:afterDate],
+                                                      octane]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2451,25 +2896,24 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                              afterDate:(NSDate *)afterDate
                                                  error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:vehicle
-                          parentEntityMainTable:TBL_MAIN_VEHICLE
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                       parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogStrictDateRangeDieselWhereBlk]
-                                      whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                  [PEUtils millisecondsFromDate:afterDate]]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:vehicle
+                                  parentMasterTable:TBL_MASTER_VEHICLE
+                                    parentMainTable:TBL_MAIN_VEHICLE
+                         parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                           parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogStrictDateRangeDieselWhereBlk]
+                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                      [PEUtils millisecondsFromDate:afterDate]]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2478,24 +2922,23 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                           octane:(NSNumber *)octane
                                            error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:vehicle
-                          parentEntityMainTable:TBL_MAIN_VEHICLE
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                       parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogOctaneWhereBlk]
-                                      whereArgs:@[octane]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:vehicle
+                                  parentMasterTable:TBL_MASTER_VEHICLE
+                                    parentMainTable:TBL_MAIN_VEHICLE
+                         parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                           parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogOctaneWhereBlk]
+                                          whereArgs:@[octane]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2503,24 +2946,23 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSArray *)unorderedDieselFuelPurchaseLogsForVehicle:(FPVehicle *)vehicle
                                                  error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:vehicle
-                          parentEntityMainTable:TBL_MAIN_VEHICLE
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                       parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogDieselWhereBlk]
-                                      whereArgs:nil
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:vehicle
+                                  parentMasterTable:TBL_MASTER_VEHICLE
+                                    parentMainTable:TBL_MAIN_VEHICLE
+                         parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                           parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDieselWhereBlk]
+                                          whereArgs:nil
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2528,24 +2970,23 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSArray *)unorderedFuelPurchaseLogsForUser:(FPUser *)user
                                         error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:user
-                          parentEntityMainTable:TBL_MAIN_USER
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_USER_ID
-                       parentEntityMainIdColumn:COL_MAIN_USER_ID
-                                       pageSize:nil
-                                       whereBlk:nil
-                                      whereArgs:nil
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:user
+                                  parentMasterTable:TBL_MASTER_USER
+                                    parentMainTable:TBL_MAIN_USER
+                         parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                           parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:nil
+                                          whereArgs:nil
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2555,25 +2996,24 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                 onOrAfterDate:(NSDate *)onOrAfterDate
                                         error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:user
-                          parentEntityMainTable:TBL_MAIN_USER
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_USER_ID
-                       parentEntityMainIdColumn:COL_MAIN_USER_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogDateRangeWhereBlk]
-                                      whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                  [PEUtils millisecondsFromDate:onOrAfterDate]]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:user
+                                  parentMasterTable:TBL_MASTER_USER
+                                    parentMainTable:TBL_MAIN_USER
+                         parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                           parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDateRangeWhereBlk]
+                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                      [PEUtils millisecondsFromDate:onOrAfterDate]]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2584,26 +3024,25 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                        octane:(NSNumber *)octane
                                         error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:user
-                          parentEntityMainTable:TBL_MAIN_USER
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_USER_ID
-                       parentEntityMainIdColumn:COL_MAIN_USER_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogDateRangeOctaneWhereBlk]
-                                      whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                  [PEUtils millisecondsFromDate:onOrAfterDate],
-                                                  octane]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:user
+                                  parentMasterTable:TBL_MASTER_USER
+                                    parentMainTable:TBL_MAIN_USER
+                         parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                           parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDateRangeOctaneWhereBlk]
+                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                      [PEUtils millisecondsFromDate:onOrAfterDate],
+                                                      octane]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2613,25 +3052,24 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                       onOrAfterDate:(NSDate *)onOrAfterDate
                                               error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:user
-                          parentEntityMainTable:TBL_MAIN_USER
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_USER_ID
-                       parentEntityMainIdColumn:COL_MAIN_USER_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogDateRangeDieselWhereBlk]
-                                      whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                  [PEUtils millisecondsFromDate:onOrAfterDate]]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:user
+                                  parentMasterTable:TBL_MASTER_USER
+                                    parentMainTable:TBL_MAIN_USER
+                         parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                           parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDateRangeDieselWhereBlk]
+                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                      [PEUtils millisecondsFromDate:onOrAfterDate]]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2640,24 +3078,23 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                        octane:(NSNumber *)octane
                                         error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:user
-                          parentEntityMainTable:TBL_MAIN_USER
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_USER_ID
-                       parentEntityMainIdColumn:COL_MAIN_USER_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogOctaneWhereBlk]
-                                      whereArgs:@[octane]
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:user
+                                  parentMasterTable:TBL_MASTER_USER
+                                    parentMainTable:TBL_MAIN_USER
+                         parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                           parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogOctaneWhereBlk]
+                                          whereArgs:@[octane]
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2665,24 +3102,23 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSArray *)unorderedDieselFuelPurchaseLogsForUser:(FPUser *)user
                                               error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fplogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    fplogs = [PELMUtils entitiesForParentEntity:user
-                          parentEntityMainTable:TBL_MAIN_USER
-                 addlJoinParentEntityMainTables:nil
-                    parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
-                     parentEntityMasterIdColumn:COL_MASTER_USER_ID
-                       parentEntityMainIdColumn:COL_MAIN_USER_ID
-                                       pageSize:nil
-                                       whereBlk:[self fpLogDieselWhereBlk]
-                                      whereArgs:nil
-                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                     addlJoinEntityMasterTables:nil
-                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                       addlJoinEntityMainTables:nil
-                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                             db:db
-                                          error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    fplogs = [self effectiveEntitiesForParentEntity:user
+                                  parentMasterTable:TBL_MASTER_USER
+                                    parentMainTable:TBL_MAIN_USER
+                         parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                           parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                  entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                    entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                     masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                       mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                           whereBlk:[self fpLogDieselWhereBlk]
+                                          whereArgs:nil
+                                orderByDomainColumn:nil
+                       orderByDomainColumnDirection:nil
+                                           pageSize:nil
+                                                 db:db
+                                              error:errorBlk];
   }];
   return fplogs;
 }
@@ -2690,32 +3126,27 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPFuelPurchaseLog *)singleGasLogForUser:(FPUser *)user
                                   whereBlk:(NSString *(^)(NSString *))whereBlk
                                  whereArgs:(NSArray *)whereArgs
-                         comparatorForSort:(NSComparisonResult(^)(id, id))comparatorForSort
                        orderByDomainColumn:(NSString *)orderByDomainColumn
               orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
                                      error:(PELMDaoErrorBlk)errorBlk {
   __block FPFuelPurchaseLog *fplog = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    NSArray *fplogs = [PELMUtils entitiesForParentEntity:user
-                                   parentEntityMainTable:TBL_MAIN_USER
-                          addlJoinParentEntityMainTables:nil
-                             parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
-                              parentEntityMasterIdColumn:COL_MASTER_USER_ID
-                                parentEntityMainIdColumn:COL_MAIN_USER_ID
-                                                pageSize:@(1)
-                                                whereBlk:whereBlk
-                                               whereArgs:whereArgs
-                                       entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                              addlJoinEntityMasterTables:nil
-                          masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                         entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                                addlJoinEntityMainTables:nil
-                            mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                       comparatorForSort:comparatorForSort
-                                     orderByDomainColumn:orderByDomainColumn
-                            orderByDomainColumnDirection:orderByDomainColumnDirection
-                                                      db:db
-                                                   error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    NSArray *fplogs = [self effectiveEntitiesForParentEntity:user
+                                           parentMasterTable:TBL_MASTER_USER
+                                             parentMainTable:TBL_MAIN_USER
+                                  parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                                    parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                           entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                             entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                              masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                                mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                                    whereBlk:whereBlk
+                                                   whereArgs:whereArgs
+                                         orderByDomainColumn:orderByDomainColumn
+                                orderByDomainColumnDirection:orderByDomainColumnDirection
+                                                    pageSize:@(1)
+                                                          db:db
+                                                       error:errorBlk];
 
     if ([fplogs count] > 0) {
       fplog = fplogs[0];
@@ -2727,32 +3158,27 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPFuelPurchaseLog *)singleGasLogForVehicle:(FPVehicle *)vehicle
                                      whereBlk:(NSString *(^)(NSString *))whereBlk
                                     whereArgs:(NSArray *)whereArgs
-                            comparatorForSort:(NSComparisonResult(^)(id, id))comparatorForSort
                           orderByDomainColumn:(NSString *)orderByDomainColumn
                  orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
                                         error:(PELMDaoErrorBlk)errorBlk {
   __block FPFuelPurchaseLog *fplog = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    NSArray *fplogs = [PELMUtils entitiesForParentEntity:vehicle
-                                   parentEntityMainTable:TBL_MAIN_VEHICLE
-                          addlJoinParentEntityMainTables:nil
-                             parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                              parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                                parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                                pageSize:@(1)
-                                                whereBlk:whereBlk
-                                               whereArgs:whereArgs
-                                       entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                              addlJoinEntityMasterTables:nil
-                          masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                         entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                                addlJoinEntityMainTables:nil
-                            mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                       comparatorForSort:comparatorForSort
-                                     orderByDomainColumn:orderByDomainColumn
-                            orderByDomainColumnDirection:orderByDomainColumnDirection
-                                                      db:db
-                                                   error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    NSArray *fplogs = [self effectiveEntitiesForParentEntity:vehicle
+                                           parentMasterTable:TBL_MASTER_VEHICLE
+                                             parentMainTable:TBL_MAIN_VEHICLE
+                                  parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                                    parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                           entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                             entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                              masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                                mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                                    whereBlk:whereBlk
+                                                   whereArgs:whereArgs
+                                         orderByDomainColumn:orderByDomainColumn
+                                orderByDomainColumnDirection:orderByDomainColumnDirection
+                                                    pageSize:@(1)
+                                                          db:db
+                                                       error:errorBlk];
 
     if ([fplogs count] > 0) {
       fplog = fplogs[0];
@@ -2764,32 +3190,27 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPFuelPurchaseLog *)singleGasLogForFuelstation:(FPFuelStation *)fuelstation
                                          whereBlk:(NSString *(^)(NSString *))whereBlk
                                         whereArgs:(NSArray *)whereArgs
-                                comparatorForSort:(NSComparisonResult(^)(id, id))comparatorForSort
                               orderByDomainColumn:(NSString *)orderByDomainColumn
                      orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
                                             error:(PELMDaoErrorBlk)errorBlk {
   __block FPFuelPurchaseLog *fplog = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    NSArray *fplogs = [PELMUtils entitiesForParentEntity:fuelstation
-                                   parentEntityMainTable:TBL_MAIN_FUEL_STATION
-                          addlJoinParentEntityMainTables:_fuelstationTypeJoinTables
-                             parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainFuelStationFromResultSet:rs];}
-                              parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
-                                parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
-                                                pageSize:@(1)
-                                                whereBlk:whereBlk
-                                               whereArgs:whereArgs
-                                       entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                              addlJoinEntityMasterTables:nil
-                          masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                                         entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                                addlJoinEntityMainTables:nil
-                            mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                       comparatorForSort:comparatorForSort
-                                     orderByDomainColumn:orderByDomainColumn
-                            orderByDomainColumnDirection:orderByDomainColumnDirection
-                                                      db:db
-                                                   error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    NSArray *fplogs = [self effectiveEntitiesForParentEntity:fuelstation
+                                           parentMasterTable:TBL_MASTER_FUEL_STATION
+                                             parentMainTable:TBL_MAIN_FUEL_STATION
+                                  parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
+                                    parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
+                                           entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                             entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                              masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                                mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                                    whereBlk:whereBlk
+                                                   whereArgs:whereArgs
+                                         orderByDomainColumn:orderByDomainColumn
+                                orderByDomainColumnDirection:orderByDomainColumnDirection
+                                                    pageSize:@(1)
+                                                          db:db
+                                                       error:errorBlk];
 
     if ([fplogs count] > 0) {
       fplog = fplogs[0];
@@ -2799,43 +3220,69 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 }
 
 - (NSString *(^)(NSString *))gasLogDateCompareWhereBlk:(NSString *)compareDirection {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ %@ ?", colPrefix, COL_FUELPL_PURCHASED_AT, compareDirection];
-  };
+  static NSDictionary *whereBlks;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlks = FPWhereTemplatesByCompareDirection(^(NSString *direction) {
+      return FPWhereTemplate(^(NSString *colPrefix) {
+        return [NSString stringWithFormat:@"%@%@ %@ ?", colPrefix, COL_FUELPL_PURCHASED_AT, direction];
+      });
+    });
+  });
+  return whereBlks[compareDirection];
 }
 
 - (NSString *(^)(NSString *))gasLogDateAndOctaneCompareWhereBlk:(NSString *)compareDirection {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ %@ ? and %@%@ = ?",
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            compareDirection,
-            colPrefix,
-            COL_FUELPL_OCTANE];
-  };
+  static NSDictionary *whereBlks;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlks = FPWhereTemplatesByCompareDirection(^(NSString *direction) {
+      return FPWhereTemplate(^(NSString *colPrefix) {
+        return [NSString stringWithFormat:@"%@%@ %@ ? and %@%@ = ?",
+                colPrefix,
+                COL_FUELPL_PURCHASED_AT,
+                direction,
+                colPrefix,
+                COL_FUELPL_OCTANE];
+      });
+    });
+  });
+  return whereBlks[compareDirection];
 }
 
 - (NSString *(^)(NSString *))gasLogDateAndDieselCompareWhereBlk:(NSString *)compareDirection {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ %@ ? and %@%@ is null and %@%@ = 1",
-            colPrefix,
-            COL_FUELPL_PURCHASED_AT,
-            compareDirection,
-            colPrefix,
-            COL_FUELPL_OCTANE,
-            colPrefix,
-            COL_FUELPL_IS_DIESEL];
-  };
+  static NSDictionary *whereBlks;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlks = FPWhereTemplatesByCompareDirection(^(NSString *direction) {
+      return FPWhereTemplate(^(NSString *colPrefix) {
+        return [NSString stringWithFormat:@"%@%@ %@ ? and %@%@ is null and %@%@ = 1",
+                colPrefix,
+                COL_FUELPL_PURCHASED_AT,
+                direction,
+                colPrefix,
+                COL_FUELPL_OCTANE,
+                colPrefix,
+                COL_FUELPL_IS_DIESEL];
+      });
+    });
+  });
+  return whereBlks[compareDirection];
 }
 
 - (NSString *(^)(NSString *))gasLogDieselWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ is null AND %@%@ = 1",
-            colPrefix,
-            COL_FUELPL_OCTANE,
-            colPrefix,
-            COL_FUELPL_IS_DIESEL];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ is null AND %@%@ = 1",
+              colPrefix,
+              COL_FUELPL_OCTANE,
+              colPrefix,
+              COL_FUELPL_IS_DIESEL];
+    });
+  });
+  return whereBlk;
 }
 
 - (FPFuelPurchaseLog *)firstGasLogForUser:(FPUser *)user
@@ -2843,7 +3290,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForUser:user
                           whereBlk:nil
                          whereArgs:nil
-                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                orderByDomainColumn:COL_FUELPL_PURCHASED_AT
       orderByDomainColumnDirection:@"ASC"
                              error:errorBlk];
@@ -2855,7 +3301,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForUser:user
                           whereBlk:[self fpLogOctaneWhereBlk]
                          whereArgs:@[octane]
-                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                orderByDomainColumn:COL_FUELPL_PURCHASED_AT
       orderByDomainColumnDirection:@"ASC"
                              error:errorBlk];
@@ -2866,7 +3311,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForUser:user
                           whereBlk:[self gasLogDieselWhereBlk]
                          whereArgs:nil
-                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                orderByDomainColumn:COL_FUELPL_PURCHASED_AT
       orderByDomainColumnDirection:@"ASC"
                              error:errorBlk];
@@ -2877,7 +3321,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForVehicle:vehicle
                              whereBlk:nil
                             whereArgs:nil
-                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                   orderByDomainColumn:COL_FUELPL_PURCHASED_AT
          orderByDomainColumnDirection:@"ASC"
                                 error:errorBlk];
@@ -2889,7 +3332,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForVehicle:vehicle
                              whereBlk:[self fpLogOctaneWhereBlk]
                             whereArgs:@[octane]
-                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                   orderByDomainColumn:COL_FUELPL_PURCHASED_AT
          orderByDomainColumnDirection:@"ASC"
                                 error:errorBlk];
@@ -2900,7 +3342,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForVehicle:vehicle
                              whereBlk:[self gasLogDieselWhereBlk]
                             whereArgs:nil
-                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                   orderByDomainColumn:COL_FUELPL_PURCHASED_AT
          orderByDomainColumnDirection:@"ASC"
                                 error:errorBlk];
@@ -2914,7 +3355,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                              whereBlk:[self fpLogDateRangeWhereBlk]
                             whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                         [PEUtils millisecondsFromDate:onOrAfterDate]]
-                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                   orderByDomainColumn:COL_FUELPL_PURCHASED_AT
          orderByDomainColumnDirection:@"ASC"
                                 error:errorBlk];
@@ -2925,7 +3365,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForFuelstation:fuelstation
                                  whereBlk:nil
                                 whereArgs:nil
-                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                       orderByDomainColumn:COL_FUELPL_PURCHASED_AT
              orderByDomainColumnDirection:@"ASC"
                                     error:errorBlk];
@@ -2937,7 +3376,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForFuelstation:fuelstation
                                  whereBlk:[self fpLogOctaneWhereBlk]
                                 whereArgs:@[octane]
-                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                       orderByDomainColumn:COL_FUELPL_PURCHASED_AT
              orderByDomainColumnDirection:@"ASC"
                                     error:errorBlk];
@@ -2948,7 +3386,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForFuelstation:fuelstation
                                  whereBlk:[self gasLogDieselWhereBlk]
                                 whereArgs:nil
-                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                       orderByDomainColumn:COL_FUELPL_PURCHASED_AT
              orderByDomainColumnDirection:@"ASC"
                                     error:errorBlk];
@@ -2959,7 +3396,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForUser:user
                           whereBlk:nil
                          whereArgs:nil
-                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                orderByDomainColumn:COL_FUELPL_PURCHASED_AT
       orderByDomainColumnDirection:@"DESC"
                              error:errorBlk];
@@ -2971,7 +3407,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForUser:user
                           whereBlk:[self fpLogOctaneWhereBlk]
                          whereArgs:@[octane]
-                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                orderByDomainColumn:COL_FUELPL_PURCHASED_AT
       orderByDomainColumnDirection:@"DESC"
                              error:errorBlk];
@@ -2982,7 +3417,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForUser:user
                           whereBlk:[self gasLogDieselWhereBlk]
                          whereArgs:nil
-                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                orderByDomainColumn:COL_FUELPL_PURCHASED_AT
       orderByDomainColumnDirection:@"DESC"
                              error:errorBlk];
@@ -2993,7 +3427,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForVehicle:vehicle
                              whereBlk:nil
                             whereArgs:nil
-                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                   orderByDomainColumn:COL_FUELPL_PURCHASED_AT
          orderByDomainColumnDirection:@"DESC"
                                 error:errorBlk];
@@ -3005,7 +3438,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForVehicle:vehicle
                              whereBlk:[self fpLogOctaneWhereBlk]
                             whereArgs:@[octane]
-                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                   orderByDomainColumn:COL_FUELPL_PURCHASED_AT
          orderByDomainColumnDirection:@"DESC"
                                 error:errorBlk];
@@ -3016,7 +3448,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForVehicle:vehicle
                              whereBlk:[self gasLogDieselWhereBlk]
                             whereArgs:nil
-                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                   orderByDomainColumn:COL_FUELPL_PURCHASED_AT
          orderByDomainColumnDirection:@"DESC"
                                 error:errorBlk];
@@ -3030,7 +3461,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                              whereBlk:[self fpLogDateRangeWhereBlk]
                             whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                         [PEUtils millisecondsFromDate:onOrAfterDate]]
-                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                   orderByDomainColumn:COL_FUELPL_PURCHASED_AT
          orderByDomainColumnDirection:@"DESC"
                                 error:errorBlk];
@@ -3041,7 +3471,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForFuelstation:fuelstation
                                  whereBlk:nil
                                 whereArgs:nil
-                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                       orderByDomainColumn:COL_FUELPL_PURCHASED_AT
              orderByDomainColumnDirection:@"DESC"
                                     error:errorBlk];
@@ -3053,7 +3482,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForFuelstation:fuelstation
                                  whereBlk:[self fpLogOctaneWhereBlk]
                                 whereArgs:@[octane]
-                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                       orderByDomainColumn:COL_FUELPL_PURCHASED_AT
              orderByDomainColumnDirection:@"DESC"
                                     error:errorBlk];
@@ -3064,7 +3492,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleGasLogForFuelstation:fuelstation
                                  whereBlk:[self gasLogDieselWhereBlk]
                                 whereArgs:nil
-                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                       orderByDomainColumn:COL_FUELPL_PURCHASED_AT
              orderByDomainColumnDirection:@"DESC"
                                     error:errorBlk];
@@ -3105,14 +3532,12 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   FPFuelPurchaseLog *lessThanDateGasLog = [self singleGasLogForVehicle:vehicle
                                                               whereBlk:[self gasLogDateCompareWhereBlk:@"<="]
                                                              whereArgs:@[[PEUtils millisecondsFromDate:date]]
-                                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                                                    orderByDomainColumn:COL_FUELPL_PURCHASED_AT
                                           orderByDomainColumnDirection:@"DESC"
                                                                  error:errorBlk];
   FPFuelPurchaseLog *greaterThanDateGasLog = [self singleGasLogForVehicle:vehicle
                                                                  whereBlk:[self gasLogDateCompareWhereBlk:@">="]
                                                                 whereArgs:@[[PEUtils millisecondsFromDate:date]]
-                                                        comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                                                       orderByDomainColumn:COL_FUELPL_PURCHASED_AT
                                              orderByDomainColumnDirection:@"ASC"
                                                                     error:errorBlk];
@@ -3130,14 +3555,12 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   FPFuelPurchaseLog *lessThanDateGasLog = [self singleGasLogForUser:user
                                                            whereBlk:[self gasLogDateAndOctaneCompareWhereBlk:@"<="]
                                                           whereArgs:@[[PEUtils millisecondsFromDate:date], octane]
-                                                  comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                                                 orderByDomainColumn:COL_FUELPL_PURCHASED_AT
                                        orderByDomainColumnDirection:@"DESC"
                                                               error:errorBlk];
   FPFuelPurchaseLog *greaterThanDateGasLog = [self singleGasLogForUser:user
                                                               whereBlk:[self gasLogDateAndOctaneCompareWhereBlk:@">="]
                                                              whereArgs:@[[PEUtils millisecondsFromDate:date], octane]
-                                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                                                    orderByDomainColumn:COL_FUELPL_PURCHASED_AT
                                           orderByDomainColumnDirection:@"ASC"
                                                                  error:errorBlk];
@@ -3154,14 +3577,12 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   FPFuelPurchaseLog *lessThanDateGasLog = [self singleGasLogForUser:user
                                                            whereBlk:[self gasLogDateAndDieselCompareWhereBlk:@"<="]
                                                           whereArgs:@[[PEUtils millisecondsFromDate:date]]
-                                                  comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                                                 orderByDomainColumn:COL_FUELPL_PURCHASED_AT
                                        orderByDomainColumnDirection:@"DESC"
                                                               error:errorBlk];
   FPFuelPurchaseLog *greaterThanDateGasLog = [self singleGasLogForUser:user
                                                               whereBlk:[self gasLogDateAndDieselCompareWhereBlk:@">="]
                                                              whereArgs:@[[PEUtils millisecondsFromDate:date]]
-                                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 purchasedAt] compare:[(FPFuelPurchaseLog *)o2 purchasedAt]];}
                                                    orderByDomainColumn:COL_FUELPL_PURCHASED_AT
                                           orderByDomainColumnDirection:@"ASC"
                                                                  error:errorBlk];
@@ -3182,7 +3603,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                              whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                          [PEUtils millisecondsFromDate:onOrAfterDate],
                                                          octane]
-                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                           orderByDomainColumnDirection:@"DESC"
                                                  error:errorBlk];
 }
@@ -3195,7 +3615,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                               whereBlk:[self fpLogDateRangeNonNilGallonPriceWhereBlk]
                                              whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                          [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                           orderByDomainColumnDirection:@"DESC"
                                                  error:errorBlk];
 }
@@ -3208,7 +3627,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                               whereBlk:[self fpLogDateRangeDieselNonNilGallonPriceWhereBlk]
                                              whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                          [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                           orderByDomainColumnDirection:@"DESC"
                                                  error:errorBlk];
 }
@@ -3223,7 +3641,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                              whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                          [PEUtils millisecondsFromDate:onOrAfterDate],
                                                          octane]
-                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                           orderByDomainColumnDirection:@"ASC"
                                                  error:errorBlk];
 }
@@ -3236,7 +3653,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                               whereBlk:[self fpLogDateRangeNonNilGallonPriceWhereBlk]
                                              whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                          [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                           orderByDomainColumnDirection:@"ASC"
                                                  error:errorBlk];
 }
@@ -3249,7 +3665,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                               whereBlk:[self fpLogDateRangeDieselNonNilGallonPriceWhereBlk]
                                              whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                          [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                           orderByDomainColumnDirection:@"ASC"
                                                  error:errorBlk];
 }
@@ -3260,7 +3675,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForUser:user
                                               whereBlk:[self fpLogOctaneNonNilGallonPriceWhereBlk]
                                              whereArgs:@[octane]
-                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                           orderByDomainColumnDirection:@"DESC" error:errorBlk];
 }
 
@@ -3269,7 +3683,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForUser:user
                                               whereBlk:[self fpLogNonNilGallonPriceWhereBlk]
                                              whereArgs:nil
-                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                           orderByDomainColumnDirection:@"DESC" error:errorBlk];
 }
 
@@ -3278,7 +3691,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForUser:user
                                               whereBlk:[self fpLogDieselNonNilGallonPriceWhereBlk]
                                              whereArgs:nil
-                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 gallonPrice] compare:[(FPFuelPurchaseLog *)o1 gallonPrice]];}
                           orderByDomainColumnDirection:@"DESC" error:errorBlk];
 }
 
@@ -3288,7 +3700,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForUser:user
                                               whereBlk:[self fpLogOctaneNonNilGallonPriceWhereBlk]
                                              whereArgs:@[octane]
-                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                           orderByDomainColumnDirection:@"ASC" error:errorBlk];
 }
 
@@ -3297,7 +3708,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForUser:user
                                               whereBlk:[self fpLogNonNilGallonPriceWhereBlk]
                                              whereArgs:nil
-                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                           orderByDomainColumnDirection:@"ASC" error:errorBlk];
 }
 
@@ -3306,14 +3716,13 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxGallonPriceFuelPurchaseLogForUser:user
                                               whereBlk:[self fpLogDieselNonNilGallonPriceWhereBlk]
                                              whereArgs:nil
-                                     comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o1 gallonPrice] compare:[(FPFuelPurchaseLog *)o2 gallonPrice]];}
                           orderByDomainColumnDirection:@"ASC" error:errorBlk];
 }
 
 - (FPFuelPurchaseLog *)masterFplogWithId:(NSNumber *)fplogId error:(PELMDaoErrorBlk)errorBlk {
   NSString *fplogTable = TBL_MASTER_FUELPURCHASE_LOG;
   __block FPFuelPurchaseLog *fplog = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     fplog = [PELMUtils entityFromQuery:[NSString stringWithFormat:@"SELECT * FROM %@ WHERE %@ = ?", fplogTable, COL_LOCAL_ID]
                            entityTable:fplogTable
                          localIdGetter:^NSNumber *(PELMModelSupport *entity) { return [entity localMasterIdentifier]; }
@@ -3332,7 +3741,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPFuelPurchaseLog *)masterFplogWithGlobalId:(NSString *)globalId error:(PELMDaoErrorBlk)errorBlk {
   NSString *fplogTable = TBL_MASTER_FUELPURCHASE_LOG;
   __block FPFuelPurchaseLog *fplog = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     fplog = [PELMUtils entityFromQuery:[NSString stringWithFormat:@"SELECT * FROM %@ WHERE %@ = ?", fplogTable, COL_GLOBAL_ID]
                            entityTable:fplogTable
                          localIdGetter:^NSNumber *(PELMModelSupport *entity) { return [entity localMasterIdentifier]; }
@@ -3363,12 +3772,13 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
         entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
                        db:db
                     error:errorBlk];
+  [self refreshMonthlyRollupsWithDb:db error:errorBlk];
 }
 
 - (NSInteger)numFuelPurchaseLogsForUser:(FPUser *)user
                                   error:(PELMDaoErrorBlk)errorBlk {
   __block NSInteger numEntities = 0;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     numEntities = [PELMUtils numEntitiesForParentEntity:user
                                   parentEntityMainTable:TBL_MAIN_USER
                          addlJoinParentEntityMainTables:nil
@@ -3389,7 +3799,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                               newerThan:(NSDate *)newerThan
                                   error:(PELMDaoErrorBlk)errorBlk {
   __block NSInteger numEntities = 0;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     numEntities = [PELMUtils numEntitiesForParentEntity:user
                                   parentEntityMainTable:TBL_MAIN_USER
                          addlJoinParentEntityMainTables:nil
@@ -3422,7 +3832,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                     beforeDateLogged:(NSDate *)beforeDateLogged
                                error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fpLogs = @[];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     fpLogs = [self fuelPurchaseLogsForUser:user
                                   pageSize:@(pageSize)
                           beforeDateLogged:beforeDateLogged
@@ -3435,7 +3845,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSArray *)unsyncedFuelPurchaseLogsForUser:(FPUser *)user
                                        error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fpLogs = @[];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     fpLogs = [self unsyncedFuelPurchaseLogsForUser:user db:db error:errorBlk];
   }];
   return fpLogs;
@@ -3457,7 +3867,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                     entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
                            addlJoinEntityMainTables:nil
                        mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                                  comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
                                 orderByDomainColumn:COL_FUELPL_PURCHASED_AT
                        orderByDomainColumnDirection:@"DESC"
                                                  db:db
@@ -3467,7 +3876,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSInteger)numFuelPurchaseLogsForVehicle:(FPVehicle *)vehicle
                                      error:(PELMDaoErrorBlk)errorBlk {
   __block NSInteger numEntities = 0;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     numEntities = [PELMUtils numEntitiesForParentEntity:vehicle
                                   parentEntityMainTable:TBL_MAIN_VEHICLE
                          addlJoinParentEntityMainTables:nil
@@ -3488,7 +3897,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                  newerThan:(NSDate *)newerThan
                                      error:(PELMDaoErrorBlk)errorBlk {
   __block NSInteger numEntities = 0;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     numEntities = [PELMUtils numEntitiesForParentEntity:vehicle
                                   parentEntityMainTable:TBL_MAIN_VEHICLE
                          addlJoinParentEntityMainTables:nil
@@ -3521,7 +3930,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                        beforeDateLogged:(NSDate *)beforeDateLogged
                                   error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fpLogs = @[];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     fpLogs = [self fuelPurchaseLogsForVehicle:vehicle
                                      pageSize:@(pageSize)
                              beforeDateLogged:beforeDateLogged
@@ -3534,7 +3943,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSInteger)numFuelPurchaseLogsForFuelStation:(FPFuelStation *)fuelStation
                                          error:(PELMDaoErrorBlk)errorBlk {
   __block NSInteger numEntities = 0;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     numEntities = [PELMUtils numEntitiesForParentEntity:fuelStation
                                   parentEntityMainTable:TBL_MAIN_FUEL_STATION
                          addlJoinParentEntityMainTables:_fuelstationTypeJoinTables
@@ -3555,7 +3964,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                  newerThan:(NSDate *)newerThan
                                      error:(PELMDaoErrorBlk)errorBlk {
   __block NSInteger numEntities = 0;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     numEntities = [PELMUtils numEntitiesForParentEntity:fuelStation
                                   parentEntityMainTable:TBL_MAIN_FUEL_STATION
                          addlJoinParentEntityMainTables:_fuelstationTypeJoinTables
@@ -3588,7 +3997,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                            beforeDateLogged:(NSDate *)beforeDateLogged
                                       error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *fpLogs = @[];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     fpLogs = [self fuelPurchaseLogsForFuelStation:fuelStation
                                          pageSize:@(pageSize)
                                  beforeDateLogged:beforeDateLogged
@@ -3675,7 +4084,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPVehicle *)vehicleForFuelPurchaseLog:(FPFuelPurchaseLog *)fpLog
                                    error:(PELMDaoErrorBlk)errorBlk {
   __block FPVehicle *vehicle = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     vehicle = [self vehicleForFuelPurchaseLog:fpLog db:db error:errorBlk];
   }];
   return vehicle;
@@ -3684,7 +4093,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPFuelStation *)fuelStationForFuelPurchaseLog:(FPFuelPurchaseLog *)fpLog
                                            error:(PELMDaoErrorBlk)errorBlk {
   __block FPFuelStation *fuelStation = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     fuelStation = [self fuelStationForFuelPurchaseLog:fpLog db:db error:errorBlk];
   }];
   return fuelStation;
@@ -3754,7 +4163,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPVehicle *)masterVehicleForMasterFpLog:(FPFuelPurchaseLog *)fplog
                                      error:(PELMDaoErrorBlk)errorBlk {
   __block FPVehicle *vehicle = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     vehicle = [self masterVehicleForMasterFpLog:fplog db:db error:errorBlk];
   }];
   return vehicle;
@@ -3776,7 +4185,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPFuelStation *)masterFuelstationForMasterFpLog:(FPFuelPurchaseLog *)fplog
                                              error:(PELMDaoErrorBlk)errorBlk {
   __block FPFuelStation *fuelstation = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     fuelstation = [self masterFuelstationForMasterFpLog:fplog db:db error:errorBlk];
   }];
   return fuelstation;
@@ -3797,7 +4206,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 
 - (FPVehicle *)vehicleForMostRecentFuelPurchaseLogForUser:(FPUser *)user error:(PELMDaoErrorBlk)errorBlk {
   __block FPVehicle *vehicle = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     vehicle = [self vehicleForMostRecentFuelPurchaseLogForUser:user db:db error:errorBlk];
     if (!vehicle) {
       NSArray *vehicles = [self vehiclesForUser:user db:db error:errorBlk];
@@ -3813,7 +4222,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                   currentLocation:(CLLocation *)currentLocation
                                                             error:(PELMDaoErrorBlk)errorBlk {
   __block FPFuelStation *fuelStation = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     FPFuelStation *(^fallbackIfNoLocation)(void) = ^ FPFuelStation * (void) {
       FPFuelStation *fs =
       [self fuelStationForMostRecentFuelPurchaseLogForUser:user db:db error:errorBlk];
@@ -3856,8 +4265,8 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                   db:(FMDatabase *)db
                                error:(PELMDaoErrorBlk)errorBlk {
   return [self fuelPurchaseLogsForParentEntity:user
-                         parentEntityMainTable:TBL_MAIN_USER
-                   parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
+                             parentMasterTable:TBL_MASTER_USER
+                               parentMainTable:TBL_MAIN_USER
                     parentEntityMasterIdColumn:COL_MASTER_USER_ID
                       parentEntityMainIdColumn:COL_MAIN_USER_ID
                                       pageSize:pageSize
@@ -3872,8 +4281,8 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                      db:(FMDatabase *)db
                                   error:(PELMDaoErrorBlk)errorBlk {
   return [self fuelPurchaseLogsForParentEntity:vehicle
-                         parentEntityMainTable:TBL_MAIN_VEHICLE
-                   parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
+                             parentMasterTable:TBL_MASTER_VEHICLE
+                               parentMainTable:TBL_MAIN_VEHICLE
                     parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
                       parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
                                       pageSize:pageSize
@@ -3888,8 +4297,8 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                          db:(FMDatabase *)db
                                       error:(PELMDaoErrorBlk)errorBlk {
   return [self fuelPurchaseLogsForParentEntity:fuelStation
-                         parentEntityMainTable:TBL_MAIN_FUEL_STATION
-                   parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainFuelStationFromResultSet:rs];}
+                             parentMasterTable:TBL_MASTER_FUEL_STATION
+                               parentMainTable:TBL_MAIN_FUEL_STATION
                     parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
                       parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
                                       pageSize:pageSize
@@ -3898,35 +4307,35 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                          error:errorBlk];
 }
 
-- (NSArray *)fuelPurchaseLogsForParentEntity:(PELMModelSupport *)parentEntity
-                       parentEntityMainTable:(NSString *)parentEntityMainTable
-                 parentEntityMainRsConverter:(PELMEntityFromResultSetBlk)parentEntityMainRsConverter
+- (NSArray *)fuelPurchaseLogsForParentEntity:(PELMMainSupport *)parentEntity
+                           parentMasterTable:(NSString *)parentMasterTable
+                             parentMainTable:(NSString *)parentMainTable
                   parentEntityMasterIdColumn:(NSString *)parentEntityMasterIdCol
                     parentEntityMainIdColumn:(NSString *)parentEntityMainIdCol
                                     pageSize:(NSNumber *)pageSize
                             beforeDateLogged:(NSDate *)beforeDateLogged
                                           db:(FMDatabase *)db
                                        error:(PELMDaoErrorBlk)errorBlk {
-  return [PELMUtils entitiesForParentEntity:parentEntity
-                      parentEntityMainTable:parentEntityMainTable
-             addlJoinParentEntityMainTables:nil
-                parentEntityMainRsConverter:parentEntityMainRsConverter
-                 parentEntityMasterIdColumn:parentEntityMasterIdCol
-                   parentEntityMainIdColumn:parentEntityMainIdCol
-                                   pageSize:pageSize
-                          pageBoundaryWhere:[NSString stringWithFormat:@"%@ < ?", COL_FUELPL_PURCHASED_AT]
-                            pageBoundaryArg:[PEUtils millisecondsFromDate:beforeDateLogged]
-                          entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
-                 addlJoinEntityMasterTables:nil
-             masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
-                            entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                   addlJoinEntityMainTables:nil
-               mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
-                          comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPFuelPurchaseLog *)o2 purchasedAt] compare:[(FPFuelPurchaseLog *)o1 purchasedAt]];}
-                        orderByDomainColumn:COL_FUELPL_PURCHASED_AT
-               orderByDomainColumnDirection:@"DESC"
-                                         db:db
-                                      error:errorBlk];
+  NSMutableArray *whereArgs = [NSMutableArray array];
+  return [self effectiveEntitiesForParentEntity:parentEntity
+                              parentMasterTable:parentMasterTable
+                                parentMainTable:parentMainTable
+                     parentEntityMasterIdColumn:parentEntityMasterIdCol
+                       parentEntityMainIdColumn:parentEntityMainIdCol
+                              entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
+                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSet:rs];}
+                                       whereBlk:[self dateBoundsWhereBlkForDateColumn:COL_FUELPL_PURCHASED_AT
+                                                                           beforeDate:beforeDateLogged
+                                                                        onOrAfterDate:nil
+                                                                            whereArgs:whereArgs]
+                                      whereArgs:whereArgs
+                            orderByDomainColumn:COL_FUELPL_PURCHASED_AT
+                   orderByDomainColumnDirection:@"DESC"
+                                       pageSize:pageSize
+                                             db:db
+                                          error:errorBlk];
 }
 
 - (void)persistDeepFuelPurchaseLogFromRemoteMaster:(FPFuelPurchaseLog *)fuelPurchaseLog
@@ -3937,6 +4346,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                              forUser:user
                                                   db:db
                                                error:errorBlk];
+    [self refreshMonthlyRollupsWithDb:db error:errorBlk];
   }];
 }
 
@@ -4019,6 +4429,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                           fuelStation:fuelStation
                                    db:db
                                 error:errorBlk];
+  [self refreshMonthlyRollupsWithDb:db error:errorBlk];
 }
 
 - (BOOL)prepareFuelPurchaseLogForEdit:(FPFuelPurchaseLog *)fuelPurchaseLog
@@ -4075,6 +4486,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                             forUser:user
                                                  db:db
                                               error:errorBlk];
+    [self refreshMonthlyRollupsWithDb:db error:errorBlk];
   }];
   return returnVal;
 }
@@ -4104,6 +4516,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
               argsArray:[self updateArgsForMainFuelPurchaseLog:fuelPurchaseLog vehicle:vehicle fuelStation:fuelStation]
                      db:db
                   error:errorBlk];
+    [self refreshMonthlyRollupsWithDb:db error:errorBlk];
   }];
 }
 
@@ -4114,6 +4527,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                              mainUpdateStmt:[self updateStmtForMainFuelPurchaseLogSansVehicleFuelStationFks]
                           mainUpdateArgsBlk:^NSArray *(PELMMainSupport *entity){return [self updateArgsForMainFuelPurchaseLog:(FPFuelPurchaseLog *)entity];}
                                       error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
 }
 
 - (void)markAsDoneEditingImmediateSyncFuelPurchaseLog:(FPFuelPurchaseLog *)fuelPurchaseLog
@@ -4123,6 +4537,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                           mainUpdateStmt:[self updateStmtForMainFuelPurchaseLogSansVehicleFuelStationFks]
                                        mainUpdateArgsBlk:^NSArray *(PELMMainSupport *entity){return [self updateArgsForMainFuelPurchaseLog:(FPFuelPurchaseLog *)entity];}
                                                    error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
 }
 
 - (void)reloadFuelPurchaseLog:(FPFuelPurchaseLog *)fuelPurchaseLog
@@ -4143,16 +4558,19 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                            masterTable:TBL_MASTER_FUELPURCHASE_LOG
                            rsConverter:^(FMResultSet *rs){return [self masterFuelPurchaseLogFromResultSet:rs];}
                                  error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
 }
 
 - (NSArray *)markFuelPurchaseLogsAsSyncInProgressForUser:(FPUser *)user
                                                    error:(PELMDaoErrorBlk)errorBlk {
-  return [self.localModelUtils markEntitiesAsSyncInProgressInMainTable:TBL_MAIN_FUELPURCHASE_LOG
-                                              addlJoinEntityMainTables:nil
-                                                   entityFromResultSet:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSetForSync:rs];}
-                                                            updateStmt:[self updateStmtForMainFuelPurchaseLogSansVehicleFuelStationFks]
-                                                         updateArgsBlk:^NSArray *(PELMMainSupport *entity){return [self updateArgsForMainFuelPurchaseLog:(FPFuelPurchaseLog *)entity];}
-                                                                 error:errorBlk];
+  NSArray *fplogs = [self.localModelUtils markEntitiesAsSyncInProgressInMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                                                         addlJoinEntityMainTables:nil
+                                                              entityFromResultSet:^(FMResultSet *rs){return [self mainFuelPurchaseLogFromResultSetForSync:rs];}
+                                                                       updateStmt:[self updateStmtForMainFuelPurchaseLogSansVehicleFuelStationFks]
+                                                                    updateArgsBlk:^NSArray *(PELMMainSupport *entity){return [self updateArgsForMainFuelPurchaseLog:(FPFuelPurchaseLog *)entity];}
+                                                                            error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
+  return fplogs;
 }
 
 - (void)cancelSyncForFuelPurchaseLog:(FPFuelPurchaseLog *)fuelPurchaseLog
@@ -4167,6 +4585,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                          mainUpdateStmt:[self updateStmtForMainFuelPurchaseLogSansVehicleFuelStationFks]
                       mainUpdateArgsBlk:^NSArray *(PELMMainSupport *entity){return [self updateArgsForMainFuelPurchaseLog:(FPFuelPurchaseLog *)entity];}
                                   error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
 }
 
 - (PELMSaveNewOrExistingCode)saveNewOrExistingMasterFuelPurchaseLog:(FPFuelPurchaseLog *)fplog
@@ -4193,18 +4612,20 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                    forFuelstation:(FPFuelStation *)fuelstation
                           forUser:(FPUser *)user
                             error:(PELMDaoErrorBlk)errorBlk {
-  return [self.localModelUtils saveMasterEntity:fplog
-                                masterTable:TBL_MASTER_FUELPURCHASE_LOG
-                           masterUpdateStmt:[self updateStmtForMasterFuelPurchaseLog]
-                        masterUpdateArgsBlk:^ NSArray * (FPFuelPurchaseLog *theFplog) { return [self updateArgsForMasterFuelPurchaseLog:theFplog vehicle:vehicle fuelStation:fuelstation]; }
-                                  mainTable:TBL_MAIN_FUELPURCHASE_LOG
-                    mainEntityFromResultSet:^ FPFuelPurchaseLog * (FMResultSet *rs) { return [self mainFuelPurchaseLogFromResultSet:rs]; }
-                             mainUpdateStmt:[self updateStmtForMainFuelPurchaseLog]
-                          mainUpdateArgsBlk:^ NSArray * (FPFuelPurchaseLog *theFplog) { return [self updateArgsForMainFuelPurchaseLog:theFplog vehicle:vehicle fuelStation:fuelstation]; }
-                                      error:errorBlk];
-}
-
-- (void)markAsSyncCompleteForNewFuelPurchaseLog:(FPFuelPurchaseLog *)fuelPurchaseLog
+  BOOL saved = [self.localModelUtils saveMasterEntity:fplog
+                                      masterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                 masterUpdateStmt:[self updateStmtForMasterFuelPurchaseLog]
+                              masterUpdateArgsBlk:^ NSArray * (FPFuelPurchaseLog *theFplog) { return [self updateArgsForMasterFuelPurchaseLog:theFplog vehicle:vehicle fuelStation:fuelstation]; }
+                                        mainTable:TBL_MAIN_FUELPURCHASE_LOG
+                          mainEntityFromResultSet:^ FPFuelPurchaseLog * (FMResultSet *rs) { return [self mainFuelPurchaseLogFromResultSet:rs]; }
+                                   mainUpdateStmt:[self updateStmtForMainFuelPurchaseLog]
+                                mainUpdateArgsBlk:^ NSArray * (FPFuelPurchaseLog *theFplog) { return [self updateArgsForMainFuelPurchaseLog:theFplog vehicle:vehicle fuelStation:fuelstation]; }
+                                            error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
+  return saved;
+}
+
+- (void)markAsSyncCompleteForNewFuelPurchaseLog:(FPFuelPurchaseLog *)fuelPurchaseLog
                                         forUser:(FPUser *)user
                                           error:(PELMDaoErrorBlk)errorBlk {
   [self.localModelUtils markAsSyncCompleteForNewEntity:fuelPurchaseLog
@@ -4217,6 +4638,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                                                                                    db:db
                                                                                                                 error:errorBlk];}
                                              error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
 }
 
 - (void)markAsSyncCompleteForUpdatedFuelPurchaseLog:(FPFuelPurchaseLog *)fuelPurchaseLog
@@ -4249,6 +4671,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                                                                           fuelStation:masterFuelStation];}
                                                       db:db
                                                    error:errorBlk];
+    [self refreshMonthlyRollupsWithDb:db error:errorBlk];
   }];
 }
 
@@ -4257,13 +4680,11 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPEnvironmentLog *)minMaxReportedMphOdometerLogForUser:(FPUser *)user
                                                  whereBlk:(NSString *(^)(NSString *))whereBlk
                                                 whereArgs:(NSArray *)whereArgs
-                                        comparatorForSort:(NSComparisonResult(^)(id, id))comparatorForSort
                              orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
                                                     error:(PELMDaoErrorBlk)errorBlk {
   return [self singleOdometerLogForUser:user
                                whereBlk:whereBlk
                               whereArgs:whereArgs
-                      comparatorForSort:comparatorForSort
                     orderByDomainColumn:COL_ENVL_MPH_READING
            orderByDomainColumnDirection:orderByDomainColumnDirection
                                   error:errorBlk];
@@ -4272,36 +4693,44 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPEnvironmentLog *)minMaxReportedMphOdometerLogForVehicle:(FPVehicle *)vehicle
                                                     whereBlk:(NSString *(^)(NSString *))whereBlk
                                                    whereArgs:(NSArray *)whereArgs
-                                           comparatorForSort:(NSComparisonResult(^)(id, id))comparatorForSort
                                 orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
                                                        error:(PELMDaoErrorBlk)errorBlk {
   return [self singleOdometerLogForVehicle:vehicle
                                   whereBlk:whereBlk
                                  whereArgs:whereArgs
-                         comparatorForSort:comparatorForSort
                        orderByDomainColumn:COL_ENVL_MPH_READING
               orderByDomainColumnDirection:orderByDomainColumnDirection
                                      error:errorBlk];
 }
 
 - (NSString *(^)(NSString *))envlogDateRangeNonNilReportedMphWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ is not null",
-            colPrefix,
-            COL_ENVL_LOG_DT,
-            colPrefix,
-            COL_ENVL_LOG_DT,
-            colPrefix,
-            COL_ENVL_MPH_READING];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ is not null",
+              colPrefix,
+              COL_ENVL_LOG_DT,
+              colPrefix,
+              COL_ENVL_LOG_DT,
+              colPrefix,
+              COL_ENVL_MPH_READING];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))envlogNonNilReportedMphWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ is not null",
-            colPrefix,
-            COL_ENVL_MPH_READING];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ is not null",
+              colPrefix,
+              COL_ENVL_MPH_READING];
+    });
+  });
+  return whereBlk;
 }
 
 - (FPEnvironmentLog *)maxReportedMphOdometerLogForUser:(FPUser *)user
@@ -4312,7 +4741,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                           whereBlk:[self envlogDateRangeNonNilReportedMphWhereBlk]
                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                      [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 reportedAvgMph] compare:[(FPEnvironmentLog *)o1 reportedAvgMph]];}
                       orderByDomainColumnDirection:@"DESC"
                                              error:errorBlk];
 }
@@ -4325,7 +4753,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                              whereBlk:[self envlogDateRangeNonNilReportedMphWhereBlk]
                                             whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                         [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 reportedAvgMph] compare:[(FPEnvironmentLog *)o1 reportedAvgMph]];}
                          orderByDomainColumnDirection:@"DESC"
                                                 error:errorBlk];
 }
@@ -4338,7 +4765,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                           whereBlk:[self envlogDateRangeNonNilReportedMphWhereBlk]
                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                      [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 reportedAvgMph] compare:[(FPEnvironmentLog *)o2 reportedAvgMph]];}
                       orderByDomainColumnDirection:@"ASC"
                                              error:errorBlk];
 }
@@ -4351,7 +4777,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                              whereBlk:[self envlogDateRangeNonNilReportedMphWhereBlk]
                                             whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                         [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 reportedAvgMph] compare:[(FPEnvironmentLog *)o2 reportedAvgMph]];}
                          orderByDomainColumnDirection:@"ASC"
                                                 error:errorBlk];
 }
@@ -4361,7 +4786,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxReportedMphOdometerLogForUser:user
                                           whereBlk:[self envlogNonNilReportedMphWhereBlk]
                                          whereArgs:nil
-                                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 reportedAvgMph] compare:[(FPEnvironmentLog *)o1 reportedAvgMph]];}
                       orderByDomainColumnDirection:@"DESC" error:errorBlk];
 }
 
@@ -4370,7 +4794,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxReportedMphOdometerLogForVehicle:vehicle
                                              whereBlk:[self envlogNonNilReportedMphWhereBlk]
                                             whereArgs:nil
-                                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 reportedAvgMph] compare:[(FPEnvironmentLog *)o1 reportedAvgMph]];}
                          orderByDomainColumnDirection:@"DESC" error:errorBlk];
 }
 
@@ -4379,7 +4802,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxReportedMphOdometerLogForUser:user
                                           whereBlk:[self envlogNonNilReportedMphWhereBlk]
                                          whereArgs:nil
-                                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 reportedAvgMph] compare:[(FPEnvironmentLog *)o2 reportedAvgMph]];}
                       orderByDomainColumnDirection:@"ASC" error:errorBlk];
 }
 
@@ -4388,20 +4810,17 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxReportedMphOdometerLogForVehicle:vehicle
                                              whereBlk:[self envlogNonNilReportedMphWhereBlk]
                                             whereArgs:nil
-                                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 reportedAvgMph] compare:[(FPEnvironmentLog *)o2 reportedAvgMph]];}
                          orderByDomainColumnDirection:@"ASC" error:errorBlk];
 }
 
 - (FPEnvironmentLog *)minMaxReportedMpgOdometerLogForUser:(FPUser *)user
                                                  whereBlk:(NSString *(^)(NSString *))whereBlk
                                                 whereArgs:(NSArray *)whereArgs
-                                        comparatorForSort:(NSComparisonResult(^)(id, id))comparatorForSort
                              orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
                                                     error:(PELMDaoErrorBlk)errorBlk {
   return [self singleOdometerLogForUser:user
                                whereBlk:whereBlk
                               whereArgs:whereArgs
-                      comparatorForSort:comparatorForSort
                     orderByDomainColumn:COL_ENVL_MPG_READING
            orderByDomainColumnDirection:orderByDomainColumnDirection
                                   error:errorBlk];
@@ -4410,36 +4829,44 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPEnvironmentLog *)minMaxReportedMpgOdometerLogForVehicle:(FPVehicle *)vehicle
                                                     whereBlk:(NSString *(^)(NSString *))whereBlk
                                                    whereArgs:(NSArray *)whereArgs
-                                           comparatorForSort:(NSComparisonResult(^)(id, id))comparatorForSort
                                 orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
                                                        error:(PELMDaoErrorBlk)errorBlk {
   return [self singleOdometerLogForVehicle:vehicle
                                   whereBlk:whereBlk
                                  whereArgs:whereArgs
-                         comparatorForSort:comparatorForSort
                        orderByDomainColumn:COL_ENVL_MPG_READING
               orderByDomainColumnDirection:orderByDomainColumnDirection
                                      error:errorBlk];
 }
 
 - (NSString *(^)(NSString *))envlogDateRangeNonNilReportedMpgWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ is not null",
-            colPrefix,
-            COL_ENVL_LOG_DT,
-            colPrefix,
-            COL_ENVL_LOG_DT,
-            colPrefix,
-            COL_ENVL_MPG_READING];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ is not null",
+              colPrefix,
+              COL_ENVL_LOG_DT,
+              colPrefix,
+              COL_ENVL_LOG_DT,
+              colPrefix,
+              COL_ENVL_MPG_READING];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))envlogNonNilReportedMpgWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ is not null",
-            colPrefix,
-            COL_ENVL_MPG_READING];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ is not null",
+              colPrefix,
+              COL_ENVL_MPG_READING];
+    });
+  });
+  return whereBlk;
 }
 
 - (FPEnvironmentLog *)maxReportedMpgOdometerLogForUser:(FPUser *)user
@@ -4450,7 +4877,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                           whereBlk:[self envlogDateRangeNonNilReportedMpgWhereBlk]
                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                      [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 reportedAvgMpg] compare:[(FPEnvironmentLog *)o1 reportedAvgMpg]];}
                       orderByDomainColumnDirection:@"DESC"
                                              error:errorBlk];
 }
@@ -4463,7 +4889,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                              whereBlk:[self envlogDateRangeNonNilReportedMpgWhereBlk]
                                             whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                         [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 reportedAvgMpg] compare:[(FPEnvironmentLog *)o1 reportedAvgMpg]];}
                          orderByDomainColumnDirection:@"DESC"
                                                 error:errorBlk];
 }
@@ -4476,7 +4901,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                           whereBlk:[self envlogDateRangeNonNilReportedMpgWhereBlk]
                                          whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                      [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 reportedAvgMpg] compare:[(FPEnvironmentLog *)o2 reportedAvgMpg]];}
                       orderByDomainColumnDirection:@"ASC"
                                              error:errorBlk];
 }
@@ -4489,7 +4913,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                              whereBlk:[self envlogDateRangeNonNilReportedMpgWhereBlk]
                                             whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                                         [PEUtils millisecondsFromDate:onOrAfterDate]]
-                                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 reportedAvgMpg] compare:[(FPEnvironmentLog *)o2 reportedAvgMpg]];}
                          orderByDomainColumnDirection:@"ASC"
                                                 error:errorBlk];
 }
@@ -4499,7 +4922,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxReportedMpgOdometerLogForUser:user
                                           whereBlk:[self envlogNonNilReportedMpgWhereBlk]
                                          whereArgs:nil
-                                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 reportedAvgMpg] compare:[(FPEnvironmentLog *)o1 reportedAvgMpg]];}
                       orderByDomainColumnDirection:@"DESC" error:errorBlk];
 }
 
@@ -4508,7 +4930,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxReportedMpgOdometerLogForVehicle:vehicle
                                              whereBlk:[self envlogNonNilReportedMpgWhereBlk]
                                             whereArgs:nil
-                                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 reportedAvgMpg] compare:[(FPEnvironmentLog *)o1 reportedAvgMpg]];}
                          orderByDomainColumnDirection:@"DESC" error:errorBlk];
 }
 
@@ -4517,7 +4938,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxReportedMpgOdometerLogForUser:user
                                           whereBlk:[self envlogNonNilReportedMpgWhereBlk]
                                          whereArgs:nil
-                                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 reportedAvgMpg] compare:[(FPEnvironmentLog *)o2 reportedAvgMpg]];}
                       orderByDomainColumnDirection:@"ASC" error:errorBlk];
 }
 
@@ -4526,51 +4946,59 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self minMaxReportedMpgOdometerLogForVehicle:vehicle
                                              whereBlk:[self envlogNonNilReportedMpgWhereBlk]
                                             whereArgs:nil
-                                    comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 reportedAvgMpg] compare:[(FPEnvironmentLog *)o2 reportedAvgMpg]];}
                          orderByDomainColumnDirection:@"ASC" error:errorBlk];
 }
 
 - (NSString *(^)(NSString *))envlogDateRangeWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ?",
-            colPrefix,
-            COL_ENVL_LOG_DT,
-            colPrefix,
-            COL_ENVL_LOG_DT];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ?",
+              colPrefix,
+              COL_ENVL_LOG_DT,
+              colPrefix,
+              COL_ENVL_LOG_DT];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))envlogStrictDateRangeWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ > ?",
-            colPrefix,
-            COL_ENVL_LOG_DT,
-            colPrefix,
-            COL_ENVL_LOG_DT];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ > ?",
+              colPrefix,
+              COL_ENVL_LOG_DT,
+              colPrefix,
+              COL_ENVL_LOG_DT];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSArray *)unorderedEnvironmentLogsForVehicle:(FPVehicle *)vehicle
                                           error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *envlogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    envlogs = [PELMUtils entitiesForParentEntity:vehicle
-                           parentEntityMainTable:TBL_MAIN_VEHICLE
-                  addlJoinParentEntityMainTables:nil
-                     parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                      parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                        parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                        pageSize:nil
-                                        whereBlk:nil
-                                       whereArgs:nil
-                               entityMasterTable:TBL_MASTER_ENV_LOG
-                      addlJoinEntityMasterTables:nil
-                  masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
-                                 entityMainTable:TBL_MAIN_ENV_LOG
-                        addlJoinEntityMainTables:nil
-                    mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
-                                              db:db
-                                           error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    envlogs = [self effectiveEntitiesForParentEntity:vehicle
+                                   parentMasterTable:TBL_MASTER_VEHICLE
+                                     parentMainTable:TBL_MAIN_VEHICLE
+                          parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                            parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                   entityMasterTable:TBL_MASTER_ENV_LOG
+                                     entityMainTable:TBL_MAIN_ENV_LOG
+                      masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
+                        mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
+                                            whereBlk:nil
+                                           whereArgs:nil
+                                 orderByDomainColumn:nil
+                        orderByDomainColumnDirection:nil
+                                            pageSize:nil
+                                                  db:db
+                                               error:errorBlk];
   }];
   return envlogs;
 }
@@ -4580,25 +5008,24 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                   onOrAfterDate:(NSDate *)onOrAfterDate
                                           error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *envlogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    envlogs = [PELMUtils entitiesForParentEntity:vehicle
-                           parentEntityMainTable:TBL_MAIN_VEHICLE
-                  addlJoinParentEntityMainTables:nil
-                     parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                      parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                        parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                        pageSize:nil
-                                        whereBlk:[self envlogDateRangeWhereBlk]
-                                       whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                   [PEUtils millisecondsFromDate:onOrAfterDate]]
-                               entityMasterTable:TBL_MASTER_ENV_LOG
-                      addlJoinEntityMasterTables:nil
-                  masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
-                                 entityMainTable:TBL_MAIN_ENV_LOG
-                        addlJoinEntityMainTables:nil
-                    mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
-                                              db:db
-                                           error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    envlogs = [self effectiveEntitiesForParentEntity:vehicle
+                                   parentMasterTable:TBL_MASTER_VEHICLE
+                                     parentMainTable:TBL_MAIN_VEHICLE
+                          parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                            parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                   entityMasterTable:TBL_MASTER_ENV_LOG
+                                     entityMainTable:TBL_MAIN_ENV_LOG
+                      masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
+                        mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
+                                            whereBlk:[self envlogDateRangeWhereBlk]
+                                           whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                       [PEUtils millisecondsFromDate:onOrAfterDate]]
+                                 orderByDomainColumn:nil
+                        orderByDomainColumnDirection:nil
+                                            pageSize:nil
+                                                  db:db
+                                               error:errorBlk];
   }];
   return envlogs;
 
@@ -4609,25 +5036,24 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                       afterDate:(NSDate *)afterDate
                                           error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *envlogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    envlogs = [PELMUtils entitiesForParentEntity:vehicle
-                           parentEntityMainTable:TBL_MAIN_VEHICLE
-                  addlJoinParentEntityMainTables:nil
-                     parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                      parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                        parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                        pageSize:nil
-                                        whereBlk:[self envlogStrictDateRangeWhereBlk]
-                                       whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                   [PEUtils millisecondsFromDate:afterDate]]
-                               entityMasterTable:TBL_MASTER_ENV_LOG
-                      addlJoinEntityMasterTables:nil
-                  masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
-                                 entityMainTable:TBL_MAIN_ENV_LOG
-                        addlJoinEntityMainTables:nil
-                    mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
-                                              db:db
-                                           error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    envlogs = [self effectiveEntitiesForParentEntity:vehicle
+                                   parentMasterTable:TBL_MASTER_VEHICLE
+                                     parentMainTable:TBL_MAIN_VEHICLE
+                          parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                            parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                   entityMasterTable:TBL_MASTER_ENV_LOG
+                                     entityMainTable:TBL_MAIN_ENV_LOG
+                      masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
+                        mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
+                                            whereBlk:[self envlogStrictDateRangeWhereBlk]
+                                           whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                       [PEUtils millisecondsFromDate:afterDate]]
+                                 orderByDomainColumn:nil
+                        orderByDomainColumnDirection:nil
+                                            pageSize:nil
+                                                  db:db
+                                               error:errorBlk];
   }];
   return envlogs;
 }
@@ -4635,24 +5061,23 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSArray *)unorderedEnvironmentLogsForUser:(FPUser *)user
                                        error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *envlogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    envlogs = [PELMUtils entitiesForParentEntity:user
-                           parentEntityMainTable:TBL_MAIN_USER
-                  addlJoinParentEntityMainTables:nil
-                     parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
-                      parentEntityMasterIdColumn:COL_MASTER_USER_ID
-                        parentEntityMainIdColumn:COL_MAIN_USER_ID
-                                        pageSize:nil
-                                        whereBlk:nil
-                                       whereArgs:nil
-                               entityMasterTable:TBL_MASTER_ENV_LOG
-                      addlJoinEntityMasterTables:nil
-                  masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
-                                 entityMainTable:TBL_MAIN_ENV_LOG
-                        addlJoinEntityMainTables:nil
-                    mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
-                                              db:db
-                                           error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    envlogs = [self effectiveEntitiesForParentEntity:user
+                                   parentMasterTable:TBL_MASTER_USER
+                                     parentMainTable:TBL_MAIN_USER
+                          parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                            parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                   entityMasterTable:TBL_MASTER_ENV_LOG
+                                     entityMainTable:TBL_MAIN_ENV_LOG
+                      masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
+                        mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
+                                            whereBlk:nil
+                                           whereArgs:nil
+                                 orderByDomainColumn:nil
+                        orderByDomainColumnDirection:nil
+                                            pageSize:nil
+                                                  db:db
+                                               error:errorBlk];
   }];
   return envlogs;
 }
@@ -4662,25 +5087,24 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                onOrAfterDate:(NSDate *)onOrAfterDate
                                        error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *envlogs = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    envlogs = [PELMUtils entitiesForParentEntity:user
-                           parentEntityMainTable:TBL_MAIN_USER
-                  addlJoinParentEntityMainTables:nil
-                     parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
-                      parentEntityMasterIdColumn:COL_MASTER_USER_ID
-                        parentEntityMainIdColumn:COL_MAIN_USER_ID
-                                        pageSize:nil
-                                        whereBlk:[self envlogDateRangeWhereBlk]
-                                       whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
-                                                   [PEUtils millisecondsFromDate:onOrAfterDate]]
-                               entityMasterTable:TBL_MASTER_ENV_LOG
-                      addlJoinEntityMasterTables:nil
-                  masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
-                                 entityMainTable:TBL_MAIN_ENV_LOG
-                        addlJoinEntityMainTables:nil
-                    mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
-                                              db:db
-                                           error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    envlogs = [self effectiveEntitiesForParentEntity:user
+                                   parentMasterTable:TBL_MASTER_USER
+                                     parentMainTable:TBL_MAIN_USER
+                          parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                            parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                   entityMasterTable:TBL_MASTER_ENV_LOG
+                                     entityMainTable:TBL_MAIN_ENV_LOG
+                      masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
+                        mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
+                                            whereBlk:[self envlogDateRangeWhereBlk]
+                                           whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
+                                                       [PEUtils millisecondsFromDate:onOrAfterDate]]
+                                 orderByDomainColumn:nil
+                        orderByDomainColumnDirection:nil
+                                            pageSize:nil
+                                                  db:db
+                                               error:errorBlk];
   }];
   return envlogs;
 }
@@ -4688,32 +5112,27 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPEnvironmentLog *)singleOdometerLogForUser:(FPUser *)user
                                       whereBlk:(NSString *(^)(NSString *))whereBlk
                                      whereArgs:(NSArray *)whereArgs
-                             comparatorForSort:(NSComparisonResult(^)(id, id))comparatorForSort
                            orderByDomainColumn:(NSString *)orderByDomainColumn
                   orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
                                          error:(PELMDaoErrorBlk)errorBlk {
   __block FPEnvironmentLog *envlog = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    NSArray *envlogs = [PELMUtils entitiesForParentEntity:user
-                                    parentEntityMainTable:TBL_MAIN_USER
-                           addlJoinParentEntityMainTables:nil
-                              parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
-                               parentEntityMasterIdColumn:COL_MASTER_USER_ID
-                                 parentEntityMainIdColumn:COL_MAIN_USER_ID
-                                                 pageSize:@(1)
-                                                 whereBlk:whereBlk
-                                                whereArgs:whereArgs
-                                        entityMasterTable:TBL_MASTER_ENV_LOG
-                               addlJoinEntityMasterTables:nil
-                           masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
-                                          entityMainTable:TBL_MAIN_ENV_LOG
-                                 addlJoinEntityMainTables:nil
-                             mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
-                                        comparatorForSort:comparatorForSort
-                                      orderByDomainColumn:orderByDomainColumn
-                             orderByDomainColumnDirection:orderByDomainColumnDirection
-                                                       db:db
-                                                    error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    NSArray *envlogs = [self effectiveEntitiesForParentEntity:user
+                                            parentMasterTable:TBL_MASTER_USER
+                                              parentMainTable:TBL_MAIN_USER
+                                   parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                                     parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                            entityMasterTable:TBL_MASTER_ENV_LOG
+                                              entityMainTable:TBL_MAIN_ENV_LOG
+                               masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
+                                 mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
+                                                     whereBlk:whereBlk
+                                                    whereArgs:whereArgs
+                                          orderByDomainColumn:orderByDomainColumn
+                                 orderByDomainColumnDirection:orderByDomainColumnDirection
+                                                     pageSize:@(1)
+                                                           db:db
+                                                        error:errorBlk];
 
     if ([envlogs count] > 0) {
       envlog = envlogs[0];
@@ -4725,32 +5144,27 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPEnvironmentLog *)singleOdometerLogForVehicle:(FPVehicle *)vehicle
                                          whereBlk:(NSString *(^)(NSString *))whereBlk
                                         whereArgs:(NSArray *)whereArgs
-                                comparatorForSort:(NSComparisonResult(^)(id, id))comparatorForSort
                               orderByDomainColumn:(NSString *)orderByDomainColumn
                      orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
                                             error:(PELMDaoErrorBlk)errorBlk {
   __block FPEnvironmentLog *envlog = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
-    NSArray *envlogs = [PELMUtils entitiesForParentEntity:vehicle
-                                    parentEntityMainTable:TBL_MAIN_VEHICLE
-                           addlJoinParentEntityMainTables:nil
-                              parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
-                               parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
-                                 parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
-                                                 pageSize:@(1)
-                                                 whereBlk:whereBlk
-                                                whereArgs:whereArgs
-                                        entityMasterTable:TBL_MASTER_ENV_LOG
-                               addlJoinEntityMasterTables:nil
-                           masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
-                                          entityMainTable:TBL_MAIN_ENV_LOG
-                                 addlJoinEntityMainTables:nil
-                             mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
-                                        comparatorForSort:comparatorForSort
-                                      orderByDomainColumn:orderByDomainColumn
-                             orderByDomainColumnDirection:orderByDomainColumnDirection
-                                                       db:db
-                                                    error:errorBlk];
+  [self inReadDatabase:^(FMDatabase *db) {
+    NSArray *envlogs = [self effectiveEntitiesForParentEntity:vehicle
+                                            parentMasterTable:TBL_MASTER_VEHICLE
+                                              parentMainTable:TBL_MAIN_VEHICLE
+                                   parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                                     parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                            entityMasterTable:TBL_MASTER_ENV_LOG
+                                              entityMainTable:TBL_MAIN_ENV_LOG
+                               masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
+                                 mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
+                                                     whereBlk:whereBlk
+                                                    whereArgs:whereArgs
+                                          orderByDomainColumn:orderByDomainColumn
+                                 orderByDomainColumnDirection:orderByDomainColumnDirection
+                                                     pageSize:@(1)
+                                                           db:db
+                                                        error:errorBlk];
     if ([envlogs count] > 0) {
       envlog = envlogs[0];
     }
@@ -4759,43 +5173,67 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 }
 
 - (NSString *(^)(NSString *))odometerLogNonNilOdometerWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ is not null", colPrefix, COL_ENVL_ODOMETER_READING];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ is not null", colPrefix, COL_ENVL_ODOMETER_READING];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))odometerLogDateRangeNonNilOdometerWhereBlk {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ is not null",
-            colPrefix,
-            COL_ENVL_LOG_DT,
-            colPrefix,
-            COL_ENVL_LOG_DT,
-            colPrefix,
-            COL_ENVL_ODOMETER_READING];
-  };
+  static FPWhereBlk whereBlk;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlk = FPWhereTemplate(^(NSString *colPrefix) {
+      return [NSString stringWithFormat:@"%@%@ < ? AND %@%@ >= ? AND %@%@ is not null",
+              colPrefix,
+              COL_ENVL_LOG_DT,
+              colPrefix,
+              COL_ENVL_LOG_DT,
+              colPrefix,
+              COL_ENVL_ODOMETER_READING];
+    });
+  });
+  return whereBlk;
 }
 
 - (NSString *(^)(NSString *))odometerLogDateCompareNonNilOdometerWhereBlk:(NSString *)compareDirection {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ %@ ? AND %@%@ is not null",
-            colPrefix,
-            COL_ENVL_LOG_DT,
-            compareDirection,
-            colPrefix,
-            COL_ENVL_ODOMETER_READING];
-  };
+  static NSDictionary *whereBlks;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlks = FPWhereTemplatesByCompareDirection(^(NSString *direction) {
+      return FPWhereTemplate(^(NSString *colPrefix) {
+        return [NSString stringWithFormat:@"%@%@ %@ ? AND %@%@ is not null",
+                colPrefix,
+                COL_ENVL_LOG_DT,
+                direction,
+                colPrefix,
+                COL_ENVL_ODOMETER_READING];
+      });
+    });
+  });
+  return whereBlks[compareDirection];
 }
 
 - (NSString *(^)(NSString *))odometerLogDateCompareNonNilTemperatureWhereBlk:(NSString *)compareDirection {
-  return ^(NSString *colPrefix) {
-    return [NSString stringWithFormat:@"%@%@ %@ ? AND %@%@ is not null",
-            colPrefix,
-            COL_ENVL_LOG_DT,
-            compareDirection,
-            colPrefix,
-            COL_ENVL_OUTSIDE_TEMP_READING];
-  };
+  static NSDictionary *whereBlks;
+  static dispatch_once_t onceToken;
+  dispatch_once(&onceToken, ^{
+    whereBlks = FPWhereTemplatesByCompareDirection(^(NSString *direction) {
+      return FPWhereTemplate(^(NSString *colPrefix) {
+        return [NSString stringWithFormat:@"%@%@ %@ ? AND %@%@ is not null",
+                colPrefix,
+                COL_ENVL_LOG_DT,
+                direction,
+                colPrefix,
+                COL_ENVL_OUTSIDE_TEMP_READING];
+      });
+    });
+  });
+  return whereBlks[compareDirection];
 }
 
 - (NSArray *)odometerLogNearestToDate:(NSDate *)date
@@ -4804,14 +5242,12 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   FPEnvironmentLog *lessThanDateOdometerLog = [self singleOdometerLogForVehicle:vehicle
                                                                        whereBlk:[self odometerLogDateCompareNonNilOdometerWhereBlk:@"<="]
                                                                       whereArgs:@[[PEUtils millisecondsFromDate:date]]
-                                                              comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 logDate] compare:[(FPEnvironmentLog *)o1 logDate]];}
                                                             orderByDomainColumn:COL_ENVL_LOG_DT
                                                    orderByDomainColumnDirection:@"DESC"
                                                                           error:errorBlk];
   FPEnvironmentLog *greaterThanDateOdometerLog = [self singleOdometerLogForVehicle:vehicle
                                                                           whereBlk:[self odometerLogDateCompareNonNilOdometerWhereBlk:@">="]
                                                                          whereArgs:@[[PEUtils millisecondsFromDate:date]]
-                                                                 comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 logDate] compare:[(FPEnvironmentLog *)o2 logDate]];}
                                                                orderByDomainColumn:COL_ENVL_LOG_DT
                                                       orderByDomainColumnDirection:@"ASC"
                                                                              error:errorBlk];
@@ -4828,14 +5264,12 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   FPEnvironmentLog *lessThanDateOdometerLog = [self singleOdometerLogForUser:user
                                                                     whereBlk:[self odometerLogDateCompareNonNilOdometerWhereBlk:@"<="]
                                                                    whereArgs:@[[PEUtils millisecondsFromDate:date]]
-                                                           comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 logDate] compare:[(FPEnvironmentLog *)o1 logDate]];}
                                                          orderByDomainColumn:COL_ENVL_LOG_DT
                                                 orderByDomainColumnDirection:@"DESC"
                                                                        error:errorBlk];
   FPEnvironmentLog *greaterThanDateOdometerLog = [self singleOdometerLogForUser:user
                                                                        whereBlk:[self odometerLogDateCompareNonNilOdometerWhereBlk:@">="]
                                                                       whereArgs:@[[PEUtils millisecondsFromDate:date]]
-                                                              comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 logDate] compare:[(FPEnvironmentLog *)o2 logDate]];}
                                                             orderByDomainColumn:COL_ENVL_LOG_DT
                                                    orderByDomainColumnDirection:@"ASC"
                                                                           error:errorBlk];
@@ -4852,14 +5286,12 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   FPEnvironmentLog *lessThanDateOdometerLog = [self singleOdometerLogForUser:user
                                                                     whereBlk:[self odometerLogDateCompareNonNilTemperatureWhereBlk:@"<="]
                                                                    whereArgs:@[[PEUtils millisecondsFromDate:date]]
-                                                           comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 logDate] compare:[(FPEnvironmentLog *)o1 logDate]];}
                                                          orderByDomainColumn:COL_ENVL_LOG_DT
                                                 orderByDomainColumnDirection:@"DESC"
                                                                        error:errorBlk];
   FPEnvironmentLog *greaterThanDateOdometerLog = [self singleOdometerLogForUser:user
                                                                        whereBlk:[self odometerLogDateCompareNonNilTemperatureWhereBlk:@">="]
                                                                       whereArgs:@[[PEUtils millisecondsFromDate:date]]
-                                                              comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 logDate] compare:[(FPEnvironmentLog *)o2 logDate]];}
                                                             orderByDomainColumn:COL_ENVL_LOG_DT
                                                    orderByDomainColumnDirection:@"ASC"
                                                                           error:errorBlk];
@@ -4878,7 +5310,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                   whereBlk:[self odometerLogDateRangeNonNilOdometerWhereBlk]
                                  whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                              [PEUtils millisecondsFromDate:onOrAfterDate]]
-                         comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 logDate] compare:[(FPEnvironmentLog *)o2 logDate]];}
                        orderByDomainColumn:COL_ENVL_LOG_DT
               orderByDomainColumnDirection:@"ASC"
                                      error:errorBlk];
@@ -4892,7 +5323,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                   whereBlk:[self odometerLogDateRangeNonNilOdometerWhereBlk]
                                  whereArgs:@[[PEUtils millisecondsFromDate:beforeDate],
                                              [PEUtils millisecondsFromDate:onOrAfterDate]]
-                         comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 logDate] compare:[(FPEnvironmentLog *)o1 logDate]];}
                        orderByDomainColumn:COL_ENVL_LOG_DT
               orderByDomainColumnDirection:@"DESC"
                                      error:errorBlk];
@@ -4903,7 +5333,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleOdometerLogForUser:user
                                whereBlk:[self odometerLogNonNilOdometerWhereBlk]
                               whereArgs:nil
-                      comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 logDate] compare:[(FPEnvironmentLog *)o2 logDate]];}
                     orderByDomainColumn:COL_ENVL_LOG_DT
            orderByDomainColumnDirection:@"ASC"
                                   error:errorBlk];
@@ -4914,7 +5343,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleOdometerLogForVehicle:vehicle
                                   whereBlk:[self odometerLogNonNilOdometerWhereBlk]
                                  whereArgs:nil
-                         comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o1 logDate] compare:[(FPEnvironmentLog *)o2 logDate]];}
                        orderByDomainColumn:COL_ENVL_LOG_DT
               orderByDomainColumnDirection:@"ASC"
                                      error:errorBlk];
@@ -4925,7 +5353,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleOdometerLogForUser:user
                                whereBlk:[self odometerLogNonNilOdometerWhereBlk]
                               whereArgs:nil
-                      comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 logDate] compare:[(FPEnvironmentLog *)o1 logDate]];}
                     orderByDomainColumn:COL_ENVL_LOG_DT
            orderByDomainColumnDirection:@"DESC"
                                   error:errorBlk];
@@ -4936,7 +5363,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
   return [self singleOdometerLogForVehicle:vehicle
                                   whereBlk:[self odometerLogNonNilOdometerWhereBlk]
                                  whereArgs:nil
-                         comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 logDate] compare:[(FPEnvironmentLog *)o1 logDate]];}
                        orderByDomainColumn:COL_ENVL_LOG_DT
               orderByDomainColumnDirection:@"DESC"
                                      error:errorBlk];
@@ -4945,7 +5371,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPEnvironmentLog *)masterEnvlogWithId:(NSNumber *)envlogId error:(PELMDaoErrorBlk)errorBlk {
   NSString *envlogTable = TBL_MASTER_ENV_LOG;
   __block FPEnvironmentLog *envlog = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     envlog = [PELMUtils entityFromQuery:[NSString stringWithFormat:@"SELECT * FROM %@ WHERE %@ = ?", envlogTable, COL_LOCAL_ID]
                             entityTable:envlogTable
                           localIdGetter:^NSNumber *(PELMModelSupport *entity) { return [entity localMasterIdentifier]; }
@@ -4964,7 +5390,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPEnvironmentLog *)masterEnvlogWithGlobalId:(NSString *)globalId error:(PELMDaoErrorBlk)errorBlk {
   NSString *envlogTable = TBL_MASTER_ENV_LOG;
   __block FPEnvironmentLog *envlog = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     envlog = [PELMUtils entityFromQuery:[NSString stringWithFormat:@"SELECT * FROM %@ WHERE %@ = ?", envlogTable, COL_GLOBAL_ID]
                             entityTable:envlogTable
                           localIdGetter:^NSNumber *(PELMModelSupport *entity) { return [entity localMasterIdentifier]; }
@@ -4995,12 +5421,13 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
         entityMasterTable:TBL_MASTER_ENV_LOG
                        db:db
                     error:errorBlk];
+  [self refreshMonthlyRollupsWithDb:db error:errorBlk];
 }
 
 - (NSInteger)numEnvironmentLogsForUser:(FPUser *)user
                                  error:(PELMDaoErrorBlk)errorBlk {
   __block NSInteger numEntities = 0;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     numEntities = [PELMUtils numEntitiesForParentEntity:user
                                   parentEntityMainTable:TBL_MAIN_USER
                          addlJoinParentEntityMainTables:nil
@@ -5021,7 +5448,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                              newerThan:(NSDate *)newerThan
                                  error:(PELMDaoErrorBlk)errorBlk {
   __block NSInteger numEntities = 0;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     numEntities = [PELMUtils numEntitiesForParentEntity:user
                                   parentEntityMainTable:TBL_MAIN_USER
                          addlJoinParentEntityMainTables:nil
@@ -5054,7 +5481,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                    beforeDateLogged:(NSDate *)beforeDateLogged
                               error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *envLogs = @[];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     envLogs = [self environmentLogsForUser:user
                                   pageSize:@(pageSize)
                           beforeDateLogged:beforeDateLogged
@@ -5067,7 +5494,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSArray *)unsyncedEnvironmentLogsForUser:(FPUser *)user
                                       error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *envLogs = @[];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     envLogs = [self unsyncedEnvironmentLogsForUser:user db:db error:errorBlk];
   }];
   return envLogs;
@@ -5089,7 +5516,6 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                     entityMainTable:TBL_MAIN_ENV_LOG
                            addlJoinEntityMainTables:nil
                        mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
-                                  comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 logDate] compare:[(FPEnvironmentLog *)o1 logDate]];}
                                 orderByDomainColumn:COL_ENVL_LOG_DT
                        orderByDomainColumnDirection:@"DESC"
                                                  db:db
@@ -5099,7 +5525,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (NSInteger)numEnvironmentLogsForVehicle:(FPVehicle *)vehicle
                                     error:(PELMDaoErrorBlk)errorBlk {
   __block NSInteger numEntities = 0;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     numEntities = [PELMUtils numEntitiesForParentEntity:vehicle
                                   parentEntityMainTable:TBL_MAIN_VEHICLE
                          addlJoinParentEntityMainTables:nil
@@ -5120,7 +5546,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                              newerThan:(NSDate *)newerThan
                                  error:(PELMDaoErrorBlk)errorBlk {
   __block NSInteger numEntities = 0;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     numEntities = [PELMUtils numEntitiesForParentEntity:vehicle
                                   parentEntityMainTable:TBL_MAIN_VEHICLE
                          addlJoinParentEntityMainTables:nil
@@ -5153,7 +5579,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                       beforeDateLogged:(NSDate *)beforeDateLogged
                                  error:(PELMDaoErrorBlk)errorBlk {
   __block NSArray *envLogs = @[];
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     envLogs = [self environmentLogsForVehicle:vehicle
                                      pageSize:@(pageSize)
                              beforeDateLogged:beforeDateLogged
@@ -5199,7 +5625,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPVehicle *)masterVehicleForMasterEnvLog:(FPEnvironmentLog *)envlog
                                       error:(PELMDaoErrorBlk)errorBlk {
   __block FPVehicle *vehicle = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     vehicle = [self masterVehicleForMasterEnvLog:envlog db:db error:errorBlk];
   }];
   return vehicle;
@@ -5221,7 +5647,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPVehicle *)vehicleForEnvironmentLog:(FPEnvironmentLog *)envLog
                                   error:(PELMDaoErrorBlk)errorBlk {
   __block FPVehicle *vehicle = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     vehicle = [self vehicleForEnvironmentLog:envLog db:db error:errorBlk];
   }];
   return vehicle;
@@ -5261,7 +5687,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
 - (FPVehicle *)defaultVehicleForNewEnvironmentLogForUser:(FPUser *)user
                                                    error:(PELMDaoErrorBlk)errorBlk {
   __block FPVehicle *vehicle = nil;
-  [self.databaseQueue inDatabase:^(FMDatabase *db) {
+  [self inReadDatabase:^(FMDatabase *db) {
     vehicle = [self vehicleForMostRecentEnvironmentLogForUser:user db:db error:errorBlk];
     if (!vehicle) {
       NSArray *vehicles = [self vehiclesForUser:user db:db error:errorBlk];
@@ -5289,8 +5715,8 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                  db:(FMDatabase *)db
                               error:(PELMDaoErrorBlk)errorBlk {
   return [self environmentLogsForParentEntity:user
-                        parentEntityMainTable:TBL_MAIN_USER
-                  parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainUserFromResultSet:rs];}
+                            parentMasterTable:TBL_MASTER_USER
+                              parentMainTable:TBL_MAIN_USER
                    parentEntityMasterIdColumn:COL_MASTER_USER_ID
                      parentEntityMainIdColumn:COL_MAIN_USER_ID
                                      pageSize:pageSize
@@ -5315,8 +5741,8 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                     db:(FMDatabase *)db
                                  error:(PELMDaoErrorBlk)errorBlk {
   return [self environmentLogsForParentEntity:vehicle
-                        parentEntityMainTable:TBL_MAIN_VEHICLE
-                  parentEntityMainRsConverter:^(FMResultSet *rs){return [self mainVehicleFromResultSet:rs];}
+                            parentMasterTable:TBL_MASTER_VEHICLE
+                              parentMainTable:TBL_MAIN_VEHICLE
                    parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
                      parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
                                      pageSize:pageSize
@@ -5325,35 +5751,35 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                         error:errorBlk];
 }
 
-- (NSArray *)environmentLogsForParentEntity:(PELMModelSupport *)parentEntity
-                      parentEntityMainTable:(NSString *)parentEntityMainTable
-                parentEntityMainRsConverter:(PELMEntityFromResultSetBlk)parentEntityMainRsConverter
+- (NSArray *)environmentLogsForParentEntity:(PELMMainSupport *)parentEntity
+                          parentMasterTable:(NSString *)parentMasterTable
+                            parentMainTable:(NSString *)parentMainTable
                  parentEntityMasterIdColumn:(NSString *)parentEntityMasterIdCol
                    parentEntityMainIdColumn:(NSString *)parentEntityMainIdCol
                                    pageSize:(NSNumber *)pageSize
                            beforeDateLogged:(NSDate *)beforeDateLogged
                                          db:(FMDatabase *)db
                                       error:(PELMDaoErrorBlk)errorBlk {
-  return [PELMUtils entitiesForParentEntity:parentEntity
-                      parentEntityMainTable:parentEntityMainTable
-             addlJoinParentEntityMainTables:nil
-                parentEntityMainRsConverter:parentEntityMainRsConverter
-                 parentEntityMasterIdColumn:parentEntityMasterIdCol
-                   parentEntityMainIdColumn:parentEntityMainIdCol
-                                   pageSize:pageSize
-                          pageBoundaryWhere:[NSString stringWithFormat:@"%@ < ?", COL_ENVL_LOG_DT]
-                            pageBoundaryArg:[PEUtils millisecondsFromDate:beforeDateLogged]
-                          entityMasterTable:TBL_MASTER_ENV_LOG
-                 addlJoinEntityMasterTables:nil
-             masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
-                            entityMainTable:TBL_MAIN_ENV_LOG
-                   addlJoinEntityMainTables:nil
-               mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
-                          comparatorForSort:^NSComparisonResult(id o1,id o2){return [[(FPEnvironmentLog *)o2 logDate] compare:[(FPEnvironmentLog *)o1 logDate]];}
-                        orderByDomainColumn:COL_ENVL_LOG_DT
-               orderByDomainColumnDirection:@"DESC"
-                                         db:db
-                                      error:errorBlk];
+  NSMutableArray *whereArgs = [NSMutableArray array];
+  return [self effectiveEntitiesForParentEntity:parentEntity
+                              parentMasterTable:parentMasterTable
+                                parentMainTable:parentMainTable
+                     parentEntityMasterIdColumn:parentEntityMasterIdCol
+                       parentEntityMainIdColumn:parentEntityMainIdCol
+                              entityMasterTable:TBL_MASTER_ENV_LOG
+                                entityMainTable:TBL_MAIN_ENV_LOG
+                 masterEntityResultSetConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
+                   mainEntityResultSetConverter:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
+                                       whereBlk:[self dateBoundsWhereBlkForDateColumn:COL_ENVL_LOG_DT
+                                                                           beforeDate:beforeDateLogged
+                                                                        onOrAfterDate:nil
+                                                                            whereArgs:whereArgs]
+                                      whereArgs:whereArgs
+                            orderByDomainColumn:COL_ENVL_LOG_DT
+                   orderByDomainColumnDirection:@"DESC"
+                                       pageSize:pageSize
+                                             db:db
+                                          error:errorBlk];
 }
 
 - (void)persistDeepEnvironmentLogFromRemoteMaster:(FPEnvironmentLog *)environmentLog
@@ -5364,6 +5790,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                             forUser:user
                                                  db:db
                                               error:errorBlk];
+    [self refreshMonthlyRollupsWithDb:db error:errorBlk];
   }];
 }
 
@@ -5433,6 +5860,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                              vehicle:vehicle
                                   db:db
                                error:errorBlk];
+  [self refreshMonthlyRollupsWithDb:db error:errorBlk];
 }
 
 - (BOOL)prepareEnvironmentLogForEdit:(FPEnvironmentLog *)environmentLog
@@ -5480,6 +5908,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                            forUser:user
                                                 db:db
                                              error:errorBlk];
+    [self refreshMonthlyRollupsWithDb:db error:errorBlk];
   }];
   return returnVal;
 }
@@ -5503,6 +5932,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
               argsArray:[self updateArgsForMainEnvironmentLog:environmentLog vehicle:vehicle]
                      db:db
                   error:errorBlk];
+    [self refreshMonthlyRollupsWithDb:db error:errorBlk];
   }];
 }
 
@@ -5513,6 +5943,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                              mainUpdateStmt:[self updateStmtForMainEnvironmentLogSansVehicleFks]
                           mainUpdateArgsBlk:^NSArray *(PELMMainSupport *entity){return [self updateArgsForMainEnvironmentLog:(FPEnvironmentLog *)entity];}
                                       error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
 }
 
 - (void)markAsDoneEditingImmediateSyncEnvironmentLog:(FPEnvironmentLog *)environmentLog
@@ -5522,6 +5953,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                           mainUpdateStmt:[self updateStmtForMainEnvironmentLogSansVehicleFks]
                                        mainUpdateArgsBlk:^NSArray *(PELMMainSupport *entity){return [self updateArgsForMainEnvironmentLog:(FPEnvironmentLog *)entity];}
                                                    error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
 }
 
 - (void)reloadEnvironmentLog:(FPEnvironmentLog *)environmentLog
@@ -5542,16 +5974,19 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                            masterTable:TBL_MASTER_ENV_LOG
                            rsConverter:^(FMResultSet *rs){return [self masterEnvironmentLogFromResultSet:rs];}
                                  error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
 }
 
 - (NSArray *)markEnvironmentLogsAsSyncInProgressForUser:(FPUser *)user
                                                   error:(PELMDaoErrorBlk)errorBlk {
-  return [self.localModelUtils markEntitiesAsSyncInProgressInMainTable:TBL_MAIN_ENV_LOG
-                                              addlJoinEntityMainTables:nil
-                                                   entityFromResultSet:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
-                                                            updateStmt:[self updateStmtForMainEnvironmentLogSansVehicleFks]
-                                                         updateArgsBlk:^NSArray *(PELMMainSupport *entity){return [self updateArgsForMainEnvironmentLog:(FPEnvironmentLog *)entity];}
-                                                                 error:errorBlk];
+  NSArray *envlogs = [self.localModelUtils markEntitiesAsSyncInProgressInMainTable:TBL_MAIN_ENV_LOG
+                                                          addlJoinEntityMainTables:nil
+                                                               entityFromResultSet:^(FMResultSet *rs){return [self mainEnvironmentLogFromResultSet:rs];}
+                                                                        updateStmt:[self updateStmtForMainEnvironmentLogSansVehicleFks]
+                                                                     updateArgsBlk:^NSArray *(PELMMainSupport *entity){return [self updateArgsForMainEnvironmentLog:(FPEnvironmentLog *)entity];}
+                                                                             error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
+  return envlogs;
 }
 
 - (void)cancelSyncForEnvironmentLog:(FPEnvironmentLog *)environmentLog
@@ -5566,6 +6001,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                          mainUpdateStmt:[self updateStmtForMainEnvironmentLogSansVehicleFks]
                       mainUpdateArgsBlk:^NSArray *(PELMMainSupport *entity){return [self updateArgsForMainEnvironmentLog:(FPEnvironmentLog *)entity];}
                                   error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
 }
 
 - (PELMSaveNewOrExistingCode)saveNewOrExistingMasterEnvironmentLog:(FPEnvironmentLog *)envlog
@@ -5590,15 +6026,17 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                       forVehicle:(FPVehicle *)vehicle
                          forUser:(FPUser *)user
                            error:(PELMDaoErrorBlk)errorBlk {
-  return [self.localModelUtils saveMasterEntity:envlog
-                                masterTable:TBL_MASTER_ENV_LOG
-                           masterUpdateStmt:[self updateStmtForMasterEnvironmentLog]
-                        masterUpdateArgsBlk:^ NSArray * (FPEnvironmentLog *theEnvlog) { return [self updateArgsForMasterEnvironmentLog:theEnvlog vehicle:vehicle]; }
-                                  mainTable:TBL_MAIN_ENV_LOG
-                    mainEntityFromResultSet:^ FPEnvironmentLog * (FMResultSet *rs) { return [self mainEnvironmentLogFromResultSet:rs]; }
-                             mainUpdateStmt:[self updateStmtForMainEnvironmentLog]
-                          mainUpdateArgsBlk:^ NSArray * (FPEnvironmentLog *theEnvlog) { return [self updateArgsForMainEnvironmentLog:theEnvlog vehicle:vehicle]; }
-                                      error:errorBlk];
+  BOOL saved = [self.localModelUtils saveMasterEntity:envlog
+                                      masterTable:TBL_MASTER_ENV_LOG
+                                 masterUpdateStmt:[self updateStmtForMasterEnvironmentLog]
+                              masterUpdateArgsBlk:^ NSArray * (FPEnvironmentLog *theEnvlog) { return [self updateArgsForMasterEnvironmentLog:theEnvlog vehicle:vehicle]; }
+                                        mainTable:TBL_MAIN_ENV_LOG
+                          mainEntityFromResultSet:^ FPEnvironmentLog * (FMResultSet *rs) { return [self mainEnvironmentLogFromResultSet:rs]; }
+                                   mainUpdateStmt:[self updateStmtForMainEnvironmentLog]
+                                mainUpdateArgsBlk:^ NSArray * (FPEnvironmentLog *theEnvlog) { return [self updateArgsForMainEnvironmentLog:theEnvlog vehicle:vehicle]; }
+                                            error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
+  return saved;
 }
 
 - (void)markAsSyncCompleteForNewEnvironmentLog:(FPEnvironmentLog *)environmentLog
@@ -5614,6 +6052,7 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                                                                                   db:db
                                                                                                                error:errorBlk];}
                                              error:errorBlk];
+  [self refreshMonthlyRollupsWithError:errorBlk];
 }
 
 - (void)markAsSyncCompleteForUpdatedEnvironmentLog:(FPEnvironmentLog *)environmentLog
@@ -5637,7 +6076,594 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                                                                                              vehicle:masterVehicle];}
                                                       db:db
                                                    error:errorBlk];
+    [self refreshMonthlyRollupsWithDb:db error:errorBlk];
+  }];
+}
+
+#pragma mark - Aggregates
+
+- (FPLogAggregate *)aggregateOfGasLogMeasure:(FPGasLogMeasure)measure
+                                     forUser:(FPUser *)user
+                                  beforeDate:(NSDate *)beforeDate
+                               onOrAfterDate:(NSDate *)onOrAfterDate
+                                      octane:(NSNumber *)octane
+                                      diesel:(BOOL)diesel
+                                       error:(PELMDaoErrorBlk)errorBlk {
+  return [self aggregateOfGasLogMeasure:measure
+                           parentEntity:user
+                      parentMasterTable:TBL_MASTER_USER
+                        parentMainTable:TBL_MAIN_USER
+             parentEntityMasterIdColumn:COL_MASTER_USER_ID
+               parentEntityMainIdColumn:COL_MAIN_USER_ID
+                             beforeDate:beforeDate
+                          onOrAfterDate:onOrAfterDate
+                                 octane:octane
+                                 diesel:diesel
+                                  error:errorBlk];
+}
+
+- (FPLogAggregate *)aggregateOfGasLogMeasure:(FPGasLogMeasure)measure
+                                  forVehicle:(FPVehicle *)vehicle
+                                  beforeDate:(NSDate *)beforeDate
+                               onOrAfterDate:(NSDate *)onOrAfterDate
+                                      octane:(NSNumber *)octane
+                                      diesel:(BOOL)diesel
+                                       error:(PELMDaoErrorBlk)errorBlk {
+  return [self aggregateOfGasLogMeasure:measure
+                           parentEntity:vehicle
+                      parentMasterTable:TBL_MASTER_VEHICLE
+                        parentMainTable:TBL_MAIN_VEHICLE
+             parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+               parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                             beforeDate:beforeDate
+                          onOrAfterDate:onOrAfterDate
+                                 octane:octane
+                                 diesel:diesel
+                                  error:errorBlk];
+}
+
+- (FPLogAggregate *)aggregateOfGasLogMeasure:(FPGasLogMeasure)measure
+                              forFuelstation:(FPFuelStation *)fuelstation
+                                  beforeDate:(NSDate *)beforeDate
+                               onOrAfterDate:(NSDate *)onOrAfterDate
+                                      octane:(NSNumber *)octane
+                                      diesel:(BOOL)diesel
+                                       error:(PELMDaoErrorBlk)errorBlk {
+  return [self aggregateOfGasLogMeasure:measure
+                           parentEntity:fuelstation
+                      parentMasterTable:TBL_MASTER_FUEL_STATION
+                        parentMainTable:TBL_MAIN_FUEL_STATION
+             parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
+               parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
+                             beforeDate:beforeDate
+                          onOrAfterDate:onOrAfterDate
+                                 octane:octane
+                                 diesel:diesel
+                                  error:errorBlk];
+}
+
+- (NSDictionary *)octaneAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                          forUser:(FPUser *)user
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk {
+  return [self octaneAggregatesOfGasLogMeasure:measure
+                                  parentEntity:user
+                             parentMasterTable:TBL_MASTER_USER
+                               parentMainTable:TBL_MAIN_USER
+                    parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                      parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                    beforeDate:beforeDate
+                                 onOrAfterDate:onOrAfterDate
+                                         error:errorBlk];
+}
+
+- (NSDictionary *)octaneAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                       forVehicle:(FPVehicle *)vehicle
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk {
+  return [self octaneAggregatesOfGasLogMeasure:measure
+                                  parentEntity:vehicle
+                             parentMasterTable:TBL_MASTER_VEHICLE
+                               parentMainTable:TBL_MAIN_VEHICLE
+                    parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                      parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                    beforeDate:beforeDate
+                                 onOrAfterDate:onOrAfterDate
+                                         error:errorBlk];
+}
+
+- (NSDictionary *)octaneAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                   forFuelstation:(FPFuelStation *)fuelstation
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk {
+  return [self octaneAggregatesOfGasLogMeasure:measure
+                                  parentEntity:fuelstation
+                             parentMasterTable:TBL_MASTER_FUEL_STATION
+                               parentMainTable:TBL_MAIN_FUEL_STATION
+                    parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
+                      parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
+                                    beforeDate:beforeDate
+                                 onOrAfterDate:onOrAfterDate
+                                         error:errorBlk];
+}
+
+- (FPLogAggregate *)aggregateOfOdometerLogMeasure:(FPOdometerLogMeasure)measure
+                                          forUser:(FPUser *)user
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk {
+  return [self aggregateOfOdometerLogMeasure:measure
+                                parentEntity:user
+                           parentMasterTable:TBL_MASTER_USER
+                             parentMainTable:TBL_MAIN_USER
+                  parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                    parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                                       error:errorBlk];
+}
+
+- (FPLogAggregate *)aggregateOfOdometerLogMeasure:(FPOdometerLogMeasure)measure
+                                       forVehicle:(FPVehicle *)vehicle
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk {
+  return [self aggregateOfOdometerLogMeasure:measure
+                                parentEntity:vehicle
+                           parentMasterTable:TBL_MASTER_VEHICLE
+                             parentMainTable:TBL_MAIN_VEHICLE
+                  parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                    parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                                       error:errorBlk];
+}
+
+- (NSArray *)daysBetweenFillupsForVehicle:(FPVehicle *)vehicle
+                               beforeDate:(NSDate *)beforeDate
+                            onOrAfterDate:(NSDate *)onOrAfterDate
+                                 timeZone:(NSTimeZone *)timeZone
+                                    error:(PELMDaoErrorBlk)errorBlk {
+  NSMutableArray *whereArgs = [NSMutableArray array];
+  NSString *(^dateBoundsWhereBlk)(NSString *) = [self dateBoundsWhereBlkForDateColumn:COL_FUELPL_PURCHASED_AT
+                                                                           beforeDate:beforeDate
+                                                                        onOrAfterDate:onOrAfterDate
+                                                                            whereArgs:whereArgs];
+  NSString *(^purchasedAtProjectionBlk)(NSString *) = ^(NSString *colPrefix) {
+    return [NSString stringWithFormat:@"%@%@ AS val", colPrefix, COL_FUELPL_PURCHASED_AT];
+  };
+  NSMutableArray *dataset = [NSMutableArray array];
+  [self inReadDatabase:^(FMDatabase *db) {
+    NSMutableArray *args = [NSMutableArray array];
+    NSString *union = [self effectiveUnionOfProjectionBlk:purchasedAtProjectionBlk
+                                             parentEntity:vehicle
+                                        parentMasterTable:TBL_MASTER_VEHICLE
+                                          parentMainTable:TBL_MAIN_VEHICLE
+                               parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                                 parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                        entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                          entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                                                 whereBlk:dateBoundsWhereBlk
+                                                whereArgs:whereArgs
+                                                     args:args
+                                                       db:db
+                                                    error:errorBlk];
+    if (!union) {
+      return;
+    }
+    // the iOS 8 system SQLite predates window functions, so rather than LAG()
+    // the previous row's date is carried along as the sorted rows stream by
+    FMResultSet *rs = [PELMUtils doQuery:[NSString stringWithFormat:@"SELECT val FROM (%@) WHERE val IS NOT NULL ORDER BY val", union]
+                               argsArray:args
+                                      db:db
+                                   error:errorBlk];
+    BOOL hasPrevious = NO;
+    int64_t previousWallClockMillis = 0;
+    while ([rs next]) {
+      NSDate *purchasedAt = [PELMUtils dateFromResultSet:rs columnName:@"val"];
+      // whole days are counted on the wall clock, the way NSCalendar counts
+      // them, so a 23 or 25 hour day across a daylight saving change is a day
+      int64_t wallClockMillis = [rs longLongIntForColumn:@"val"] + ((int64_t)[timeZone secondsFromGMTForDate:purchasedAt] * 1000);
+      if (hasPrevious) {
+        [dataset addObject:@[purchasedAt, @((wallClockMillis - previousWallClockMillis) / (24 * 60 * 60 * 1000))]];
+      }
+      hasPrevious = YES;
+      previousWallClockMillis = wallClockMillis;
+    }
+    [rs close];
+  }];
+  return dataset;
+}
+
+#pragma mark - Log Columns
+
+- (FPLogColumns *)gasLogColumnsForUser:(FPUser *)user error:(PELMDaoErrorBlk)errorBlk {
+  return [self gasLogColumnsForParentEntity:user
+                          parentMasterTable:TBL_MASTER_USER
+                            parentMainTable:TBL_MAIN_USER
+                 parentEntityMasterIdColumn:COL_MASTER_USER_ID
+                   parentEntityMainIdColumn:COL_MAIN_USER_ID
+                                      error:errorBlk];
+}
+
+- (FPLogColumns *)gasLogColumnsForVehicle:(FPVehicle *)vehicle error:(PELMDaoErrorBlk)errorBlk {
+  return [self gasLogColumnsForParentEntity:vehicle
+                          parentMasterTable:TBL_MASTER_VEHICLE
+                            parentMainTable:TBL_MAIN_VEHICLE
+                 parentEntityMasterIdColumn:COL_MASTER_VEHICLE_ID
+                   parentEntityMainIdColumn:COL_MAIN_VEHICLE_ID
+                                      error:errorBlk];
+}
+
+- (FPLogColumns *)gasLogColumnsForFuelstation:(FPFuelStation *)fuelstation error:(PELMDaoErrorBlk)errorBlk {
+  return [self gasLogColumnsForParentEntity:fuelstation
+                          parentMasterTable:TBL_MASTER_FUEL_STATION
+                            parentMainTable:TBL_MAIN_FUEL_STATION
+                 parentEntityMasterIdColumn:COL_MASTER_FUELSTATION_ID
+                   parentEntityMainIdColumn:COL_MAIN_FUELSTATION_ID
+                                      error:errorBlk];
+}
+
+#pragma mark - Monthly Rollups
+
+- (NSDictionary *)monthlyAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                           forUser:(FPUser *)user
+                                        beforeDate:(NSDate *)beforeDate
+                                     onOrAfterDate:(NSDate *)onOrAfterDate
+                                            octane:(NSNumber *)octane
+                                            diesel:(BOOL)diesel
+                                             error:(PELMDaoErrorBlk)errorBlk {
+  return [self monthlyAggregatesFromRollupTable:TBL_VEHICLE_GAS_MONTHLY_ROLLUP
+                                 measureColumns:[self gasLogRollupColumnsForMeasure:measure]
+                                   parentEntity:user
+                              parentMasterTable:TBL_MASTER_USER
+                                parentMainTable:TBL_MAIN_USER
+                        masterParentIdsSubquery:[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@ = ?",
+                                                COL_LOCAL_ID, TBL_MASTER_VEHICLE, COL_MASTER_USER_ID]
+                          mainParentIdsSubquery:[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@ = ?",
+                                                COL_LOCAL_ID, TBL_MAIN_VEHICLE, COL_MAIN_USER_ID]
+                                     beforeDate:beforeDate
+                                  onOrAfterDate:onOrAfterDate
+                                        fuelKey:[self rollupFuelKeyForOctane:octane diesel:diesel]
+                                          error:errorBlk];
+}
+
+- (NSDictionary *)monthlyAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                        forVehicle:(FPVehicle *)vehicle
+                                        beforeDate:(NSDate *)beforeDate
+                                     onOrAfterDate:(NSDate *)onOrAfterDate
+                                            octane:(NSNumber *)octane
+                                            diesel:(BOOL)diesel
+                                             error:(PELMDaoErrorBlk)errorBlk {
+  return [self monthlyAggregatesFromRollupTable:TBL_VEHICLE_GAS_MONTHLY_ROLLUP
+                                 measureColumns:[self gasLogRollupColumnsForMeasure:measure]
+                                   parentEntity:vehicle
+                              parentMasterTable:TBL_MASTER_VEHICLE
+                                parentMainTable:TBL_MAIN_VEHICLE
+                        masterParentIdsSubquery:nil
+                          mainParentIdsSubquery:nil
+                                     beforeDate:beforeDate
+                                  onOrAfterDate:onOrAfterDate
+                                        fuelKey:[self rollupFuelKeyForOctane:octane diesel:diesel]
+                                          error:errorBlk];
+}
+
+- (NSDictionary *)monthlyAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                    forFuelstation:(FPFuelStation *)fuelstation
+                                        beforeDate:(NSDate *)beforeDate
+                                     onOrAfterDate:(NSDate *)onOrAfterDate
+                                            octane:(NSNumber *)octane
+                                            diesel:(BOOL)diesel
+                                             error:(PELMDaoErrorBlk)errorBlk {
+  return [self monthlyAggregatesFromRollupTable:TBL_FUELSTATION_GAS_MONTHLY_ROLLUP
+                                 measureColumns:[self gasLogRollupColumnsForMeasure:measure]
+                                   parentEntity:fuelstation
+                              parentMasterTable:TBL_MASTER_FUEL_STATION
+                                parentMainTable:TBL_MAIN_FUEL_STATION
+                        masterParentIdsSubquery:nil
+                          mainParentIdsSubquery:nil
+                                     beforeDate:beforeDate
+                                  onOrAfterDate:onOrAfterDate
+                                        fuelKey:[self rollupFuelKeyForOctane:octane diesel:diesel]
+                                          error:errorBlk];
+}
+
+- (NSDictionary *)octaneMonthlyAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                                 forUser:(FPUser *)user
+                                              beforeDate:(NSDate *)beforeDate
+                                           onOrAfterDate:(NSDate *)onOrAfterDate
+                                                   error:(PELMDaoErrorBlk)errorBlk {
+  return [self octaneMonthlyAggregatesFromRollupTable:TBL_VEHICLE_GAS_MONTHLY_ROLLUP
+                                       measureColumns:[self gasLogRollupColumnsForMeasure:measure]
+                                         parentEntity:user
+                                    parentMasterTable:TBL_MASTER_USER
+                                      parentMainTable:TBL_MAIN_USER
+                              masterParentIdsSubquery:[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@ = ?",
+                                                      COL_LOCAL_ID, TBL_MASTER_VEHICLE, COL_MASTER_USER_ID]
+                                mainParentIdsSubquery:[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@ = ?",
+                                                      COL_LOCAL_ID, TBL_MAIN_VEHICLE, COL_MAIN_USER_ID]
+                                           beforeDate:beforeDate
+                                        onOrAfterDate:onOrAfterDate
+                                                error:errorBlk];
+}
+
+- (NSDictionary *)octaneMonthlyAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                              forVehicle:(FPVehicle *)vehicle
+                                              beforeDate:(NSDate *)beforeDate
+                                           onOrAfterDate:(NSDate *)onOrAfterDate
+                                                   error:(PELMDaoErrorBlk)errorBlk {
+  return [self octaneMonthlyAggregatesFromRollupTable:TBL_VEHICLE_GAS_MONTHLY_ROLLUP
+                                       measureColumns:[self gasLogRollupColumnsForMeasure:measure]
+                                         parentEntity:vehicle
+                                    parentMasterTable:TBL_MASTER_VEHICLE
+                                      parentMainTable:TBL_MAIN_VEHICLE
+                              masterParentIdsSubquery:nil
+                                mainParentIdsSubquery:nil
+                                           beforeDate:beforeDate
+                                        onOrAfterDate:onOrAfterDate
+                                                error:errorBlk];
+}
+
+- (NSDictionary *)octaneMonthlyAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                          forFuelstation:(FPFuelStation *)fuelstation
+                                              beforeDate:(NSDate *)beforeDate
+                                           onOrAfterDate:(NSDate *)onOrAfterDate
+                                                   error:(PELMDaoErrorBlk)errorBlk {
+  return [self octaneMonthlyAggregatesFromRollupTable:TBL_FUELSTATION_GAS_MONTHLY_ROLLUP
+                                       measureColumns:[self gasLogRollupColumnsForMeasure:measure]
+                                         parentEntity:fuelstation
+                                    parentMasterTable:TBL_MASTER_FUEL_STATION
+                                      parentMainTable:TBL_MAIN_FUEL_STATION
+                              masterParentIdsSubquery:nil
+                                mainParentIdsSubquery:nil
+                                           beforeDate:beforeDate
+                                        onOrAfterDate:onOrAfterDate
+                                                error:errorBlk];
+}
+
+- (NSDictionary *)monthlyAggregatesOfOdometerLogMeasure:(FPOdometerLogMeasure)measure
+                                             forVehicle:(FPVehicle *)vehicle
+                                             beforeDate:(NSDate *)beforeDate
+                                          onOrAfterDate:(NSDate *)onOrAfterDate
+                                                  error:(PELMDaoErrorBlk)errorBlk {
+  return [self monthlyAggregatesFromRollupTable:TBL_VEHICLE_ODOMETER_MONTHLY_ROLLUP
+                                 measureColumns:[self odometerLogRollupColumnsForMeasure:measure]
+                                   parentEntity:vehicle
+                              parentMasterTable:TBL_MASTER_VEHICLE
+                                parentMainTable:TBL_MAIN_VEHICLE
+                        masterParentIdsSubquery:nil
+                          mainParentIdsSubquery:nil
+                                     beforeDate:beforeDate
+                                  onOrAfterDate:onOrAfterDate
+                                        fuelKey:nil
+                                          error:errorBlk];
+}
+
+- (void)rebuildMonthlyRollupsWithError:(PELMDaoErrorBlk)errorBlk {
+  [self.databaseQueue inTransaction:^(FMDatabase *db, BOOL *rollback) {
+    [self rebuildMonthlyRollupsWithDb:db error:errorBlk];
+  }];
+}
+
+/*
+ For the log writes made through localModelUtils, which commit in a transaction
+ of their own (the pod's, which the refresh has no way into): recomputes the
+ months they dirtied right after.  A rollup read landing between the two commits
+ (or after a crash between them) sees the dirty months and finishes the refresh
+ itself; see inMonthlyRollupsReadDatabase:error:.
+ */
+- (void)refreshMonthlyRollupsWithError:(PELMDaoErrorBlk)errorBlk {
+  [self.databaseQueue inTransaction:^(FMDatabase *db, BOOL *rollback) {
+    [self refreshMonthlyRollupsWithDb:db error:errorBlk];
+  }];
+}
+
+/*
+ Runs a read of the rollups on the read pool, unless the committed state it
+ would read still has dirty months (a localModelUtils log write whose refresh
+ hasn't committed yet); then the refresh is finished on databaseQueue and the
+ read made after it, so no read pairs new logs with old rollups.  The writes
+ made in a transaction of ours refresh in it, and never leave dirty months
+ behind.
+ */
+- (void)inMonthlyRollupsReadDatabase:(void (^)(FMDatabase *db))block error:(PELMDaoErrorBlk)errorBlk {
+  __block BOOL rollupsDirty = NO;
+  [self inReadDatabase:^(FMDatabase *db) {
+    FMResultSet *rs = [PELMUtils doQuery:[NSString stringWithFormat:@"SELECT 1 FROM %@ LIMIT 1", TBL_MONTHLY_ROLLUP_DIRTY]
+                               argsArray:@[]
+                                      db:db
+                                   error:errorBlk];
+    rollupsDirty = [rs next];
+    [rs close];
+    if (!rollupsDirty) {
+      block(db);
+    }
   }];
+  if (rollupsDirty) {
+    [self refreshMonthlyRollupsWithError:errorBlk];
+    [self inReadDatabase:block];
+  }
+}
+
+#pragma mark - Quantile Sketches
+
+- (FPQuantileSketch *)gallonPriceSketchForUser:(FPUser *)user
+                                    beforeDate:(NSDate *)beforeDate
+                                 onOrAfterDate:(NSDate *)onOrAfterDate
+                                        octane:(NSNumber *)octane
+                                        diesel:(BOOL)diesel
+                                         error:(PELMDaoErrorBlk)errorBlk {
+  return [self quantileSketchFromRollupTable:TBL_VEHICLE_GAS_MONTHLY_ROLLUP
+                                sketchColumn:COL_ROLLUP_PRICE_SKETCH
+                                parentEntity:user
+                           parentMasterTable:TBL_MASTER_USER
+                             parentMainTable:TBL_MAIN_USER
+                     masterParentIdsSubquery:[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@ = ?",
+                                             COL_LOCAL_ID, TBL_MASTER_VEHICLE, COL_MASTER_USER_ID]
+                       mainParentIdsSubquery:[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@ = ?",
+                                             COL_LOCAL_ID, TBL_MAIN_VEHICLE, COL_MAIN_USER_ID]
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                                     fuelKey:[self rollupFuelKeyForOctane:octane diesel:diesel]
+                                       error:errorBlk];
+}
+
+- (FPQuantileSketch *)gallonPriceSketchForVehicle:(FPVehicle *)vehicle
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                           octane:(NSNumber *)octane
+                                           diesel:(BOOL)diesel
+                                            error:(PELMDaoErrorBlk)errorBlk {
+  return [self quantileSketchFromRollupTable:TBL_VEHICLE_GAS_MONTHLY_ROLLUP
+                                sketchColumn:COL_ROLLUP_PRICE_SKETCH
+                                parentEntity:vehicle
+                           parentMasterTable:TBL_MASTER_VEHICLE
+                             parentMainTable:TBL_MAIN_VEHICLE
+                     masterParentIdsSubquery:nil
+                       mainParentIdsSubquery:nil
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                                     fuelKey:[self rollupFuelKeyForOctane:octane diesel:diesel]
+                                       error:errorBlk];
+}
+
+- (FPQuantileSketch *)gallonPriceSketchForFuelstation:(FPFuelStation *)fuelstation
+                                           beforeDate:(NSDate *)beforeDate
+                                        onOrAfterDate:(NSDate *)onOrAfterDate
+                                               octane:(NSNumber *)octane
+                                               diesel:(BOOL)diesel
+                                                error:(PELMDaoErrorBlk)errorBlk {
+  return [self quantileSketchFromRollupTable:TBL_FUELSTATION_GAS_MONTHLY_ROLLUP
+                                sketchColumn:COL_ROLLUP_PRICE_SKETCH
+                                parentEntity:fuelstation
+                           parentMasterTable:TBL_MASTER_FUEL_STATION
+                             parentMainTable:TBL_MAIN_FUEL_STATION
+                     masterParentIdsSubquery:nil
+                       mainParentIdsSubquery:nil
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                                     fuelKey:[self rollupFuelKeyForOctane:octane diesel:diesel]
+                                       error:errorBlk];
+}
+
+- (FPQuantileSketch *)reportedAvgMpgSketchForUser:(FPUser *)user
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk {
+  return [self quantileSketchFromRollupTable:TBL_VEHICLE_ODOMETER_MONTHLY_ROLLUP
+                                sketchColumn:COL_ROLLUP_MPG_SKETCH
+                                parentEntity:user
+                           parentMasterTable:TBL_MASTER_USER
+                             parentMainTable:TBL_MAIN_USER
+                     masterParentIdsSubquery:[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@ = ?",
+                                             COL_LOCAL_ID, TBL_MASTER_VEHICLE, COL_MASTER_USER_ID]
+                       mainParentIdsSubquery:[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@ = ?",
+                                             COL_LOCAL_ID, TBL_MAIN_VEHICLE, COL_MAIN_USER_ID]
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                                     fuelKey:nil
+                                       error:errorBlk];
+}
+
+- (FPQuantileSketch *)reportedAvgMpgSketchForVehicle:(FPVehicle *)vehicle
+                                          beforeDate:(NSDate *)beforeDate
+                                       onOrAfterDate:(NSDate *)onOrAfterDate
+                                               error:(PELMDaoErrorBlk)errorBlk {
+  return [self quantileSketchFromRollupTable:TBL_VEHICLE_ODOMETER_MONTHLY_ROLLUP
+                                sketchColumn:COL_ROLLUP_MPG_SKETCH
+                                parentEntity:vehicle
+                           parentMasterTable:TBL_MASTER_VEHICLE
+                             parentMainTable:TBL_MAIN_VEHICLE
+                     masterParentIdsSubquery:nil
+                       mainParentIdsSubquery:nil
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                                     fuelKey:nil
+                                       error:errorBlk];
+}
+
+#pragma mark - Data Version
+
+/*
+ Moved by FPWalDidCommit only after a commit, so a reader that sees the new
+ version also sees the data it stands for.  Every write to the store (local
+ saves and deletes, changelog applies, deep saves) commits on databaseQueue.
+ */
+- (int64_t)dataVersion {
+  return OSAtomicAdd64Barrier(0, &_dataVersion);
+}
+
+- (void)dataDidCommit {
+  OSAtomicIncrement64Barrier(&_dataVersion);
+}
+
+#pragma mark - Statement Count
+
+@synthesize statementObserver = _statementObserver;
+
+/*
+ Turns on db's statement cache, so each distinct query (our where-templates and
+ column lists are fixed, with values always bound as parameters, so the SQL
+ text identifies the query's shape) is prepared once on the connection and
+ then reset and rebound on every later run; and starts counting the statements
+ run on it.  The bookkeeping is retained by db itself, so it's dropped when the
+ pool closes and releases the connection (its profile callback goes with the
+ closed handle).
+ */
+- (void)countStatementsOfDb:(FMDatabase *)db {
+  [db setShouldCacheStatements:YES];
+  FPConnectionStatements *connection = [[FPConnectionStatements alloc] init];
+  connection.dao = self;
+  connection.db = db;
+  objc_setAssociatedObject(db, &FPConnectionStatementsKey, connection, OBJC_ASSOCIATION_RETAIN_NONATOMIC);
+  sqlite3_profile([db sqliteHandle], FPProfileStatement, (__bridge void *)connection);
+}
+
+/*
+ FMDB puts each statement it prepares into the connection's cache (keyed by its
+ SQL) before running it, and on a hit runs a cached one instead; so a run that
+ finds more cached statements for its SQL than were counted before it is the
+ one that prepared the newest of them.  SQL missing from the cache wasn't run
+ through it (e.g., sqlite3_exec'd), so was prepared for that run alone.
+ */
+- (void)statementDidRun:(const char *)sql onConnection:(FPConnectionStatements *)connection {
+  OSAtomicIncrement64Barrier(&_numStatementsExecuted);
+  NSString *sqlString = [NSString stringWithUTF8String:sql];
+  id cached = [connection.db cachedStatements][sqlString];
+  NSUInteger numCached = 0;
+  if ([cached isKindOfClass:[FMStatement class]]) {
+    numCached = 1;
+  } else if (cached) {
+    numCached = [cached count];
+  }
+  NSUInteger numPrepared = [connection.numPreparedBySql[sqlString] unsignedIntegerValue];
+  if (numCached > numPrepared) {
+    connection.numPreparedBySql[sqlString] = @(numPrepared + 1);
+    OSAtomicIncrement64Barrier(&_numStatementCacheMisses);
+  } else if (numCached == 0) {
+    OSAtomicIncrement64Barrier(&_numStatementCacheMisses);
+  } else {
+    OSAtomicIncrement64Barrier(&_numStatementCacheHits);
+  }
+  void (^statementObserver)(NSString *) = self.statementObserver;
+  if (statementObserver) {
+    statementObserver(sqlString);
+  }
+}
+
+- (int64_t)numStatementsExecuted {
+  return OSAtomicAdd64Barrier(0, &_numStatementsExecuted);
+}
+
+- (int64_t)numStatementCacheHits {
+  return OSAtomicAdd64Barrier(0, &_numStatementCacheHits);
+}
+
+- (int64_t)numStatementCacheMisses {
+  return OSAtomicAdd64Barrier(0, &_numStatementCacheMisses);
 }
 
 #pragma mark - Result set -> Model helpers (private)
@@ -6390,47 +7416,60 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                                   rsConverter:^(FMResultSet *rs){return [self masterFuelStationFromResultSet:rs];}
                                            db:db
                                         error:errorBlk];
-  NSString *stmt = [NSString stringWithFormat:@"INSERT INTO %@ (%@, %@, %@, \
-%@, %@, %@, %@, %@, %@, %@, %@, %@, %@, %@, %@, %@) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
-                    TBL_MASTER_FUELPURCHASE_LOG,
-                    COL_MASTER_USER_ID,
-                    COL_MASTER_VEHICLE_ID,
-                    COL_MASTER_FUELSTATION_ID,
-                    COL_GLOBAL_ID,
-                    COL_MEDIA_TYPE,
-                    COL_MST_CREATED_AT,
-                    COL_MST_UPDATED_AT,
-                    COL_MST_DELETED_DT,
-                    COL_FUELPL_NUM_GALLONS,
-                    COL_FUELPL_OCTANE,
-                    COL_FUELPL_ODOMETER,
-                    COL_FUELPL_PRICE_PER_GALLON,
-                    COL_FUELPL_CAR_WASH_PER_GALLON_DISCOUNT,
-                    COL_FUELPL_GOT_CAR_WASH,
-                    COL_FUELPL_PURCHASED_AT,
-                    COL_FUELPL_IS_DIESEL];
-  [PELMUtils doMasterInsert:stmt
-                  argsArray:@[PELMOrNil([user localMasterIdentifier]),
-                              PELMOrNil([vehicle localMasterIdentifier]),
-                              PELMOrNil([fuelStation localMasterIdentifier]),
-                              PELMOrNil([fuelPurchaseLog globalIdentifier]),
-                              PELMOrNil([[fuelPurchaseLog mediaType] description]),
-                              PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog createdAt]]),
-                              PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog updatedAt]]),
-                              PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog deletedAt]]),
-                              PELMOrNil([fuelPurchaseLog numGallons]),
-                              PELMOrNil([fuelPurchaseLog octane]),
-                              PELMOrNil([fuelPurchaseLog odometer]),
-                              PELMOrNil([fuelPurchaseLog gallonPrice]),
-                              PELMOrNil([fuelPurchaseLog carWashPerGallonDiscount]),
-                              [NSNumber numberWithBool:[fuelPurchaseLog gotCarWash]],
-                              PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog purchasedAt]]),
-                              [NSNumber numberWithBool:[fuelPurchaseLog isDiesel]]]
+  [PELMUtils doMasterInsert:[self insertStmtForTable:TBL_MASTER_FUELPURCHASE_LOG
+                                             columns:[self masterFuelPurchaseLogColumns]
+                                             numRows:1]
+                  argsArray:[self masterFuelPurchaseLogArgs:fuelPurchaseLog
+                                                     userId:[user localMasterIdentifier]
+                                                  vehicleId:[vehicle localMasterIdentifier]
+                                              fuelStationId:[fuelStation localMasterIdentifier]]
                      entity:fuelPurchaseLog
                          db:db
                       error:errorBlk];
 }
 
+- (NSArray *)masterFuelPurchaseLogColumns {
+  return @[COL_MASTER_USER_ID,
+           COL_MASTER_VEHICLE_ID,
+           COL_MASTER_FUELSTATION_ID,
+           COL_GLOBAL_ID,
+           COL_MEDIA_TYPE,
+           COL_MST_CREATED_AT,
+           COL_MST_UPDATED_AT,
+           COL_MST_DELETED_DT,
+           COL_FUELPL_NUM_GALLONS,
+           COL_FUELPL_OCTANE,
+           COL_FUELPL_ODOMETER,
+           COL_FUELPL_PRICE_PER_GALLON,
+           COL_FUELPL_CAR_WASH_PER_GALLON_DISCOUNT,
+           COL_FUELPL_GOT_CAR_WASH,
+           COL_FUELPL_PURCHASED_AT,
+           COL_FUELPL_IS_DIESEL];
+}
+
+/* In the order of masterFuelPurchaseLogColumns. */
+- (NSArray *)masterFuelPurchaseLogArgs:(FPFuelPurchaseLog *)fuelPurchaseLog
+                                userId:(NSNumber *)userId
+                             vehicleId:(NSNumber *)vehicleId
+                         fuelStationId:(NSNumber *)fuelStationId {
+  return @[PELMOrNil(userId),
+           PELMOrNil(vehicleId),
+           PELMOrNil(fuelStationId),
+           PELMOrNil([fuelPurchaseLog globalIdentifier]),
+           PELMOrNil([[fuelPurchaseLog mediaType] description]),
+           PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog createdAt]]),
+           PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog updatedAt]]),
+           PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog deletedAt]]),
+           PELMOrNil(FPDecimalNumberRoundedToEntryScale([fuelPurchaseLog numGallons])),
+           PELMOrNil([fuelPurchaseLog octane]),
+           PELMOrNil([fuelPurchaseLog odometer]),
+           PELMOrNil(FPDecimalNumberRoundedToEntryScale([fuelPurchaseLog gallonPrice])),
+           PELMOrNil([fuelPurchaseLog carWashPerGallonDiscount]),
+           [NSNumber numberWithBool:[fuelPurchaseLog gotCarWash]],
+           PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog purchasedAt]]),
+           [NSNumber numberWithBool:[fuelPurchaseLog isDiesel]]];
+}
+
 - (void)insertIntoMainFuelPurchaseLog:(FPFuelPurchaseLog *)fuelPurchaseLog
                               forUser:(FPUser *)user
                               vehicle:(FPVehicle *)vehicle
@@ -6471,10 +7510,10 @@ Required schema version: %d.", currentSchemaVersion, FP_REQUIRED_SCHEMA_VERSION)
                             PELMOrNil([[fuelPurchaseLog mediaType] description]),
                             PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog updatedAt]]),
                             PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog dateCopiedFromMaster]]),
-                            PELMOrNil([fuelPurchaseLog numGallons]),
+                            PELMOrNil(FPDecimalNumberRoundedToEntryScale([fuelPurchaseLog numGallons])),
                             PELMOrNil([fuelPurchaseLog octane]),
                             PELMOrNil([fuelPurchaseLog odometer]),
-                            PELMOrNil([fuelPurchaseLog gallonPrice]),
+                            PELMOrNil(FPDecimalNumberRoundedToEntryScale([fuelPurchaseLog gallonPrice])),
                             PELMOrNil([fuelPurchaseLog carWashPerGallonDiscount]),
                             [NSNumber numberWithBool:[fuelPurchaseLog gotCarWash]],
                             PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog purchasedAt]]),
@@ -6581,10 +7620,10 @@ WHERE %@ = ?",
     PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog createdAt]]),
     PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog updatedAt]]),
     PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog deletedAt]]),
-    PELMOrNil([fuelPurchaseLog numGallons]),
+    PELMOrNil(FPDecimalNumberRoundedToEntryScale([fuelPurchaseLog numGallons])),
     PELMOrNil([fuelPurchaseLog octane]),
     PELMOrNil([fuelPurchaseLog odometer]),
-    PELMOrNil([fuelPurchaseLog gallonPrice]),
+    PELMOrNil(FPDecimalNumberRoundedToEntryScale([fuelPurchaseLog gallonPrice])),
     PELMOrNil([fuelPurchaseLog carWashPerGallonDiscount]),
     [NSNumber numberWithBool:[fuelPurchaseLog gotCarWash]],
     PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog purchasedAt]]),
@@ -6709,10 +7748,10 @@ WHERE %@ = ?",
     PELMOrNil([[fuelPurchaseLog mediaType] description]),
     PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog updatedAt]]),
     PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog dateCopiedFromMaster]]),
-    PELMOrNil([fuelPurchaseLog numGallons]),
+    PELMOrNil(FPDecimalNumberRoundedToEntryScale([fuelPurchaseLog numGallons])),
     PELMOrNil([fuelPurchaseLog octane]),
     PELMOrNil([fuelPurchaseLog odometer]),
-    PELMOrNil([fuelPurchaseLog gallonPrice]),
+    PELMOrNil(FPDecimalNumberRoundedToEntryScale([fuelPurchaseLog gallonPrice])),
     PELMOrNil([fuelPurchaseLog carWashPerGallonDiscount]),
     [NSNumber numberWithBool:[fuelPurchaseLog gotCarWash]],
     PELMOrNil([PEUtils millisecondsFromDate:[fuelPurchaseLog purchasedAt]]),
@@ -6753,41 +7792,52 @@ WHERE %@ = ?",
                               rsConverter:^(FMResultSet *rs){return [self masterVehicleFromResultSet:rs];}
                                        db:db
                                     error:errorBlk];
-  NSString *stmt = [NSString stringWithFormat:@"INSERT INTO %@ (%@, %@, %@, \
-%@, %@, %@, %@, %@, %@, %@, %@, %@, %@) VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
-                    TBL_MASTER_ENV_LOG,
-                    COL_MASTER_USER_ID,
-                    COL_MASTER_VEHICLE_ID,
-                    COL_GLOBAL_ID,
-                    COL_MEDIA_TYPE,
-                    COL_MST_CREATED_AT,
-                    COL_MST_UPDATED_AT,
-                    COL_MST_DELETED_DT,
-                    COL_ENVL_ODOMETER_READING,
-                    COL_ENVL_MPG_READING,
-                    COL_ENVL_MPH_READING,
-                    COL_ENVL_OUTSIDE_TEMP_READING,
-                    COL_ENVL_LOG_DT,
-                    COL_ENVL_DTE];
-  [PELMUtils doMasterInsert:stmt
-                  argsArray:@[PELMOrNil([user localMasterIdentifier]),
-                              PELMOrNil([vehicle localMasterIdentifier]),
-                              PELMOrNil([environmentLog globalIdentifier]),
-                              PELMOrNil([[environmentLog mediaType] description]),
-                              PELMOrNil([PEUtils millisecondsFromDate:[environmentLog createdAt]]),
-                              PELMOrNil([PEUtils millisecondsFromDate:[environmentLog updatedAt]]),
-                              PELMOrNil([PEUtils millisecondsFromDate:[environmentLog deletedAt]]),
-                              PELMOrNil([environmentLog odometer]),
-                              PELMOrNil([environmentLog reportedAvgMpg]),
-                              PELMOrNil([environmentLog reportedAvgMph]),
-                              PELMOrNil([environmentLog reportedOutsideTemp]),
-                              PELMOrNil([PEUtils millisecondsFromDate:[environmentLog logDate]]),
-                              PELMOrNil([environmentLog reportedDte])]
+  [PELMUtils doMasterInsert:[self insertStmtForTable:TBL_MASTER_ENV_LOG
+                                             columns:[self masterEnvironmentLogColumns]
+                                             numRows:1]
+                  argsArray:[self masterEnvironmentLogArgs:environmentLog
+                                                    userId:[user localMasterIdentifier]
+                                                 vehicleId:[vehicle localMasterIdentifier]]
                      entity:environmentLog
                          db:db
                       error:errorBlk];
 }
 
+- (NSArray *)masterEnvironmentLogColumns {
+  return @[COL_MASTER_USER_ID,
+           COL_MASTER_VEHICLE_ID,
+           COL_GLOBAL_ID,
+           COL_MEDIA_TYPE,
+           COL_MST_CREATED_AT,
+           COL_MST_UPDATED_AT,
+           COL_MST_DELETED_DT,
+           COL_ENVL_ODOMETER_READING,
+           COL_ENVL_MPG_READING,
+           COL_ENVL_MPH_READING,
+           COL_ENVL_OUTSIDE_TEMP_READING,
+           COL_ENVL_LOG_DT,
+           COL_ENVL_DTE];
+}
+
+/* In the order of masterEnvironmentLogColumns. */
+- (NSArray *)masterEnvironmentLogArgs:(FPEnvironmentLog *)environmentLog
+                               userId:(NSNumber *)userId
+                            vehicleId:(NSNumber *)vehicleId {
+  return @[PELMOrNil(userId),
+           PELMOrNil(vehicleId),
+           PELMOrNil([environmentLog globalIdentifier]),
+           PELMOrNil([[environmentLog mediaType] description]),
+           PELMOrNil([PEUtils millisecondsFromDate:[environmentLog createdAt]]),
+           PELMOrNil([PEUtils millisecondsFromDate:[environmentLog updatedAt]]),
+           PELMOrNil([PEUtils millisecondsFromDate:[environmentLog deletedAt]]),
+           PELMOrNil([environmentLog odometer]),
+           PELMOrNil([environmentLog reportedAvgMpg]),
+           PELMOrNil([environmentLog reportedAvgMph]),
+           PELMOrNil([environmentLog reportedOutsideTemp]),
+           PELMOrNil([PEUtils millisecondsFromDate:[environmentLog logDate]]),
+           PELMOrNil([environmentLog reportedDte])];
+}
+
 - (void)insertIntoMainEnvironmentLog:(FPEnvironmentLog *)environmentLog
                              forUser:(FPUser *)user
                              vehicle:(FPVehicle *)vehicle
@@ -7046,4 +8096,1339 @@ WHERE %@ = ?",
   return args;
 }
 
+#pragma mark - Bulk Import helpers (private)
+
+/*
+ Persists logs like persistDeepFuelPurchaseLogFromRemoteMaster:forUser:db:error:
+ does, but in multi-row inserts (see bulkInsertIntoMasterTable:...), with their
+ vehicles and fuel stations resolved through vehicleIds and fuelStationIds (see
+ masterLocalIdOfTable:globalId:ids:db:error:).  A log not naming its vehicle or
+ fuel station by global ID is persisted on its own.
+ */
+- (void)bulkPersistDeepFuelPurchaseLogsFromRemoteMaster:(NSArray *)fuelPurchaseLogs
+                                                forUser:(FPUser *)user
+                                             vehicleIds:(NSMutableDictionary *)vehicleIds
+                                         fuelStationIds:(NSMutableDictionary *)fuelStationIds
+                                                     db:(FMDatabase *)db
+                                                  error:(PELMDaoErrorBlk)errorBlk {
+  NSMutableArray *bulkLogs = [NSMutableArray arrayWithCapacity:fuelPurchaseLogs.count];
+  for (FPFuelPurchaseLog *fuelPurchaseLog in fuelPurchaseLogs) {
+    if ([fuelPurchaseLog vehicleGlobalIdentifier] && [fuelPurchaseLog fuelStationGlobalIdentifier]) {
+      [bulkLogs addObject:fuelPurchaseLog];
+    } else {
+      [self persistDeepFuelPurchaseLogFromRemoteMaster:fuelPurchaseLog forUser:user db:db error:errorBlk];
+    }
+  }
+  [self bulkInsertIntoMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                          columns:[self masterFuelPurchaseLogColumns]
+                         entities:bulkLogs
+                          argsBlk:^(FPFuelPurchaseLog *fuelPurchaseLog) {
+                            return [self masterFuelPurchaseLogArgs:fuelPurchaseLog
+                                                            userId:[user localMasterIdentifier]
+                                                         vehicleId:[self masterLocalIdOfTable:TBL_MASTER_VEHICLE
+                                                                                     globalId:[fuelPurchaseLog vehicleGlobalIdentifier]
+                                                                                          ids:vehicleIds
+                                                                                           db:db
+                                                                                        error:errorBlk]
+                                                     fuelStationId:[self masterLocalIdOfTable:TBL_MASTER_FUEL_STATION
+                                                                                     globalId:[fuelPurchaseLog fuelStationGlobalIdentifier]
+                                                                                          ids:fuelStationIds
+                                                                                           db:db
+                                                                                        error:errorBlk]];
+                          }
+                               db:db
+                            error:errorBlk];
+}
+
+/*
+ The environment log counterpart of
+ bulkPersistDeepFuelPurchaseLogsFromRemoteMaster:forUser:vehicleIds:fuelStationIds:db:error:.
+ */
+- (void)bulkPersistDeepEnvironmentLogsFromRemoteMaster:(NSArray *)environmentLogs
+                                               forUser:(FPUser *)user
+                                            vehicleIds:(NSMutableDictionary *)vehicleIds
+                                                    db:(FMDatabase *)db
+                                                 error:(PELMDaoErrorBlk)errorBlk {
+  NSMutableArray *bulkLogs = [NSMutableArray arrayWithCapacity:environmentLogs.count];
+  for (FPEnvironmentLog *environmentLog in environmentLogs) {
+    if ([environmentLog vehicleGlobalIdentifier]) {
+      [bulkLogs addObject:environmentLog];
+    } else {
+      [self persistDeepEnvironmentLogFromRemoteMaster:environmentLog forUser:user db:db error:errorBlk];
+    }
+  }
+  [self bulkInsertIntoMasterTable:TBL_MASTER_ENV_LOG
+                          columns:[self masterEnvironmentLogColumns]
+                         entities:bulkLogs
+                          argsBlk:^(FPEnvironmentLog *environmentLog) {
+                            return [self masterEnvironmentLogArgs:environmentLog
+                                                           userId:[user localMasterIdentifier]
+                                                        vehicleId:[self masterLocalIdOfTable:TBL_MASTER_VEHICLE
+                                                                                    globalId:[environmentLog vehicleGlobalIdentifier]
+                                                                                         ids:vehicleIds
+                                                                                          db:db
+                                                                                       error:errorBlk]];
+                          }
+                               db:db
+                            error:errorBlk];
+}
+
+/*
+ The local master ID of table's row with globalId; ids is consulted first, and
+ remembers what's looked up.
+ */
+- (NSNumber *)masterLocalIdOfTable:(NSString *)table
+                          globalId:(NSString *)globalId
+                               ids:(NSMutableDictionary *)ids
+                                db:(FMDatabase *)db
+                             error:(PELMDaoErrorBlk)errorBlk {
+  NSNumber *localId = ids[globalId];
+  if (!localId) {
+    localId = [PELMUtils numberFromTable:table
+                            selectColumn:COL_LOCAL_ID
+                             whereColumn:COL_GLOBAL_ID
+                              whereValue:globalId
+                                      db:db
+                                   error:errorBlk];
+    if (localId) {
+      ids[globalId] = localId;
+    }
+  }
+  return localId;
+}
+
+/* "(?, ?, ..., ?)", of numPlaceholders placeholders. */
+- (NSString *)placeholdersTuple:(NSUInteger)numPlaceholders {
+  NSMutableArray *placeholders = [NSMutableArray arrayWithCapacity:numPlaceholders];
+  for (NSUInteger i = 0; i < numPlaceholders; i++) {
+    [placeholders addObject:@"?"];
+  }
+  return [NSString stringWithFormat:@"(%@)", [placeholders componentsJoinedByString:@", "]];
+}
+
+- (NSString *)insertStmtForTable:(NSString *)table columns:(NSArray *)columns numRows:(NSUInteger)numRows {
+  NSString *row = [self placeholdersTuple:columns.count];
+  NSMutableArray *rows = [NSMutableArray arrayWithCapacity:numRows];
+  for (NSUInteger i = 0; i < numRows; i++) {
+    [rows addObject:row];
+  }
+  return [NSString stringWithFormat:@"INSERT INTO %@ (%@) VALUES %@",
+          table,
+          [columns componentsJoinedByString:@", "],
+          [rows componentsJoinedByString:@", "]];
+}
+
+/*
+ Inserts entities (each with a global ID) into master table, as many rows per
+ INSERT as fit under FP_MAX_STATEMENT_ARGS; every full batch is the same
+ statement, so it's prepared once.  The new rows' local IDs are read back (by
+ global ID) onto the entities, and then their relations are inserted.  Into an
+ empty table, a large enough batch defers the secondary indexes (see
+ FP_BULK_INSERT_DEFER_INDEXES_MIN_ROWS); being in the caller's transaction, a
+ failed import rolls back to the indexes it started with.
+ */
+- (void)bulkInsertIntoMasterTable:(NSString *)table
+                          columns:(NSArray *)columns
+                         entities:(NSArray *)entities
+                          argsBlk:(NSArray *(^)(id entity))argsBlk
+                               db:(FMDatabase *)db
+                            error:(PELMDaoErrorBlk)errorBlk {
+  if (entities.count == 0) {
+    return;
+  }
+  NSArray *deferredIndexes = @[];
+  if (entities.count >= FP_BULK_INSERT_DEFER_INDEXES_MIN_ROWS && [self isTableEmpty:table db:db error:errorBlk]) {
+    deferredIndexes = [self dropSecondaryIndexesOfTable:table db:db error:errorBlk];
+  }
+  NSUInteger rowsPerStmt = MAX(FP_MAX_STATEMENT_ARGS / columns.count, 1);
+  for (NSUInteger start = 0; start < entities.count; start += rowsPerStmt) {
+    NSArray *batch = [entities subarrayWithRange:NSMakeRange(start, MIN(rowsPerStmt, entities.count - start))];
+    NSMutableArray *args = [NSMutableArray arrayWithCapacity:batch.count * columns.count];
+    NSMutableDictionary *entitiesByGlobalId = [NSMutableDictionary dictionaryWithCapacity:batch.count];
+    for (PELMMainSupport *entity in batch) {
+      [args addObjectsFromArray:argsBlk(entity)];
+      entitiesByGlobalId[[entity globalIdentifier]] = entity;
+    }
+    [PELMUtils doUpdate:[self insertStmtForTable:table columns:columns numRows:batch.count]
+              argsArray:args
+                     db:db
+                  error:errorBlk];
+    NSString *qry = [NSString stringWithFormat:@"SELECT %@, %@ FROM %@ WHERE %@ IN %@",
+                     COL_GLOBAL_ID,
+                     COL_LOCAL_ID,
+                     table,
+                     COL_GLOBAL_ID,
+                     [self placeholdersTuple:entitiesByGlobalId.count]];
+    FMResultSet *rs = [PELMUtils doQuery:qry argsArray:[entitiesByGlobalId allKeys] db:db error:errorBlk];
+    while ([rs next]) {
+      [entitiesByGlobalId[[rs stringForColumn:COL_GLOBAL_ID]] setLocalMasterIdentifier:[PELMUtils numberFromResultSet:rs columnName:COL_LOCAL_ID]];
+    }
+    [rs close];
+  }
+  for (PELMMainSupport *entity in entities) {
+    [PELMUtils insertRelations:[entity relations]
+                     forEntity:entity
+                   entityTable:table
+               localIdentifier:[entity localMasterIdentifier]
+                            db:db
+                         error:errorBlk];
+  }
+  for (NSString *indexDDL in deferredIndexes) {
+    [PELMUtils doUpdate:indexDDL db:db error:errorBlk];
+  }
+}
+
+- (BOOL)isTableEmpty:(NSString *)table db:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk {
+  FMResultSet *rs = [PELMUtils doQuery:[NSString stringWithFormat:@"SELECT 1 FROM %@ LIMIT 1", table]
+                             argsArray:@[]
+                                    db:db
+                                 error:errorBlk];
+  BOOL isEmpty = ![rs next];
+  [rs close];
+  return isEmpty;
+}
+
+/*
+ Drops table's secondary indexes (those with DDL of their own, i.e., not the
+ ones backing its primary key or UNIQUE columns), returning their DDL.
+ */
+- (NSArray *)dropSecondaryIndexesOfTable:(NSString *)table db:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk {
+  NSMutableArray *names = [NSMutableArray array];
+  NSMutableArray *ddls = [NSMutableArray array];
+  FMResultSet *rs = [PELMUtils doQuery:@"SELECT name, sql FROM sqlite_master WHERE type = 'index' AND tbl_name = ? AND sql IS NOT NULL"
+                             argsArray:@[table]
+                                    db:db
+                                 error:errorBlk];
+  while ([rs next]) {
+    [names addObject:[rs stringForColumn:@"name"]];
+    [ddls addObject:[rs stringForColumn:@"sql"]];
+  }
+  [rs close];
+  for (NSString *name in names) {
+    [PELMUtils doUpdate:[NSString stringWithFormat:@"DROP INDEX %@", name] db:db error:errorBlk];
+  }
+  return ddls;
+}
+
+#pragma mark - Aggregate helpers (private)
+
+/*
+ A column's value in micro-units (see FPFixedPoint.h), as an integer, so that
+ SQLite's SUM, MIN and MAX over it are exact.
+ */
+- (NSString *)microsExprOfColumn:(NSString *)column colPrefix:(NSString *)colPrefix {
+  return [NSString stringWithFormat:@"CAST(ROUND(%@%@ * %lld) AS INTEGER)", colPrefix, column, (long long)FPMicrosPerUnit];
+}
+
+/*
+ num gallons * gallon price, in micro-units.  Both are stored with at most
+ FPEntryScale (3) decimal places, so the product of their milli-unit values is
+ exact, and the same as FPSumAddMicrosProduct's of their micro-unit values.
+ */
+- (NSString *)spentMicrosExprWithColPrefix:(NSString *)colPrefix {
+  return [NSString stringWithFormat:@"CAST(ROUND(%@%@ * 1000) AS INTEGER) * CAST(ROUND(%@%@ * 1000) AS INTEGER)",
+          colPrefix,
+          COL_FUELPL_NUM_GALLONS,
+          colPrefix,
+          COL_FUELPL_PRICE_PER_GALLON];
+}
+
+/* The measure's value expression yields micro-units. */
+- (NSString *(^)(NSString *))gasLogValueExprBlkForMeasure:(FPGasLogMeasure)measure {
+  switch (measure) {
+    case FPGasLogMeasureSpent:
+      return ^(NSString *colPrefix) {
+        return [self spentMicrosExprWithColPrefix:colPrefix];
+      };
+    case FPGasLogMeasureGallonPrice:
+      return ^(NSString *colPrefix) {
+        return [self microsExprOfColumn:COL_FUELPL_PRICE_PER_GALLON colPrefix:colPrefix];
+      };
+    case FPGasLogMeasureNumGallons:
+      return ^(NSString *colPrefix) {
+        return [self microsExprOfColumn:COL_FUELPL_NUM_GALLONS colPrefix:colPrefix];
+      };
+  }
+}
+
+/* The measure's value expression yields micro-units. */
+- (NSString *(^)(NSString *))odometerLogValueExprBlkForMeasure:(FPOdometerLogMeasure)measure {
+  switch (measure) {
+    case FPOdometerLogMeasureReportedAvgMpg:
+      return ^(NSString *colPrefix) {
+        return [self microsExprOfColumn:COL_ENVL_MPG_READING colPrefix:colPrefix];
+      };
+    case FPOdometerLogMeasureReportedAvgMph:
+      return ^(NSString *colPrefix) {
+        return [self microsExprOfColumn:COL_ENVL_MPH_READING colPrefix:colPrefix];
+      };
+    case FPOdometerLogMeasureOdometer:
+      return ^(NSString *colPrefix) {
+        return [self microsExprOfColumn:COL_ENVL_ODOMETER_READING colPrefix:colPrefix];
+      };
+    case FPOdometerLogMeasureOutsideTemp:
+      return ^(NSString *colPrefix) {
+        return [self microsExprOfColumn:COL_ENVL_OUTSIDE_TEMP_READING colPrefix:colPrefix];
+      };
+  }
+}
+
+- (NSString *(^)(NSString *))dateBoundsWhereBlkForDateColumn:(NSString *)dateColumn
+                                                   beforeDate:(NSDate *)beforeDate
+                                                onOrAfterDate:(NSDate *)onOrAfterDate
+                                                    whereArgs:(NSMutableArray *)whereArgs {
+  if (beforeDate) {
+    [whereArgs addObject:[PEUtils millisecondsFromDate:beforeDate]];
+  }
+  if (onOrAfterDate) {
+    [whereArgs addObject:[PEUtils millisecondsFromDate:onOrAfterDate]];
+  }
+  return ^(NSString *colPrefix) {
+    NSMutableArray *clauses = [NSMutableArray arrayWithCapacity:2];
+    if (beforeDate) {
+      [clauses addObject:[NSString stringWithFormat:@"%@%@ < ?", colPrefix, dateColumn]];
+    }
+    if (onOrAfterDate) {
+      [clauses addObject:[NSString stringWithFormat:@"%@%@ >= ?", colPrefix, dateColumn]];
+    }
+    return [clauses componentsJoinedByString:@" AND "];
+  };
+}
+
+- (FPLogAggregate *)aggregateOfGasLogMeasure:(FPGasLogMeasure)measure
+                                parentEntity:(PELMMainSupport *)parentEntity
+                           parentMasterTable:(NSString *)parentMasterTable
+                             parentMainTable:(NSString *)parentMainTable
+                  parentEntityMasterIdColumn:(NSString *)parentEntityMasterIdColumn
+                    parentEntityMainIdColumn:(NSString *)parentEntityMainIdColumn
+                                  beforeDate:(NSDate *)beforeDate
+                               onOrAfterDate:(NSDate *)onOrAfterDate
+                                      octane:(NSNumber *)octane
+                                      diesel:(BOOL)diesel
+                                       error:(PELMDaoErrorBlk)errorBlk {
+  NSMutableArray *whereArgs = [NSMutableArray array];
+  NSString *(^dateBoundsWhereBlk)(NSString *) = [self dateBoundsWhereBlkForDateColumn:COL_FUELPL_PURCHASED_AT
+                                                                           beforeDate:beforeDate
+                                                                        onOrAfterDate:onOrAfterDate
+                                                                            whereArgs:whereArgs];
+  if (!diesel && octane) {
+    [whereArgs addObject:octane];
+  }
+  NSString *(^whereBlk)(NSString *) = ^(NSString *colPrefix) {
+    NSMutableArray *clauses = [NSMutableArray array];
+    NSString *dateBounds = dateBoundsWhereBlk(colPrefix);
+    if (dateBounds.length > 0) {
+      [clauses addObject:dateBounds];
+    }
+    if (diesel) {
+      [clauses addObject:[NSString stringWithFormat:@"%@%@ is null AND %@%@ = 1",
+                          colPrefix,
+                          COL_FUELPL_OCTANE,
+                          colPrefix,
+                          COL_FUELPL_IS_DIESEL]];
+    } else if (octane) {
+      [clauses addObject:[NSString stringWithFormat:@"%@%@ = ?", colPrefix, COL_FUELPL_OCTANE]];
+    }
+    return [clauses componentsJoinedByString:@" AND "];
+  };
+  return [self aggregateOfValueExprBlk:[self gasLogValueExprBlkForMeasure:measure]
+                          parentEntity:parentEntity
+                     parentMasterTable:parentMasterTable
+                       parentMainTable:parentMainTable
+            parentEntityMasterIdColumn:parentEntityMasterIdColumn
+              parentEntityMainIdColumn:parentEntityMainIdColumn
+                     entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                       entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                              whereBlk:whereBlk
+                             whereArgs:whereArgs
+                                 error:errorBlk];
+}
+
+- (NSDictionary *)octaneAggregatesOfGasLogMeasure:(FPGasLogMeasure)measure
+                                     parentEntity:(PELMMainSupport *)parentEntity
+                                parentMasterTable:(NSString *)parentMasterTable
+                                  parentMainTable:(NSString *)parentMainTable
+                       parentEntityMasterIdColumn:(NSString *)parentEntityMasterIdColumn
+                         parentEntityMainIdColumn:(NSString *)parentEntityMainIdColumn
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk {
+  NSMutableArray *whereArgs = [NSMutableArray array];
+  NSString *(^dateBoundsWhereBlk)(NSString *) = [self dateBoundsWhereBlkForDateColumn:COL_FUELPL_PURCHASED_AT
+                                                                           beforeDate:beforeDate
+                                                                        onOrAfterDate:onOrAfterDate
+                                                                            whereArgs:whereArgs];
+  NSString *(^valueExprBlk)(NSString *) = [self gasLogValueExprBlkForMeasure:measure];
+  NSString *(^projectionBlk)(NSString *) = ^(NSString *colPrefix) {
+    return [NSString stringWithFormat:@"%@ AS fk, %@ AS val", [self fuelKeyExprWithColPrefix:colPrefix], valueExprBlk(colPrefix)];
+  };
+  NSMutableDictionary *octaneAggregates = [NSMutableDictionary dictionary];
+  [self inReadDatabase:^(FMDatabase *db) {
+    NSMutableArray *args = [NSMutableArray array];
+    NSString *union = [self effectiveUnionOfProjectionBlk:projectionBlk
+                                             parentEntity:parentEntity
+                                        parentMasterTable:parentMasterTable
+                                          parentMainTable:parentMainTable
+                               parentEntityMasterIdColumn:parentEntityMasterIdColumn
+                                 parentEntityMainIdColumn:parentEntityMainIdColumn
+                                        entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                          entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                                                 whereBlk:dateBoundsWhereBlk
+                                                whereArgs:whereArgs
+                                                     args:args
+                                                       db:db
+                                                    error:errorBlk];
+    if (!union) {
+      return;
+    }
+    NSString *qry = [NSString stringWithFormat:@"SELECT fk, COUNT(*), COUNT(val), IFNULL(SUM(val), 0), MIN(val), MAX(val) FROM (%@) \
+WHERE fk <> %ld GROUP BY fk", union, (long)FP_ROLLUP_FUEL_KEY_UNSPECIFIED];
+    FMResultSet *rs = [PELMUtils doQuery:qry argsArray:args db:db error:errorBlk];
+    while ([rs next]) {
+      octaneAggregates[@([rs longForColumnIndex:0])] =
+        [[FPLogAggregate alloc] initWithNumLogs:[rs longForColumnIndex:1]
+                                          count:[rs longForColumnIndex:2]
+                                            sum:[self decimalNumberFromMicrosResultSet:rs columnIndex:3]
+                                            min:[self decimalNumberFromMicrosResultSet:rs columnIndex:4]
+                                            max:[self decimalNumberFromMicrosResultSet:rs columnIndex:5]];
+    }
+    [rs close];
+  }];
+  return octaneAggregates;
+}
+
+- (NSArray *)distinctOctanesForParentEntity:(PELMMainSupport *)parentEntity
+                          parentMasterTable:(NSString *)parentMasterTable
+                            parentMainTable:(NSString *)parentMainTable
+                 parentEntityMasterIdColumn:(NSString *)parentEntityMasterIdColumn
+                   parentEntityMainIdColumn:(NSString *)parentEntityMainIdColumn
+                                      error:(PELMDaoErrorBlk)errorBlk {
+  NSString *(^octaneProjectionBlk)(NSString *) = ^(NSString *colPrefix) {
+    return [NSString stringWithFormat:@"%@%@ AS val", colPrefix, COL_FUELPL_OCTANE];
+  };
+  NSString *(^octaneWhereBlk)(NSString *) = ^(NSString *colPrefix) {
+    return [NSString stringWithFormat:@"%@%@ IS NOT NULL", colPrefix, COL_FUELPL_OCTANE];
+  };
+  NSMutableArray *octanes = [NSMutableArray array];
+  [self inReadDatabase:^(FMDatabase *db) {
+    NSMutableArray *args = [NSMutableArray array];
+    NSString *union = [self effectiveUnionOfProjectionBlk:octaneProjectionBlk
+                                             parentEntity:parentEntity
+                                        parentMasterTable:parentMasterTable
+                                          parentMainTable:parentMainTable
+                               parentEntityMasterIdColumn:parentEntityMasterIdColumn
+                                 parentEntityMainIdColumn:parentEntityMainIdColumn
+                                        entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                          entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                                                 whereBlk:octaneWhereBlk
+                                                whereArgs:@[]
+                                                     args:args
+                                                       db:db
+                                                    error:errorBlk];
+    if (!union) {
+      return;
+    }
+    FMResultSet *rs = [PELMUtils doQuery:[NSString stringWithFormat:@"SELECT DISTINCT val FROM (%@) ORDER BY val", union]
+                               argsArray:args
+                                      db:db
+                                   error:errorBlk];
+    while ([rs next]) {
+      [octanes addObject:@([rs intForColumnIndex:0])];
+    }
+    [rs close];
+  }];
+  return octanes;
+}
+
+- (FPLogAggregate *)aggregateOfOdometerLogMeasure:(FPOdometerLogMeasure)measure
+                                     parentEntity:(PELMMainSupport *)parentEntity
+                                parentMasterTable:(NSString *)parentMasterTable
+                                  parentMainTable:(NSString *)parentMainTable
+                       parentEntityMasterIdColumn:(NSString *)parentEntityMasterIdColumn
+                         parentEntityMainIdColumn:(NSString *)parentEntityMainIdColumn
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                            error:(PELMDaoErrorBlk)errorBlk {
+  NSMutableArray *whereArgs = [NSMutableArray array];
+  return [self aggregateOfValueExprBlk:[self odometerLogValueExprBlkForMeasure:measure]
+                          parentEntity:parentEntity
+                     parentMasterTable:parentMasterTable
+                       parentMainTable:parentMainTable
+            parentEntityMasterIdColumn:parentEntityMasterIdColumn
+              parentEntityMainIdColumn:parentEntityMainIdColumn
+                     entityMasterTable:TBL_MASTER_ENV_LOG
+                       entityMainTable:TBL_MAIN_ENV_LOG
+                              whereBlk:[self dateBoundsWhereBlkForDateColumn:COL_ENVL_LOG_DT
+                                                                  beforeDate:beforeDate
+                                                               onOrAfterDate:onOrAfterDate
+                                                                   whereArgs:whereArgs]
+                             whereArgs:whereArgs
+                                 error:errorBlk];
+}
+
+- (NSDecimalNumber *)decimalNumberFromMicrosResultSet:(FMResultSet *)rs columnIndex:(int)columnIndex {
+  if ([rs columnIndexIsNull:columnIndex]) {
+    return nil;
+  }
+  return FPDecimalNumberFromMicros([rs longLongIntForColumnIndex:columnIndex]);
+}
+
+/*
+ Returns the UNION ALL of the parent entity's master and main child rows,
+ selecting the columns given by projectionBlk (and appending the query args to
+ args), or nil if the parent entity has no rows in either table.  Master rows
+ that have been copied down to the main table are excluded from the master half
+ so that each log appears exactly once.
+ */
+- (NSString *)effectiveUnionOfProjectionBlk:(NSString *(^)(NSString *))projectionBlk
+                               parentEntity:(PELMMainSupport *)parentEntity
+                          parentMasterTable:(NSString *)parentMasterTable
+                            parentMainTable:(NSString *)parentMainTable
+                 parentEntityMasterIdColumn:(NSString *)parentEntityMasterIdColumn
+                   parentEntityMainIdColumn:(NSString *)parentEntityMainIdColumn
+                          entityMasterTable:(NSString *)entityMasterTable
+                            entityMainTable:(NSString *)entityMainTable
+                                   whereBlk:(NSString *(^)(NSString *))whereBlk
+                                  whereArgs:(NSArray *)whereArgs
+                                       args:(NSMutableArray *)args
+                                         db:(FMDatabase *)db
+                                      error:(PELMDaoErrorBlk)errorBlk {
+  NSNumber *parentMasterId = [self masterIdForParentEntity:parentEntity parentMasterTable:parentMasterTable db:db error:errorBlk];
+  NSNumber *parentMainId = [self mainIdForParentEntity:parentEntity parentMainTable:parentMainTable db:db error:errorBlk];
+  NSMutableArray *selects = [NSMutableArray arrayWithCapacity:2];
+  if (parentMasterId) {
+    NSString *where = whereBlk ? whereBlk(@"mstr.") : @"";
+    [selects addObject:[NSString stringWithFormat:@"SELECT %@ FROM %@ mstr WHERE mstr.%@ = ? AND \
+mstr.%@ NOT IN (SELECT %@ FROM %@ WHERE %@ IS NOT NULL)%@%@",
+                        projectionBlk(@"mstr."),
+                        entityMasterTable,
+                        parentEntityMasterIdColumn,
+                        COL_GLOBAL_ID,
+                        COL_GLOBAL_ID,
+                        entityMainTable,
+                        COL_GLOBAL_ID,
+                        where.length > 0 ? @" AND " : @"",
+                        where]];
+    [args addObject:parentMasterId];
+    [args addObjectsFromArray:whereArgs];
+  }
+  if (parentMainId) {
+    NSString *where = whereBlk ? whereBlk(@"man.") : @"";
+    [selects addObject:[NSString stringWithFormat:@"SELECT %@ FROM %@ man WHERE man.%@ = ?%@%@",
+                        projectionBlk(@"man."),
+                        entityMainTable,
+                        parentEntityMainIdColumn,
+                        where.length > 0 ? @" AND " : @"",
+                        where]];
+    [args addObject:parentMainId];
+    [args addObjectsFromArray:whereArgs];
+  }
+  if (selects.count == 0) {
+    return nil;
+  }
+  return [selects componentsJoinedByString:@" UNION ALL "];
+}
+
+/*
+ The names of table's columns, in table order.  Cached; columns are only ever
+ added by a schema migration, which clears the cache.
+ */
+- (NSArray *)columnsOfTable:(NSString *)table db:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk {
+  NSArray *columns = [_tableColumns objectForKey:table];
+  if (!columns) {
+    NSMutableArray *names = [NSMutableArray array];
+    FMResultSet *rs = [PELMUtils doQuery:[NSString stringWithFormat:@"PRAGMA table_info(%@)", table]
+                               argsArray:@[]
+                                      db:db
+                                   error:errorBlk];
+    while ([rs next]) {
+      [names addObject:[rs stringForColumn:@"name"]];
+    }
+    [rs close];
+    columns = names;
+    [_tableColumns setObject:columns forKey:table];
+  }
+  return columns;
+}
+
+/*
+ Fetches the parent entity's effective child entities (each child's main row
+ if it has one, otherwise its master row) with a single statement over
+ effectiveUnionOfProjectionBlk:..., rather than a query per table merged and
+ sorted in memory (as PELMUtils' entitiesForParentEntity:... does).  Both
+ halves of the union select every column of either table (NULL where a table
+ doesn't have it), plus which table the row came from, so each row goes to
+ the matching converter.  The filtering happens in each half, against the
+ tables' indexes; only the ordering and the page size (if given) apply to the
+ union as a whole.
+ */
+- (NSArray *)effectiveEntitiesForParentEntity:(PELMMainSupport *)parentEntity
+                            parentMasterTable:(NSString *)parentMasterTable
+                              parentMainTable:(NSString *)parentMainTable
+                   parentEntityMasterIdColumn:(NSString *)parentEntityMasterIdColumn
+                     parentEntityMainIdColumn:(NSString *)parentEntityMainIdColumn
+                            entityMasterTable:(NSString *)entityMasterTable
+                              entityMainTable:(NSString *)entityMainTable
+               masterEntityResultSetConverter:(PELMEntityFromResultSetBlk)masterEntityResultSetConverter
+                 mainEntityResultSetConverter:(PELMEntityFromResultSetBlk)mainEntityResultSetConverter
+                                     whereBlk:(NSString *(^)(NSString *))whereBlk
+                                    whereArgs:(NSArray *)whereArgs
+                          orderByDomainColumn:(NSString *)orderByDomainColumn
+                 orderByDomainColumnDirection:(NSString *)orderByDomainColumnDirection
+                                     pageSize:(NSNumber *)pageSize
+                                           db:(FMDatabase *)db
+                                        error:(PELMDaoErrorBlk)errorBlk {
+  NSArray *masterColumns = [self columnsOfTable:entityMasterTable db:db error:errorBlk];
+  NSArray *mainColumns = [self columnsOfTable:entityMainTable db:db error:errorBlk];
+  NSMutableOrderedSet *columns = [NSMutableOrderedSet orderedSetWithArray:masterColumns];
+  [columns addObjectsFromArray:mainColumns];
+  NSString *(^projectionBlk)(NSString *) = ^(NSString *colPrefix) {
+    BOOL isMaster = [colPrefix isEqualToString:@"mstr."];
+    NSArray *tableColumns = isMaster ? masterColumns : mainColumns;
+    NSMutableArray *projection = [NSMutableArray arrayWithCapacity:columns.count + 1];
+    [projection addObject:[NSString stringWithFormat:@"%ld AS %@",
+                           (long)(isMaster ? FP_ROLLUP_SRC_MASTER : FP_ROLLUP_SRC_MAIN),
+                           FP_EFFECTIVE_SRC]];
+    for (NSString *column in columns) {
+      [projection addObject:[tableColumns containsObject:column] ?
+       [NSString stringWithFormat:@"%@%@ AS %@", colPrefix, column, column] :
+       [NSString stringWithFormat:@"NULL AS %@", column]];
+    }
+    return [projection componentsJoinedByString:@", "];
+  };
+  NSMutableArray *args = [NSMutableArray array];
+  NSString *union = [self effectiveUnionOfProjectionBlk:projectionBlk
+                                           parentEntity:parentEntity
+                                      parentMasterTable:parentMasterTable
+                                        parentMainTable:parentMainTable
+                             parentEntityMasterIdColumn:parentEntityMasterIdColumn
+                               parentEntityMainIdColumn:parentEntityMainIdColumn
+                                      entityMasterTable:entityMasterTable
+                                        entityMainTable:entityMainTable
+                                               whereBlk:whereBlk
+                                              whereArgs:whereArgs
+                                                   args:args
+                                                     db:db
+                                                  error:errorBlk];
+  if (!union) {
+    return @[];
+  }
+  NSMutableString *qry = [NSMutableString stringWithFormat:@"SELECT * FROM (%@)", union];
+  if (orderByDomainColumn) {
+    [qry appendFormat:@" ORDER BY %@ %@", orderByDomainColumn, orderByDomainColumnDirection];
+  }
+  if (pageSize) {
+    [qry appendString:@" LIMIT ?"];
+    [args addObject:pageSize];
+  }
+  NSMutableArray *entities = [NSMutableArray array];
+  FMResultSet *rs = [PELMUtils doQuery:qry argsArray:args db:db error:errorBlk];
+  while ([rs next]) {
+    if ([rs longForColumn:FP_EFFECTIVE_SRC] == FP_ROLLUP_SRC_MAIN) {
+      [entities addObject:mainEntityResultSetConverter(rs)];
+    } else {
+      [entities addObject:masterEntityResultSetConverter(rs)];
+    }
+  }
+  [rs close];
+  return entities;
+}
+
+/*
+ Computes the aggregate over the union of the parent entity's master and main
+ child rows.
+ */
+- (FPLogAggregate *)aggregateOfValueExprBlk:(NSString *(^)(NSString *))valueExprBlk
+                               parentEntity:(PELMMainSupport *)parentEntity
+                          parentMasterTable:(NSString *)parentMasterTable
+                            parentMainTable:(NSString *)parentMainTable
+                 parentEntityMasterIdColumn:(NSString *)parentEntityMasterIdColumn
+                   parentEntityMainIdColumn:(NSString *)parentEntityMainIdColumn
+                          entityMasterTable:(NSString *)entityMasterTable
+                            entityMainTable:(NSString *)entityMainTable
+                                   whereBlk:(NSString *(^)(NSString *))whereBlk
+                                  whereArgs:(NSArray *)whereArgs
+                                      error:(PELMDaoErrorBlk)errorBlk {
+  NSString *(^projectionBlk)(NSString *) = ^(NSString *colPrefix) {
+    return [NSString stringWithFormat:@"%@ AS val", valueExprBlk(colPrefix)];
+  };
+  __block FPLogAggregate *aggregate = nil;
+  [self inReadDatabase:^(FMDatabase *db) {
+    NSMutableArray *args = [NSMutableArray array];
+    NSString *union = [self effectiveUnionOfProjectionBlk:projectionBlk
+                                             parentEntity:parentEntity
+                                        parentMasterTable:parentMasterTable
+                                          parentMainTable:parentMainTable
+                               parentEntityMasterIdColumn:parentEntityMasterIdColumn
+                                 parentEntityMainIdColumn:parentEntityMainIdColumn
+                                        entityMasterTable:entityMasterTable
+                                          entityMainTable:entityMainTable
+                                                 whereBlk:whereBlk
+                                                whereArgs:whereArgs
+                                                     args:args
+                                                       db:db
+                                                    error:errorBlk];
+    if (!union) {
+      return;
+    }
+    NSString *qry = [NSString stringWithFormat:@"SELECT COUNT(*), COUNT(val), IFNULL(SUM(val), 0), MIN(val), MAX(val) FROM (%@)", union];
+    FMResultSet *rs = [PELMUtils doQuery:qry argsArray:args db:db error:errorBlk];
+    if ([rs next]) {
+      aggregate = [[FPLogAggregate alloc] initWithNumLogs:[rs longForColumnIndex:0]
+                                                    count:[rs longForColumnIndex:1]
+                                                      sum:[self decimalNumberFromMicrosResultSet:rs columnIndex:2]
+                                                      min:[self decimalNumberFromMicrosResultSet:rs columnIndex:3]
+                                                      max:[self decimalNumberFromMicrosResultSet:rs columnIndex:4]];
+    }
+    [rs close];
+  }];
+  if (!aggregate) {
+    aggregate = [[FPLogAggregate alloc] initWithNumLogs:0 count:0 sum:[NSDecimalNumber zero] min:nil max:nil];
+  }
+  return aggregate;
+}
+
+#pragma mark - Log Columns helpers (private)
+
+- (FPLogColumns *)gasLogColumnsForParentEntity:(PELMMainSupport *)parentEntity
+                             parentMasterTable:(NSString *)parentMasterTable
+                               parentMainTable:(NSString *)parentMainTable
+                    parentEntityMasterIdColumn:(NSString *)parentEntityMasterIdColumn
+                      parentEntityMainIdColumn:(NSString *)parentEntityMainIdColumn
+                                         error:(PELMDaoErrorBlk)errorBlk {
+  NSString *(^projectionBlk)(NSString *) = ^(NSString *colPrefix) {
+    return [NSString stringWithFormat:@"%@%@ AS dt, %@%@ AS g, %@%@ AS p, %@%@ AS oct, %@%@ AS dsl, %@%@ AS o",
+            colPrefix, COL_FUELPL_PURCHASED_AT,
+            colPrefix, COL_FUELPL_NUM_GALLONS,
+            colPrefix, COL_FUELPL_PRICE_PER_GALLON,
+            colPrefix, COL_FUELPL_OCTANE,
+            colPrefix, COL_FUELPL_IS_DIESEL,
+            colPrefix, COL_FUELPL_ODOMETER];
+  };
+  NSString *(^whereBlk)(NSString *) = ^(NSString *colPrefix) {
+    return [NSString stringWithFormat:@"%@%@ IS NOT NULL", colPrefix, COL_FUELPL_PURCHASED_AT];
+  };
+  FPLogColumns *columns = [[FPLogColumns alloc] init];
+  [self inReadDatabase:^(FMDatabase *db) {
+    NSMutableArray *args = [NSMutableArray array];
+    NSString *union = [self effectiveUnionOfProjectionBlk:projectionBlk
+                                             parentEntity:parentEntity
+                                        parentMasterTable:parentMasterTable
+                                          parentMainTable:parentMainTable
+                               parentEntityMasterIdColumn:parentEntityMasterIdColumn
+                                 parentEntityMainIdColumn:parentEntityMainIdColumn
+                                        entityMasterTable:TBL_MASTER_FUELPURCHASE_LOG
+                                          entityMainTable:TBL_MAIN_FUELPURCHASE_LOG
+                                                 whereBlk:whereBlk
+                                                whereArgs:@[]
+                                                     args:args
+                                                       db:db
+                                                    error:errorBlk];
+    if (!union) {
+      return;
+    }
+    FMResultSet *rs = [PELMUtils doQuery:[NSString stringWithFormat:@"SELECT * FROM (%@) ORDER BY dt", union]
+                               argsArray:args
+                                      db:db
+                                   error:errorBlk];
+    while ([rs next]) {
+      [columns appendRowWithPurchasedAtMillis:[rs longLongIntForColumn:@"dt"]
+                                   numGallons:[PELMUtils decimalNumberFromResultSet:rs columnName:@"g"]
+                                  gallonPrice:[PELMUtils decimalNumberFromResultSet:rs columnName:@"p"]
+                                       octane:[rs columnIsNull:@"oct"] ? nil : @([rs intForColumn:@"oct"])
+                                     isDiesel:[rs boolForColumn:@"dsl"]
+                                     odometer:[PELMUtils decimalNumberFromResultSet:rs columnName:@"o"]];
+    }
+    [rs close];
+  }];
+  return columns;
+}
+
+#pragma mark - Monthly Rollup helpers (private)
+
+/*
+ Each source is: [rollup table, src, log table, log table's parent id column,
+ log table's date column, main log table that shadows it (or NSNull)].
+ */
+- (NSArray *)monthlyRollupSources {
+  return @[@[TBL_VEHICLE_GAS_MONTHLY_ROLLUP, @(FP_ROLLUP_SRC_MASTER), TBL_MASTER_FUELPURCHASE_LOG, COL_MASTER_VEHICLE_ID, COL_FUELPL_PURCHASED_AT, TBL_MAIN_FUELPURCHASE_LOG],
+           @[TBL_VEHICLE_GAS_MONTHLY_ROLLUP, @(FP_ROLLUP_SRC_MAIN), TBL_MAIN_FUELPURCHASE_LOG, COL_MAIN_VEHICLE_ID, COL_FUELPL_PURCHASED_AT, [NSNull null]],
+           @[TBL_FUELSTATION_GAS_MONTHLY_ROLLUP, @(FP_ROLLUP_SRC_MASTER), TBL_MASTER_FUELPURCHASE_LOG, COL_MASTER_FUELSTATION_ID, COL_FUELPL_PURCHASED_AT, TBL_MAIN_FUELPURCHASE_LOG],
+           @[TBL_FUELSTATION_GAS_MONTHLY_ROLLUP, @(FP_ROLLUP_SRC_MAIN), TBL_MAIN_FUELPURCHASE_LOG, COL_MAIN_FUELSTATION_ID, COL_FUELPL_PURCHASED_AT, [NSNull null]],
+           @[TBL_VEHICLE_ODOMETER_MONTHLY_ROLLUP, @(FP_ROLLUP_SRC_MASTER), TBL_MASTER_ENV_LOG, COL_MASTER_VEHICLE_ID, COL_ENVL_LOG_DT, TBL_MAIN_ENV_LOG],
+           @[TBL_VEHICLE_ODOMETER_MONTHLY_ROLLUP, @(FP_ROLLUP_SRC_MAIN), TBL_MAIN_ENV_LOG, COL_MAIN_VEHICLE_ID, COL_ENVL_LOG_DT, [NSNull null]]];
+}
+
+- (NSArray *)monthlyRollupSourceForTable:(NSString *)rollupTable src:(NSNumber *)src {
+  for (NSArray *source in [self monthlyRollupSources]) {
+    if ([source[0] isEqualToString:rollupTable] && [source[1] isEqualToNumber:src]) {
+      return source;
+    }
+  }
+  return nil;
+}
+
+/*
+ Returns [rollup columns, aggregate expressions, per-log projection, grouping
+ column, sketch column, sketched projection column, rollup column matching the
+ grouping column (or NSNull)] used to recompute one month of the given rollup
+ table.  The projected measures are in micro-units, so the rolled up totals,
+ minimums and maximums are exact.
+ */
+- (NSArray *)monthlyRollupRecomputePartsForTable:(NSString *)rollupTable {
+  if ([rollupTable isEqualToString:TBL_VEHICLE_ODOMETER_MONTHLY_ROLLUP]) {
+    return @[[@[COL_ROLLUP_NUM_LOGS,
+                COL_ROLLUP_ODOMETER_COUNT,
+                COL_ROLLUP_ODOMETER_MIN,
+                COL_ROLLUP_ODOMETER_MAX,
+                COL_ROLLUP_MPG_TOTAL,
+                COL_ROLLUP_MPG_COUNT,
+                COL_ROLLUP_MPH_TOTAL,
+                COL_ROLLUP_MPH_COUNT,
+                COL_ROLLUP_TEMP_TOTAL,
+                COL_ROLLUP_TEMP_COUNT] componentsJoinedByString:@", "],
+             @"COUNT(*), COUNT(o), MIN(o), MAX(o), IFNULL(SUM(mpg), 0), COUNT(mpg), IFNULL(SUM(mph), 0), COUNT(mph), IFNULL(SUM(t), 0), COUNT(t)",
+             [NSString stringWithFormat:@"0 AS grp, %@ AS o, %@ AS mpg, %@ AS mph, %@ AS t",
+              [self microsExprOfColumn:COL_ENVL_ODOMETER_READING colPrefix:@""],
+              [self microsExprOfColumn:COL_ENVL_MPG_READING colPrefix:@""],
+              [self microsExprOfColumn:COL_ENVL_MPH_READING colPrefix:@""],
+              [self microsExprOfColumn:COL_ENVL_OUTSIDE_TEMP_READING colPrefix:@""]],
+             @"grp",
+             COL_ROLLUP_MPG_SKETCH,
+             @"mpg",
+             [NSNull null]];
+  }
+  return @[[@[COL_ROLLUP_FUEL_KEY,
+              COL_ROLLUP_NUM_LOGS,
+              COL_ROLLUP_GALLONS_TOTAL,
+              COL_ROLLUP_GALLONS_COUNT,
+              COL_ROLLUP_SPEND_TOTAL,
+              COL_ROLLUP_SPEND_COUNT,
+              COL_ROLLUP_PRICE_TOTAL,
+              COL_ROLLUP_PRICE_COUNT,
+              COL_ROLLUP_ODOMETER_COUNT,
+              COL_ROLLUP_ODOMETER_MIN,
+              COL_ROLLUP_ODOMETER_MAX] componentsJoinedByString:@", "],
+           @"fk, COUNT(*), IFNULL(SUM(g), 0), COUNT(g), IFNULL(SUM(s), 0), COUNT(s), IFNULL(SUM(p), 0), COUNT(p), COUNT(o), MIN(o), MAX(o)",
+           [NSString stringWithFormat:@"%@ AS fk, %@ AS g, %@ AS s, %@ AS p, %@ AS o",
+            [self fuelKeyExprWithColPrefix:@""],
+            [self microsExprOfColumn:COL_FUELPL_NUM_GALLONS colPrefix:@""],
+            [self spentMicrosExprWithColPrefix:@""],
+            [self microsExprOfColumn:COL_FUELPL_PRICE_PER_GALLON colPrefix:@""],
+            [self microsExprOfColumn:COL_FUELPL_ODOMETER colPrefix:@""]],
+           @"fk",
+           COL_ROLLUP_PRICE_SKETCH,
+           @"p",
+           COL_ROLLUP_FUEL_KEY];
+}
+
+/*
+ A gas log's fuel key: FPOctaneKeyDiesel for a diesel log without an octane
+ (exactly what the diesel filters select), else its octane, else
+ FP_ROLLUP_FUEL_KEY_UNSPECIFIED.  A diesel-flagged log with an octane is keyed
+ by the octane, as the octane filters select it.
+ */
+- (NSString *)fuelKeyExprWithColPrefix:(NSString *)colPrefix {
+  return [NSString stringWithFormat:@"CASE WHEN %@%@ IS NULL AND %@%@ = 1 THEN %ld WHEN %@%@ IS NOT NULL THEN %@%@ ELSE %ld END",
+          colPrefix, COL_FUELPL_OCTANE,
+          colPrefix, COL_FUELPL_IS_DIESEL,
+          (long)FPOctaneKeyDiesel,
+          colPrefix, COL_FUELPL_OCTANE,
+          colPrefix, COL_FUELPL_OCTANE,
+          (long)FP_ROLLUP_FUEL_KEY_UNSPECIFIED];
+}
+
+- (NSNumber *)rollupFuelKeyForOctane:(NSNumber *)octane diesel:(BOOL)diesel {
+  if (diesel) {
+    return @(FPOctaneKeyDiesel);
+  }
+  return octane;
+}
+
+/*
+ Returns [count column, total column, min column, max column]; the columns
+ that aren't rolled up for the measure are NSNull.
+ */
+- (NSArray *)gasLogRollupColumnsForMeasure:(FPGasLogMeasure)measure {
+  switch (measure) {
+    case FPGasLogMeasureSpent:
+      return @[COL_ROLLUP_SPEND_COUNT, COL_ROLLUP_SPEND_TOTAL, [NSNull null], [NSNull null]];
+    case FPGasLogMeasureGallonPrice:
+      return @[COL_ROLLUP_PRICE_COUNT, COL_ROLLUP_PRICE_TOTAL, [NSNull null], [NSNull null]];
+    case FPGasLogMeasureNumGallons:
+      return @[COL_ROLLUP_GALLONS_COUNT, COL_ROLLUP_GALLONS_TOTAL, [NSNull null], [NSNull null]];
+  }
+}
+
+- (NSArray *)odometerLogRollupColumnsForMeasure:(FPOdometerLogMeasure)measure {
+  switch (measure) {
+    case FPOdometerLogMeasureReportedAvgMpg:
+      return @[COL_ROLLUP_MPG_COUNT, COL_ROLLUP_MPG_TOTAL, [NSNull null], [NSNull null]];
+    case FPOdometerLogMeasureReportedAvgMph:
+      return @[COL_ROLLUP_MPH_COUNT, COL_ROLLUP_MPH_TOTAL, [NSNull null], [NSNull null]];
+    case FPOdometerLogMeasureOdometer:
+      return @[COL_ROLLUP_ODOMETER_COUNT, [NSNull null], COL_ROLLUP_ODOMETER_MIN, COL_ROLLUP_ODOMETER_MAX];
+    case FPOdometerLogMeasureOutsideTemp:
+      return @[COL_ROLLUP_TEMP_COUNT, COL_ROLLUP_TEMP_TOTAL, [NSNull null], [NSNull null]];
+  }
+}
+
+- (void)rebuildMonthlyRollupsWithDb:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk {
+  FPMonthBoundaries *boundaries = [FPMonthBoundaries currentBoundaries];
+  [self recordMonthlyRollupsCalendar:boundaries.calendar db:db error:errorBlk];
+  for (NSString *rollupTable in @[TBL_VEHICLE_GAS_MONTHLY_ROLLUP,
+                                  TBL_FUELSTATION_GAS_MONTHLY_ROLLUP,
+                                  TBL_VEHICLE_ODOMETER_MONTHLY_ROLLUP]) {
+    [PELMUtils doUpdate:[NSString stringWithFormat:@"DELETE FROM %@", rollupTable] db:db error:errorBlk];
+  }
+  for (NSArray *source in [self monthlyRollupSources]) {
+    [PELMUtils doUpdate:[NSString stringWithFormat:@"INSERT OR IGNORE INTO %@ (%@, %@, %@, %@) \
+SELECT '%@', %@, %@, %@ FROM %@ WHERE %@ IS NOT NULL AND %@ IS NOT NULL",
+                         TBL_MONTHLY_ROLLUP_DIRTY,
+                         COL_ROLLUP_DIRTY_TABLE,
+                         COL_ROLLUP_SRC,
+                         COL_ROLLUP_PARENT_ID,
+                         COL_ROLLUP_DIRTY_LOG_DT,
+                         source[0], source[1], source[3], source[4], source[2],
+                         source[3], source[4]]
+                     db:db
+                  error:errorBlk];
+  }
+  [self recomputeDirtyMonthlyRollupsWithBoundaries:boundaries db:db error:errorBlk];
+}
+
+- (void)refreshMonthlyRollupsWithDb:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk {
+  FPMonthBoundaries *boundaries = [FPMonthBoundaries currentBoundaries];
+  if (![self monthlyRollupsAreKeyedByCalendar:boundaries.calendar db:db error:errorBlk]) {
+    // the month boundaries moved under the rollups (time zone or calendar
+    // change, maybe while the app wasn't running), so every month key is suspect
+    [self rebuildMonthlyRollupsWithDb:db error:errorBlk];
+    return;
+  }
+  [self recomputeDirtyMonthlyRollupsWithBoundaries:boundaries db:db error:errorBlk];
+}
+
+/*
+ The calendar the rollups are keyed by is kept in the database, not in memory,
+ so that a time zone or locale change made while the app wasn't running is
+ caught on the next open.
+ */
+- (BOOL)monthlyRollupsAreKeyedByCalendar:(NSCalendar *)calendar
+                                      db:(FMDatabase *)db
+                                   error:(PELMDaoErrorBlk)errorBlk {
+  FMResultSet *rs = [PELMUtils doQuery:[NSString stringWithFormat:@"SELECT %@, %@ FROM %@",
+                                        COL_ROLLUP_CALENDAR_ID,
+                                        COL_ROLLUP_TIME_ZONE_NAME,
+                                        TBL_MONTHLY_ROLLUP_CALENDAR]
+                             argsArray:@[]
+                                    db:db
+                                 error:errorBlk];
+  BOOL keyedByCalendar = NO;
+  if ([rs next]) {
+    keyedByCalendar = [[rs stringForColumnIndex:0] isEqualToString:calendar.calendarIdentifier] &&
+      [[rs stringForColumnIndex:1] isEqualToString:calendar.timeZone.name];
+  }
+  [rs close];
+  return keyedByCalendar;
+}
+
+- (void)recordMonthlyRollupsCalendar:(NSCalendar *)calendar
+                                  db:(FMDatabase *)db
+                               error:(PELMDaoErrorBlk)errorBlk {
+  [PELMUtils doUpdate:[NSString stringWithFormat:@"DELETE FROM %@", TBL_MONTHLY_ROLLUP_CALENDAR] db:db error:errorBlk];
+  [PELMUtils doUpdate:[NSString stringWithFormat:@"INSERT INTO %@ (%@, %@) VALUES (?, ?)",
+                       TBL_MONTHLY_ROLLUP_CALENDAR,
+                       COL_ROLLUP_CALENDAR_ID,
+                       COL_ROLLUP_TIME_ZONE_NAME]
+            argsArray:@[calendar.calendarIdentifier, calendar.timeZone.name]
+                   db:db
+                error:errorBlk];
+}
+
+- (void)recomputeDirtyMonthlyRollupsWithBoundaries:(FPMonthBoundaries *)boundaries
+                                                db:(FMDatabase *)db
+                                             error:(PELMDaoErrorBlk)errorBlk {
+  NSMutableOrderedSet *dirtyMonths = [NSMutableOrderedSet orderedSet];
+  FMResultSet *rs = [PELMUtils doQuery:[NSString stringWithFormat:@"SELECT %@, %@, %@, %@ FROM %@",
+                                        COL_ROLLUP_DIRTY_TABLE,
+                                        COL_ROLLUP_SRC,
+                                        COL_ROLLUP_PARENT_ID,
+                                        COL_ROLLUP_DIRTY_LOG_DT,
+                                        TBL_MONTHLY_ROLLUP_DIRTY]
+                             argsArray:@[]
+                                    db:db
+                                 error:errorBlk];
+  while ([rs next]) {
+    [dirtyMonths addObject:@[[rs stringForColumn:COL_ROLLUP_DIRTY_TABLE],
+                             [rs objectForColumnName:COL_ROLLUP_SRC],
+                             [rs objectForColumnName:COL_ROLLUP_PARENT_ID],
+                             @([boundaries monthKeyForMillis:[rs longLongIntForColumn:COL_ROLLUP_DIRTY_LOG_DT]])]];
+  }
+  [rs close];
+  if (dirtyMonths.count > 0) {
+    for (NSArray *dirtyMonth in dirtyMonths) {
+      [self recomputeMonthlyRollup:dirtyMonth[0]
+                               src:dirtyMonth[1]
+                          parentId:dirtyMonth[2]
+                          monthKey:dirtyMonth[3]
+                        boundaries:boundaries
+                                db:db
+                             error:errorBlk];
+    }
+    [PELMUtils doUpdate:[NSString stringWithFormat:@"DELETE FROM %@", TBL_MONTHLY_ROLLUP_DIRTY] db:db error:errorBlk];
+  }
+}
+
+- (void)recomputeMonthlyRollup:(NSString *)rollupTable
+                           src:(NSNumber *)src
+                      parentId:(NSNumber *)parentId
+                      monthKey:(NSNumber *)monthKey
+                    boundaries:(FPMonthBoundaries *)boundaries
+                            db:(FMDatabase *)db
+                         error:(PELMDaoErrorBlk)errorBlk {
+  NSArray *source = [self monthlyRollupSourceForTable:rollupTable src:src];
+  NSArray *parts = [self monthlyRollupRecomputePartsForTable:rollupTable];
+  NSString *shadowFilter = @"";
+  if (source[5] != [NSNull null]) {
+    shadowFilter = [NSString stringWithFormat:@" AND %@ NOT IN (SELECT %@ FROM %@ WHERE %@ IS NOT NULL)",
+                    COL_GLOBAL_ID,
+                    COL_GLOBAL_ID,
+                    source[5],
+                    COL_GLOBAL_ID];
+  }
+  [PELMUtils doUpdate:[NSString stringWithFormat:@"DELETE FROM %@ WHERE %@ = ? AND %@ = ? AND %@ = ?",
+                       rollupTable,
+                       COL_ROLLUP_SRC,
+                       COL_ROLLUP_PARENT_ID,
+                       COL_ROLLUP_MONTH_KEY]
+            argsArray:@[src, parentId, monthKey]
+                   db:db
+                error:errorBlk];
+  NSString *monthLogs = [NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@ = ? AND %@ < ? AND %@ >= ?%@",
+                         parts[2],
+                         source[2],
+                         source[3],
+                         source[4],
+                         source[4],
+                         shadowFilter];
+  NSArray *monthLogsArgs = @[parentId,
+                             @([boundaries firstMillisOfMonthKey:[monthKey integerValue] + 1]),
+                             @([boundaries firstMillisOfMonthKey:[monthKey integerValue]])];
+  [PELMUtils doUpdate:[NSString stringWithFormat:@"INSERT INTO %@ (%@, %@, %@, %@) SELECT ?, ?, ?, %@ FROM (%@) GROUP BY %@",
+                       rollupTable,
+                       COL_ROLLUP_SRC,
+                       COL_ROLLUP_PARENT_ID,
+                       COL_ROLLUP_MONTH_KEY,
+                       parts[0],
+                       parts[1],
+                       monthLogs,
+                       parts[3]]
+            argsArray:[@[src, parentId, monthKey] arrayByAddingObjectsFromArray:monthLogsArgs]
+                   db:db
+                error:errorBlk];
+
+  // the month's quantile sketches, one per group, built from the month's logs
+  NSMutableDictionary *sketches = [NSMutableDictionary dictionary];
+  FMResultSet *rs = [PELMUtils doQuery:[NSString stringWithFormat:@"SELECT %@, %@ FROM (%@) WHERE %@ IS NOT NULL",
+                                        parts[3],
+                                        parts[5],
+                                        monthLogs,
+                                        parts[5]]
+                             argsArray:monthLogsArgs
+                                    db:db
+                                 error:errorBlk];
+  while ([rs next]) {
+    NSNumber *group = @([rs longForColumnIndex:0]);
+    FPQuantileSketch *sketch = sketches[group];
+    if (!sketch) {
+      sketch = [[FPQuantileSketch alloc] init];
+      sketches[group] = sketch;
+    }
+    [sketch addValue:(double)[rs longLongIntForColumnIndex:1] / FPMicrosPerUnit];
+  }
+  [rs close];
+  [sketches enumerateKeysAndObjectsUsingBlock:^(NSNumber *group, FPQuantileSketch *sketch, BOOL *stop) {
+    NSMutableString *update = [NSMutableString stringWithFormat:@"UPDATE %@ SET %@ = ? WHERE %@ = ? AND %@ = ? AND %@ = ?",
+                               rollupTable,
+                               parts[4],
+                               COL_ROLLUP_SRC,
+                               COL_ROLLUP_PARENT_ID,
+                               COL_ROLLUP_MONTH_KEY];
+    NSMutableArray *args = [NSMutableArray arrayWithObjects:[sketch dataRepresentation], src, parentId, monthKey, nil];
+    if (parts[6] != [NSNull null]) {
+      [update appendFormat:@" AND %@ = ?", parts[6]];
+      [args addObject:group];
+    }
+    [PELMUtils doUpdate:update argsArray:args db:db error:errorBlk];
+  }];
+}
+
+- (NSNumber *)masterIdForParentEntity:(PELMMainSupport *)parentEntity
+                    parentMasterTable:(NSString *)parentMasterTable
+                                   db:(FMDatabase *)db
+                                error:(PELMDaoErrorBlk)errorBlk {
+  NSNumber *parentMasterId = [parentEntity localMasterIdentifier];
+  if (!parentMasterId && [parentEntity globalIdentifier]) {
+    parentMasterId = [PELMUtils numberFromTable:parentMasterTable
+                                   selectColumn:COL_LOCAL_ID
+                                    whereColumn:COL_GLOBAL_ID
+                                     whereValue:[parentEntity globalIdentifier]
+                                             db:db
+                                          error:errorBlk];
+  }
+  return parentMasterId;
+}
+
+- (NSNumber *)mainIdForParentEntity:(PELMMainSupport *)parentEntity
+                    parentMainTable:(NSString *)parentMainTable
+                                 db:(FMDatabase *)db
+                              error:(PELMDaoErrorBlk)errorBlk {
+  NSNumber *parentMainId = [parentEntity localMainIdentifier];
+  if (!parentMainId) {
+    parentMainId = [PELMUtils localMainIdentifierForEntity:parentEntity mainTable:parentMainTable db:db error:errorBlk];
+  }
+  return parentMainId;
+}
+
+- (NSDictionary *)monthlyAggregatesFromRollupTable:(NSString *)rollupTable
+                                    measureColumns:(NSArray *)measureColumns
+                                      parentEntity:(PELMMainSupport *)parentEntity
+                                 parentMasterTable:(NSString *)parentMasterTable
+                                   parentMainTable:(NSString *)parentMainTable
+                           masterParentIdsSubquery:(NSString *)masterParentIdsSubquery
+                             mainParentIdsSubquery:(NSString *)mainParentIdsSubquery
+                                        beforeDate:(NSDate *)beforeDate
+                                     onOrAfterDate:(NSDate *)onOrAfterDate
+                                           fuelKey:(NSNumber *)fuelKey
+                                             error:(PELMDaoErrorBlk)errorBlk {
+  NSMutableDictionary *monthlyAggregates = [NSMutableDictionary dictionary];
+  [self enumerateMonthlyAggregatesFromRollupTable:rollupTable
+                                   measureColumns:measureColumns
+                                     parentEntity:parentEntity
+                                parentMasterTable:parentMasterTable
+                                  parentMainTable:parentMainTable
+                          masterParentIdsSubquery:masterParentIdsSubquery
+                            mainParentIdsSubquery:mainParentIdsSubquery
+                                       beforeDate:beforeDate
+                                    onOrAfterDate:onOrAfterDate
+                                          fuelKey:fuelKey
+                                 groupedByFuelKey:NO
+                                     aggregateBlk:^(NSNumber *rowFuelKey, NSNumber *monthKey, FPLogAggregate *aggregate) {
+                                       monthlyAggregates[monthKey] = aggregate;
+                                     }
+                                            error:errorBlk];
+  return monthlyAggregates;
+}
+
+- (NSDictionary *)octaneMonthlyAggregatesFromRollupTable:(NSString *)rollupTable
+                                          measureColumns:(NSArray *)measureColumns
+                                            parentEntity:(PELMMainSupport *)parentEntity
+                                       parentMasterTable:(NSString *)parentMasterTable
+                                         parentMainTable:(NSString *)parentMainTable
+                                 masterParentIdsSubquery:(NSString *)masterParentIdsSubquery
+                                   mainParentIdsSubquery:(NSString *)mainParentIdsSubquery
+                                              beforeDate:(NSDate *)beforeDate
+                                           onOrAfterDate:(NSDate *)onOrAfterDate
+                                                   error:(PELMDaoErrorBlk)errorBlk {
+  NSMutableDictionary *octaneMonthlyAggregates = [NSMutableDictionary dictionary];
+  [self enumerateMonthlyAggregatesFromRollupTable:rollupTable
+                                   measureColumns:measureColumns
+                                     parentEntity:parentEntity
+                                parentMasterTable:parentMasterTable
+                                  parentMainTable:parentMainTable
+                          masterParentIdsSubquery:masterParentIdsSubquery
+                            mainParentIdsSubquery:mainParentIdsSubquery
+                                       beforeDate:beforeDate
+                                    onOrAfterDate:onOrAfterDate
+                                          fuelKey:nil
+                                 groupedByFuelKey:YES
+                                     aggregateBlk:^(NSNumber *rowFuelKey, NSNumber *monthKey, FPLogAggregate *aggregate) {
+                                       NSMutableDictionary *monthlyAggregates = octaneMonthlyAggregates[rowFuelKey];
+                                       if (!monthlyAggregates) {
+                                         monthlyAggregates = [NSMutableDictionary dictionary];
+                                         octaneMonthlyAggregates[rowFuelKey] = monthlyAggregates;
+                                       }
+                                       monthlyAggregates[monthKey] = aggregate;
+                                     }
+                                            error:errorBlk];
+  return octaneMonthlyAggregates;
+}
+
+/*
+ The condition selecting the parent entity's rollup rows (master and main) for
+ the months overlapping [onOrAfterDate, beforeDate) and, if given, the fuel key;
+ its args are appended to args.  Returns nil if the parent entity is in neither
+ the master nor the main table.
+ */
+- (NSString *)rollupRowsConditionForParentEntity:(PELMMainSupport *)parentEntity
+                               parentMasterTable:(NSString *)parentMasterTable
+                                 parentMainTable:(NSString *)parentMainTable
+                         masterParentIdsSubquery:(NSString *)masterParentIdsSubquery
+                           mainParentIdsSubquery:(NSString *)mainParentIdsSubquery
+                                      beforeDate:(NSDate *)beforeDate
+                                   onOrAfterDate:(NSDate *)onOrAfterDate
+                                         fuelKey:(NSNumber *)fuelKey
+                                            args:(NSMutableArray *)args
+                                              db:(FMDatabase *)db
+                                           error:(PELMDaoErrorBlk)errorBlk {
+  FPMonthBoundaries *boundaries = [FPMonthBoundaries currentBoundaries];
+  NSNumber *parentMasterId = [self masterIdForParentEntity:parentEntity parentMasterTable:parentMasterTable db:db error:errorBlk];
+  NSNumber *parentMainId = [self mainIdForParentEntity:parentEntity parentMainTable:parentMainTable db:db error:errorBlk];
+  NSMutableArray *parentConditions = [NSMutableArray arrayWithCapacity:2];
+  NSString *(^parentCondition)(NSInteger, NSString *) = ^(NSInteger src, NSString *parentIdsSubquery) {
+    return [NSString stringWithFormat:@"(%@ = %ld AND %@ %@)",
+            COL_ROLLUP_SRC,
+            (long)src,
+            COL_ROLLUP_PARENT_ID,
+            parentIdsSubquery ? [NSString stringWithFormat:@"IN (%@)", parentIdsSubquery] : @"= ?"];
+  };
+  if (parentMasterId) {
+    [parentConditions addObject:parentCondition(FP_ROLLUP_SRC_MASTER, masterParentIdsSubquery)];
+    [args addObject:parentMasterId];
+  }
+  if (parentMainId) {
+    [parentConditions addObject:parentCondition(FP_ROLLUP_SRC_MAIN, mainParentIdsSubquery)];
+    [args addObject:parentMainId];
+  }
+  if (parentConditions.count == 0) {
+    return nil;
+  }
+  NSMutableString *condition = [NSMutableString stringWithFormat:@"(%@)", [parentConditions componentsJoinedByString:@" OR "]];
+  if (onOrAfterDate) {
+    [condition appendFormat:@" AND %@ >= ?", COL_ROLLUP_MONTH_KEY];
+    [args addObject:@([boundaries monthKeyForDate:onOrAfterDate])];
+  }
+  if (beforeDate) {
+    [condition appendFormat:@" AND %@ <= ?", COL_ROLLUP_MONTH_KEY];
+    [args addObject:@([boundaries monthKeyForMillis:FPEpochMillisFromDate(beforeDate) - 1])];
+  }
+  if (fuelKey) {
+    [condition appendFormat:@" AND %@ = ?", COL_ROLLUP_FUEL_KEY];
+    [args addObject:fuelKey];
+  }
+  return condition;
+}
+
+/*
+ Merges the month sketches of the parent entity's rollup rows.  Because the
+ rollups are monthly, onOrAfterDate and beforeDate are widened to whole months.
+ */
+- (FPQuantileSketch *)quantileSketchFromRollupTable:(NSString *)rollupTable
+                                       sketchColumn:(NSString *)sketchColumn
+                                       parentEntity:(PELMMainSupport *)parentEntity
+                                  parentMasterTable:(NSString *)parentMasterTable
+                                    parentMainTable:(NSString *)parentMainTable
+                            masterParentIdsSubquery:(NSString *)masterParentIdsSubquery
+                              mainParentIdsSubquery:(NSString *)mainParentIdsSubquery
+                                         beforeDate:(NSDate *)beforeDate
+                                      onOrAfterDate:(NSDate *)onOrAfterDate
+                                            fuelKey:(NSNumber *)fuelKey
+                                              error:(PELMDaoErrorBlk)errorBlk {
+  FPQuantileSketch *sketch = [[FPQuantileSketch alloc] init];
+  [self inMonthlyRollupsReadDatabase:^(FMDatabase *db) {
+    NSMutableArray *args = [NSMutableArray array];
+    NSString *condition = [self rollupRowsConditionForParentEntity:parentEntity
+                                                 parentMasterTable:parentMasterTable
+                                                   parentMainTable:parentMainTable
+                                           masterParentIdsSubquery:masterParentIdsSubquery
+                                             mainParentIdsSubquery:mainParentIdsSubquery
+                                                        beforeDate:beforeDate
+                                                     onOrAfterDate:onOrAfterDate
+                                                           fuelKey:fuelKey
+                                                              args:args
+                                                                db:db
+                                                             error:errorBlk];
+    if (!condition) {
+      return;
+    }
+    FMResultSet *rs = [PELMUtils doQuery:[NSString stringWithFormat:@"SELECT %@ FROM %@ WHERE %@ AND %@ IS NOT NULL ORDER BY %@, %@, %@",
+                                          sketchColumn,
+                                          rollupTable,
+                                          condition,
+                                          sketchColumn,
+                                          COL_ROLLUP_MONTH_KEY,
+                                          COL_ROLLUP_SRC,
+                                          COL_ROLLUP_PARENT_ID]
+                               argsArray:args
+                                      db:db
+                                   error:errorBlk];
+    while ([rs next]) {
+      FPQuantileSketch *monthSketch = [[FPQuantileSketch alloc] initWithData:[rs dataForColumnIndex:0]];
+      if (monthSketch) {
+        [sketch mergeSketch:monthSketch];
+      }
+    }
+    [rs close];
+  } error:errorBlk];
+  return sketch;
+}
+
+/*
+ Sums the rollup rows of the parent entity into one aggregate per month (or,
+ if groupedByFuelKey, per fuel key and month, leaving out logs with neither an
+ octane nor the diesel flag) and hands each to aggregateBlk; the fuel key passed
+ is nil when not grouped.
+ */
+- (void)enumerateMonthlyAggregatesFromRollupTable:(NSString *)rollupTable
+                                   measureColumns:(NSArray *)measureColumns
+                                     parentEntity:(PELMMainSupport *)parentEntity
+                                parentMasterTable:(NSString *)parentMasterTable
+                                  parentMainTable:(NSString *)parentMainTable
+                          masterParentIdsSubquery:(NSString *)masterParentIdsSubquery
+                            mainParentIdsSubquery:(NSString *)mainParentIdsSubquery
+                                       beforeDate:(NSDate *)beforeDate
+                                    onOrAfterDate:(NSDate *)onOrAfterDate
+                                          fuelKey:(NSNumber *)fuelKey
+                                 groupedByFuelKey:(BOOL)groupedByFuelKey
+                                     aggregateBlk:(void(^)(NSNumber *, NSNumber *, FPLogAggregate *))aggregateBlk
+                                            error:(PELMDaoErrorBlk)errorBlk {
+  [self inMonthlyRollupsReadDatabase:^(FMDatabase *db) {
+    NSMutableArray *args = [NSMutableArray array];
+    NSString *condition = [self rollupRowsConditionForParentEntity:parentEntity
+                                                 parentMasterTable:parentMasterTable
+                                                   parentMainTable:parentMainTable
+                                           masterParentIdsSubquery:masterParentIdsSubquery
+                                             mainParentIdsSubquery:mainParentIdsSubquery
+                                                        beforeDate:beforeDate
+                                                     onOrAfterDate:onOrAfterDate
+                                                           fuelKey:fuelKey
+                                                              args:args
+                                                                db:db
+                                                             error:errorBlk];
+    if (!condition) {
+      return;
+    }
+    NSMutableString *qry = [NSMutableString stringWithFormat:@"SELECT %@, SUM(%@), SUM(%@), %@, %@, %@, %@ FROM %@ WHERE %@",
+                            COL_ROLLUP_MONTH_KEY,
+                            COL_ROLLUP_NUM_LOGS,
+                            measureColumns[0],
+                            measureColumns[1] != [NSNull null] ? [NSString stringWithFormat:@"IFNULL(SUM(%@), 0)", measureColumns[1]] : @"NULL",
+                            measureColumns[2] != [NSNull null] ? [NSString stringWithFormat:@"MIN(%@)", measureColumns[2]] : @"NULL",
+                            measureColumns[3] != [NSNull null] ? [NSString stringWithFormat:@"MAX(%@)", measureColumns[3]] : @"NULL",
+                            groupedByFuelKey ? COL_ROLLUP_FUEL_KEY : @"NULL",
+                            rollupTable,
+                            condition];
+    if (groupedByFuelKey) {
+      [qry appendFormat:@" AND %@ <> %ld GROUP BY %@, %@",
+       COL_ROLLUP_FUEL_KEY,
+       (long)FP_ROLLUP_FUEL_KEY_UNSPECIFIED,
+       COL_ROLLUP_FUEL_KEY,
+       COL_ROLLUP_MONTH_KEY];
+    } else {
+      [qry appendFormat:@" GROUP BY %@", COL_ROLLUP_MONTH_KEY];
+    }
+    FMResultSet *rs = [PELMUtils doQuery:qry argsArray:args db:db error:errorBlk];
+    while ([rs next]) {
+      aggregateBlk(groupedByFuelKey ? @([rs longForColumnIndex:6]) : nil,
+                   @([rs longForColumnIndex:0]),
+                   [[FPLogAggregate alloc] initWithNumLogs:[rs longForColumnIndex:1]
+                                                     count:[rs longForColumnIndex:2]
+                                                       sum:[self decimalNumberFromMicrosResultSet:rs columnIndex:3]
+                                                       min:[self decimalNumberFromMicrosResultSet:rs columnIndex:4]
+                                                       max:[self decimalNumberFromMicrosResultSet:rs columnIndex:5]]);
+    }
+    [rs close];
+  } error:errorBlk];
+}
+
 @end
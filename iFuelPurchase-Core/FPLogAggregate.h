@@ -0,0 +1,61 @@
+//
+//  FPLogAggregate.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+typedef NS_ENUM(NSInteger, FPGasLogMeasure) {
+  FPGasLogMeasureSpent,       // num gallons * gallon price
+  FPGasLogMeasureGallonPrice,
+  FPGasLogMeasureNumGallons
+};
+
+typedef NS_ENUM(NSInteger, FPOdometerLogMeasure) {
+  FPOdometerLogMeasureReportedAvgMpg,
+  FPOdometerLogMeasureReportedAvgMph,
+  FPOdometerLogMeasureOdometer,
+  FPOdometerLogMeasureOutsideTemp
+};
+
+/**
+ Per-octane aggregates are keyed by octane; diesel logs without an octane are
+ keyed by FPOctaneKeyDiesel.
+ */
+FOUNDATION_EXPORT NSInteger const FPOctaneKeyDiesel;
+
+/**
+ The SUM / COUNT / MIN / MAX of a log measure, as computed by the database.
+ numLogs is the number of logs that matched, whether or not the measure was
+ present on them; count is the number of logs that carried the measure.
+ */
+@interface FPLogAggregate : NSObject
+
+#pragma mark - Initializers
+
+- (instancetype)initWithNumLogs:(NSInteger)numLogs
+                          count:(NSInteger)count
+                            sum:(NSDecimalNumber *)sum
+                            min:(NSDecimalNumber *)min
+                            max:(NSDecimalNumber *)max;
+
+#pragma mark - Properties
+
+@property (nonatomic, readonly) NSInteger numLogs;
+
+@property (nonatomic, readonly) NSInteger count;
+
+@property (nonatomic, readonly) NSDecimalNumber *sum;
+
+@property (nonatomic, readonly) NSDecimalNumber *min;
+
+@property (nonatomic, readonly) NSDecimalNumber *max;
+
+#pragma mark - Derived Values
+
+- (NSDecimalNumber *)avg;
+
+@end
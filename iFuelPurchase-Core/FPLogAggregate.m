@@ -0,0 +1,42 @@
+//
+//  FPLogAggregate.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPLogAggregate.h"
+
+NSInteger const FPOctaneKeyDiesel = -1;
+
+@implementation FPLogAggregate
+
+#pragma mark - Initializers
+
+- (instancetype)initWithNumLogs:(NSInteger)numLogs
+                          count:(NSInteger)count
+                            sum:(NSDecimalNumber *)sum
+                            min:(NSDecimalNumber *)min
+                            max:(NSDecimalNumber *)max {
+  self = [super init];
+  if (self) {
+    _numLogs = numLogs;
+    _count = count;
+    _sum = sum;
+    _min = min;
+    _max = max;
+  }
+  return self;
+}
+
+#pragma mark - Derived Values
+
+- (NSDecimalNumber *)avg {
+  if (_count > 0) {
+    return [_sum decimalNumberByDividingBy:[[NSDecimalNumber alloc] initWithInteger:_count]];
+  }
+  return nil;
+}
+
+@end
@@ -0,0 +1,95 @@
+//
+//  FPLogColumns.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "FPFixedPoint.h"
+#import "FPLogAggregate.h"
+
+/** Marks a null gallons, price or odometer value. */
+FOUNDATION_EXPORT const FPMicros FPLogColumnsNullMicros;
+
+/** Marks a null octane. */
+FOUNDATION_EXPORT const int32_t FPLogColumnsNullOctane;
+
+/**
+ The gas logs of a vehicle, fuel station or user laid out column by column:
+ one contiguous C array per field, rows sorted by purchase date.  Stat kernels
+ read just the arrays they need, and date ranges are found by binary search
+ rather than by filtering log objects.  Gallons, prices and odometer readings
+ are held in micro-units (see FPFixedPoint); a value with more than 6 decimal
+ places is rounded when it's appended.
+
+ Logs without a purchase date aren't included.  Once loaded, a columns object
+ isn't modified, so it can be read from several threads at once.
+ */
+@interface FPLogColumns : NSObject
+
+#pragma mark - Initializers
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+#pragma mark - Loading
+
+/**
+ Rows must be appended in purchase date order.
+ */
+- (void)appendRowWithPurchasedAtMillis:(int64_t)purchasedAtMillis
+                            numGallons:(NSDecimalNumber *)numGallons
+                           gallonPrice:(NSDecimalNumber *)gallonPrice
+                                octane:(NSNumber *)octane
+                              isDiesel:(BOOL)isDiesel
+                              odometer:(NSDecimalNumber *)odometer;
+
+#pragma mark - Columns
+
+@property (nonatomic, readonly) NSUInteger count;
+
+- (const int64_t *)purchasedAtMillis;
+
+- (const FPMicros *)numGallons;
+
+- (const FPMicros *)gallonPrices;
+
+- (const int32_t *)octanes;
+
+- (const BOOL *)dieselFlags;
+
+- (const FPMicros *)odometers;
+
+#pragma mark - Ranges
+
+/**
+ The rows purchased within [onOrAfterDate, beforeDate); nil dates are unbounded.
+ */
+- (NSRange)rangeOfRowsBeforeDate:(NSDate *)beforeDate onOrAfterDate:(NSDate *)onOrAfterDate;
+
+/**
+ The rows purchased within (afterMillis, beforeMillis).
+ */
+- (NSRange)rangeOfRowsBeforeMillis:(int64_t)beforeMillis afterMillis:(int64_t)afterMillis;
+
+#pragma mark - Kernels
+
+/**
+ Sums the measure over the rows in range that carry it; the sum's count is
+ the number of such rows.
+ */
+- (FPSum)sumOfMeasure:(FPGasLogMeasure)measure inRange:(NSRange)range;
+
+/**
+ The same aggregate the local DAO computes in SQL, over the rows in range.  A
+ nil octane (and diesel NO) matches every row; diesel matches the diesel rows
+ without an octane.
+ */
+- (FPLogAggregate *)aggregateOfMeasure:(FPGasLogMeasure)measure
+                               inRange:(NSRange)range
+                                octane:(NSNumber *)octane
+                                diesel:(BOOL)diesel;
+
+@end
@@ -0,0 +1,268 @@
+//
+//  FPLogColumns.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPLogColumns.h"
+
+#import <PEObjc-Commons/PEUtils.h>
+
+#import "FPColumnKernels.h"
+
+const FPMicros FPLogColumnsNullMicros = INT64_MIN;
+
+const int32_t FPLogColumnsNullOctane = INT32_MIN;
+
+static FPMicros FPLogColumnsMicrosFromDecimalNumber(NSDecimalNumber *value) {
+  FPMicros micros;
+  if ([PEUtils isNil:value]) {
+    return FPLogColumnsNullMicros;
+  }
+  FPMicrosFromDecimal([value decimalValue], &micros);
+  return micros;
+}
+
+/*
+ The index of the first row whose date is >= millis (or > millis, if strictly).
+ */
+static NSUInteger FPLogColumnsLowerBound(const int64_t *dates, NSUInteger count, int64_t millis, BOOL strictly) {
+  NSUInteger low = 0;
+  NSUInteger high = count;
+  while (low < high) {
+    NSUInteger mid = low + ((high - low) / 2);
+    if (dates[mid] < millis || (strictly && dates[mid] == millis)) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/*
+ The measure's value on row i, in micro-units; NO if the row doesn't carry it.
+ A spent value that doesn't fit in micro-units is rounded, which only matters
+ for comparing rows (sums are kept exact by FPLogColumnsAddValue).
+ */
+static inline BOOL FPLogColumnsValue(FPGasLogMeasure measure,
+                                     const FPMicros *gallons,
+                                     const FPMicros *prices,
+                                     NSUInteger i,
+                                     FPMicros *micros) {
+  switch (measure) {
+    case FPGasLogMeasureSpent:
+      if (gallons[i] == FPLogColumnsNullMicros || prices[i] == FPLogColumnsNullMicros) {
+        return NO;
+      }
+      FPMicrosMultiply(gallons[i], prices[i], micros);
+      return YES;
+    case FPGasLogMeasureGallonPrice:
+      *micros = prices[i];
+      return prices[i] != FPLogColumnsNullMicros;
+    case FPGasLogMeasureNumGallons:
+      *micros = gallons[i];
+      return gallons[i] != FPLogColumnsNullMicros;
+  }
+  return NO;
+}
+
+static inline void FPLogColumnsAddValue(FPSum *sum,
+                                        FPGasLogMeasure measure,
+                                        const FPMicros *gallons,
+                                        const FPMicros *prices,
+                                        NSUInteger i) {
+  switch (measure) {
+    case FPGasLogMeasureSpent:
+      FPSumAddMicrosProduct(sum, gallons[i], prices[i]);
+      break;
+    case FPGasLogMeasureGallonPrice:
+      FPSumAddMicros(sum, prices[i]);
+      break;
+    case FPGasLogMeasureNumGallons:
+      FPSumAddMicros(sum, gallons[i]);
+      break;
+  }
+}
+
+@implementation FPLogColumns {
+  NSMutableData *_purchasedAtMillis;
+  NSMutableData *_numGallons;
+  NSMutableData *_gallonPrices;
+  NSMutableData *_octanes;
+  NSMutableData *_dieselFlags;
+  NSMutableData *_odometers;
+}
+
+#pragma mark - Initializers
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity {
+  self = [super init];
+  if (self) {
+    _purchasedAtMillis = [NSMutableData dataWithCapacity:capacity * sizeof(int64_t)];
+    _numGallons = [NSMutableData dataWithCapacity:capacity * sizeof(FPMicros)];
+    _gallonPrices = [NSMutableData dataWithCapacity:capacity * sizeof(FPMicros)];
+    _octanes = [NSMutableData dataWithCapacity:capacity * sizeof(int32_t)];
+    _dieselFlags = [NSMutableData dataWithCapacity:capacity * sizeof(BOOL)];
+    _odometers = [NSMutableData dataWithCapacity:capacity * sizeof(FPMicros)];
+  }
+  return self;
+}
+
+- (instancetype)init {
+  return [self initWithCapacity:0];
+}
+
+#pragma mark - Loading
+
+- (void)appendRowWithPurchasedAtMillis:(int64_t)purchasedAtMillis
+                            numGallons:(NSDecimalNumber *)numGallons
+                           gallonPrice:(NSDecimalNumber *)gallonPrice
+                                octane:(NSNumber *)octane
+                              isDiesel:(BOOL)isDiesel
+                              odometer:(NSDecimalNumber *)odometer {
+  FPMicros gallonsMicros = FPLogColumnsMicrosFromDecimalNumber(numGallons);
+  FPMicros priceMicros = FPLogColumnsMicrosFromDecimalNumber(gallonPrice);
+  FPMicros odometerMicros = FPLogColumnsMicrosFromDecimalNumber(odometer);
+  int32_t octaneValue = [PEUtils isNil:octane] ? FPLogColumnsNullOctane : (int32_t)[octane intValue];
+  [_purchasedAtMillis appendBytes:&purchasedAtMillis length:sizeof(int64_t)];
+  [_numGallons appendBytes:&gallonsMicros length:sizeof(FPMicros)];
+  [_gallonPrices appendBytes:&priceMicros length:sizeof(FPMicros)];
+  [_octanes appendBytes:&octaneValue length:sizeof(int32_t)];
+  [_dieselFlags appendBytes:&isDiesel length:sizeof(BOOL)];
+  [_odometers appendBytes:&odometerMicros length:sizeof(FPMicros)];
+  _count++;
+}
+
+#pragma mark - Columns
+
+- (const int64_t *)purchasedAtMillis {
+  return _purchasedAtMillis.bytes;
+}
+
+- (const FPMicros *)numGallons {
+  return _numGallons.bytes;
+}
+
+- (const FPMicros *)gallonPrices {
+  return _gallonPrices.bytes;
+}
+
+- (const int32_t *)octanes {
+  return _octanes.bytes;
+}
+
+- (const BOOL *)dieselFlags {
+  return _dieselFlags.bytes;
+}
+
+- (const FPMicros *)odometers {
+  return _odometers.bytes;
+}
+
+#pragma mark - Ranges
+
+- (NSRange)rangeOfRowsBeforeDate:(NSDate *)beforeDate onOrAfterDate:(NSDate *)onOrAfterDate {
+  const int64_t *dates = [self purchasedAtMillis];
+  NSUInteger start = 0;
+  NSUInteger end = _count;
+  if (onOrAfterDate) {
+    start = FPLogColumnsLowerBound(dates, _count, [[PEUtils millisecondsFromDate:onOrAfterDate] longLongValue], NO);
+  }
+  if (beforeDate) {
+    end = FPLogColumnsLowerBound(dates, _count, [[PEUtils millisecondsFromDate:beforeDate] longLongValue], NO);
+  }
+  return end > start ? NSMakeRange(start, end - start) : NSMakeRange(start, 0);
+}
+
+- (NSRange)rangeOfRowsBeforeMillis:(int64_t)beforeMillis afterMillis:(int64_t)afterMillis {
+  const int64_t *dates = [self purchasedAtMillis];
+  NSUInteger start = FPLogColumnsLowerBound(dates, _count, afterMillis, YES);
+  NSUInteger end = FPLogColumnsLowerBound(dates, _count, beforeMillis, NO);
+  return end > start ? NSMakeRange(start, end - start) : NSMakeRange(start, 0);
+}
+
+#pragma mark - Kernels
+
+- (FPColumnSummary)summaryOfMeasure:(FPGasLogMeasure)measure inRange:(NSRange)range {
+  const FPMicros *gallons = [self numGallons] + range.location;
+  const FPMicros *prices = [self gallonPrices] + range.location;
+  switch (measure) {
+    case FPGasLogMeasureSpent:
+      return FPColumnSummarizeMicrosProducts(gallons, prices, range.length, FPLogColumnsNullMicros);
+    case FPGasLogMeasureGallonPrice:
+      return FPColumnSummarizeMicros(prices, range.length, FPLogColumnsNullMicros);
+    case FPGasLogMeasureNumGallons:
+      return FPColumnSummarizeMicros(gallons, range.length, FPLogColumnsNullMicros);
+  }
+  return FPColumnSummarizeMicros(gallons, 0, FPLogColumnsNullMicros);
+}
+
+- (FPSum)sumOfMeasure:(FPGasLogMeasure)measure inRange:(NSRange)range {
+  return [self summaryOfMeasure:measure inRange:range].sum;
+}
+
+- (FPLogAggregate *)aggregateOfMeasure:(FPGasLogMeasure)measure
+                               inRange:(NSRange)range
+                                octane:(NSNumber *)octane
+                                diesel:(BOOL)diesel {
+  if (!octane && !diesel) {
+    FPColumnSummary summary = [self summaryOfMeasure:measure inRange:range];
+    BOOL any = summary.sum.count > 0;
+    return [[FPLogAggregate alloc] initWithNumLogs:range.length
+                                             count:summary.sum.count
+                                               sum:FPSumDecimalNumber(&summary.sum)
+                                               min:any ? [NSDecimalNumber decimalNumberWithDecimal:summary.min] : nil
+                                               max:any ? [NSDecimalNumber decimalNumberWithDecimal:summary.max] : nil];
+  }
+  const FPMicros *gallons = [self numGallons];
+  const FPMicros *prices = [self gallonPrices];
+  const int32_t *octanes = [self octanes];
+  const BOOL *dieselFlags = [self dieselFlags];
+  int32_t octaneValue = octane ? (int32_t)[octane intValue] : FPLogColumnsNullOctane;
+  NSInteger numLogs = 0;
+  FPSum sum = FPSumMake();
+  NSUInteger minRow = NSNotFound;
+  NSUInteger maxRow = NSNotFound;
+  FPMicros min = 0;
+  FPMicros max = 0;
+  for (NSUInteger i = range.location; i < NSMaxRange(range); i++) {
+    if (diesel) {
+      if (octanes[i] != FPLogColumnsNullOctane || !dieselFlags[i]) {
+        continue;
+      }
+    } else if (octane && octanes[i] != octaneValue) {
+      continue;
+    }
+    numLogs++;
+    FPMicros micros;
+    if (FPLogColumnsValue(measure, gallons, prices, i, &micros)) {
+      FPLogColumnsAddValue(&sum, measure, gallons, prices, i);
+      if (minRow == NSNotFound || micros < min) {
+        minRow = i;
+        min = micros;
+      }
+      if (maxRow == NSNotFound || micros > max) {
+        maxRow = i;
+        max = micros;
+      }
+    }
+  }
+  NSDecimalNumber *(^exactValueOfRow)(NSUInteger) = ^NSDecimalNumber *(NSUInteger row) {
+    if (row == NSNotFound) {
+      return nil;
+    }
+    FPSum value = FPSumMake();
+    FPLogColumnsAddValue(&value, measure, gallons, prices, row);
+    return FPSumDecimalNumber(&value);
+  };
+  return [[FPLogAggregate alloc] initWithNumLogs:numLogs
+                                           count:sum.count
+                                             sum:FPSumDecimalNumber(&sum)
+                                             min:exactValueOfRow(minRow)
+                                             max:exactValueOfRow(maxRow)];
+}
+
+@end
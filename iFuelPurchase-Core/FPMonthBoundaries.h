@@ -0,0 +1,50 @@
+//
+//  FPMonthBoundaries.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/** Epoch milliseconds, the way purchased_at and log_date are stored. */
+typedef int64_t FPEpochMillis;
+
+FPEpochMillis FPEpochMillisFromDate(NSDate *date);
+
+/**
+ A precomputed table of the first instant of every month (in epoch
+ milliseconds) for a given calendar and time zone.  Months are identified by
+ month key (year * 12 + month).  Going from a month key to its boundaries is
+ array indexing, and going from a date to its month key is a binary search, so
+ stats loops no longer need NSCalendar.  Dates outside of the table's range
+ fall back to NSCalendar.
+ */
+@interface FPMonthBoundaries : NSObject
+
+/**
+ The shared table for the given calendar.  It is rebuilt whenever the
+ calendar's identifier or time zone no longer match those of the table.
+ */
++ (FPMonthBoundaries *)boundariesForCalendar:(NSCalendar *)calendar;
+
+/** The shared table for [NSCalendar currentCalendar]. */
++ (FPMonthBoundaries *)currentBoundaries;
+
+@property (nonatomic, readonly) NSCalendar *calendar;
+
+/** Whether the calendar's months start at the same instants as this table's. */
+- (BOOL)matchesCalendar:(NSCalendar *)calendar;
+
+- (NSInteger)monthKeyForYear:(NSInteger)year month:(NSInteger)month;
+
+- (NSInteger)monthKeyForMillis:(FPEpochMillis)millis;
+
+- (NSInteger)monthKeyForDate:(NSDate *)date;
+
+- (FPEpochMillis)firstMillisOfMonthKey:(NSInteger)monthKey;
+
+- (NSDate *)firstDayOfMonthKey:(NSInteger)monthKey;
+
+@end
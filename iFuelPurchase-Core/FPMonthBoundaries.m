@@ -0,0 +1,120 @@
+//
+//  FPMonthBoundaries.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPMonthBoundaries.h"
+
+static NSInteger const FP_MONTH_BOUNDARIES_FIRST_YEAR = 1970;
+static NSInteger const FP_MONTH_BOUNDARIES_LAST_YEAR = 2100;
+
+FPEpochMillis FPEpochMillisFromDate(NSDate *date) {
+  return (FPEpochMillis)floor([date timeIntervalSince1970] * 1000.0);
+}
+
+@implementation FPMonthBoundaries {
+  NSInteger _firstMonthKey;
+  NSInteger _numMonths;
+  FPEpochMillis *_monthStarts; // _numMonths + 1 entries; the last one closes the last month
+}
+
+#pragma mark - Initializers
+
+- (instancetype)initWithCalendar:(NSCalendar *)calendar {
+  self = [super init];
+  if (self) {
+    _calendar = [calendar copy];
+    _firstMonthKey = [self monthKeyForYear:FP_MONTH_BOUNDARIES_FIRST_YEAR month:1];
+    _numMonths = (FP_MONTH_BOUNDARIES_LAST_YEAR - FP_MONTH_BOUNDARIES_FIRST_YEAR + 1) * 12;
+    _monthStarts = malloc(sizeof(FPEpochMillis) * (_numMonths + 1));
+    NSDateComponents *comps = [[NSDateComponents alloc] init];
+    comps.day = 1;
+    for (NSInteger i = 0; i <= _numMonths; i++) {
+      comps.year = FP_MONTH_BOUNDARIES_FIRST_YEAR + (i / 12);
+      comps.month = (i % 12) + 1;
+      _monthStarts[i] = FPEpochMillisFromDate([_calendar dateFromComponents:comps]);
+    }
+  }
+  return self;
+}
+
+- (void)dealloc {
+  free(_monthStarts);
+}
+
+#pragma mark - Shared Tables
+
++ (FPMonthBoundaries *)boundariesForCalendar:(NSCalendar *)calendar {
+  static FPMonthBoundaries *boundaries = nil;
+  @synchronized(self) {
+    if (boundaries == nil || ![boundaries matchesCalendar:calendar]) {
+      boundaries = [[FPMonthBoundaries alloc] initWithCalendar:calendar];
+    }
+    return boundaries;
+  }
+}
+
++ (FPMonthBoundaries *)currentBoundaries {
+  return [self boundariesForCalendar:[NSCalendar currentCalendar]];
+}
+
+- (BOOL)matchesCalendar:(NSCalendar *)calendar {
+  return [_calendar.calendarIdentifier isEqualToString:calendar.calendarIdentifier] &&
+    [_calendar.timeZone isEqualToTimeZone:calendar.timeZone];
+}
+
+#pragma mark - Month Keys
+
+- (NSInteger)monthKeyForYear:(NSInteger)year month:(NSInteger)month {
+  return (year * 12) + month;
+}
+
+- (NSInteger)monthKeyForMillis:(FPEpochMillis)millis {
+  if (millis < _monthStarts[0] || millis >= _monthStarts[_numMonths]) {
+    return [self calendarMonthKeyForDate:[NSDate dateWithTimeIntervalSince1970:millis / 1000.0]];
+  }
+  // the last month start <= millis
+  NSInteger low = 0;
+  NSInteger high = _numMonths - 1;
+  while (low < high) {
+    NSInteger mid = (low + high + 1) / 2;
+    if (_monthStarts[mid] <= millis) {
+      low = mid;
+    } else {
+      high = mid - 1;
+    }
+  }
+  return _firstMonthKey + low;
+}
+
+- (NSInteger)monthKeyForDate:(NSDate *)date {
+  return [self monthKeyForMillis:FPEpochMillisFromDate(date)];
+}
+
+- (NSInteger)calendarMonthKeyForDate:(NSDate *)date {
+  NSDateComponents *comps = [_calendar components:NSCalendarUnitYear|NSCalendarUnitMonth fromDate:date];
+  return [self monthKeyForYear:comps.year month:comps.month];
+}
+
+#pragma mark - Boundaries
+
+- (FPEpochMillis)firstMillisOfMonthKey:(NSInteger)monthKey {
+  NSInteger i = monthKey - _firstMonthKey;
+  if (i >= 0 && i <= _numMonths) {
+    return _monthStarts[i];
+  }
+  NSDateComponents *comps = [[NSDateComponents alloc] init];
+  comps.day = 1;
+  comps.month = ((monthKey - 1) % 12) + 1;
+  comps.year = (monthKey - 1) / 12;
+  return FPEpochMillisFromDate([_calendar dateFromComponents:comps]);
+}
+
+- (NSDate *)firstDayOfMonthKey:(NSInteger)monthKey {
+  return [NSDate dateWithTimeIntervalSince1970:[self firstMillisOfMonthKey:monthKey] / 1000.0];
+}
+
+@end
@@ -0,0 +1,35 @@
+//
+//  FPOctanePriceStats.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ The price-per-gallon stats of a single octane (or of diesel) over a range:
+ the avg, min and max gallon price, and a [first day of month, avg gallon
+ price] dataset.
+ */
+@interface FPOctanePriceStats : NSObject
+
+#pragma mark - Initializers
+
+- (instancetype)initWithAvg:(NSDecimalNumber *)avg
+                        min:(NSDecimalNumber *)min
+                        max:(NSDecimalNumber *)max
+                    dataSet:(NSArray *)dataSet;
+
+#pragma mark - Properties
+
+@property (nonatomic, readonly) NSDecimalNumber *avg;
+
+@property (nonatomic, readonly) NSDecimalNumber *min;
+
+@property (nonatomic, readonly) NSDecimalNumber *max;
+
+@property (nonatomic, readonly) NSArray *dataSet;
+
+@end
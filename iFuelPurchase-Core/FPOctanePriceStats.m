@@ -0,0 +1,29 @@
+//
+//  FPOctanePriceStats.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPOctanePriceStats.h"
+
+@implementation FPOctanePriceStats
+
+#pragma mark - Initializers
+
+- (instancetype)initWithAvg:(NSDecimalNumber *)avg
+                        min:(NSDecimalNumber *)min
+                        max:(NSDecimalNumber *)max
+                    dataSet:(NSArray *)dataSet {
+  self = [super init];
+  if (self) {
+    _avg = avg;
+    _min = min;
+    _max = max;
+    _dataSet = dataSet;
+  }
+  return self;
+}
+
+@end
@@ -0,0 +1,83 @@
+//
+//  FPQuantileSketch.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/** The accuracy parameter used by -init. */
+FOUNDATION_EXPORT NSUInteger const FPQuantileSketchDefaultK;
+
+/**
+ A mergeable, fixed-size summary of a stream of values that answers quantile
+ queries (a KLL sketch).  Values are kept in levels; level h holds values that
+ each stand for 2^h of the values added, and when a level fills up it's sorted
+ and every other value is promoted to the level above.  Up to k values the
+ sketch is exact; past that, a quantile's rank is off by roughly 1.7 / k of the
+ count (under 1% at the default k), and the sketch holds at most about 3k
+ values no matter how many are added.
+
+ Compaction alternates between keeping the odd and the even positions, level by
+ level, so that a given sequence of adds and merges always yields the same
+ sketch.  Merging two sketches gives the sketch of the two streams together, so
+ sketches kept per month can be combined into the sketch of any span of months.
+ */
+@interface FPQuantileSketch : NSObject
+
+#pragma mark - Initializers
+
+- (instancetype)initWithK:(NSUInteger)k;
+
+/**
+ Returns nil if data isn't the dataRepresentation of a sketch.
+ */
+- (instancetype)initWithData:(NSData *)data;
+
+#pragma mark - Properties
+
+@property (nonatomic, readonly) NSUInteger k;
+
+/** The number of values added (or merged in). */
+@property (nonatomic, readonly) NSUInteger count;
+
+/** The number of values held, which is what a quantile query costs. */
+@property (nonatomic, readonly) NSUInteger numRetained;
+
+#pragma mark - Updating
+
+- (void)addValue:(double)value;
+
+/**
+ Merges the values of sketch into the receiver; sketch itself isn't changed.
+ */
+- (void)mergeSketch:(FPQuantileSketch *)sketch;
+
+#pragma mark - Querying
+
+/**
+ The smallest value v held such that at least quantile * count of the values
+ added are <= v (so, while the sketch is exact, the nearest-rank quantile).
+ quantile is clamped to [0, 1]; 0 and 1 give the exact min and max.  Returns
+ NAN if the sketch is empty.
+ */
+- (double)quantile:(double)quantile;
+
+/**
+ The quantile as a decimal, rounded to 15 significant digits so that decimal
+ inputs (e.g., a gallon price of 3.859) come back out exactly; nil if the sketch
+ is empty.
+ */
+- (NSDecimalNumber *)decimalNumberForQuantile:(double)quantile;
+
+#pragma mark - Serialization
+
+/**
+ A compact, byte-order independent encoding of the sketch, suitable for
+ storing in a BLOB column.
+ */
+- (NSData *)dataRepresentation;
+
+@end
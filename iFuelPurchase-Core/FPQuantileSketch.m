@@ -0,0 +1,321 @@
+//
+//  FPQuantileSketch.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPQuantileSketch.h"
+
+NSUInteger const FPQuantileSketchDefaultK = 200;
+
+static uint32_t const FPQuantileSketchMagic = 0x53515046; // "FPQS"
+static uint32_t const FPQuantileSketchFormatVersion = 1;
+static NSUInteger const FPQuantileSketchMinK = 8;
+static NSUInteger const FPQuantileSketchMaxLevels = 32;
+
+/*
+ Levels shrink geometrically from the top: the top level holds up to k values,
+ the one below it 2/3 as many, and so on, but never fewer than 2.
+ */
+static NSUInteger FPLevelCapacity(NSUInteger k, NSUInteger numLevels, NSUInteger level) {
+  NSUInteger capacity = (NSUInteger)ceil(k * pow(2.0 / 3.0, numLevels - 1 - level));
+  return MAX(capacity, 2);
+}
+
+static int FPCompareDoubles(const void *lhs, const void *rhs) {
+  double a = *(const double *)lhs;
+  double b = *(const double *)rhs;
+  return a < b ? -1 : (a > b ? 1 : 0);
+}
+
+typedef struct {
+  double value;
+  uint64_t weight;
+} FPWeightedValue;
+
+static int FPCompareWeightedValues(const void *lhs, const void *rhs) {
+  return FPCompareDoubles(&((const FPWeightedValue *)lhs)->value, &((const FPWeightedValue *)rhs)->value);
+}
+
+#pragma mark - Encoding helpers
+
+static void FPAppendUInt32(NSMutableData *data, uint32_t value) {
+  uint32_t little = CFSwapInt32HostToLittle(value);
+  [data appendBytes:&little length:sizeof(little)];
+}
+
+static void FPAppendUInt64(NSMutableData *data, uint64_t value) {
+  uint64_t little = CFSwapInt64HostToLittle(value);
+  [data appendBytes:&little length:sizeof(little)];
+}
+
+static void FPAppendDouble(NSMutableData *data, double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  FPAppendUInt64(data, bits);
+}
+
+static BOOL FPReadUInt32(NSData *data, NSUInteger *offset, uint32_t *value) {
+  if (*offset + sizeof(uint32_t) > data.length) {
+    return NO;
+  }
+  uint32_t little;
+  [data getBytes:&little range:NSMakeRange(*offset, sizeof(little))];
+  *value = CFSwapInt32LittleToHost(little);
+  *offset += sizeof(little);
+  return YES;
+}
+
+static BOOL FPReadUInt64(NSData *data, NSUInteger *offset, uint64_t *value) {
+  if (*offset + sizeof(uint64_t) > data.length) {
+    return NO;
+  }
+  uint64_t little;
+  [data getBytes:&little range:NSMakeRange(*offset, sizeof(little))];
+  *value = CFSwapInt64LittleToHost(little);
+  *offset += sizeof(little);
+  return YES;
+}
+
+static BOOL FPReadDouble(NSData *data, NSUInteger *offset, double *value) {
+  uint64_t bits;
+  if (!FPReadUInt64(data, offset, &bits)) {
+    return NO;
+  }
+  memcpy(value, &bits, sizeof(bits));
+  return YES;
+}
+
+@implementation FPQuantileSketch {
+  NSMutableArray *_levels; // NSMutableData of doubles, one per level
+  uint32_t _compactionParity; // bit h: the offset level h's next compaction keeps
+  double _min;
+  double _max;
+}
+
+#pragma mark - Initializers
+
+- (instancetype)init {
+  return [self initWithK:FPQuantileSketchDefaultK];
+}
+
+- (instancetype)initWithK:(NSUInteger)k {
+  self = [super init];
+  if (self) {
+    _k = MAX(k, FPQuantileSketchMinK);
+    _levels = [NSMutableArray arrayWithObject:[NSMutableData data]];
+    _min = NAN;
+    _max = NAN;
+  }
+  return self;
+}
+
+- (instancetype)initWithData:(NSData *)data {
+  NSUInteger offset = 0;
+  uint32_t magic, version, k, numLevels, parity;
+  uint64_t count;
+  double min, max;
+  if (!FPReadUInt32(data, &offset, &magic) || magic != FPQuantileSketchMagic ||
+      !FPReadUInt32(data, &offset, &version) || version != FPQuantileSketchFormatVersion ||
+      !FPReadUInt32(data, &offset, &k) ||
+      !FPReadUInt32(data, &offset, &numLevels) || numLevels == 0 || numLevels > FPQuantileSketchMaxLevels ||
+      !FPReadUInt32(data, &offset, &parity) ||
+      !FPReadUInt64(data, &offset, &count) ||
+      !FPReadDouble(data, &offset, &min) ||
+      !FPReadDouble(data, &offset, &max)) {
+    return nil;
+  }
+  self = [self initWithK:k];
+  if (self) {
+    [_levels removeAllObjects];
+    for (uint32_t h = 0; h < numLevels; h++) {
+      uint32_t numValues;
+      if (!FPReadUInt32(data, &offset, &numValues) || offset + (NSUInteger)numValues * sizeof(double) > data.length) {
+        return nil;
+      }
+      NSMutableData *level = [NSMutableData dataWithLength:numValues * sizeof(double)];
+      double *values = level.mutableBytes;
+      for (uint32_t i = 0; i < numValues; i++) {
+        FPReadDouble(data, &offset, &values[i]);
+      }
+      [_levels addObject:level];
+    }
+    if (offset != data.length) {
+      return nil;
+    }
+    _compactionParity = parity;
+    _count = (NSUInteger)count;
+    _min = min;
+    _max = max;
+  }
+  return self;
+}
+
+#pragma mark - Properties
+
+- (NSUInteger)numRetained {
+  NSUInteger numRetained = 0;
+  for (NSData *level in _levels) {
+    numRetained += level.length / sizeof(double);
+  }
+  return numRetained;
+}
+
+#pragma mark - Helpers
+
+/*
+ Compacts every level that's over its capacity, lowest first.  Compacting a
+ level sorts it and promotes every other value (each promoted value standing
+ in for itself and its neighbor); with an odd number of values, the largest
+ stays behind.  Adding a level shrinks the capacities of the ones below it, so
+ the pass starts over until no level is over.
+ */
+- (void)compress {
+  BOOL compacted = YES;
+  while (compacted) {
+    compacted = NO;
+    for (NSUInteger h = 0; h < _levels.count; h++) {
+      NSMutableData *level = _levels[h];
+      NSUInteger numValues = level.length / sizeof(double);
+      if (numValues <= FPLevelCapacity(_k, _levels.count, h)) {
+        continue;
+      }
+      if (h + 1 == _levels.count) {
+        if (_levels.count == FPQuantileSketchMaxLevels) {
+          break;
+        }
+        [_levels addObject:[NSMutableData data]];
+      }
+      double *values = level.mutableBytes;
+      qsort(values, numValues, sizeof(double), FPCompareDoubles);
+      NSUInteger numPaired = numValues & ~(NSUInteger)1;
+      NSUInteger offset = (_compactionParity >> h) & 1;
+      NSMutableData *nextLevel = _levels[h + 1];
+      for (NSUInteger i = offset; i < numPaired; i += 2) {
+        [nextLevel appendBytes:&values[i] length:sizeof(double)];
+      }
+      _compactionParity ^= (uint32_t)1 << h;
+      if (numPaired < numValues) {
+        values[0] = values[numPaired];
+      }
+      level.length = (numValues - numPaired) * sizeof(double);
+      compacted = YES;
+    }
+  }
+}
+
+#pragma mark - Updating
+
+- (void)addValue:(double)value {
+  if (isnan(value)) {
+    return;
+  }
+  if (_count == 0 || value < _min) {
+    _min = value;
+  }
+  if (_count == 0 || value > _max) {
+    _max = value;
+  }
+  _count++;
+  NSMutableData *level0 = _levels[0];
+  [level0 appendBytes:&value length:sizeof(double)];
+  if (level0.length / sizeof(double) > FPLevelCapacity(_k, _levels.count, 0)) {
+    [self compress];
+  }
+}
+
+- (void)mergeSketch:(FPQuantileSketch *)sketch {
+  if (sketch.count == 0) {
+    return;
+  }
+  if (_count == 0 || sketch->_min < _min) {
+    _min = sketch->_min;
+  }
+  if (_count == 0 || sketch->_max > _max) {
+    _max = sketch->_max;
+  }
+  _count += sketch.count;
+  for (NSUInteger h = 0; h < sketch->_levels.count; h++) {
+    if (h == _levels.count) {
+      [_levels addObject:[NSMutableData data]];
+    }
+    [_levels[h] appendData:sketch->_levels[h]];
+  }
+  [self compress];
+}
+
+#pragma mark - Querying
+
+- (double)quantile:(double)quantile {
+  if (_count == 0) {
+    return NAN;
+  }
+  if (quantile <= 0.0) {
+    return _min;
+  }
+  if (quantile >= 1.0) {
+    return _max;
+  }
+  NSUInteger numRetained = [self numRetained];
+  FPWeightedValue *weighted = malloc(numRetained * sizeof(FPWeightedValue));
+  NSUInteger n = 0;
+  uint64_t totalWeight = 0;
+  for (NSUInteger h = 0; h < _levels.count; h++) {
+    NSData *level = _levels[h];
+    const double *values = level.bytes;
+    for (NSUInteger i = 0; i < level.length / sizeof(double); i++) {
+      weighted[n].value = values[i];
+      weighted[n].weight = (uint64_t)1 << h;
+      totalWeight += weighted[n].weight;
+      n++;
+    }
+  }
+  qsort(weighted, n, sizeof(FPWeightedValue), FPCompareWeightedValues);
+  double targetWeight = quantile * totalWeight;
+  double result = _max;
+  uint64_t cumulativeWeight = 0;
+  for (NSUInteger i = 0; i < n; i++) {
+    cumulativeWeight += weighted[i].weight;
+    if (cumulativeWeight >= targetWeight) {
+      result = weighted[i].value;
+      break;
+    }
+  }
+  free(weighted);
+  return result;
+}
+
+- (NSDecimalNumber *)decimalNumberForQuantile:(double)quantile {
+  if (_count == 0) {
+    return nil;
+  }
+  return [NSDecimalNumber decimalNumberWithString:[NSString stringWithFormat:@"%.15g", [self quantile:quantile]]
+                                           locale:@{NSLocaleDecimalSeparator : @"."}];
+}
+
+#pragma mark - Serialization
+
+- (NSData *)dataRepresentation {
+  NSMutableData *data = [NSMutableData dataWithCapacity:44 + _levels.count * 4 + [self numRetained] * sizeof(double)];
+  FPAppendUInt32(data, FPQuantileSketchMagic);
+  FPAppendUInt32(data, FPQuantileSketchFormatVersion);
+  FPAppendUInt32(data, (uint32_t)_k);
+  FPAppendUInt32(data, (uint32_t)_levels.count);
+  FPAppendUInt32(data, _compactionParity);
+  FPAppendUInt64(data, _count);
+  FPAppendDouble(data, _min);
+  FPAppendDouble(data, _max);
+  for (NSData *level in _levels) {
+    const double *values = level.bytes;
+    NSUInteger numValues = level.length / sizeof(double);
+    FPAppendUInt32(data, (uint32_t)numValues);
+    for (NSUInteger i = 0; i < numValues; i++) {
+      FPAppendDouble(data, values[i]);
+    }
+  }
+  return data;
+}
+
+@end
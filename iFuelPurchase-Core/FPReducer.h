@@ -0,0 +1,65 @@
+//
+//  FPReducer.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ A streaming reducer: values are fed in one at a time and the result is
+ available at any point.  Values are NSNumber or NSDecimalNumber instances;
+ nil and NSNull values are skipped.  Reducers can be fused so that several
+ results (e.g., avg, min and max) come out of a single O(n) pass.
+ */
+@interface FPReducer : NSObject
+
+#pragma mark - Reducers
+
+/** The NSDecimalNumber sum; nil if no values were reduced. */
++ (FPReducer *)sumReducer;
+
+/** The NSNumber count of values reduced. */
++ (FPReducer *)countReducer;
+
+/** The NSDecimalNumber average; nil if no values were reduced. */
++ (FPReducer *)avgReducer;
+
+/** The smallest value reduced, as given. */
++ (FPReducer *)minReducer;
+
+/** The largest value reduced, as given. */
++ (FPReducer *)maxReducer;
+
+/** The most recent value reduced. */
++ (FPReducer *)lastReducer;
+
+/**
+ Feeds every value to each of the given reducers; its result is the array of
+ their results, in order, with NSNull standing in for nil.
+ */
++ (FPReducer *)fusedReducerWithReducers:(NSArray *)reducers;
+
+#pragma mark - Reducing
+
+- (void)reduceValue:(id)value;
+
+/**
+ Reduces the value of each item, as returned by valueBlk, and returns self.
+ */
+- (FPReducer *)reduceItems:(NSArray *)items valueBlk:(id(^)(id))valueBlk;
+
+/**
+ Reduces the value (dp[1]) of each datapoint of a [date, value] dataset, and
+ returns self.  An FPDataset's values are reduced straight out of its buffer,
+ without boxing them (min and max come back as NSDecimalNumber instances).
+ */
+- (FPReducer *)reduceDataset:(NSArray *)dataset;
+
+#pragma mark - Result
+
+- (id)result;
+
+@end
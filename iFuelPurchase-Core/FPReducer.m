@@ -0,0 +1,282 @@
+//
+//  FPReducer.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPReducer.h"
+
+#import <PEObjc-Commons/PEUtils.h>
+
+#import "FPDataset.h"
+#import "FPFixedPoint.h"
+
+@interface FPReducer ()
+- (void)reduceNonNilValue:(id)value;
+- (void)reduceDecimalValue:(NSDecimal)value;
+@end
+
+@interface FPSumReducer : FPReducer
+@end
+
+@interface FPCountReducer : FPReducer
+@end
+
+@interface FPAvgReducer : FPReducer
+@end
+
+@interface FPMinMaxReducer : FPReducer
+- (instancetype)initWithOrdering:(NSComparisonResult)ordering;
+@end
+
+@interface FPLastReducer : FPReducer
+@end
+
+@interface FPFusedReducer : FPReducer
+- (instancetype)initWithReducers:(NSArray *)reducers;
+@end
+
+@implementation FPReducer
+
+#pragma mark - Reducers
+
++ (FPReducer *)sumReducer {
+  return [[FPSumReducer alloc] init];
+}
+
++ (FPReducer *)countReducer {
+  return [[FPCountReducer alloc] init];
+}
+
++ (FPReducer *)avgReducer {
+  return [[FPAvgReducer alloc] init];
+}
+
++ (FPReducer *)minReducer {
+  return [[FPMinMaxReducer alloc] initWithOrdering:NSOrderedAscending];
+}
+
++ (FPReducer *)maxReducer {
+  return [[FPMinMaxReducer alloc] initWithOrdering:NSOrderedDescending];
+}
+
++ (FPReducer *)lastReducer {
+  return [[FPLastReducer alloc] init];
+}
+
++ (FPReducer *)fusedReducerWithReducers:(NSArray *)reducers {
+  return [[FPFusedReducer alloc] initWithReducers:reducers];
+}
+
+#pragma mark - Reducing
+
+- (void)reduceNonNilValue:(id)value {
+  [self doesNotRecognizeSelector:_cmd];
+}
+
+/*
+ Reduces a value read straight out of an FPDataset's buffer; reducers that
+ work on decimals override this so as to skip boxing it.
+ */
+- (void)reduceDecimalValue:(NSDecimal)value {
+  [self reduceNonNilValue:[NSDecimalNumber decimalNumberWithDecimal:value]];
+}
+
+- (void)reduceValue:(id)value {
+  if (![PEUtils isNil:value]) {
+    [self reduceNonNilValue:value];
+  }
+}
+
+- (FPReducer *)reduceItems:(NSArray *)items valueBlk:(id(^)(id))valueBlk {
+  for (id item in items) {
+    [self reduceValue:valueBlk(item)];
+  }
+  return self;
+}
+
+- (FPReducer *)reduceDataset:(NSArray *)dataset {
+  if ([dataset isKindOfClass:[FPDataset class]]) {
+    const NSDecimal *values = [(FPDataset *)dataset values];
+    for (NSUInteger i = 0; i < dataset.count; i++) {
+      [self reduceDecimalValue:values[i]];
+    }
+    return self;
+  }
+  for (NSArray *dp in dataset) {
+    [self reduceValue:dp[1]];
+  }
+  return self;
+}
+
+#pragma mark - Result
+
+- (id)result {
+  [self doesNotRecognizeSelector:_cmd];
+  return nil;
+}
+
+@end
+
+@implementation FPSumReducer {
+  FPSum _sum;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _sum = FPSumMake();
+  }
+  return self;
+}
+
+- (void)reduceNonNilValue:(id)value {
+  FPSumAddDecimal(&_sum, [value decimalValue]);
+}
+
+- (void)reduceDecimalValue:(NSDecimal)value {
+  FPSumAddDecimal(&_sum, value);
+}
+
+- (id)result {
+  return _sum.count > 0 ? FPSumDecimalNumber(&_sum) : nil;
+}
+
+@end
+
+@implementation FPCountReducer {
+  NSInteger _count;
+}
+
+- (void)reduceNonNilValue:(id)value {
+  _count++;
+}
+
+- (void)reduceDecimalValue:(NSDecimal)value {
+  _count++;
+}
+
+- (id)result {
+  return @(_count);
+}
+
+@end
+
+@implementation FPAvgReducer {
+  FPSum _sum;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _sum = FPSumMake();
+  }
+  return self;
+}
+
+- (void)reduceNonNilValue:(id)value {
+  FPSumAddDecimal(&_sum, [value decimalValue]);
+}
+
+- (void)reduceDecimalValue:(NSDecimal)value {
+  FPSumAddDecimal(&_sum, value);
+}
+
+- (id)result {
+  return FPSumAverage(&_sum);
+}
+
+@end
+
+@implementation FPMinMaxReducer {
+  NSComparisonResult _ordering;
+  id _value;
+  NSDecimal _decimal;
+  BOOL _hasDecimal; // the extreme so far came in as a decimal, and is boxed on demand
+}
+
+- (instancetype)initWithOrdering:(NSComparisonResult)ordering {
+  self = [super init];
+  if (self) {
+    _ordering = ordering;
+  }
+  return self;
+}
+
+- (void)reduceNonNilValue:(id)value {
+  id current = [self result];
+  if (current == nil || [value compare:current] == _ordering) {
+    _value = value;
+    _hasDecimal = NO;
+  }
+}
+
+- (void)reduceDecimalValue:(NSDecimal)value {
+  if (_value && !_hasDecimal) {
+    [super reduceDecimalValue:value];
+  } else if (!_hasDecimal || NSDecimalCompare(&value, &_decimal) == _ordering) {
+    _decimal = value;
+    _hasDecimal = YES;
+    _value = nil;
+  }
+}
+
+- (id)result {
+  if (_value == nil && _hasDecimal) {
+    _value = [NSDecimalNumber decimalNumberWithDecimal:_decimal];
+  }
+  return _value;
+}
+
+@end
+
+@implementation FPLastReducer {
+  id _value;
+}
+
+- (void)reduceNonNilValue:(id)value {
+  _value = value;
+}
+
+- (id)result {
+  return _value;
+}
+
+@end
+
+@implementation FPFusedReducer {
+  NSArray *_reducers;
+}
+
+- (instancetype)initWithReducers:(NSArray *)reducers {
+  self = [super init];
+  if (self) {
+    _reducers = reducers;
+  }
+  return self;
+}
+
+- (void)reduceNonNilValue:(id)value {
+  for (FPReducer *reducer in _reducers) {
+    [reducer reduceNonNilValue:value];
+  }
+}
+
+- (void)reduceDecimalValue:(NSDecimal)value {
+  for (FPReducer *reducer in _reducers) {
+    [reducer reduceDecimalValue:value];
+  }
+}
+
+- (id)result {
+  NSMutableArray *results = [NSMutableArray arrayWithCapacity:_reducers.count];
+  for (FPReducer *reducer in _reducers) {
+    id result = [reducer result];
+    [results addObject:result ? result : [NSNull null]];
+  }
+  return results;
+}
+
+@end
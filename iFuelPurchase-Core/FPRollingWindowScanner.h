@@ -0,0 +1,88 @@
+//
+//  FPRollingWindowScanner.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#import "FPLogAggregate.h"
+
+@class FPDataset;
+@class FPLogColumns;
+@class FPEnvironmentLog;
+
+typedef NS_ENUM(NSInteger, FPRollingSeriesGranularity) {
+  /** A datapoint per log, dated as the log. */
+  FPRollingSeriesGranularityPerLog,
+  /** A datapoint per day, dated at the start of the day. */
+  FPRollingSeriesGranularityDaily
+};
+
+/**
+ Computes moving sums and averages (e.g., over the trailing 30, 90 or 365 days)
+ of a series of dated values.  The values are sorted by date once, up front,
+ and a series is then produced by sliding a window across them with a pair of
+ indexes: each datapoint adds the values that entered the window since the
+ previous datapoint and removes the ones that left it, so a whole series costs
+ a single pass over the values however wide the window is, rather than a range
+ query per datapoint.
+
+ A window of n days ending on a given day holds the values dated that day and
+ on the n - 1 days before it (and, for a per-log datapoint, only those dated
+ no later than the log).  Values are held in micro-units (see FPFixedPoint), so
+ a value with more than 6 decimal places is rounded; sums are exact.
+ */
+@interface FPRollingWindowScanner : NSObject
+
+#pragma mark - Initializers
+
+/**
+ The measure of the gas log rows carrying it.  A nil octane (and diesel NO)
+ takes every row; diesel takes the diesel rows without an octane.
+ */
+- (instancetype)initWithGasLogColumns:(FPLogColumns *)gasLogColumns
+                              measure:(FPGasLogMeasure)measure
+                               octane:(NSNumber *)octane
+                               diesel:(BOOL)diesel;
+
+/**
+ envlogs can be in any order; logs without a date, or for which valueBlk
+ returns nil, are ignored.
+ */
+- (instancetype)initWithEnvironmentLogs:(NSArray *)envlogs
+                               valueBlk:(NSDecimalNumber *(^)(FPEnvironmentLog *))valueBlk;
+
+#pragma mark - Properties
+
+/** The number of values held. */
+@property (nonatomic, readonly) NSUInteger count;
+
+#pragma mark - Scanning
+
+/**
+ Returns a [date, moving sum] dataset of the datapoints dated within
+ [onOrAfterDate, beforeDate), though their windows may reach back before
+ onOrAfterDate.  Daily datapoints run from the day of the first value in range
+ through the last day starting before beforeDate (or, if beforeDate is nil,
+ the day of the last value), skipping days whose window is empty.
+ */
+- (FPDataset *)movingSumDataSetWithWindowDays:(NSInteger)windowDays
+                                  granularity:(FPRollingSeriesGranularity)granularity
+                                     calendar:(NSCalendar *)calendar
+                                   beforeDate:(NSDate *)beforeDate
+                                onOrAfterDate:(NSDate *)onOrAfterDate;
+
+/**
+ As movingSumDataSetWithWindowDays:..., with each datapoint's value being the
+ average of the values in its window.
+ */
+- (FPDataset *)movingAvgDataSetWithWindowDays:(NSInteger)windowDays
+                                  granularity:(FPRollingSeriesGranularity)granularity
+                                     calendar:(NSCalendar *)calendar
+                                   beforeDate:(NSDate *)beforeDate
+                                onOrAfterDate:(NSDate *)onOrAfterDate;
+
+@end
@@ -0,0 +1,271 @@
+//
+//  FPRollingWindowScanner.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPRollingWindowScanner.h"
+
+#import <PEObjc-Commons/PEUtils.h>
+
+#import "FPDataset.h"
+#import "FPEnvironmentLog.h"
+#import "FPFixedPoint.h"
+#import "FPLogColumns.h"
+#import "FPMonthBoundaries.h"
+
+typedef struct {
+  FPEpochMillis millis;
+  FPMicros value;
+} FPDatedValue;
+
+static int FPCompareDatedValues(const void *lhs, const void *rhs) {
+  const FPDatedValue *a = lhs;
+  const FPDatedValue *b = rhs;
+  if (a->millis != b->millis) {
+    return a->millis < b->millis ? -1 : 1;
+  }
+  return a->value < b->value ? -1 : (a->value > b->value ? 1 : 0);
+}
+
+/*
+ The values in [start, end), and their running sum.
+ */
+typedef struct {
+  NSUInteger start;
+  NSUInteger end;
+  FPSum sum;
+} FPRollingWindow;
+
+@implementation FPRollingWindowScanner {
+  NSMutableData *_millis;
+  NSMutableData *_values;
+  NSMutableData *_factors; // non-nil when each value is the product of _values and _factors
+}
+
+#pragma mark - Initializers
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity products:(BOOL)products {
+  self = [super init];
+  if (self) {
+    _millis = [NSMutableData dataWithCapacity:capacity * sizeof(FPEpochMillis)];
+    _values = [NSMutableData dataWithCapacity:capacity * sizeof(FPMicros)];
+    if (products) {
+      _factors = [NSMutableData dataWithCapacity:capacity * sizeof(FPMicros)];
+    }
+  }
+  return self;
+}
+
+- (instancetype)initWithGasLogColumns:(FPLogColumns *)gasLogColumns
+                              measure:(FPGasLogMeasure)measure
+                               octane:(NSNumber *)octane
+                               diesel:(BOOL)diesel {
+  self = [self initWithCapacity:gasLogColumns.count products:measure == FPGasLogMeasureSpent];
+  if (self) {
+    const int64_t *purchasedAtMillis = [gasLogColumns purchasedAtMillis];
+    const FPMicros *gallons = [gasLogColumns numGallons];
+    const FPMicros *prices = [gasLogColumns gallonPrices];
+    const int32_t *octanes = [gasLogColumns octanes];
+    const BOOL *dieselFlags = [gasLogColumns dieselFlags];
+    int32_t octaneValue = octane ? (int32_t)[octane intValue] : FPLogColumnsNullOctane;
+    for (NSUInteger i = 0; i < gasLogColumns.count; i++) {
+      if (diesel) {
+        if (octanes[i] != FPLogColumnsNullOctane || !dieselFlags[i]) {
+          continue;
+        }
+      } else if (octane && octanes[i] != octaneValue) {
+        continue;
+      }
+      FPMicros value = FPLogColumnsNullMicros;
+      switch (measure) {
+        case FPGasLogMeasureSpent:
+          if (gallons[i] == FPLogColumnsNullMicros || prices[i] == FPLogColumnsNullMicros) {
+            continue;
+          }
+          [_factors appendBytes:&prices[i] length:sizeof(FPMicros)];
+          value = gallons[i];
+          break;
+        case FPGasLogMeasureGallonPrice:
+          value = prices[i];
+          break;
+        case FPGasLogMeasureNumGallons:
+          value = gallons[i];
+          break;
+      }
+      if (value == FPLogColumnsNullMicros) {
+        continue;
+      }
+      [_millis appendBytes:&purchasedAtMillis[i] length:sizeof(FPEpochMillis)];
+      [_values appendBytes:&value length:sizeof(FPMicros)];
+      _count++;
+    }
+  }
+  return self;
+}
+
+- (instancetype)initWithEnvironmentLogs:(NSArray *)envlogs
+                               valueBlk:(NSDecimalNumber *(^)(FPEnvironmentLog *))valueBlk {
+  self = [self initWithCapacity:envlogs.count products:NO];
+  if (self) {
+    NSMutableData *datedValues = [NSMutableData dataWithLength:envlogs.count * sizeof(FPDatedValue)];
+    FPDatedValue *datedValuesBytes = datedValues.mutableBytes;
+    NSUInteger numDatedValues = 0;
+    for (FPEnvironmentLog *envlog in envlogs) {
+      NSDecimalNumber *value = valueBlk(envlog);
+      if (envlog.logDate && ![PEUtils isNil:value]) {
+        datedValuesBytes[numDatedValues].millis = FPEpochMillisFromDate(envlog.logDate);
+        FPMicrosFromDecimal([value decimalValue], &datedValuesBytes[numDatedValues].value);
+        numDatedValues++;
+      }
+    }
+    qsort(datedValuesBytes, numDatedValues, sizeof(FPDatedValue), FPCompareDatedValues);
+    for (NSUInteger i = 0; i < numDatedValues; i++) {
+      [_millis appendBytes:&datedValuesBytes[i].millis length:sizeof(FPEpochMillis)];
+      [_values appendBytes:&datedValuesBytes[i].value length:sizeof(FPMicros)];
+    }
+    _count = numDatedValues;
+  }
+  return self;
+}
+
+#pragma mark - Helpers
+
+/*
+ The index of the first value dated on or after millis.
+ */
+- (NSUInteger)lowerBoundForMillis:(FPEpochMillis)millis {
+  const FPEpochMillis *dates = _millis.bytes;
+  NSUInteger low = 0;
+  NSUInteger high = _count;
+  while (low < high) {
+    NSUInteger mid = low + ((high - low) / 2);
+    if (dates[mid] < millis) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return low;
+}
+
+/*
+ Moves the window to hold the values dated within [startMillis, endMillis).
+ Both bounds only ever move forward, so across a whole series each value is
+ added once and removed at most once.
+ */
+- (void)slideWindow:(FPRollingWindow *)window startMillis:(FPEpochMillis)startMillis endMillis:(FPEpochMillis)endMillis {
+  const FPEpochMillis *dates = _millis.bytes;
+  const FPMicros *values = _values.bytes;
+  const FPMicros *factors = _factors.bytes;
+  while (window->end < _count && dates[window->end] < endMillis) {
+    if (factors) {
+      FPSumAddMicrosProduct(&window->sum, values[window->end], factors[window->end]);
+    } else {
+      FPSumAddMicros(&window->sum, values[window->end]);
+    }
+    window->end++;
+  }
+  while (window->start < window->end && dates[window->start] < startMillis) {
+    if (factors) {
+      FPSumRemoveMicrosProduct(&window->sum, values[window->start], factors[window->start]);
+    } else {
+      FPSumRemoveMicros(&window->sum, values[window->start]);
+    }
+    window->start++;
+  }
+}
+
+- (FPDataset *)dataSetWithWindowDays:(NSInteger)windowDays
+                         granularity:(FPRollingSeriesGranularity)granularity
+                            calendar:(NSCalendar *)calendar
+                          beforeDate:(NSDate *)beforeDate
+                       onOrAfterDate:(NSDate *)onOrAfterDate
+                         windowValue:(NSDecimal(^)(const FPSum *))windowValue {
+  const FPEpochMillis *dates = _millis.bytes;
+  NSUInteger first = onOrAfterDate ? [self lowerBoundForMillis:FPEpochMillisFromDate(onOrAfterDate)] : 0;
+  NSUInteger last = beforeDate ? [self lowerBoundForMillis:FPEpochMillisFromDate(beforeDate)] : _count;
+  FPDataset *dataset = [[FPDataset alloc] init];
+  if (first >= last || windowDays < 1) {
+    return dataset;
+  }
+  NSDate *(^windowStartForDay)(NSDate *) = ^NSDate *(NSDate *dayStart) {
+    return [calendar dateByAddingUnit:NSCalendarUnitDay value:-(windowDays - 1) toDate:dayStart options:0];
+  };
+  NSDate *firstDayStart = [calendar startOfDayForDate:[NSDate dateWithTimeIntervalSince1970:dates[first] / 1000.0]];
+  FPRollingWindow window;
+  window.start = window.end = [self lowerBoundForMillis:FPEpochMillisFromDate(windowStartForDay(firstDayStart))];
+  window.sum = FPSumMake();
+  switch (granularity) {
+    case FPRollingSeriesGranularityPerLog: {
+      // the window's start only moves when the datapoints cross into a new day
+      FPEpochMillis nextDayMillis = INT64_MIN;
+      FPEpochMillis startMillis = 0;
+      for (NSUInteger i = first; i < last; i++) {
+        if (dates[i] >= nextDayMillis) {
+          NSDate *dayStart = [calendar startOfDayForDate:[NSDate dateWithTimeIntervalSince1970:dates[i] / 1000.0]];
+          nextDayMillis = FPEpochMillisFromDate([calendar dateByAddingUnit:NSCalendarUnitDay value:1 toDate:dayStart options:0]);
+          startMillis = FPEpochMillisFromDate(windowStartForDay(dayStart));
+        }
+        [self slideWindow:&window startMillis:startMillis endMillis:dates[i] + 1];
+        [dataset appendValue:windowValue(&window.sum) atMillis:dates[i]];
+      }
+      break;
+    }
+    case FPRollingSeriesGranularityDaily: {
+      FPEpochMillis beforeMillis = beforeDate ? FPEpochMillisFromDate(beforeDate) : dates[last - 1] + 1;
+      for (NSInteger day = 0; ; day++) {
+        NSDate *dayStart = [calendar dateByAddingUnit:NSCalendarUnitDay value:day toDate:firstDayStart options:0];
+        if (FPEpochMillisFromDate(dayStart) >= beforeMillis) {
+          break;
+        }
+        NSDate *nextDayStart = [calendar dateByAddingUnit:NSCalendarUnitDay value:day + 1 toDate:firstDayStart options:0];
+        [self slideWindow:&window
+              startMillis:FPEpochMillisFromDate(windowStartForDay(dayStart))
+                endMillis:FPEpochMillisFromDate(nextDayStart)];
+        if (window.sum.count > 0) {
+          [dataset appendValue:windowValue(&window.sum) atMillis:FPEpochMillisFromDate(dayStart)];
+        }
+      }
+      break;
+    }
+  }
+  return dataset;
+}
+
+#pragma mark - Scanning
+
+- (FPDataset *)movingSumDataSetWithWindowDays:(NSInteger)windowDays
+                                  granularity:(FPRollingSeriesGranularity)granularity
+                                     calendar:(NSCalendar *)calendar
+                                   beforeDate:(NSDate *)beforeDate
+                                onOrAfterDate:(NSDate *)onOrAfterDate {
+  return [self dataSetWithWindowDays:windowDays
+                         granularity:granularity
+                            calendar:calendar
+                          beforeDate:beforeDate
+                       onOrAfterDate:onOrAfterDate
+                         windowValue:^NSDecimal(const FPSum *sum) { return FPSumTotal(sum); }];
+}
+
+- (FPDataset *)movingAvgDataSetWithWindowDays:(NSInteger)windowDays
+                                  granularity:(FPRollingSeriesGranularity)granularity
+                                     calendar:(NSCalendar *)calendar
+                                   beforeDate:(NSDate *)beforeDate
+                                onOrAfterDate:(NSDate *)onOrAfterDate {
+  return [self dataSetWithWindowDays:windowDays
+                         granularity:granularity
+                            calendar:calendar
+                          beforeDate:beforeDate
+                       onOrAfterDate:onOrAfterDate
+                         windowValue:^NSDecimal(const FPSum *sum) {
+                           // never called on an empty window
+                           NSDecimal avg;
+                           FPSumAverageDecimal(sum, &avg);
+                           return avg;
+                         }];
+}
+
+@end
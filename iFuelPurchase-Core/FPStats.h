@@ -10,6 +10,10 @@
 
 #import <PELocal-Data/PELMDefs.h>
 
+#import "FPStatsSnapshot.h"
+#import "FPRollingWindowScanner.h"
+#import "FPStatsRequest.h"
+
 @protocol FPLocalDao;
 @class FPVehicle;
 @class FPUser;
@@ -23,6 +27,79 @@
 
 - (id)initWithLocalDao:(id<FPLocalDao>)localDao errorBlk:(PELMDaoErrorBlk)errorBlk;
 
+#pragma mark - Cache
+
+/**
+ Every stat is memoized by (stat, scope entity, date range), and the cache is
+ stamped with the local DAO's data version; any save, delete or changelog
+ application invalidates it.  The memoization is applied to every stat method
+ at once, when the class is initialized, rather than by each method; the cache
+ holds a bounded number of results, evicting beyond that.
+ */
+@property (nonatomic, readonly) NSInteger cacheHits;
+
+@property (nonatomic, readonly) NSInteger cacheMisses;
+
+- (void)clearCache;
+
+#pragma mark - Concurrency
+
+/**
+ Whether user-level datasets compute each vehicle's dataset concurrently (one
+ dispatch_apply iteration per vehicle, reading through the local DAO's pool of
+ read-only connections) before merging them.  Defaults to YES.
+ */
+@property (nonatomic) BOOL computesDatasetsConcurrently;
+
+#pragma mark - Asynchronous Requests
+
+/**
+ Computes valueBlk(self) on the stats queue (a serial queue of the receiver's
+ own) and calls completionBlk with the value on the completion queue, unless
+ the returned request is cancelled first.  Any stat (or set of stats) can be
+ requested this way, e.g.:
+
+   [stats computeValueAsyncForKey:@[@"overallSpentOnGas", user.localMainIdentifier]
+                           screen:@"VehicleDetail"
+                         valueBlk:^id(FPStats *stats) { return [stats overallSpentOnGasForUser:user]; }
+                    completionBlk:^(NSDecimalNumber *spent) { ... }];
+
+ key identifies the stat and its scope: while a request with an equal key is
+ in flight, a new one joins it rather than computing the value again.  A nil
+ key is never coalesced.
+
+ screen identifies the requester: the request joins the screen's current round
+ of requests (see beginRoundForScreen:), and is cancelled along with the rest
+ of the round when the screen begins its next one.  Requests of the same round
+ never cancel each other.  nil means the request isn't tied to a screen.
+ */
+- (FPStatsRequest *)computeValueAsyncForKey:(NSArray *)key
+                                     screen:(NSString *)screen
+                                   valueBlk:(id(^)(FPStats *))valueBlk
+                              completionBlk:(void(^)(id))completionBlk;
+
+/**
+ Begins a new round of requests for screen, cancelling the requests of its
+ earlier rounds that haven't completed.  A screen that moves on (to another
+ vehicle, say) begins a round before requesting its stats, so it never gets
+ stale values.
+ */
+- (void)beginRoundForScreen:(NSString *)screen;
+
+/**
+ As computeValueAsyncForKey:screen:valueBlk:completionBlk:, computing the
+ snapshot (which is never coalesced) and passing it to completionBlk.
+ */
+- (FPStatsRequest *)computeSnapshotAsync:(FPStatsSnapshot *)snapshot
+                                  screen:(NSString *)screen
+                           completionBlk:(void(^)(FPStatsSnapshot *))completionBlk;
+
+/** Where completion blocks are called; defaults to the main queue. */
+@property (nonatomic, strong) dispatch_queue_t completionQueue;
+
+/** The number of requests that joined a computation already in flight. */
+@property (nonatomic, readonly) NSInteger numCoalescedRequests;
+
 #pragma mark - Sinces since last odometer log
 
 - (NSNumber *)daysSinceLastOdometerLogForUser:(FPUser *)user;
@@ -555,6 +632,125 @@
 
 - (NSDecimalNumber *)overallMinPricePerDieselGallonForFuelstation:(FPFuelStation *)fuelstation;
 
+#pragma mark - Price Per Gallon By Octane
+
+/**
+ The price-per-gallon stats (FPOctanePriceStats) of every octane the entity's
+ gas logs were purchased at over the range, keyed by octane (diesel is keyed by
+ FPOctaneKeyDiesel).  Takes one grouped aggregate query and one grouped monthly
+ rollup query, rather than a set of queries per octane.
+ */
+- (NSDictionary *)pricePerGallonStatsByOctaneForUser:(FPUser *)user range:(FPStatsRange)range;
+
+- (NSDictionary *)pricePerGallonStatsByOctaneForVehicle:(FPVehicle *)vehicle range:(FPStatsRange)range;
+
+- (NSDictionary *)pricePerGallonStatsByOctaneForFuelstation:(FPFuelStation *)fuelstation range:(FPStatsRange)range;
+
+#pragma mark - Percentiles
+
+/**
+ Percentiles of the gallon price and of the reported avg MPG, where quantile is
+ a fraction (0.1 for p10, 0.5 for the median, 0.9 for p90).  octane is nil for
+ every fuel, an octane, or FPOctaneKeyDiesel.  They're answered from the
+ monthly quantile sketches the local DAO keeps (see FPQuantileSketch), so the
+ cost doesn't grow with the number of logs; the sketch for an entity, octane
+ and range is fetched once and shared by every percentile asked of it.  Ranges
+ are widened to whole months.  Nil if there are no values in range.
+ */
+- (NSDecimalNumber *)pricePerGallonQuantile:(double)quantile
+                                    forUser:(FPUser *)user
+                                     octane:(NSNumber *)octane
+                                      range:(FPStatsRange)range;
+
+- (NSDecimalNumber *)pricePerGallonQuantile:(double)quantile
+                                 forVehicle:(FPVehicle *)vehicle
+                                     octane:(NSNumber *)octane
+                                      range:(FPStatsRange)range;
+
+- (NSDecimalNumber *)pricePerGallonQuantile:(double)quantile
+                             forFuelstation:(FPFuelStation *)fuelstation
+                                     octane:(NSNumber *)octane
+                                      range:(FPStatsRange)range;
+
+- (NSDecimalNumber *)reportedAvgMpgQuantile:(double)quantile
+                                    forUser:(FPUser *)user
+                                      range:(FPStatsRange)range;
+
+- (NSDecimalNumber *)reportedAvgMpgQuantile:(double)quantile
+                                 forVehicle:(FPVehicle *)vehicle
+                                      range:(FPStatsRange)range;
+
+#pragma mark - Rolling Windows
+
+/**
+ Moving sums and averages over a trailing window of windowDays days (e.g., 30,
+ 90 or 365): a datapoint's value covers the logs dated on its day and on the
+ windowDays - 1 days before it.  granularity gives a datapoint per log (dated
+ as the log) or per day (dated at the start of the day, for the days whose
+ window holds a log).  Only the datapoints in range are returned, though their
+ windows reach back before it.  Each series is computed in a single sliding
+ pass over the date-sorted logs (see FPRollingWindowScanner), rather than a
+ range query per datapoint.  The avg spent on gas is per log; octane is as for
+ the percentiles.
+ */
+- (NSArray *)movingSumSpentOnGasDataSetForUser:(FPUser *)user
+                                    windowDays:(NSInteger)windowDays
+                                   granularity:(FPRollingSeriesGranularity)granularity
+                                         range:(FPStatsRange)range;
+
+- (NSArray *)movingSumSpentOnGasDataSetForVehicle:(FPVehicle *)vehicle
+                                       windowDays:(NSInteger)windowDays
+                                      granularity:(FPRollingSeriesGranularity)granularity
+                                            range:(FPStatsRange)range;
+
+- (NSArray *)movingSumSpentOnGasDataSetForFuelstation:(FPFuelStation *)fuelstation
+                                           windowDays:(NSInteger)windowDays
+                                          granularity:(FPRollingSeriesGranularity)granularity
+                                                range:(FPStatsRange)range;
+
+- (NSArray *)movingAvgSpentOnGasDataSetForUser:(FPUser *)user
+                                    windowDays:(NSInteger)windowDays
+                                   granularity:(FPRollingSeriesGranularity)granularity
+                                         range:(FPStatsRange)range;
+
+- (NSArray *)movingAvgSpentOnGasDataSetForVehicle:(FPVehicle *)vehicle
+                                       windowDays:(NSInteger)windowDays
+                                      granularity:(FPRollingSeriesGranularity)granularity
+                                            range:(FPStatsRange)range;
+
+- (NSArray *)movingAvgSpentOnGasDataSetForFuelstation:(FPFuelStation *)fuelstation
+                                           windowDays:(NSInteger)windowDays
+                                          granularity:(FPRollingSeriesGranularity)granularity
+                                                range:(FPStatsRange)range;
+
+- (NSArray *)movingAvgPricePerGallonDataSetForUser:(FPUser *)user
+                                            octane:(NSNumber *)octane
+                                        windowDays:(NSInteger)windowDays
+                                       granularity:(FPRollingSeriesGranularity)granularity
+                                             range:(FPStatsRange)range;
+
+- (NSArray *)movingAvgPricePerGallonDataSetForVehicle:(FPVehicle *)vehicle
+                                               octane:(NSNumber *)octane
+                                           windowDays:(NSInteger)windowDays
+                                          granularity:(FPRollingSeriesGranularity)granularity
+                                                range:(FPStatsRange)range;
+
+- (NSArray *)movingAvgPricePerGallonDataSetForFuelstation:(FPFuelStation *)fuelstation
+                                                   octane:(NSNumber *)octane
+                                               windowDays:(NSInteger)windowDays
+                                              granularity:(FPRollingSeriesGranularity)granularity
+                                                    range:(FPStatsRange)range;
+
+- (NSArray *)movingAvgReportedMpgDataSetForUser:(FPUser *)user
+                                     windowDays:(NSInteger)windowDays
+                                    granularity:(FPRollingSeriesGranularity)granularity
+                                          range:(FPStatsRange)range;
+
+- (NSArray *)movingAvgReportedMpgDataSetForVehicle:(FPVehicle *)vehicle
+                                        windowDays:(NSInteger)windowDays
+                                       granularity:(FPRollingSeriesGranularity)granularity
+                                             range:(FPStatsRange)range;
+
 #pragma mark - Miles Recorded
 
 - (NSDecimalNumber *)milesRecordedForVehicle:(FPVehicle *)vehicle;
@@ -578,4 +774,12 @@
               oneYearAgoFromDate:(NSDate *)oneYearAgoFromDate
               withinDaysVariance:(NSInteger)daysVariance;
 
+#pragma mark - Snapshots
+
+/**
+ Computes every stat requested of the snapshot, fetching each requested
+ entity's logs once.
+ */
+- (void)computeSnapshot:(FPStatsSnapshot *)snapshot;
+
 @end
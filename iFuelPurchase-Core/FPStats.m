@@ -8,17 +8,166 @@
 
 #import "FPStats.h"
 
+#import <objc/runtime.h>
+#import <objc/message.h>
 #import <PEObjc-Commons/PEUtils.h>
 
 #import "FPFuelPurchaseLog.h"
 #import "FPEnvironmentLog.h"
 #import "FPLocalDao.h"
+#import "FPLogAggregate.h"
+#import "FPFixedPoint.h"
+#import "FPReducer.h"
+#import "FPDataset.h"
+#import "FPDatasetMerger.h"
+#import "FPMonthBoundaries.h"
+#import "FPOctanePriceStats.h"
+#import "FPQuantileSketch.h"
+#import "FPRollingWindowScanner.h"
+#import "FPCostPerMileScanner.h"
+#import "FPLogColumns.h"
+#import "FPStatsSnapshot.h"
+#import "FPUser.h"
+#import "FPVehicle.h"
+#import "FPFuelStation.h"
 
 typedef id (^FPValueBlock)(void);
 
+/*
+ The most results kept at once; the cache evicts beyond that.  A screen's worth
+ of stats for a few vehicles and stations is a few hundred.
+ */
+static NSUInteger const FP_MAX_MEMOIZED_VALUES = 2048;
+
+/*
+ Each memoized method's selector, mapped to the one its own implementation was
+ moved to (see +initialize).  Built once, then only read.
+ */
+static CFDictionaryRef FPUnmemoizedSelectors;
+
+/*
+ Whether a call with these arguments is memoized: it must be scoped to a user,
+ vehicle or fuel station, and its other arguments must be values (octanes,
+ years, ranges); a call given dates, logs or collections is computed afresh.
+ */
+static BOOL FPIsMemoArg(id arg, BOOL *isScope) {
+  if ([arg isKindOfClass:[FPUser class]] ||
+      [arg isKindOfClass:[FPVehicle class]] ||
+      [arg isKindOfClass:[FPFuelStation class]]) {
+    *isScope = YES;
+    return YES;
+  }
+  return arg == nil || [arg isKindOfClass:[NSNumber class]] || [arg isKindOfClass:[NSString class]];
+}
+
+/*
+ Memo keys identify entities by their local identifiers rather than by the
+ (mutable) entity objects themselves; nil arguments are keyed as NSNull.
+ */
+static id FPMemoArg(id arg) {
+  if (arg == nil) {
+    return [NSNull null];
+  }
+  if ([arg isKindOfClass:[PELMModelSupport class]]) {
+    PELMModelSupport *entity = arg;
+    return @[NSStringFromClass([entity class]),
+             entity.localMainIdentifier ? entity.localMainIdentifier : [NSNull null],
+             entity.localMasterIdentifier ? entity.localMasterIdentifier : [NSNull null]];
+  }
+  return arg;
+}
+
+/*
+ The memo key of the call: its selector and arguments; nil if the call isn't
+ memoized.
+ */
+static NSArray *FPMemoKey(NSInvocation *invocation) {
+  NSMethodSignature *signature = [invocation methodSignature];
+  NSMutableArray *key = [NSMutableArray arrayWithObject:[NSValue valueWithPointer:[invocation selector]]];
+  BOOL isScoped = NO;
+  for (NSUInteger i = 2; i < [signature numberOfArguments]; i++) {
+    const char *type = [signature getArgumentTypeAtIndex:i];
+    if (type[0] == _C_ID) {
+      __unsafe_unretained id arg = nil;
+      [invocation getArgument:&arg atIndex:i];
+      if (!FPIsMemoArg(arg, &isScoped)) {
+        return nil;
+      }
+      [key addObject:FPMemoArg(arg)];
+    } else {
+      // a number; +initialize only memoizes methods taking objects and numbers
+      char bytes[sizeof(long double)];
+      [invocation getArgument:bytes atIndex:i];
+      [key addObject:[NSValue valueWithBytes:bytes objCType:type]];
+    }
+  }
+  return isScoped ? key : nil;
+}
+
+/*
+ Whether method is memoized: it returns an object, and takes objects (not
+ blocks) and numbers, at least one of them an object (the scope).
+ */
+static BOOL FPIsMemoizable(Method method) {
+  char returnType[8];
+  method_getReturnType(method, returnType, sizeof(returnType));
+  if (strcmp(returnType, @encode(id)) != 0) {
+    return NO;
+  }
+  BOOL takesObject = NO;
+  unsigned int numArgs = method_getNumberOfArguments(method);
+  for (unsigned int i = 2; i < numArgs; i++) {
+    char argType[8];
+    method_getArgumentType(method, i, argType, sizeof(argType));
+    if (strcmp(argType, @encode(id)) == 0) {
+      takesObject = YES;
+    } else if (strlen(argType) != 1 || !strchr("cislqCISLQBfd", argType[0])) {
+      return NO;
+    }
+  }
+  return takesObject;
+}
+
+/*
+ A computation queued or running on the stats queue, and the requests waiting
+ on it (each with its completion block).
+ */
+@interface FPStatsComputation : NSObject
+@property (nonatomic, readonly) NSMutableArray *requests;
+@property (nonatomic, readonly) NSMutableArray *completionBlks;
+@end
+
+@implementation FPStatsComputation
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _requests = [NSMutableArray array];
+    _completionBlks = [NSMutableArray array];
+  }
+  return self;
+}
+
+- (BOOL)hasLiveRequest {
+  for (FPStatsRequest *request in _requests) {
+    if (!request.isCancelled) {
+      return YES;
+    }
+  }
+  return NO;
+}
+
+@end
+
 @implementation FPStats {
   id<FPLocalDao> _localDao;
   PELMDaoErrorBlk _errorBlk;
+  NSCache *_memoCache;
+  int64_t _memoDataVersion;
+  NSDate *_memoDay;
+  dispatch_queue_t _statsQueue;
+  NSMutableDictionary *_computationsInFlight; // by key; also guards _requestsByScreen
+  NSMutableDictionary *_requestsByScreen; // the uncompleted requests of each screen's current round
 }
 
 #pragma mark - Initializers
@@ -28,84 +177,250 @@ typedef id (^FPValueBlock)(void);
   if (self) {
     _localDao = localDao;
     _errorBlk = errorBlk;
+    _memoCache = [[NSCache alloc] init];
+    [_memoCache setCountLimit:FP_MAX_MEMOIZED_VALUES];
+    _memoDataVersion = -1;
+    _computesDatasetsConcurrently = YES;
+    _statsQueue = dispatch_queue_create("FPStats", DISPATCH_QUEUE_SERIAL);
+    _completionQueue = dispatch_get_main_queue();
+    _computationsInFlight = [NSMutableDictionary dictionary];
+    _requestsByScreen = [NSMutableDictionary dictionary];
   }
   return self;
 }
 
-#pragma mark - Helpers
+#pragma mark - Memoization
 
-- (NSDecimalNumber *)avgValueForItems:(NSArray *)items
-                        itemValidator:(BOOL(^)(id))itemValidator
-                          accumulator:(NSDecimalNumber *(^)(id))accumulator {
-  NSInteger itemsCount = [items count];
-  if (itemsCount > 0) {
-    NSInteger numRelevantItems = 0;
-    NSDecimalNumber *total = [NSDecimalNumber zero];
-    for (id item in items) {
-      if (itemValidator(item)) {
-        NSDecimalNumber *val = accumulator(item);
-        if (val) {
-          numRelevantItems++;
-          total = [total decimalNumberByAdding:val];
-        }
-      }
-    }
-    if (numRelevantItems > 0) {
-      return [total decimalNumberByDividingBy:[[NSDecimalNumber alloc] initWithInteger:numRelevantItems]];
+/*
+ Routes every memoizable method (see FPIsMemoizable) through
+ forwardInvocation:, which memoizes it.  This covers each stat, and the
+ per-entity values the stats share (the entity's gas log columns, its sketches).
+ The method's own implementation moves to an "fpUnmemoized_" selector.
+ */
++ (void)initialize {
+  if (self != [FPStats class]) {
+    return;
+  }
+  CFMutableDictionaryRef unmemoizedSelectors = CFDictionaryCreateMutable(NULL, 0, NULL, NULL);
+  unsigned int numMethods;
+  Method *methods = class_copyMethodList(self, &numMethods);
+  for (unsigned int i = 0; i < numMethods; i++) {
+    Method method = methods[i];
+    if (FPIsMemoizable(method)) {
+      SEL selector = method_getName(method);
+      SEL unmemoizedSelector = sel_registerName([[@"fpUnmemoized_" stringByAppendingString:NSStringFromSelector(selector)] UTF8String]);
+      class_addMethod(self, unmemoizedSelector, method_getImplementation(method), method_getTypeEncoding(method));
+      method_setImplementation(method, _objc_msgForward);
+      CFDictionarySetValue(unmemoizedSelectors, selector, unmemoizedSelector);
     }
   }
-  return nil;
+  free(methods);
+  FPUnmemoizedSelectors = CFDictionaryCreateCopy(NULL, unmemoizedSelectors);
+  CFRelease(unmemoizedSelectors);
 }
 
-- (NSDecimalNumber *)avgValueForDataset:(NSArray *)dataset
-                            accumulator:(NSDecimalNumber *(^)(id))accumulator {
-  return [self avgValueForItems:dataset
-                  itemValidator:^(NSArray *dp){return YES;}
-                    accumulator:^(NSArray *dp){return accumulator(dp[1]);}];
+- (void)forwardInvocation:(NSInvocation *)invocation {
+  SEL unmemoizedSelector = (SEL)CFDictionaryGetValue(FPUnmemoizedSelectors, [invocation selector]);
+  if (!unmemoizedSelector) {
+    [super forwardInvocation:invocation];
+    return;
+  }
+  NSArray *key = FPMemoKey(invocation);
+  [invocation setSelector:unmemoizedSelector];
+  if (!key) {
+    [invocation invoke];
+    return;
+  }
+  __autoreleasing id value = [self memoizedValueForKey:key valueBlk:^id{
+    [invocation invoke];
+    __unsafe_unretained id computedValue = nil;
+    [invocation getReturnValue:&computedValue];
+    return computedValue;
+  }];
+  [invocation setReturnValue:&value];
+}
+
+/*
+ Results are memoized for the day (the year-to-date and last-year ranges, and
+ the days-since stats, only move from one day to the next), and are dropped
+ wholesale as soon as the day changes or the local DAO's data version moves.
+ */
+- (id)memoizedValueForKey:(NSArray *)key valueBlk:(FPValueBlock)valueBlk {
+  int64_t dataVersion = [_localDao dataVersion];
+  NSDate *day = [[NSCalendar currentCalendar] startOfDayForDate:[NSDate date]];
+  @synchronized(_memoCache) {
+    if (dataVersion != _memoDataVersion || ![day isEqualToDate:_memoDay]) {
+      [_memoCache removeAllObjects];
+      _memoDataVersion = dataVersion;
+      _memoDay = day;
+    }
+    id value = [_memoCache objectForKey:key];
+    if (value) {
+      _cacheHits++;
+      return value == [NSNull null] ? nil : value;
+    }
+    _cacheMisses++;
+  }
+  id value = valueBlk();
+  @synchronized(_memoCache) {
+    if (dataVersion == _memoDataVersion && [day isEqualToDate:_memoDay]) {
+      [_memoCache setObject:(value ? value : [NSNull null]) forKey:key];
+    }
+  }
+  return value;
 }
 
-- (NSDecimalNumber *)avgValueForIntegerDataset:(NSArray *)dataset {
-  return [self avgValueForDataset:dataset
-                      accumulator:^(NSNumber *val) {return [[NSDecimalNumber alloc] initWithInteger:val.integerValue];}];
+- (void)clearCache {
+  @synchronized(_memoCache) {
+    [_memoCache removeAllObjects];
+  }
 }
 
-- (NSDecimalNumber *)avgValueForDecimalDataset:(NSArray *)dataset {
-  return [self avgValueForDataset:dataset accumulator:^(NSDecimalNumber *val) {return val;}];
+#pragma mark - Asynchronous Requests
+
+- (FPStatsRequest *)computeValueAsyncForKey:(NSArray *)key
+                                     screen:(NSString *)screen
+                                   valueBlk:(id(^)(FPStats *))valueBlk
+                              completionBlk:(void(^)(id))completionBlk {
+  FPStatsRequest *request = [[FPStatsRequest alloc] initWithKey:key screen:screen];
+  FPStatsComputation *computation = nil;
+  BOOL joined = NO;
+  @synchronized(_computationsInFlight) {
+    if (screen) {
+      NSMutableArray *round = _requestsByScreen[screen];
+      if (!round) {
+        round = [NSMutableArray array];
+        _requestsByScreen[screen] = round;
+      }
+      [round addObject:request];
+    }
+    if (key) {
+      computation = _computationsInFlight[key];
+    }
+    if (computation) {
+      joined = YES;
+      _numCoalescedRequests++;
+    } else {
+      computation = [[FPStatsComputation alloc] init];
+      if (key) {
+        _computationsInFlight[key] = computation;
+      }
+    }
+    [computation.requests addObject:request];
+    [computation.completionBlks addObject:completionBlk ? [completionBlk copy] : ^(id value) {}];
+  }
+  if (!joined) {
+    dispatch_async(_statsQueue, ^{
+      [self runComputation:computation key:key valueBlk:valueBlk];
+    });
+  }
+  return request;
+}
+
+/*
+ Skips the computation if every request waiting on it was cancelled while it
+ was queued.  Once it's past that check it leaves the in-flight table only
+ when it has its value, so a request that joins it meanwhile gets that value.
+ */
+- (void)runComputation:(FPStatsComputation *)computation key:(NSArray *)key valueBlk:(id(^)(FPStats *))valueBlk {
+  BOOL wanted;
+  @synchronized(_computationsInFlight) {
+    wanted = [computation hasLiveRequest];
+    if (!wanted && key && _computationsInFlight[key] == computation) {
+      [_computationsInFlight removeObjectForKey:key];
+    }
+  }
+  id value = nil;
+  if (wanted) {
+    @autoreleasepool {
+      value = valueBlk(self);
+    }
+  }
+  NSArray *requests;
+  NSArray *completionBlks;
+  @synchronized(_computationsInFlight) {
+    if (key && _computationsInFlight[key] == computation) {
+      [_computationsInFlight removeObjectForKey:key];
+    }
+    requests = [computation.requests copy];
+    completionBlks = [computation.completionBlks copy];
+  }
+  dispatch_async(_completionQueue, ^{
+    for (NSUInteger i = 0; i < requests.count; i++) {
+      FPStatsRequest *request = requests[i];
+      if (request.screen) {
+        @synchronized(_computationsInFlight) {
+          [_requestsByScreen[request.screen] removeObjectIdenticalTo:request];
+        }
+      }
+      if (!request.isCancelled) {
+        void (^completionBlk)(id) = completionBlks[i];
+        completionBlk(value);
+      }
+    }
+  });
 }
 
-- (NSDecimalNumber *)minMaxValueForDataset:(NSArray *)dataset
-                                comparator:(NSComparisonResult(^)(NSArray *, NSArray *))comparator {
-  NSInteger count = [dataset count];
-  if (count > 1) {
-    NSArray *sortedDataset = [dataset sortedArrayUsingComparator:comparator];
-    return sortedDataset[0][1];
-  } else if (count == 1) {
-    return dataset[0][1];
+- (void)beginRoundForScreen:(NSString *)screen {
+  NSArray *previousRound;
+  @synchronized(_computationsInFlight) {
+    previousRound = _requestsByScreen[screen];
+    _requestsByScreen[screen] = [NSMutableArray array];
   }
-  return nil;
+  [previousRound makeObjectsPerformSelector:@selector(cancel)];
+}
+
+- (FPStatsRequest *)computeSnapshotAsync:(FPStatsSnapshot *)snapshot
+                                  screen:(NSString *)screen
+                           completionBlk:(void(^)(FPStatsSnapshot *))completionBlk {
+  return [self computeValueAsyncForKey:nil
+                                screen:screen
+                              valueBlk:^id(FPStats *stats) {
+                                [stats computeSnapshot:snapshot];
+                                return snapshot;
+                              }
+                         completionBlk:completionBlk];
+}
+
+#pragma mark - Log Columns
+
+/*
+ The entity's gas logs in columnar form.  They're loaded once and then kept in
+ the memo cache, so they stay warm until the log data changes.
+ */
+- (FPLogColumns *)gasLogColumnsForEntity:(id)entity {
+  if ([entity isKindOfClass:[FPUser class]]) {
+    return [_localDao gasLogColumnsForUser:entity error:_errorBlk];
+  } else if ([entity isKindOfClass:[FPVehicle class]]) {
+    return [_localDao gasLogColumnsForVehicle:entity error:_errorBlk];
+  }
+  return [_localDao gasLogColumnsForFuelstation:entity error:_errorBlk];
+}
+
+#pragma mark - Helpers
+
+- (NSDecimalNumber *)avgValueForItems:(NSArray *)items
+                        itemValidator:(BOOL(^)(id))itemValidator
+                          accumulator:(NSDecimalNumber *(^)(id))accumulator {
+  return [[[FPReducer avgReducer] reduceItems:items
+                                     valueBlk:^id(id item) { return itemValidator(item) ? accumulator(item) : nil; }] result];
+}
+
+- (NSDecimalNumber *)avgValueForDataset:(NSArray *)dataset {
+  return [[[FPReducer avgReducer] reduceDataset:dataset] result];
 }
 
 - (NSDecimalNumber *)minValueForDataset:(NSArray *)dataset {
-  return [self minMaxValueForDataset:dataset comparator:^NSComparisonResult(NSArray *dp1, NSArray *dp2) {
-    return [dp1[1] compare:dp2[1]];
-  }];
+  return [[[FPReducer minReducer] reduceDataset:dataset] result];
 }
 
 - (NSDecimalNumber *)maxValueForDataset:(NSArray *)dataset {
-  return [self minMaxValueForDataset:dataset comparator:^NSComparisonResult(NSArray *dp1, NSArray *dp2) {
-    return [dp2[1] compare:dp1[1]];
-  }];
+  return [[[FPReducer maxReducer] reduceDataset:dataset] result];
 }
 
-- (NSDecimalNumber *)totalSpentFromFplogs:(NSArray *)fplogs {
-  if (fplogs.count > 0) {
-    NSDecimalNumber *total = [NSDecimalNumber zero];
-    for (FPFuelPurchaseLog *fplog in fplogs) {
-      if (![PEUtils isNil:fplog.numGallons] && ![PEUtils isNil:fplog.gallonPrice]) {
-        total = [total decimalNumberByAdding:[fplog.numGallons decimalNumberByMultiplyingBy:fplog.gallonPrice]];
-      }
-    }
-    return total;
+- (NSDecimalNumber *)totalSpentFromAggregate:(FPLogAggregate *)aggregate {
+  if (aggregate.numLogs > 0) {
+    return aggregate.sum;
   }
   return nil;
 }
@@ -118,74 +433,114 @@ typedef id (^FPValueBlock)(void);
   return [self oneYearAgoFromDate:[NSDate date]];
 }
 
-- (NSArray *)dataSetForEntity:(id)entity
-                     valueBlk:(id(^)(NSDate *, NSDate *))valueBlk
-                         year:(NSInteger)year
-                   startMonth:(NSInteger)startMonth
-                     endMonth:(NSInteger)endMonth
-                     calendar:(NSCalendar *)calendar
-                   beforeDate:(NSDate *)beforeDate {
-  NSMutableArray *dataset = [NSMutableArray array];
-  for (NSInteger i = startMonth; i <= endMonth; i++) {
-    NSDate *firstDayOfMonth = [PEUtils firstDayOfYear:year month:i calendar:calendar];
-    if ([firstDayOfMonth compare:beforeDate] == NSOrderedAscending) {
-      NSDate *firstDateOfNextMonth = [calendar dateByAddingUnit:NSCalendarUnitMonth value:1 toDate:firstDayOfMonth options:0];
-      id value = valueBlk(firstDateOfNextMonth, firstDayOfMonth);
-      if (value) {
-        [dataset addObject:@[firstDayOfMonth, value]];
+/*
+ The [beforeDate, onOrAfterDate] bounds of the range; nil for the overall
+ range.
+ */
+- (NSArray *)boundsForRange:(FPStatsRange)range {
+  NSDate *now = [NSDate date];
+  NSCalendar *calendar = [NSCalendar currentCalendar];
+  switch (range) {
+    case FPStatsRangeYearToDate:
+      return @[now, [PEUtils firstDayOfYearOfDate:now calendar:calendar]];
+    case FPStatsRangeLastYear: {
+      NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:now calendar:calendar];
+      return @[lastYearRange[1], lastYearRange[0]];
+    }
+    case FPStatsRangeOverall:
+      break;
+  }
+  return nil;
+}
+
+#pragma mark - Monthly Aggregation
+
+/*
+ Returns the [beforeDate, onOrAfterDate] pair spanning whole months such that
+ every month visited by dataSetForEntity:monthlyBuckets:bucketValueBlk:beforeDate:onOrAfterDate:
+ is fully covered.
+ */
+- (NSArray *)wholeMonthsRangeForBeforeDate:(NSDate *)beforeDate
+                             onOrAfterDate:(NSDate *)onOrAfterDate
+                                  calendar:(NSCalendar *)calendar {
+  FPMonthBoundaries *boundaries = [FPMonthBoundaries boundariesForCalendar:calendar];
+  return @[[boundaries firstDayOfMonthKey:[boundaries monthKeyForDate:beforeDate] + 1],
+           [boundaries firstDayOfMonthKey:[boundaries monthKeyForDate:onOrAfterDate]]];
+}
+
+- (NSDictionary *)monthlyBucketsForItems:(NSArray *)items
+                             itemDateBlk:(NSDate *(^)(id))itemDateBlk
+                                calendar:(NSCalendar *)calendar {
+  FPMonthBoundaries *boundaries = [FPMonthBoundaries boundariesForCalendar:calendar];
+  NSMutableDictionary *buckets = [NSMutableDictionary dictionary];
+  for (id item in items) {
+    NSDate *itemDate = itemDateBlk(item);
+    if (itemDate) {
+      NSNumber *monthKey = @([boundaries monthKeyForDate:itemDate]);
+      NSMutableArray *bucket = buckets[monthKey];
+      if (bucket == nil) {
+        bucket = [NSMutableArray array];
+        buckets[monthKey] = bucket;
       }
+      [bucket addObject:item];
     }
   }
-  return dataset;
+  return buckets;
 }
 
+/*
+ Visits each month from onOrAfterDate's month through beforeDate's month that
+ starts before beforeDate, adding a [first day of month, value] datapoint for
+ each month with a bucket (and a non-nil value).  The dataset is an FPDataset,
+ so the reductions and merges over it don't box its values.
+ */
 - (NSArray *)dataSetForEntity:(id)entity
-               monthOfDataBlk:(NSArray *(^)(NSInteger, NSInteger, NSInteger, NSCalendar *))monthOfDataBlk
+               monthlyBuckets:(NSDictionary *)monthlyBuckets
+               bucketValueBlk:(id(^)(id, NSNumber *))bucketValueBlk
                    beforeDate:(NSDate *)beforeDate
                 onOrAfterDate:(NSDate *)onOrAfterDate {
-  NSMutableArray *dataset = [NSMutableArray array];
-  NSCalendar *calendar = [NSCalendar currentCalendar];
-  NSDateComponents *beforeDateComps = [calendar components:NSCalendarUnitYear|NSCalendarUnitMonth|NSCalendarUnitDay fromDate:beforeDate];
-  NSDateComponents *onOrAfterDateComps = [calendar components:NSCalendarUnitYear|NSCalendarUnitMonth|NSCalendarUnitDay fromDate:onOrAfterDate];
-  NSInteger startYear = onOrAfterDateComps.year;
-  NSInteger endYear = beforeDateComps.year;
-  for (NSInteger i = startYear; i <= endYear; i++) {
-    NSInteger startMonth;
-    if (i == startYear) {
-      startMonth = onOrAfterDateComps.month;
-    } else {
-      startMonth = 1;
-    }
-    NSInteger endMonth;
-    if (i == endYear) {
-      endMonth = beforeDateComps.month;
-    } else {
-      endMonth = 12;
-    }
-    NSDate *startMonthDate = [PEUtils dateFromCalendar:calendar day:1 month:startMonth year:i];
-    if ([startMonthDate compare:beforeDate] == NSOrderedAscending) {
-      [dataset addObjectsFromArray:monthOfDataBlk(i, startMonth, endMonth, calendar)];
+  if (monthlyBuckets.count == 0) {
+    return @[];
+  }
+  FPMonthBoundaries *boundaries = [FPMonthBoundaries currentBoundaries];
+  FPEpochMillis beforeMillis = FPEpochMillisFromDate(beforeDate);
+  NSInteger lastMonthKey = [boundaries monthKeyForMillis:beforeMillis];
+  FPDataset *dataset = [[FPDataset alloc] initWithCapacity:monthlyBuckets.count];
+  for (NSInteger monthKey = [boundaries monthKeyForDate:onOrAfterDate];
+       monthKey <= lastMonthKey && [boundaries firstMillisOfMonthKey:monthKey] < beforeMillis;
+       monthKey++) {
+    id bucket = monthlyBuckets[@(monthKey)];
+    if (bucket) {
+      id value = bucketValueBlk(bucket, @(monthKey));
+      if (value) {
+        [dataset appendValue:[value decimalValue] atMillis:[boundaries firstMillisOfMonthKey:monthKey]];
+      }
     }
   }
   return dataset;
 }
 
-- (NSDecimalNumber *)avgReportedMphFromEnvlogs:(NSArray *)envlogs {
-  return [self avgValueForItems:envlogs
-                  itemValidator:^BOOL(FPEnvironmentLog *envlog) { return ![PEUtils isNil:envlog.reportedAvgMph]; }
-                    accumulator:^NSDecimalNumber *(FPEnvironmentLog *envlog) { return envlog.reportedAvgMph; }];
-}
-
-- (NSDecimalNumber *)avgReportedMpgFromEnvlogs:(NSArray *)envlogs {
-  return [self avgValueForItems:envlogs
-                  itemValidator:^BOOL(FPEnvironmentLog *envlog) { return ![PEUtils isNil:envlog.reportedAvgMpg]; }
-                    accumulator:^NSDecimalNumber *(FPEnvironmentLog *envlog) { return envlog.reportedAvgMpg; }];
+- (NSArray *)monthlyRollupDataSetForEntity:(id)entity
+                                beforeDate:(NSDate *)beforeDate
+                             onOrAfterDate:(NSDate *)onOrAfterDate
+                        aggregatesFetchBlk:(NSDictionary *(^)(void))aggregatesFetchBlk
+                            bucketValueBlk:(id(^)(FPLogAggregate *))bucketValueBlk {
+  return [self dataSetForEntity:entity
+                 monthlyBuckets:aggregatesFetchBlk()
+                 bucketValueBlk:^id(FPLogAggregate *aggregate, NSNumber *monthKey) { return bucketValueBlk(aggregate); }
+                     beforeDate:beforeDate
+                  onOrAfterDate:onOrAfterDate];
 }
 
-- (NSDecimalNumber *)avgGallonPriceFromFplogs:(NSArray *)fplogs {
-  return [self avgValueForItems:fplogs
-                  itemValidator:^BOOL(FPFuelPurchaseLog *fplog) { return ![PEUtils isNil:fplog.gallonPrice]; }
-                    accumulator:^NSDecimalNumber *(FPFuelPurchaseLog *fplog) { return fplog.gallonPrice; }];
+- (FPCostPerMileScanner *)costPerMileScannerForOdometerLogs:(NSArray *)envlogs
+                                               gasLogColumns:(FPLogColumns *)gasLogColumns
+                                                 gasLogRange:(NSRange)gasLogRange {
+  return [[FPCostPerMileScanner alloc] initWithOdometerLogs:envlogs
+                                              gasLogColumns:gasLogColumns
+                                                gasLogRange:gasLogRange
+                                             costPerMileBlk:^NSDecimalNumber *(NSDecimalNumber *milesDriven, NSDecimalNumber *spentOnGas) {
+                                               return [self costPerMileForMilesDriven:milesDriven totalSpentOnGas:spentOnGas];
+                                             }];
 }
 
 - (NSDecimalNumber *)avgGasCostPerMileForUser:(FPUser *)user
@@ -201,52 +556,55 @@ typedef id (^FPValueBlock)(void);
 - (NSDecimalNumber *)avgGasCostPerMileForVehicle:(FPVehicle *)vehicle
                                       beforeDate:(NSDate *)beforeDate
                                    onOrAfterDate:(NSDate *)onOrAfterDate {
-  FPEnvironmentLog *firstOdometerLog = [_localDao firstOdometerLogForVehicle:vehicle
-                                                                  beforeDate:beforeDate
-                                                               onOrAfterDate:onOrAfterDate
-                                                                       error:_errorBlk];
-  if (firstOdometerLog) {
-    NSDecimalNumber *milesDriven = [self milesRecordedForVehicle:vehicle
-                                                      beforeDate:beforeDate
-                                                   onOrAfterDate:onOrAfterDate];
-    NSDecimalNumber *totalSpentOnGas = [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                                                      beforeDate:beforeDate
-                                                                                                       afterDate:firstOdometerLog.logDate
-                                                                                                           error:_errorBlk]];
-    return [self costPerMileForMilesDriven:milesDriven totalSpentOnGas:totalSpentOnGas];
+  NSArray *envlogs = [_localDao unorderedEnvironmentLogsForVehicle:vehicle
+                                                        beforeDate:beforeDate
+                                                     onOrAfterDate:onOrAfterDate
+                                                             error:_errorBlk];
+  if (envlogs.count == 0) {
+    return nil;
   }
-  return nil;
+  FPLogColumns *gasLogColumns = [self gasLogColumnsForEntity:vehicle];
+  return [[self costPerMileScannerForOdometerLogs:envlogs
+                                    gasLogColumns:gasLogColumns
+                                      gasLogRange:[gasLogColumns rangeOfRowsBeforeDate:beforeDate onOrAfterDate:onOrAfterDate]] costPerMile];
+}
+
+- (NSArray *)datasetsForEntities:(NSArray *)entities datasetForEntityBlk:(NSArray *(^)(id))datasetForEntityBlk {
+  NSUInteger numEntities = entities.count;
+  NSMutableArray *datasets = [NSMutableArray arrayWithCapacity:numEntities];
+  if (!_computesDatasetsConcurrently || numEntities < 2) {
+    for (id entity in entities) {
+      NSArray *dataset = datasetForEntityBlk(entity);
+      [datasets addObject:dataset ? dataset : @[]];
+    }
+    return datasets;
+  }
+  for (NSUInteger i = 0; i < numEntities; i++) {
+    [datasets addObject:@[]];
+  }
+  dispatch_apply(numEntities, dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^(size_t i) {
+    @autoreleasepool {
+      NSArray *dataset = datasetForEntityBlk(entities[i]);
+      if (dataset) {
+        @synchronized(datasets) {
+          datasets[i] = dataset;
+        }
+      }
+    }
+  });
+  return datasets;
 }
 
 - (NSArray *)mergeDataSetsForUser:(FPUser *)user
                  childEntitiesBlk:(NSArray *(^)(void))childEntitiesBlk
          datasetForChildEntityBlk:(NSArray *(^)(id))datasetForChildEntityBlk
           entityDatapointValueBlk:(NSDecimalNumber *(^)(id))entityDatapointValueBlk {
-  NSMutableDictionary *allEntitiesDatapointsDict = [NSMutableDictionary dictionary];
   NSArray *entities = childEntitiesBlk();
   if (entities.count > 0) {
-    for (FPVehicle *entity in entities) {
-      NSArray *entityDatapoints = datasetForChildEntityBlk(entity);
-      for (NSArray *entityDatapoint in entityDatapoints) {
-        NSDate *entityDatapointDate = entityDatapoint[0];
-        NSDecimalNumber *allEntitiesDatapointVal = allEntitiesDatapointsDict[entityDatapointDate];
-        if (allEntitiesDatapointVal != nil) {
-          NSDecimalNumber *entityDatapointVal = entityDatapointValueBlk(entityDatapoint[1]);
-          NSDecimalNumber *tmpTotalDatapointVal = [allEntitiesDatapointVal decimalNumberByAdding:entityDatapointVal];
-          allEntitiesDatapointsDict[entityDatapointDate] = [tmpTotalDatapointVal decimalNumberByDividingBy:[[NSDecimalNumber alloc] initWithInteger:2]];
-        } else {
-          allEntitiesDatapointsDict[entityDatapointDate] = entityDatapointValueBlk(entityDatapoint[1]);
-        }
-      }
-    }
-    NSArray *keys = [allEntitiesDatapointsDict allKeys];
-    NSMutableArray *allEntitiesDataSet = [NSMutableArray arrayWithCapacity:keys.count];
-    for (NSDate *entryDate in keys) {
-      [allEntitiesDataSet addObject:@[entryDate, allEntitiesDatapointsDict[entryDate]]];
-    }
-    return [allEntitiesDataSet sortedArrayUsingComparator:^NSComparisonResult(NSArray *dp1, NSArray *dp2) {
-      return [dp1[0] compare:dp2[0]];
-    }];
+    // the datasets come back in entity order, so the merge below is the same
+    // however the per-entity work was scheduled
+    return [FPDatasetMerger averagedMergeOfDatasets:[self datasetsForEntities:entities datasetForEntityBlk:datasetForChildEntityBlk]
+                                           valueBlk:entityDatapointValueBlk];
   }
   return @[];
 }
@@ -268,59 +626,26 @@ typedef id (^FPValueBlock)(void);
                                       beforeDate:(NSDate *)beforeDate
                                    onOrAfterDate:(NSDate *)onOrAfterDate
                                         calendar:(NSCalendar *)calendar {
-  NSArray *fplogs = [_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                        beforeDate:beforeDate
-                                                     onOrAfterDate:onOrAfterDate
-                                                             error:_errorBlk];
-  fplogs = [fplogs sortedArrayUsingComparator:^NSComparisonResult(FPFuelPurchaseLog *fplog1, FPFuelPurchaseLog *fplog2) {
-    return [fplog1.purchasedAt compare:fplog2.purchasedAt];
-  }];
-  NSMutableArray *dataset = [NSMutableArray array];
-  NSInteger numFplogs = [fplogs count];
-  if (numFplogs > 0) {
-    for (NSInteger i = 0; i < numFplogs; i++) {
-      if (i + 1 < numFplogs) {
-        FPFuelPurchaseLog *log1 = fplogs[i];
-        FPFuelPurchaseLog *log2 = fplogs[i+1];
-        NSDateComponents *components = [calendar components:NSCalendarUnitDay fromDate:log1.purchasedAt toDate:log2.purchasedAt options:0];
-        [dataset addObject:@[log2.purchasedAt, @([components day])]];
-      }
-    }
-  }
-  return dataset;
+  return [_localDao daysBetweenFillupsForVehicle:vehicle
+                                     beforeDate:beforeDate
+                                  onOrAfterDate:onOrAfterDate
+                                       timeZone:calendar.timeZone
+                                          error:_errorBlk];
 }
 
 - (NSArray *)avgDaysBetweenFillupsDataSetForVehicle:(FPVehicle *)vehicle
                                          beforeDate:(NSDate *)beforeDate
                                       onOrAfterDate:(NSDate *)onOrAfterDate
                                            calendar:(NSCalendar *)calendar {
-  NSMutableDictionary *monthlyData = [NSMutableDictionary dictionary];
   NSArray *dataset = [self daysBetweenFillupsDataSetForVehicle:vehicle beforeDate:beforeDate onOrAfterDate:onOrAfterDate calendar:calendar];
-  for (NSArray *dp in dataset) {
-    NSDate *date = dp[0];
-    NSDateComponents *comps = [calendar components:NSCalendarUnitMonth|NSCalendarUnitYear fromDate:date];
-    comps.day = 1;
-    NSDate *startOfMonth = [calendar dateFromComponents:comps];
-    NSMutableArray *datapoints = monthlyData[startOfMonth];
-    if (datapoints == nil) {
-      datapoints = [NSMutableArray array];
-      monthlyData[startOfMonth] = datapoints;
-    }
-    [datapoints addObject:dp[1]];
-  }
-  NSArray *keys = [monthlyData allKeys];
-  NSMutableArray *avgDaysBetweenFillups = [NSMutableArray arrayWithCapacity:keys.count];
-  for (NSDate *startOfMonth in keys) {
-    NSArray *numDaysValues = monthlyData[startOfMonth];
-    NSDecimalNumber *total = [NSDecimalNumber zero];
-    for (NSNumber *numDaysVal in numDaysValues) {
-      total = [total decimalNumberByAdding:[[NSDecimalNumber alloc] initWithInteger:numDaysVal.integerValue]];
-    }
-    [avgDaysBetweenFillups addObject:@[startOfMonth, [total decimalNumberByDividingBy:[[NSDecimalNumber alloc] initWithInteger:numDaysValues.count]]]];
-  }
-  return [avgDaysBetweenFillups sortedArrayUsingComparator:^NSComparisonResult(NSArray *obj1, NSArray *obj2) {
-    return [obj1[0] compare:obj2[0]];
-  }];
+  NSDictionary *monthlyBuckets = [self monthlyBucketsForItems:dataset
+                                                  itemDateBlk:^NSDate *(NSArray *dp) { return dp[0]; }
+                                                     calendar:calendar];
+  return [self dataSetForEntity:vehicle
+                 monthlyBuckets:monthlyBuckets
+                 bucketValueBlk:^id(NSArray *datapoints, NSNumber *monthKey) { return [self avgValueForDataset:datapoints]; }
+                     beforeDate:beforeDate
+                  onOrAfterDate:onOrAfterDate];
 }
 
 - (NSArray *)avgDaysBetweenFillupsDataSetForUser:(FPUser *)user
@@ -333,7 +658,7 @@ typedef id (^FPValueBlock)(void);
                                                                                                      beforeDate:beforeDate
                                                                                                   onOrAfterDate:onOrAfterDate
                                                                                                        calendar:calendar]; }
-            entityDatapointValueBlk:^(NSDecimalNumber *avgNumDays) {return avgNumDays;}];
+            entityDatapointValueBlk:nil];
 }
 
 - (NSArray *)avgGasCostPerMileDataSetForUser:(FPUser *)user
@@ -344,92 +669,82 @@ typedef id (^FPValueBlock)(void);
            datasetForChildEntityBlk:^(FPVehicle *vehicle) { return [self avgGasCostPerMileDataSetForVehicle:vehicle
                                                                                                  beforeDate:beforeDate
                                                                                               onOrAfterDate:onOrAfterDate]; }
-            entityDatapointValueBlk:^(NSDecimalNumber *gasCostPerMile) {return gasCostPerMile;}];
+            entityDatapointValueBlk:nil];
 }
 
 - (NSArray *)avgGasCostPerMileDataSetForVehicle:(FPVehicle *)vehicle
                                      beforeDate:(NSDate *)beforeDate
                                   onOrAfterDate:(NSDate *)onOrAfterDate {
-  return [self dataSetForEntity:vehicle
-                 monthOfDataBlk:^NSArray *(NSInteger year, NSInteger startMonth, NSInteger endMonth, NSCalendar *cal) {
-                   return [self dataSetForEntity:vehicle
-                                        valueBlk:^id(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                          return [self avgGasCostPerMileForVehicle:vehicle beforeDate:firstDateOfNextMonth onOrAfterDate:firstDayOfMonth];
-                                        }
-                                            year:year
-                                      startMonth:startMonth
-                                        endMonth:endMonth
-                                        calendar:cal
-                                      beforeDate:beforeDate];
-                 }
-                     beforeDate:beforeDate
-                  onOrAfterDate:onOrAfterDate];
+  NSCalendar *calendar = [NSCalendar currentCalendar];
+  NSArray *range = [self wholeMonthsRangeForBeforeDate:beforeDate onOrAfterDate:onOrAfterDate calendar:calendar];
+  NSArray *envlogs = [_localDao unorderedEnvironmentLogsForVehicle:vehicle
+                                                        beforeDate:range[0]
+                                                     onOrAfterDate:range[1]
+                                                             error:_errorBlk];
+  if (envlogs.count == 0) {
+    return @[];
+  }
+  FPLogColumns *gasLogColumns = [self gasLogColumnsForEntity:vehicle];
+  FPCostPerMileScanner *scanner = [self costPerMileScannerForOdometerLogs:envlogs
+                                                            gasLogColumns:gasLogColumns
+                                                              gasLogRange:[gasLogColumns rangeOfRowsBeforeDate:range[0] onOrAfterDate:range[1]]];
+  return [scanner monthlyDataSetWithBoundaries:[FPMonthBoundaries boundariesForCalendar:calendar]
+                                    beforeDate:beforeDate
+                                 onOrAfterDate:onOrAfterDate];
 }
 
 - (NSArray *)spentOnGasDataSetForUser:(FPUser *)user
                            beforeDate:(NSDate *)beforeDate
                         onOrAfterDate:(NSDate *)onOrAfterDate {
-  return [self dataSetForEntity:user
-                 monthOfDataBlk:^NSArray *(NSInteger year, NSInteger startMonth, NSInteger endMonth, NSCalendar *cal) {
-                   return [self dataSetForEntity:user
-                                        valueBlk:^id(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                          return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                                                             beforeDate:firstDateOfNextMonth
-                                                                                                          onOrAfterDate:firstDayOfMonth
-                                                                                                                  error:_errorBlk]];
-                                        }
-                                            year:year
-                                      startMonth:startMonth
-                                        endMonth:endMonth
-                                        calendar:cal
-                                      beforeDate:beforeDate];
-                 }
-                     beforeDate:beforeDate
-                  onOrAfterDate:onOrAfterDate];
+  return [self monthlyRollupDataSetForEntity:user
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                          aggregatesFetchBlk:^NSDictionary *{
+                            return [_localDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                       forUser:user
+                                                                    beforeDate:beforeDate
+                                                                 onOrAfterDate:onOrAfterDate
+                                                                        octane:nil
+                                                                        diesel:NO
+                                                                         error:_errorBlk];
+                          }
+                              bucketValueBlk:^id(FPLogAggregate *aggregate) { return [self totalSpentFromAggregate:aggregate]; }];
 }
 
 - (NSArray *)spentOnGasDataSetForVehicle:(FPVehicle *)vehicle
                               beforeDate:(NSDate *)beforeDate
                            onOrAfterDate:(NSDate *)onOrAfterDate {
-  return [self dataSetForEntity:vehicle
-                 monthOfDataBlk:^NSArray *(NSInteger year, NSInteger startMonth, NSInteger endMonth, NSCalendar *cal) {
-                   return [self dataSetForEntity:vehicle
-                                        valueBlk:^id(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                          return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                                                                beforeDate:firstDateOfNextMonth
-                                                                                                             onOrAfterDate:firstDayOfMonth
-                                                                                                                     error:_errorBlk]];
-                                        }
-                                            year:year
-                                      startMonth:startMonth
-                                        endMonth:endMonth
-                                        calendar:cal
-                                      beforeDate:beforeDate];
-                 }
-                     beforeDate:beforeDate
-                  onOrAfterDate:onOrAfterDate];
+  return [self monthlyRollupDataSetForEntity:vehicle
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                          aggregatesFetchBlk:^NSDictionary *{
+                            return [_localDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                    forVehicle:vehicle
+                                                                    beforeDate:beforeDate
+                                                                 onOrAfterDate:onOrAfterDate
+                                                                        octane:nil
+                                                                        diesel:NO
+                                                                         error:_errorBlk];
+                          }
+                              bucketValueBlk:^id(FPLogAggregate *aggregate) { return [self totalSpentFromAggregate:aggregate]; }];
 }
 
 - (NSArray *)spentOnGasDataSetForFuelstation:(FPFuelStation *)fuelstation
                                   beforeDate:(NSDate *)beforeDate
                                onOrAfterDate:(NSDate *)onOrAfterDate {
-  return [self dataSetForEntity:fuelstation
-                 monthOfDataBlk:^NSArray *(NSInteger year, NSInteger startMonth, NSInteger endMonth, NSCalendar *cal) {
-                   return [self dataSetForEntity:fuelstation
-                                        valueBlk:^id(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                          return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                                                    beforeDate:firstDateOfNextMonth
-                                                                                                                 onOrAfterDate:firstDayOfMonth
-                                                                                                                         error:_errorBlk]];
-                                        }
-                                            year:year
-                                      startMonth:startMonth
-                                        endMonth:endMonth
-                                        calendar:cal
-                                      beforeDate:beforeDate];
-                 }
-                     beforeDate:beforeDate
-                  onOrAfterDate:onOrAfterDate];
+  return [self monthlyRollupDataSetForEntity:fuelstation
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                          aggregatesFetchBlk:^NSDictionary *{
+                            return [_localDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                forFuelstation:fuelstation
+                                                                    beforeDate:beforeDate
+                                                                 onOrAfterDate:onOrAfterDate
+                                                                        octane:nil
+                                                                        diesel:NO
+                                                                         error:_errorBlk];
+                          }
+                              bucketValueBlk:^id(FPLogAggregate *aggregate) { return [self totalSpentFromAggregate:aggregate]; }];
 }
 
 - (NSArray *)avgReportedMphDataSetForUser:(FPUser *)user
@@ -440,29 +755,23 @@ typedef id (^FPValueBlock)(void);
            datasetForChildEntityBlk:^(FPVehicle *vehicle) { return [self avgReportedMphDataSetForVehicle:vehicle
                                                                                               beforeDate:beforeDate
                                                                                            onOrAfterDate:onOrAfterDate]; }
-            entityDatapointValueBlk:^(NSDecimalNumber *avgReportedMph) {return avgReportedMph;}];
+            entityDatapointValueBlk:nil];
 }
 
 - (NSArray *)avgReportedMphDataSetForVehicle:(FPVehicle *)vehicle
                                   beforeDate:(NSDate *)beforeDate
                                onOrAfterDate:(NSDate *)onOrAfterDate {
-  return [self dataSetForEntity:vehicle
-                 monthOfDataBlk:^NSArray *(NSInteger year, NSInteger startMonth, NSInteger endMonth, NSCalendar *cal) {
-                   return [self dataSetForEntity:vehicle
-                                        valueBlk:^id(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                          return [self avgReportedMphFromEnvlogs:[_localDao unorderedEnvironmentLogsForVehicle:vehicle
-                                                                                                                    beforeDate:firstDateOfNextMonth
-                                                                                                                 onOrAfterDate:firstDayOfMonth
-                                                                                                                         error:_errorBlk]];
-                                        }
-                                            year:year
-                                      startMonth:startMonth
-                                        endMonth:endMonth
-                                        calendar:cal
-                                      beforeDate:beforeDate];
-                 }
-                     beforeDate:beforeDate
-                  onOrAfterDate:onOrAfterDate];
+  return [self monthlyRollupDataSetForEntity:vehicle
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                          aggregatesFetchBlk:^NSDictionary *{
+                            return [_localDao monthlyAggregatesOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMph
+                                                                         forVehicle:vehicle
+                                                                         beforeDate:beforeDate
+                                                                      onOrAfterDate:onOrAfterDate
+                                                                              error:_errorBlk];
+                          }
+                              bucketValueBlk:^id(FPLogAggregate *aggregate) { return [aggregate avg]; }];
 }
 
 - (NSArray *)avgReportedMpgDataSetForUser:(FPUser *)user
@@ -473,49 +782,34 @@ typedef id (^FPValueBlock)(void);
            datasetForChildEntityBlk:^(FPVehicle *vehicle) { return [self avgReportedMpgDataSetForVehicle:vehicle
                                                                                               beforeDate:beforeDate
                                                                                            onOrAfterDate:onOrAfterDate]; }
-            entityDatapointValueBlk:^(NSDecimalNumber *avgReportedMpg) {return avgReportedMpg;}];
+            entityDatapointValueBlk:nil];
 }
 
 - (NSArray *)avgReportedMpgDataSetForVehicle:(FPVehicle *)vehicle
                                   beforeDate:(NSDate *)beforeDate
                                onOrAfterDate:(NSDate *)onOrAfterDate {
-  return [self dataSetForEntity:vehicle
-                 monthOfDataBlk:^NSArray *(NSInteger year, NSInteger startMonth, NSInteger endMonth, NSCalendar *cal) {
-                   return [self dataSetForEntity:vehicle
-                                        valueBlk:^id(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                          return [self avgReportedMpgFromEnvlogs:[_localDao unorderedEnvironmentLogsForVehicle:vehicle
-                                                                                                                    beforeDate:firstDateOfNextMonth
-                                                                                                                 onOrAfterDate:firstDayOfMonth
-                                                                                                                         error:_errorBlk]];
-                                        }
-                                            year:year
-                                      startMonth:startMonth
-                                        endMonth:endMonth
-                                        calendar:cal
-                                      beforeDate:beforeDate];
-                 }
-                     beforeDate:beforeDate
-                  onOrAfterDate:onOrAfterDate];
+  return [self monthlyRollupDataSetForEntity:vehicle
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                          aggregatesFetchBlk:^NSDictionary *{
+                            return [_localDao monthlyAggregatesOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMpg
+                                                                         forVehicle:vehicle
+                                                                         beforeDate:beforeDate
+                                                                      onOrAfterDate:onOrAfterDate
+                                                                              error:_errorBlk];
+                          }
+                              bucketValueBlk:^id(FPLogAggregate *aggregate) { return [aggregate avg]; }];
 }
 
 - (NSArray *)avgPricePerGallonDataSetWithEntity:(id)entity
                                      beforeDate:(NSDate *)beforeDate
                                   onOrAfterDate:(NSDate *)onOrAfterDate
-                                   logsFetchBlk:(NSArray *(^)(NSDate *, NSDate *))logsFetchBlk {
-  return [self dataSetForEntity:entity
-                 monthOfDataBlk:^NSArray *(NSInteger year, NSInteger startMonth, NSInteger endMonth, NSCalendar *cal) {
-                   return [self dataSetForEntity:entity
-                                        valueBlk:^id(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                          return [self avgGallonPriceFromFplogs:logsFetchBlk(firstDateOfNextMonth, firstDayOfMonth)];
-                                        }
-                                            year:year
-                                      startMonth:startMonth
-                                        endMonth:endMonth
-                                        calendar:cal
-                                      beforeDate:beforeDate];
-                 }
-                     beforeDate:beforeDate
-                  onOrAfterDate:onOrAfterDate];
+                             aggregatesFetchBlk:(NSDictionary *(^)(void))aggregatesFetchBlk {
+  return [self monthlyRollupDataSetForEntity:entity
+                                  beforeDate:beforeDate
+                               onOrAfterDate:onOrAfterDate
+                          aggregatesFetchBlk:aggregatesFetchBlk
+                              bucketValueBlk:^id(FPLogAggregate *aggregate) { return [aggregate avg]; }];
 }
 
 - (NSArray *)avgPricePerGallonDataSetForUser:(FPUser *)user
@@ -525,13 +819,15 @@ typedef id (^FPValueBlock)(void);
   return [self avgPricePerGallonDataSetWithEntity:user
                                        beforeDate:beforeDate
                                     onOrAfterDate:onOrAfterDate
-                                     logsFetchBlk:^NSArray *(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                       return [_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                               beforeDate:firstDateOfNextMonth
-                                                                            onOrAfterDate:firstDayOfMonth
-                                                                                   octane:octane
-                                                                                    error:_errorBlk];
-                                     }];
+                               aggregatesFetchBlk:^NSDictionary *{
+                                 return [_localDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                            forUser:user
+                                                                         beforeDate:beforeDate
+                                                                      onOrAfterDate:onOrAfterDate
+                                                                             octane:octane
+                                                                             diesel:NO
+                                                                              error:_errorBlk];
+                               }];
 }
 
 - (NSArray *)avgPricePerGallonDataSetForUser:(FPUser *)user
@@ -540,12 +836,15 @@ typedef id (^FPValueBlock)(void);
   return [self avgPricePerGallonDataSetWithEntity:user
                                        beforeDate:beforeDate
                                     onOrAfterDate:onOrAfterDate
-                                     logsFetchBlk:^NSArray *(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                       return [_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                               beforeDate:firstDateOfNextMonth
-                                                                            onOrAfterDate:firstDayOfMonth
-                                                                                    error:_errorBlk];
-                                     }];
+                               aggregatesFetchBlk:^NSDictionary *{
+                                 return [_localDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                            forUser:user
+                                                                         beforeDate:beforeDate
+                                                                      onOrAfterDate:onOrAfterDate
+                                                                             octane:nil
+                                                                             diesel:NO
+                                                                              error:_errorBlk];
+                               }];
 }
 
 - (NSArray *)avgPricePerGallonDataSetForVehicle:(FPVehicle *)vehicle
@@ -555,13 +854,15 @@ typedef id (^FPValueBlock)(void);
   return [self avgPricePerGallonDataSetWithEntity:vehicle
                                        beforeDate:beforeDate
                                     onOrAfterDate:onOrAfterDate
-                                     logsFetchBlk:^NSArray *(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                       return [_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                                  beforeDate:firstDateOfNextMonth
-                                                                               onOrAfterDate:firstDayOfMonth
-                                                                                      octane:octane
-                                                                                       error:_errorBlk];
-                                     }];
+                               aggregatesFetchBlk:^NSDictionary *{
+                                 return [_localDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                         forVehicle:vehicle
+                                                                         beforeDate:beforeDate
+                                                                      onOrAfterDate:onOrAfterDate
+                                                                             octane:octane
+                                                                             diesel:NO
+                                                                              error:_errorBlk];
+                               }];
 }
 
 - (NSArray *)avgPricePerGallonDataSetForVehicle:(FPVehicle *)vehicle
@@ -570,12 +871,15 @@ typedef id (^FPValueBlock)(void);
   return [self avgPricePerGallonDataSetWithEntity:vehicle
                                        beforeDate:beforeDate
                                     onOrAfterDate:onOrAfterDate
-                                     logsFetchBlk:^NSArray *(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                       return [_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                                  beforeDate:firstDateOfNextMonth
-                                                                               onOrAfterDate:firstDayOfMonth
-                                                                                       error:_errorBlk];
-                                     }];
+                               aggregatesFetchBlk:^NSDictionary *{
+                                 return [_localDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                         forVehicle:vehicle
+                                                                         beforeDate:beforeDate
+                                                                      onOrAfterDate:onOrAfterDate
+                                                                             octane:nil
+                                                                             diesel:NO
+                                                                              error:_errorBlk];
+                               }];
 }
 
 - (NSArray *)avgPricePerGallonDataSetForFuelstation:(FPFuelStation *)fuelstation
@@ -585,13 +889,15 @@ typedef id (^FPValueBlock)(void);
   return [self avgPricePerGallonDataSetWithEntity:fuelstation
                                        beforeDate:beforeDate
                                     onOrAfterDate:onOrAfterDate
-                                     logsFetchBlk:^NSArray *(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                       return [_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                      beforeDate:firstDateOfNextMonth
-                                                                                   onOrAfterDate:firstDayOfMonth
-                                                                                          octane:octane
-                                                                                           error:_errorBlk];
-                                     }];
+                               aggregatesFetchBlk:^NSDictionary *{
+                                 return [_localDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                     forFuelstation:fuelstation
+                                                                         beforeDate:beforeDate
+                                                                      onOrAfterDate:onOrAfterDate
+                                                                             octane:octane
+                                                                             diesel:NO
+                                                                              error:_errorBlk];
+                               }];
 }
 
 - (NSArray *)avgPricePerGallonDataSetForFuelstation:(FPFuelStation *)fuelstation
@@ -600,12 +906,15 @@ typedef id (^FPValueBlock)(void);
   return [self avgPricePerGallonDataSetWithEntity:fuelstation
                                        beforeDate:beforeDate
                                     onOrAfterDate:onOrAfterDate
-                                     logsFetchBlk:^NSArray *(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                       return [_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                      beforeDate:firstDateOfNextMonth
-                                                                                   onOrAfterDate:firstDayOfMonth
-                                                                                           error:_errorBlk];
-                                     }];
+                               aggregatesFetchBlk:^NSDictionary *{
+                                 return [_localDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                     forFuelstation:fuelstation
+                                                                         beforeDate:beforeDate
+                                                                      onOrAfterDate:onOrAfterDate
+                                                                             octane:nil
+                                                                             diesel:NO
+                                                                              error:_errorBlk];
+                               }];
 }
 
 - (NSArray *)avgPricePerDieselGallonDataSetForUser:(FPUser *)user
@@ -614,12 +923,15 @@ typedef id (^FPValueBlock)(void);
   return [self avgPricePerGallonDataSetWithEntity:user
                                        beforeDate:beforeDate
                                     onOrAfterDate:onOrAfterDate
-                                     logsFetchBlk:^NSArray *(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                       return [_localDao unorderedDieselFuelPurchaseLogsForUser:user
-                                                                                     beforeDate:firstDateOfNextMonth
-                                                                                  onOrAfterDate:firstDayOfMonth
-                                                                                          error:_errorBlk];
-                                     }];
+                               aggregatesFetchBlk:^NSDictionary *{
+                                 return [_localDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                            forUser:user
+                                                                         beforeDate:beforeDate
+                                                                      onOrAfterDate:onOrAfterDate
+                                                                             octane:nil
+                                                                             diesel:YES
+                                                                              error:_errorBlk];
+                               }];
 }
 
 - (NSArray *)avgPricePerDieselGallonDataSetForVehicle:(FPVehicle *)vehicle
@@ -628,12 +940,15 @@ typedef id (^FPValueBlock)(void);
   return [self avgPricePerGallonDataSetWithEntity:vehicle
                                        beforeDate:beforeDate
                                     onOrAfterDate:onOrAfterDate
-                                     logsFetchBlk:^NSArray *(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                       return [_localDao unorderedDieselFuelPurchaseLogsForVehicle:vehicle
-                                                                                        beforeDate:firstDateOfNextMonth
-                                                                                     onOrAfterDate:firstDayOfMonth
-                                                                                             error:_errorBlk];
-                                     }];
+                               aggregatesFetchBlk:^NSDictionary *{
+                                 return [_localDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                         forVehicle:vehicle
+                                                                         beforeDate:beforeDate
+                                                                      onOrAfterDate:onOrAfterDate
+                                                                             octane:nil
+                                                                             diesel:YES
+                                                                              error:_errorBlk];
+                               }];
 }
 
 - (NSArray *)avgPricePerDieselGallonDataSetForFuelstation:(FPFuelStation *)fuelstation
@@ -642,12 +957,15 @@ typedef id (^FPValueBlock)(void);
   return [self avgPricePerGallonDataSetWithEntity:fuelstation
                                        beforeDate:beforeDate
                                     onOrAfterDate:onOrAfterDate
-                                     logsFetchBlk:^NSArray *(NSDate *firstDateOfNextMonth, NSDate *firstDayOfMonth) {
-                                       return [_localDao unorderedDieselFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                            beforeDate:firstDateOfNextMonth
-                                                                                         onOrAfterDate:firstDayOfMonth
-                                                                                                 error:_errorBlk];
-                                     }];
+                               aggregatesFetchBlk:^NSDictionary *{
+                                 return [_localDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                     forFuelstation:fuelstation
+                                                                         beforeDate:beforeDate
+                                                                      onOrAfterDate:onOrAfterDate
+                                                                             octane:nil
+                                                                             diesel:YES
+                                                                              error:_errorBlk];
+                               }];
 }
 
 - (NSDecimalNumber *)costPerMileForMilesDriven:(NSDecimalNumber *)milesDriven
@@ -721,10 +1039,11 @@ typedef id (^FPValueBlock)(void);
   NSCalendar *calendar = [NSCalendar currentCalendar];
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:calendar];
-  return [self avgReportedMphFromEnvlogs:[_localDao unorderedEnvironmentLogsForUser:user
-                                                                         beforeDate:now
-                                                                      onOrAfterDate:firstDayOfCurrentYear
-                                                                              error:_errorBlk]];
+  return [[_localDao aggregateOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMph
+                                           forUser:user
+                                        beforeDate:now
+                                     onOrAfterDate:firstDayOfCurrentYear
+                                             error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgReportedMphDataSetForUser:(FPUser *)user {
@@ -736,10 +1055,11 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgReportedMphForUser:(FPUser *)user {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgReportedMphFromEnvlogs:[_localDao unorderedEnvironmentLogsForUser:user
-                                                                         beforeDate:lastYearRange[1]
-                                                                      onOrAfterDate:lastYearRange[0]
-                                                                              error:_errorBlk]];
+  return [[_localDao aggregateOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMph
+                                           forUser:user
+                                        beforeDate:lastYearRange[1]
+                                     onOrAfterDate:lastYearRange[0]
+                                             error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgReportedMphDataSetForUser:(FPUser *)user {
@@ -748,7 +1068,11 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgReportedMphForUser:(FPUser *)user {
-  return [self avgReportedMphFromEnvlogs:[_localDao unorderedEnvironmentLogsForUser:user error:_errorBlk]];
+  return [[_localDao aggregateOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMph
+                                           forUser:user
+                                        beforeDate:nil
+                                     onOrAfterDate:nil
+                                             error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgReportedMphDataSetForUser:(FPUser *)user {
@@ -767,10 +1091,11 @@ typedef id (^FPValueBlock)(void);
   NSCalendar *calendar = [NSCalendar currentCalendar];
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:calendar];
-  return [self avgReportedMphFromEnvlogs:[_localDao unorderedEnvironmentLogsForVehicle:vehicle
-                                                                            beforeDate:now
-                                                                         onOrAfterDate:firstDayOfCurrentYear
-                                                                                 error:_errorBlk]];
+  return [[_localDao aggregateOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMph
+                                        forVehicle:vehicle
+                                        beforeDate:now
+                                     onOrAfterDate:firstDayOfCurrentYear
+                                             error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgReportedMphDataSetForVehicle:(FPVehicle *)vehicle {
@@ -782,10 +1107,11 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgReportedMphForVehicle:(FPVehicle *)vehicle {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgReportedMphFromEnvlogs:[_localDao unorderedEnvironmentLogsForVehicle:vehicle
-                                                                            beforeDate:lastYearRange[1]
-                                                                         onOrAfterDate:lastYearRange[0]
-                                                                                 error:_errorBlk]];
+  return [[_localDao aggregateOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMph
+                                        forVehicle:vehicle
+                                        beforeDate:lastYearRange[1]
+                                     onOrAfterDate:lastYearRange[0]
+                                             error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgReportedMphDataSetForVehicle:(FPVehicle *)vehicle {
@@ -794,7 +1120,11 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgReportedMphForVehicle:(FPVehicle *)vehicle {
-  return [self avgReportedMphFromEnvlogs:[_localDao unorderedEnvironmentLogsForVehicle:vehicle error:_errorBlk]];
+  return [[_localDao aggregateOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMph
+                                        forVehicle:vehicle
+                                        beforeDate:nil
+                                     onOrAfterDate:nil
+                                             error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgReportedMphDataSetForVehicle:(FPVehicle *)vehicle {
@@ -907,10 +1237,11 @@ typedef id (^FPValueBlock)(void);
   NSCalendar *calendar = [NSCalendar currentCalendar];
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:calendar];
-  return [self avgReportedMpgFromEnvlogs:[_localDao unorderedEnvironmentLogsForUser:user
-                                                                         beforeDate:now
-                                                                      onOrAfterDate:firstDayOfCurrentYear
-                                                                              error:_errorBlk]];
+  return [[_localDao aggregateOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMpg
+                                           forUser:user
+                                        beforeDate:now
+                                     onOrAfterDate:firstDayOfCurrentYear
+                                             error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgReportedMpgDataSetForUser:(FPUser *)user {
@@ -922,10 +1253,11 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgReportedMpgForUser:(FPUser *)user {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgReportedMpgFromEnvlogs:[_localDao unorderedEnvironmentLogsForUser:user
-                                                                         beforeDate:lastYearRange[1]
-                                                                      onOrAfterDate:lastYearRange[0]
-                                                                              error:_errorBlk]];
+  return [[_localDao aggregateOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMpg
+                                           forUser:user
+                                        beforeDate:lastYearRange[1]
+                                     onOrAfterDate:lastYearRange[0]
+                                             error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgReportedMpgDataSetForUser:(FPUser *)user {
@@ -934,7 +1266,11 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgReportedMpgForUser:(FPUser *)user {
-  return [self avgReportedMpgFromEnvlogs:[_localDao unorderedEnvironmentLogsForUser:user error:_errorBlk]];
+  return [[_localDao aggregateOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMpg
+                                           forUser:user
+                                        beforeDate:nil
+                                     onOrAfterDate:nil
+                                             error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgReportedMpgDataSetForUser:(FPUser *)user {
@@ -953,10 +1289,11 @@ typedef id (^FPValueBlock)(void);
   NSCalendar *calendar = [NSCalendar currentCalendar];
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:calendar];
-  return [self avgReportedMpgFromEnvlogs:[_localDao unorderedEnvironmentLogsForVehicle:vehicle
-                                                                            beforeDate:now
-                                                                         onOrAfterDate:firstDayOfCurrentYear
-                                                                                 error:_errorBlk]];
+  return [[_localDao aggregateOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMpg
+                                        forVehicle:vehicle
+                                        beforeDate:now
+                                     onOrAfterDate:firstDayOfCurrentYear
+                                             error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgReportedMpgDataSetForVehicle:(FPVehicle *)vehicle {
@@ -968,10 +1305,11 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgReportedMpgForVehicle:(FPVehicle *)vehicle {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgReportedMpgFromEnvlogs:[_localDao unorderedEnvironmentLogsForVehicle:vehicle
-                                                                            beforeDate:lastYearRange[1]
-                                                                         onOrAfterDate:lastYearRange[0]
-                                                                                 error:_errorBlk]];
+  return [[_localDao aggregateOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMpg
+                                        forVehicle:vehicle
+                                        beforeDate:lastYearRange[1]
+                                     onOrAfterDate:lastYearRange[0]
+                                             error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgReportedMpgDataSetForVehicle:(FPVehicle *)vehicle {
@@ -980,7 +1318,11 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgReportedMpgForVehicle:(FPVehicle *)vehicle {
-  return [self avgReportedMpgFromEnvlogs:[_localDao unorderedEnvironmentLogsForVehicle:vehicle error:_errorBlk]];
+  return [[_localDao aggregateOfOdometerLogMeasure:FPOdometerLogMeasureReportedAvgMpg
+                                        forVehicle:vehicle
+                                        beforeDate:nil
+                                     onOrAfterDate:nil
+                                             error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgReportedMpgDataSetForVehicle:(FPVehicle *)vehicle {
@@ -1109,7 +1451,7 @@ typedef id (^FPValueBlock)(void);
                                                  beforeDate:now
                                               onOrAfterDate:firstDayOfCurrentYear
                                                    calendar:calendar];
-  return [self avgValueForIntegerDataset:dataset];
+  return [self avgValueForDataset:dataset];
 }
 
 - (NSNumber *)yearToDateMaxDaysBetweenFillupsForUser:(FPUser *)user {
@@ -1150,7 +1492,7 @@ typedef id (^FPValueBlock)(void);
                                                  beforeDate:lastYearRange[1]
                                               onOrAfterDate:lastYearRange[0]
                                                    calendar:calendar];
-  return [self avgValueForIntegerDataset:dataset];
+  return [self avgValueForDataset:dataset];
 }
 
 - (NSNumber *)lastYearMaxDaysBetweenFillupsForUser:(FPUser *)user {
@@ -1190,7 +1532,7 @@ typedef id (^FPValueBlock)(void);
                                                    beforeDate:now
                                                 onOrAfterDate:firstGasLog.purchasedAt
                                                      calendar:calendar];
-    return [self avgValueForIntegerDataset:dataset];
+    return [self avgValueForDataset:dataset];
   }
   return nil;
 }
@@ -1243,7 +1585,7 @@ typedef id (^FPValueBlock)(void);
                                                     beforeDate:now
                                                  onOrAfterDate:firstDayOfCurrentYear
                                                       calendar:calendar];
-  return [self avgValueForIntegerDataset:dataset];
+  return [self avgValueForDataset:dataset];
 }
 
 - (NSNumber *)yearToDateMaxDaysBetweenFillupsForVehicle:(FPVehicle *)vehicle {
@@ -1284,7 +1626,7 @@ typedef id (^FPValueBlock)(void);
                                                     beforeDate:lastYearRange[1]
                                                  onOrAfterDate:lastYearRange[0]
                                                       calendar:calendar];
-  return [self avgValueForIntegerDataset:dataset];
+  return [self avgValueForDataset:dataset];
 }
 
 - (NSNumber *)lastYearMaxDaysBetweenFillupsForVehicle:(FPVehicle *)vehicle {
@@ -1324,7 +1666,7 @@ typedef id (^FPValueBlock)(void);
                                                       beforeDate:now
                                                    onOrAfterDate:firstGasLog.purchasedAt
                                                         calendar:calendar];
-    return [self avgValueForIntegerDataset:dataset];
+    return [self avgValueForDataset:dataset];
   }
   return nil;
 }
@@ -1483,10 +1825,13 @@ typedef id (^FPValueBlock)(void);
   NSDateComponents *components = [calendar components:NSCalendarUnitDay|NSCalendarUnitMonth|NSCalendarUnitYear fromDate:now];
   [components setDay:1];
   NSDate *firstDayOfCurrentMonth = [calendar dateFromComponents:components];
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                     beforeDate:now
-                                                                  onOrAfterDate:firstDayOfCurrentMonth
-                                                                          error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                   forUser:user
+                                                                beforeDate:now
+                                                             onOrAfterDate:firstDayOfCurrentMonth
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSDecimalNumber *)lastMonthSpentOnGasForUser:(FPUser *)user {
@@ -1497,19 +1842,25 @@ typedef id (^FPValueBlock)(void);
   NSDate *firstDayOfCurrentMonth = [calendar dateFromComponents:components];
   [components setMonth:(components.month - 1)];
   NSDate *firstDayOfPreviousMonth = [calendar dateFromComponents:components];
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                     beforeDate:firstDayOfCurrentMonth
-                                                                  onOrAfterDate:firstDayOfPreviousMonth
-                                                                          error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                   forUser:user
+                                                                beforeDate:firstDayOfCurrentMonth
+                                                             onOrAfterDate:firstDayOfPreviousMonth
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSDecimalNumber *)yearToDateSpentOnGasForUser:(FPUser *)user {
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]];
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                     beforeDate:now
-                                                                  onOrAfterDate:firstDayOfCurrentYear
-                                                                          error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                   forUser:user
+                                                                beforeDate:now
+                                                             onOrAfterDate:firstDayOfCurrentYear
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSArray *)yearToDateSpentOnGasDataSetForUser:(FPUser *)user {
@@ -1531,14 +1882,17 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearSpentOnGasForUser:(FPUser *)user {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                     beforeDate:lastYearRange[1]
-                                                                  onOrAfterDate:lastYearRange[0]
-                                                                          error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                   forUser:user
+                                                                beforeDate:lastYearRange[1]
+                                                             onOrAfterDate:lastYearRange[0]
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSDecimalNumber *)yearToDateAvgSpentOnGasForUser:(FPUser *)user {
-  return [self avgValueForDecimalDataset:[self yearToDateSpentOnGasExcludingPartialMonthsDataSetForUser:user]];
+  return [self avgValueForDataset:[self yearToDateSpentOnGasExcludingPartialMonthsDataSetForUser:user]];
 }
 
 - (NSDecimalNumber *)yearToDateMinSpentOnGasForUser:(FPUser *)user {
@@ -1555,7 +1909,7 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)lastYearAvgSpentOnGasForUser:(FPUser *)user {
-  return [self avgValueForDecimalDataset:[self lastYearSpentOnGasDataSetForUser:user]];
+  return [self avgValueForDataset:[self lastYearSpentOnGasDataSetForUser:user]];
 }
 
 - (NSDecimalNumber *)lastYearMinSpentOnGasForUser:(FPUser *)user {
@@ -1567,7 +1921,13 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallSpentOnGasForUser:(FPUser *)user {
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForUser:user error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                   forUser:user
+                                                                beforeDate:nil
+                                                             onOrAfterDate:nil
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSArray *)overallSpentOnGasDataSetForUser:(FPUser *)user {
@@ -1593,7 +1953,7 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgSpentOnGasForUser:(FPUser *)user {
-  return [self avgValueForDecimalDataset:[self overallSpentOnGasExcludingPartialMonthsDataSetForUser:user]];
+  return [self avgValueForDataset:[self overallSpentOnGasExcludingPartialMonthsDataSetForUser:user]];
 }
 
 - (NSDecimalNumber *)overallMinSpentOnGasForUser:(FPUser *)user {
@@ -1610,10 +1970,13 @@ typedef id (^FPValueBlock)(void);
   NSDateComponents *components = [calendar components:NSCalendarUnitDay|NSCalendarUnitMonth|NSCalendarUnitYear fromDate:now];
   [components setDay:1];
   NSDate *firstDayOfCurrentMonth = [calendar dateFromComponents:components];
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                        beforeDate:now
-                                                                     onOrAfterDate:firstDayOfCurrentMonth
-                                                                             error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                forVehicle:vehicle
+                                                                beforeDate:now
+                                                             onOrAfterDate:firstDayOfCurrentMonth
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSDecimalNumber *)lastMonthSpentOnGasForVehicle:(FPVehicle *)vehicle {
@@ -1624,19 +1987,25 @@ typedef id (^FPValueBlock)(void);
   NSDate *firstDayOfCurrentMonth = [calendar dateFromComponents:components];
   [components setMonth:(components.month - 1)];
   NSDate *firstDayOfPreviousMonth = [calendar dateFromComponents:components];
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                        beforeDate:firstDayOfCurrentMonth
-                                                                     onOrAfterDate:firstDayOfPreviousMonth
-                                                                             error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                forVehicle:vehicle
+                                                                beforeDate:firstDayOfCurrentMonth
+                                                             onOrAfterDate:firstDayOfPreviousMonth
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSDecimalNumber *)yearToDateSpentOnGasForVehicle:(FPVehicle *)vehicle {
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]];
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                        beforeDate:now
-                                                                     onOrAfterDate:firstDayOfCurrentYear
-                                                                             error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                forVehicle:vehicle
+                                                                beforeDate:now
+                                                             onOrAfterDate:firstDayOfCurrentYear
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSArray *)yearToDateSpentOnGasDataSetForVehicle:(FPVehicle *)vehicle {
@@ -1657,7 +2026,7 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)yearToDateAvgSpentOnGasForVehicle:(FPVehicle *)vehicle {
-  return [self avgValueForDecimalDataset:[self yearToDateSpentOnGasExcludingPartialMonthsDataSetForVehicle:vehicle]];
+  return [self avgValueForDataset:[self yearToDateSpentOnGasExcludingPartialMonthsDataSetForVehicle:vehicle]];
 }
 
 - (NSDecimalNumber *)yearToDateMinSpentOnGasForVehicle:(FPVehicle *)vehicle {
@@ -1670,10 +2039,13 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearSpentOnGasForVehicle:(FPVehicle *)vehicle {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                        beforeDate:lastYearRange[1]
-                                                                     onOrAfterDate:lastYearRange[0]
-                                                                             error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                forVehicle:vehicle
+                                                                beforeDate:lastYearRange[1]
+                                                             onOrAfterDate:lastYearRange[0]
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSArray *)lastYearSpentOnGasDataSetForVehicle:(FPVehicle *)vehicle {
@@ -1689,7 +2061,7 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)lastYearAvgSpentOnGasForVehicle:(FPVehicle *)vehicle {
-  return [self avgValueForDecimalDataset:[self lastYearSpentOnGasDataSetForVehicle:vehicle]];
+  return [self avgValueForDataset:[self lastYearSpentOnGasDataSetForVehicle:vehicle]];
 }
 
 - (NSDecimalNumber *)lastYearMinSpentOnGasForVehicle:(FPVehicle *)vehicle {
@@ -1701,7 +2073,13 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallSpentOnGasForVehicle:(FPVehicle *)vehicle {
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                                forVehicle:vehicle
+                                                                beforeDate:nil
+                                                             onOrAfterDate:nil
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSArray *)overallSpentOnGasDataSetForVehicle:(FPVehicle *)vehicle {
@@ -1727,7 +2105,7 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgSpentOnGasForVehicle:(FPVehicle *)vehicle {
-  return [self avgValueForDecimalDataset:[self overallSpentOnGasExcludingPartialMonthsDataSetForVehicle:vehicle]];
+  return [self avgValueForDataset:[self overallSpentOnGasExcludingPartialMonthsDataSetForVehicle:vehicle]];
 }
 
 - (NSDecimalNumber *)overallMinSpentOnGasForVehicle:(FPVehicle *)vehicle {
@@ -1744,10 +2122,13 @@ typedef id (^FPValueBlock)(void);
   NSDateComponents *components = [calendar components:NSCalendarUnitDay|NSCalendarUnitMonth|NSCalendarUnitYear fromDate:now];
   [components setDay:1];
   NSDate *firstDayOfCurrentMonth = [calendar dateFromComponents:components];
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                            beforeDate:now
-                                                                         onOrAfterDate:firstDayOfCurrentMonth
-                                                                                 error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                            forFuelstation:fuelstation
+                                                                beforeDate:now
+                                                             onOrAfterDate:firstDayOfCurrentMonth
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSDecimalNumber *)lastMonthSpentOnGasForFuelstation:(FPFuelStation *)fuelstation {
@@ -1758,18 +2139,24 @@ typedef id (^FPValueBlock)(void);
   NSDate *firstDayOfCurrentMonth = [calendar dateFromComponents:components];
   [components setMonth:(components.month - 1)];
   NSDate *firstDayOfPreviousMonth = [calendar dateFromComponents:components];
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                            beforeDate:firstDayOfCurrentMonth
-                                                                         onOrAfterDate:firstDayOfPreviousMonth
-                                                                                 error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                            forFuelstation:fuelstation
+                                                                beforeDate:firstDayOfCurrentMonth
+                                                             onOrAfterDate:firstDayOfPreviousMonth
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSDecimalNumber *)yearToDateSpentOnGasForFuelstation:(FPFuelStation *)fuelstation {
   NSDate *now = [NSDate date];
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                            beforeDate:now
-                                                                         onOrAfterDate:[PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]]
-                                                                                 error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                            forFuelstation:fuelstation
+                                                                beforeDate:now
+                                                             onOrAfterDate:[PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]]
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSArray *)yearToDateSpentOnGasDataSetForFuelstation:(FPFuelStation *)fuelstation {
@@ -1790,7 +2177,7 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)yearToDateAvgSpentOnGasForFuelstation:(FPFuelStation *)fuelstation {
-  return [self avgValueForDecimalDataset:[self yearToDateSpentOnGasExcludingPartialMonthsDataSetForFuelstation:fuelstation]];
+  return [self avgValueForDataset:[self yearToDateSpentOnGasExcludingPartialMonthsDataSetForFuelstation:fuelstation]];
 }
 
 - (NSDecimalNumber *)yearToDateMinSpentOnGasForFuelstation:(FPFuelStation *)fuelstation {
@@ -1803,10 +2190,13 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearSpentOnGasForFuelstation:(FPFuelStation *)fuelstation {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                            beforeDate:lastYearRange[1]
-                                                                         onOrAfterDate:lastYearRange[0]
-                                                                                 error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                            forFuelstation:fuelstation
+                                                                beforeDate:lastYearRange[1]
+                                                             onOrAfterDate:lastYearRange[0]
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSArray *)lastYearSpentOnGasDataSetForFuelstation:(FPFuelStation *)fuelstation {
@@ -1815,7 +2205,7 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)lastYearAvgSpentOnGasForFuelstation:(FPFuelStation *)fuelstation {
-  return [self avgValueForDecimalDataset:[self lastYearSpentOnGasDataSetForFuelstation:fuelstation]];
+  return [self avgValueForDataset:[self lastYearSpentOnGasDataSetForFuelstation:fuelstation]];
 }
 
 - (NSDecimalNumber *)lastYearMinSpentOnGasForFuelstation:(FPFuelStation *)fuelstation {
@@ -1827,7 +2217,13 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallSpentOnGasForFuelstation:(FPFuelStation *)fuelstation {
-  return [self totalSpentFromFplogs:[_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation error:_errorBlk]];
+  return [self totalSpentFromAggregate:[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureSpent
+                                                            forFuelstation:fuelstation
+                                                                beforeDate:nil
+                                                             onOrAfterDate:nil
+                                                                    octane:nil
+                                                                    diesel:NO
+                                                                     error:_errorBlk]];
 }
 
 - (NSArray *)overallSpentOnGasDataSetForFuelstation:(FPFuelStation *)fuelstation {
@@ -1853,7 +2249,7 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgSpentOnGasForFuelstation:(FPFuelStation *)fuelstation {
-  return [self avgValueForDecimalDataset:[self overallSpentOnGasExcludingPartialMonthsDataSetForFuelstation:fuelstation]];
+  return [self avgValueForDataset:[self overallSpentOnGasExcludingPartialMonthsDataSetForFuelstation:fuelstation]];
 }
 
 - (NSDecimalNumber *)overallMinSpentOnGasForFuelstation:(FPFuelStation *)fuelstation {
@@ -1869,11 +2265,13 @@ typedef id (^FPValueBlock)(void);
 - (NSDecimalNumber *)yearToDateAvgPricePerGallonForUser:(FPUser *)user octane:(NSNumber *)octane {
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                         beforeDate:now
-                                                                      onOrAfterDate:firstDayOfCurrentYear
-                                                                             octane:octane
-                                                                              error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                      forUser:user
+                                   beforeDate:now
+                                onOrAfterDate:firstDayOfCurrentYear
+                                       octane:octane
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgPricePerGallonDataSetForUser:(FPUser *)user octane:(NSNumber *)octane {
@@ -1884,11 +2282,13 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgPricePerGallonForUser:(FPUser *)user octane:(NSNumber *)octane {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                         beforeDate:lastYearRange[1]
-                                                                      onOrAfterDate:lastYearRange[0]
-                                                                             octane:octane
-                                                                              error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                      forUser:user
+                                   beforeDate:lastYearRange[1]
+                                onOrAfterDate:lastYearRange[0]
+                                       octane:octane
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgPricePerGallonDataSetForUser:(FPUser *)user octane:(NSNumber *)octane {
@@ -1897,9 +2297,13 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgPricePerGallonForUser:(FPUser *)user octane:(NSNumber *)octane {
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                             octane:octane
-                                                                              error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                      forUser:user
+                                   beforeDate:nil
+                                onOrAfterDate:nil
+                                       octane:octane
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgPricePerGallonDataSetForUser:(FPUser *)user octane:(NSNumber *)octane {
@@ -1920,10 +2324,13 @@ typedef id (^FPValueBlock)(void);
 - (NSDecimalNumber *)yearToDateAvgPricePerGallonForUser:(FPUser *)user {
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                         beforeDate:now
-                                                                      onOrAfterDate:firstDayOfCurrentYear
-                                                                              error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                      forUser:user
+                                   beforeDate:now
+                                onOrAfterDate:firstDayOfCurrentYear
+                                       octane:nil
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgPricePerGallonDataSetForUser:(FPUser *)user {
@@ -1934,10 +2341,13 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgPricePerGallonForUser:(FPUser *)user {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                         beforeDate:lastYearRange[1]
-                                                                      onOrAfterDate:lastYearRange[0]
-                                                                              error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                      forUser:user
+                                   beforeDate:lastYearRange[1]
+                                onOrAfterDate:lastYearRange[0]
+                                       octane:nil
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgPricePerGallonDataSetForUser:(FPUser *)user {
@@ -1946,8 +2356,13 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgPricePerGallonForUser:(FPUser *)user {
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForUser:user
-                                                                              error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                      forUser:user
+                                   beforeDate:nil
+                                onOrAfterDate:nil
+                                       octane:nil
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgPricePerGallonDataSetForUser:(FPUser *)user {
@@ -1968,10 +2383,13 @@ typedef id (^FPValueBlock)(void);
 - (NSDecimalNumber *)yearToDateAvgPricePerDieselGallonForUser:(FPUser *)user {
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedDieselFuelPurchaseLogsForUser:user
-                                                                               beforeDate:now
-                                                                            onOrAfterDate:firstDayOfCurrentYear
-                                                                                    error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                      forUser:user
+                                   beforeDate:now
+                                onOrAfterDate:firstDayOfCurrentYear
+                                       octane:nil
+                                       diesel:YES
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgPricePerDieselGallonDataSetForUser:(FPUser *)user {
@@ -1982,10 +2400,13 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgPricePerDieselGallonForUser:(FPUser *)user {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedDieselFuelPurchaseLogsForUser:user
-                                                                               beforeDate:lastYearRange[1]
-                                                                            onOrAfterDate:lastYearRange[0]
-                                                                                    error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                      forUser:user
+                                   beforeDate:lastYearRange[1]
+                                onOrAfterDate:lastYearRange[0]
+                                       octane:nil
+                                       diesel:YES
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgPricePerDieselGallonDataSetForUser:(FPUser *)user {
@@ -1994,8 +2415,13 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgPricePerDieselGallonForUser:(FPUser *)user {
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedDieselFuelPurchaseLogsForUser:user
-                                                                                    error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                      forUser:user
+                                   beforeDate:nil
+                                onOrAfterDate:nil
+                                       octane:nil
+                                       diesel:YES
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgPricePerDieselGallonDataSetForUser:(FPUser *)user {
@@ -2013,11 +2439,13 @@ typedef id (^FPValueBlock)(void);
 - (NSDecimalNumber *)yearToDateAvgPricePerGallonForVehicle:(FPVehicle *)vehicle octane:(NSNumber *)octane {
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                            beforeDate:now
-                                                                         onOrAfterDate:firstDayOfCurrentYear
-                                                                                octane:octane
-                                                                                 error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                   forVehicle:vehicle
+                                   beforeDate:now
+                                onOrAfterDate:firstDayOfCurrentYear
+                                       octane:octane
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgPricePerGallonDataSetForVehicle:(FPVehicle *)vehicle octane:(NSNumber *)octane {
@@ -2031,11 +2459,13 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgPricePerGallonForVehicle:(FPVehicle *)vehicle octane:(NSNumber *)octane {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                            beforeDate:lastYearRange[1]
-                                                                         onOrAfterDate:lastYearRange[0]
-                                                                                octane:octane
-                                                                                 error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                   forVehicle:vehicle
+                                   beforeDate:lastYearRange[1]
+                                onOrAfterDate:lastYearRange[0]
+                                       octane:octane
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgPricePerGallonDataSetForVehicle:(FPVehicle *)vehicle octane:(NSNumber *)octane {
@@ -2047,9 +2477,13 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgPricePerGallonForVehicle:(FPVehicle *)vehicle octane:(NSNumber *)octane {
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                                octane:octane
-                                                                                 error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                   forVehicle:vehicle
+                                   beforeDate:nil
+                                onOrAfterDate:nil
+                                       octane:octane
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgPricePerGallonDataSetForVehicle:(FPVehicle *)vehicle octane:(NSNumber *)octane {
@@ -2068,10 +2502,13 @@ typedef id (^FPValueBlock)(void);
 - (NSDecimalNumber *)yearToDateAvgPricePerGallonForVehicle:(FPVehicle *)vehicle {
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                            beforeDate:now
-                                                                         onOrAfterDate:firstDayOfCurrentYear
-                                                                                 error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                   forVehicle:vehicle
+                                   beforeDate:now
+                                onOrAfterDate:firstDayOfCurrentYear
+                                       octane:nil
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgPricePerGallonDataSetForVehicle:(FPVehicle *)vehicle {
@@ -2084,10 +2521,13 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgPricePerGallonForVehicle:(FPVehicle *)vehicle {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                            beforeDate:lastYearRange[1]
-                                                                         onOrAfterDate:lastYearRange[0]
-                                                                                 error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                   forVehicle:vehicle
+                                   beforeDate:lastYearRange[1]
+                                onOrAfterDate:lastYearRange[0]
+                                       octane:nil
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgPricePerGallonDataSetForVehicle:(FPVehicle *)vehicle {
@@ -2098,8 +2538,13 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgPricePerGallonForVehicle:(FPVehicle *)vehicle {
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                                 error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                   forVehicle:vehicle
+                                   beforeDate:nil
+                                onOrAfterDate:nil
+                                       octane:nil
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgPricePerGallonDataSetForVehicle:(FPVehicle *)vehicle {
@@ -2117,10 +2562,13 @@ typedef id (^FPValueBlock)(void);
 - (NSDecimalNumber *)yearToDateAvgPricePerDieselGallonForVehicle:(FPVehicle *)vehicle {
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedDieselFuelPurchaseLogsForVehicle:vehicle
-                                                                                  beforeDate:now
-                                                                               onOrAfterDate:firstDayOfCurrentYear
-                                                                                       error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                   forVehicle:vehicle
+                                   beforeDate:now
+                                onOrAfterDate:firstDayOfCurrentYear
+                                       octane:nil
+                                       diesel:YES
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgPricePerDieselGallonDataSetForVehicle:(FPVehicle *)vehicle {
@@ -2133,10 +2581,13 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgPricePerDieselGallonForVehicle:(FPVehicle *)vehicle {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedDieselFuelPurchaseLogsForVehicle:vehicle
-                                                                                  beforeDate:lastYearRange[1]
-                                                                               onOrAfterDate:lastYearRange[0]
-                                                                                       error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                   forVehicle:vehicle
+                                   beforeDate:lastYearRange[1]
+                                onOrAfterDate:lastYearRange[0]
+                                       octane:nil
+                                       diesel:YES
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgPricePerDieselGallonDataSetForVehicle:(FPVehicle *)vehicle {
@@ -2147,8 +2598,13 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgPricePerDieselGallonForVehicle:(FPVehicle *)vehicle {
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForVehicle:vehicle
-                                                                                 error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                   forVehicle:vehicle
+                                   beforeDate:nil
+                                onOrAfterDate:nil
+                                       octane:nil
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgPricePerDieselGallonDataSetForVehicle:(FPVehicle *)vehicle {
@@ -2166,11 +2622,13 @@ typedef id (^FPValueBlock)(void);
 - (NSDecimalNumber *)yearToDateAvgPricePerGallonForFuelstation:(FPFuelStation *)fuelstation octane:(NSNumber *)octane {
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                beforeDate:now
-                                                                             onOrAfterDate:firstDayOfCurrentYear
-                                                                                    octane:octane
-                                                                                     error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                               forFuelstation:fuelstation
+                                   beforeDate:now
+                                onOrAfterDate:firstDayOfCurrentYear
+                                       octane:octane
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgPricePerGallonDataSetForFuelstation:(FPFuelStation *)fuelstation octane:(NSNumber *)octane {
@@ -2181,11 +2639,13 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgPricePerGallonForFuelstation:(FPFuelStation *)fuelstation octane:(NSNumber *)octane {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                beforeDate:lastYearRange[1]
-                                                                             onOrAfterDate:lastYearRange[0]
-                                                                                    octane:octane
-                                                                                     error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                               forFuelstation:fuelstation
+                                   beforeDate:lastYearRange[1]
+                                onOrAfterDate:lastYearRange[0]
+                                       octane:octane
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgPricePerGallonDataSetForFuelstation:(FPFuelStation *)fuelstation octane:(NSNumber *)octane {
@@ -2197,9 +2657,13 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgPricePerGallonForFuelstation:(FPFuelStation *)fuelstation octane:(NSNumber *)octane {
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                    octane:octane
-                                                                                     error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                               forFuelstation:fuelstation
+                                   beforeDate:nil
+                                onOrAfterDate:nil
+                                       octane:octane
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgPricePerGallonDataSetForFuelstation:(FPFuelStation *)fuelstation octane:(NSNumber *)octane {
@@ -2218,10 +2682,13 @@ typedef id (^FPValueBlock)(void);
 - (NSDecimalNumber *)yearToDateAvgPricePerGallonForFuelstation:(FPFuelStation *)fuelstation {
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                beforeDate:now
-                                                                             onOrAfterDate:firstDayOfCurrentYear
-                                                                                     error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                               forFuelstation:fuelstation
+                                   beforeDate:now
+                                onOrAfterDate:firstDayOfCurrentYear
+                                       octane:nil
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgPricePerGallonDataSetForFuelstation:(FPFuelStation *)fuelstation {
@@ -2232,10 +2699,13 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgPricePerGallonForFuelstation:(FPFuelStation *)fuelstation {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                beforeDate:lastYearRange[1]
-                                                                             onOrAfterDate:lastYearRange[0]
-                                                                                     error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                               forFuelstation:fuelstation
+                                   beforeDate:lastYearRange[1]
+                                onOrAfterDate:lastYearRange[0]
+                                       octane:nil
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgPricePerGallonDataSetForFuelstation:(FPFuelStation *)fuelstation {
@@ -2246,8 +2716,13 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgPricePerGallonForFuelstation:(FPFuelStation *)fuelstation {
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                     error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                               forFuelstation:fuelstation
+                                   beforeDate:nil
+                                onOrAfterDate:nil
+                                       octane:nil
+                                       diesel:NO
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgPricePerGallonDataSetForFuelstation:(FPFuelStation *)fuelstation {
@@ -2265,10 +2740,13 @@ typedef id (^FPValueBlock)(void);
 - (NSDecimalNumber *)yearToDateAvgPricePerDieselGallonForFuelstation:(FPFuelStation *)fuelstation {
   NSDate *now = [NSDate date];
   NSDate *firstDayOfCurrentYear = [PEUtils firstDayOfYearOfDate:now calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedDieselFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                      beforeDate:now
-                                                                                   onOrAfterDate:firstDayOfCurrentYear
-                                                                                           error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                               forFuelstation:fuelstation
+                                   beforeDate:now
+                                onOrAfterDate:firstDayOfCurrentYear
+                                       octane:nil
+                                       diesel:YES
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)yearToDateAvgPricePerDieselGallonDataSetForFuelstation:(FPFuelStation *)fuelstation {
@@ -2279,10 +2757,13 @@ typedef id (^FPValueBlock)(void);
 
 - (NSDecimalNumber *)lastYearAvgPricePerDieselGallonForFuelstation:(FPFuelStation *)fuelstation {
   NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedDieselFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                      beforeDate:lastYearRange[1]
-                                                                                   onOrAfterDate:lastYearRange[0]
-                                                                                           error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                               forFuelstation:fuelstation
+                                   beforeDate:lastYearRange[1]
+                                onOrAfterDate:lastYearRange[0]
+                                       octane:nil
+                                       diesel:YES
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)lastYearAvgPricePerDieselGallonDataSetForFuelstation:(FPFuelStation *)fuelstation {
@@ -2293,8 +2774,13 @@ typedef id (^FPValueBlock)(void);
 }
 
 - (NSDecimalNumber *)overallAvgPricePerDieselGallonForFuelstation:(FPFuelStation *)fuelstation {
-  return [self avgGallonPriceFromFplogs:[_localDao unorderedDieselFuelPurchaseLogsForFuelstation:fuelstation
-                                                                                           error:_errorBlk]];
+  return [[_localDao aggregateOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                               forFuelstation:fuelstation
+                                   beforeDate:nil
+                                onOrAfterDate:nil
+                                       octane:nil
+                                       diesel:YES
+                                        error:_errorBlk] avg];
 }
 
 - (NSArray *)overallAvgPricePerDieselGallonDataSetForFuelstation:(FPFuelStation *)fuelstation {
@@ -2727,6 +3213,403 @@ typedef id (^FPValueBlock)(void);
                                                                 error:_errorBlk].gallonPrice;
 }
 
+#pragma mark - Price Per Gallon By Octane
+
+/*
+ Pairs each octane's aggregate with its monthly rollups.  When the range is
+ unbounded, an octane's dataset spans its first month with logs through its
+ last.
+ */
+- (NSDictionary *)pricePerGallonStatsByOctaneForEntity:(id)entity
+                                                 range:(FPStatsRange)range
+                                    aggregatesFetchBlk:(NSDictionary *(^)(NSDate *, NSDate *))aggregatesFetchBlk
+                             monthlyAggregatesFetchBlk:(NSDictionary *(^)(NSDate *, NSDate *))monthlyAggregatesFetchBlk {
+  NSArray *bounds = [self boundsForRange:range];
+  NSDictionary *octaneAggregates = aggregatesFetchBlk(bounds[0], bounds[1]);
+  NSDictionary *octaneMonthlyAggregates = monthlyAggregatesFetchBlk(bounds[0], bounds[1]);
+  FPMonthBoundaries *boundaries = [FPMonthBoundaries currentBoundaries];
+  NSMutableDictionary *statsByOctane = [NSMutableDictionary dictionaryWithCapacity:octaneAggregates.count];
+  [octaneAggregates enumerateKeysAndObjectsUsingBlock:^(NSNumber *octane, FPLogAggregate *aggregate, BOOL *stop) {
+    NSDictionary *monthlyAggregates = octaneMonthlyAggregates[octane];
+    NSArray *dataSet = @[];
+    if (monthlyAggregates.count > 0) {
+      NSDate *beforeDate = bounds[0];
+      NSDate *onOrAfterDate = bounds[1];
+      if (!bounds) {
+        NSArray *monthKeys = [monthlyAggregates.allKeys sortedArrayUsingSelector:@selector(compare:)];
+        beforeDate = [boundaries firstDayOfMonthKey:[monthKeys.lastObject integerValue] + 1];
+        onOrAfterDate = [boundaries firstDayOfMonthKey:[monthKeys[0] integerValue]];
+      }
+      dataSet = [self dataSetForEntity:entity
+                        monthlyBuckets:monthlyAggregates
+                        bucketValueBlk:^id(FPLogAggregate *monthlyAggregate, NSNumber *monthKey) { return [monthlyAggregate avg]; }
+                            beforeDate:beforeDate
+                         onOrAfterDate:onOrAfterDate];
+    }
+    statsByOctane[octane] = [[FPOctanePriceStats alloc] initWithAvg:[aggregate avg]
+                                                                min:aggregate.min
+                                                                max:aggregate.max
+                                                            dataSet:dataSet];
+  }];
+  return statsByOctane;
+}
+
+- (NSDictionary *)pricePerGallonStatsByOctaneForUser:(FPUser *)user range:(FPStatsRange)range {
+  return [self pricePerGallonStatsByOctaneForEntity:user
+                                              range:range
+                                 aggregatesFetchBlk:^NSDictionary *(NSDate *beforeDate, NSDate *onOrAfterDate) {
+                                   return [_localDao octaneAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                             forUser:user
+                                                                          beforeDate:beforeDate
+                                                                       onOrAfterDate:onOrAfterDate
+                                                                               error:_errorBlk];
+                                 }
+                          monthlyAggregatesFetchBlk:^NSDictionary *(NSDate *beforeDate, NSDate *onOrAfterDate) {
+                            return [_localDao octaneMonthlyAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                             forUser:user
+                                                                          beforeDate:beforeDate
+                                                                       onOrAfterDate:onOrAfterDate
+                                                                               error:_errorBlk];
+                          }];
+}
+
+- (NSDictionary *)pricePerGallonStatsByOctaneForVehicle:(FPVehicle *)vehicle range:(FPStatsRange)range {
+  return [self pricePerGallonStatsByOctaneForEntity:vehicle
+                                              range:range
+                                 aggregatesFetchBlk:^NSDictionary *(NSDate *beforeDate, NSDate *onOrAfterDate) {
+                                   return [_localDao octaneAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                          forVehicle:vehicle
+                                                                          beforeDate:beforeDate
+                                                                       onOrAfterDate:onOrAfterDate
+                                                                               error:_errorBlk];
+                                 }
+                          monthlyAggregatesFetchBlk:^NSDictionary *(NSDate *beforeDate, NSDate *onOrAfterDate) {
+                            return [_localDao octaneMonthlyAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                          forVehicle:vehicle
+                                                                          beforeDate:beforeDate
+                                                                       onOrAfterDate:onOrAfterDate
+                                                                               error:_errorBlk];
+                          }];
+}
+
+- (NSDictionary *)pricePerGallonStatsByOctaneForFuelstation:(FPFuelStation *)fuelstation range:(FPStatsRange)range {
+  return [self pricePerGallonStatsByOctaneForEntity:fuelstation
+                                              range:range
+                                 aggregatesFetchBlk:^NSDictionary *(NSDate *beforeDate, NSDate *onOrAfterDate) {
+                                   return [_localDao octaneAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                      forFuelstation:fuelstation
+                                                                          beforeDate:beforeDate
+                                                                       onOrAfterDate:onOrAfterDate
+                                                                               error:_errorBlk];
+                                 }
+                          monthlyAggregatesFetchBlk:^NSDictionary *(NSDate *beforeDate, NSDate *onOrAfterDate) {
+                            return [_localDao octaneMonthlyAggregatesOfGasLogMeasure:FPGasLogMeasureGallonPrice
+                                                                      forFuelstation:fuelstation
+                                                                          beforeDate:beforeDate
+                                                                       onOrAfterDate:onOrAfterDate
+                                                                               error:_errorBlk];
+                          }];
+}
+
+#pragma mark - Percentiles
+
+/*
+ octane is nil for every fuel, an octane, or FPOctaneKeyDiesel.
+ */
+- (FPQuantileSketch *)gallonPriceSketchForEntity:(id)entity octane:(NSNumber *)octane range:(FPStatsRange)range {
+  NSArray *bounds = [self boundsForRange:range];
+  BOOL diesel = [octane isEqualToNumber:@(FPOctaneKeyDiesel)];
+  NSNumber *nonDieselOctane = diesel ? nil : octane;
+  if ([entity isKindOfClass:[FPUser class]]) {
+    return [_localDao gallonPriceSketchForUser:entity
+                                    beforeDate:bounds[0]
+                                 onOrAfterDate:bounds[1]
+                                        octane:nonDieselOctane
+                                        diesel:diesel
+                                         error:_errorBlk];
+  } else if ([entity isKindOfClass:[FPVehicle class]]) {
+    return [_localDao gallonPriceSketchForVehicle:entity
+                                       beforeDate:bounds[0]
+                                    onOrAfterDate:bounds[1]
+                                           octane:nonDieselOctane
+                                           diesel:diesel
+                                            error:_errorBlk];
+  }
+  return [_localDao gallonPriceSketchForFuelstation:entity
+                                         beforeDate:bounds[0]
+                                      onOrAfterDate:bounds[1]
+                                             octane:nonDieselOctane
+                                             diesel:diesel
+                                              error:_errorBlk];
+}
+
+- (FPQuantileSketch *)reportedAvgMpgSketchForEntity:(id)entity range:(FPStatsRange)range {
+  NSArray *bounds = [self boundsForRange:range];
+  if ([entity isKindOfClass:[FPUser class]]) {
+    return [_localDao reportedAvgMpgSketchForUser:entity
+                                       beforeDate:bounds[0]
+                                    onOrAfterDate:bounds[1]
+                                            error:_errorBlk];
+  }
+  return [_localDao reportedAvgMpgSketchForVehicle:entity
+                                        beforeDate:bounds[0]
+                                     onOrAfterDate:bounds[1]
+                                             error:_errorBlk];
+}
+
+- (NSDecimalNumber *)pricePerGallonQuantile:(double)quantile
+                                    forUser:(FPUser *)user
+                                     octane:(NSNumber *)octane
+                                      range:(FPStatsRange)range {
+  return [[self gallonPriceSketchForEntity:user octane:octane range:range] decimalNumberForQuantile:quantile];
+}
+
+- (NSDecimalNumber *)pricePerGallonQuantile:(double)quantile
+                                 forVehicle:(FPVehicle *)vehicle
+                                     octane:(NSNumber *)octane
+                                      range:(FPStatsRange)range {
+  return [[self gallonPriceSketchForEntity:vehicle octane:octane range:range] decimalNumberForQuantile:quantile];
+}
+
+- (NSDecimalNumber *)pricePerGallonQuantile:(double)quantile
+                             forFuelstation:(FPFuelStation *)fuelstation
+                                     octane:(NSNumber *)octane
+                                      range:(FPStatsRange)range {
+  return [[self gallonPriceSketchForEntity:fuelstation octane:octane range:range] decimalNumberForQuantile:quantile];
+}
+
+- (NSDecimalNumber *)reportedAvgMpgQuantile:(double)quantile
+                                    forUser:(FPUser *)user
+                                      range:(FPStatsRange)range {
+  return [[self reportedAvgMpgSketchForEntity:user range:range] decimalNumberForQuantile:quantile];
+}
+
+- (NSDecimalNumber *)reportedAvgMpgQuantile:(double)quantile
+                                 forVehicle:(FPVehicle *)vehicle
+                                      range:(FPStatsRange)range {
+  return [[self reportedAvgMpgSketchForEntity:vehicle range:range] decimalNumberForQuantile:quantile];
+}
+
+#pragma mark - Rolling Windows
+
+- (NSArray *)rollingDataSetFromScanner:(FPRollingWindowScanner *)scanner
+                             movingSum:(BOOL)movingSum
+                            windowDays:(NSInteger)windowDays
+                           granularity:(FPRollingSeriesGranularity)granularity
+                                 range:(FPStatsRange)range {
+  NSArray *bounds = [self boundsForRange:range];
+  NSCalendar *calendar = [NSCalendar currentCalendar];
+  if (movingSum) {
+    return [scanner movingSumDataSetWithWindowDays:windowDays
+                                       granularity:granularity
+                                          calendar:calendar
+                                        beforeDate:bounds[0]
+                                     onOrAfterDate:bounds[1]];
+  }
+  return [scanner movingAvgDataSetWithWindowDays:windowDays
+                                     granularity:granularity
+                                        calendar:calendar
+                                      beforeDate:bounds[0]
+                                   onOrAfterDate:bounds[1]];
+}
+
+/*
+ octane is nil for every fuel, an octane, or FPOctaneKeyDiesel.  The scan runs
+ over the entity's memoized gas log columns, so every window size and
+ granularity shares a single load of the logs.
+ */
+- (NSArray *)rollingDataSetForGasLogsOfEntity:(id)entity
+                                      measure:(FPGasLogMeasure)measure
+                                       octane:(NSNumber *)octane
+                                    movingSum:(BOOL)movingSum
+                                   windowDays:(NSInteger)windowDays
+                                  granularity:(FPRollingSeriesGranularity)granularity
+                                        range:(FPStatsRange)range {
+  BOOL diesel = [octane isEqualToNumber:@(FPOctaneKeyDiesel)];
+  FPRollingWindowScanner *scanner = [[FPRollingWindowScanner alloc] initWithGasLogColumns:[self gasLogColumnsForEntity:entity]
+                                                                                  measure:measure
+                                                                                   octane:diesel ? nil : octane
+                                                                                   diesel:diesel];
+  return [self rollingDataSetFromScanner:scanner
+                               movingSum:movingSum
+                              windowDays:windowDays
+                             granularity:granularity
+                                   range:range];
+}
+
+- (NSArray *)movingAvgReportedMpgDataSetForEntity:(id)entity
+                                       windowDays:(NSInteger)windowDays
+                                      granularity:(FPRollingSeriesGranularity)granularity
+                                            range:(FPStatsRange)range {
+  NSArray *bounds = [self boundsForRange:range];
+  NSArray *envlogs;
+  if (bounds) {
+    // the windows of the range's first datapoints reach back before it
+    NSDate *windowsStartDate = [[NSCalendar currentCalendar] dateByAddingUnit:NSCalendarUnitDay
+                                                                       value:-windowDays
+                                                                      toDate:bounds[1]
+                                                                     options:0];
+    if ([entity isKindOfClass:[FPUser class]]) {
+      envlogs = [_localDao unorderedEnvironmentLogsForUser:entity
+                                                beforeDate:bounds[0]
+                                             onOrAfterDate:windowsStartDate
+                                                     error:_errorBlk];
+    } else {
+      envlogs = [_localDao unorderedEnvironmentLogsForVehicle:entity
+                                                   beforeDate:bounds[0]
+                                                onOrAfterDate:windowsStartDate
+                                                        error:_errorBlk];
+    }
+  } else if ([entity isKindOfClass:[FPUser class]]) {
+    envlogs = [_localDao unorderedEnvironmentLogsForUser:entity error:_errorBlk];
+  } else {
+    envlogs = [_localDao unorderedEnvironmentLogsForVehicle:entity error:_errorBlk];
+  }
+  FPRollingWindowScanner *scanner = [[FPRollingWindowScanner alloc] initWithEnvironmentLogs:envlogs
+                                                                                   valueBlk:^NSDecimalNumber *(FPEnvironmentLog *envlog) {
+                                                                                     return envlog.reportedAvgMpg;
+                                                                                   }];
+  return [self rollingDataSetFromScanner:scanner
+                               movingSum:NO
+                              windowDays:windowDays
+                             granularity:granularity
+                                   range:range];
+}
+
+- (NSArray *)movingSumSpentOnGasDataSetForUser:(FPUser *)user
+                                    windowDays:(NSInteger)windowDays
+                                   granularity:(FPRollingSeriesGranularity)granularity
+                                         range:(FPStatsRange)range {
+  return [self rollingDataSetForGasLogsOfEntity:user
+                                        measure:FPGasLogMeasureSpent
+                                         octane:nil
+                                      movingSum:YES
+                                     windowDays:windowDays
+                                    granularity:granularity
+                                          range:range];
+}
+
+- (NSArray *)movingSumSpentOnGasDataSetForVehicle:(FPVehicle *)vehicle
+                                       windowDays:(NSInteger)windowDays
+                                      granularity:(FPRollingSeriesGranularity)granularity
+                                            range:(FPStatsRange)range {
+  return [self rollingDataSetForGasLogsOfEntity:vehicle
+                                        measure:FPGasLogMeasureSpent
+                                         octane:nil
+                                      movingSum:YES
+                                     windowDays:windowDays
+                                    granularity:granularity
+                                          range:range];
+}
+
+- (NSArray *)movingSumSpentOnGasDataSetForFuelstation:(FPFuelStation *)fuelstation
+                                           windowDays:(NSInteger)windowDays
+                                          granularity:(FPRollingSeriesGranularity)granularity
+                                                range:(FPStatsRange)range {
+  return [self rollingDataSetForGasLogsOfEntity:fuelstation
+                                        measure:FPGasLogMeasureSpent
+                                         octane:nil
+                                      movingSum:YES
+                                     windowDays:windowDays
+                                    granularity:granularity
+                                          range:range];
+}
+
+- (NSArray *)movingAvgSpentOnGasDataSetForUser:(FPUser *)user
+                                    windowDays:(NSInteger)windowDays
+                                   granularity:(FPRollingSeriesGranularity)granularity
+                                         range:(FPStatsRange)range {
+  return [self rollingDataSetForGasLogsOfEntity:user
+                                        measure:FPGasLogMeasureSpent
+                                         octane:nil
+                                      movingSum:NO
+                                     windowDays:windowDays
+                                    granularity:granularity
+                                          range:range];
+}
+
+- (NSArray *)movingAvgSpentOnGasDataSetForVehicle:(FPVehicle *)vehicle
+                                       windowDays:(NSInteger)windowDays
+                                      granularity:(FPRollingSeriesGranularity)granularity
+                                            range:(FPStatsRange)range {
+  return [self rollingDataSetForGasLogsOfEntity:vehicle
+                                        measure:FPGasLogMeasureSpent
+                                         octane:nil
+                                      movingSum:NO
+                                     windowDays:windowDays
+                                    granularity:granularity
+                                          range:range];
+}
+
+- (NSArray *)movingAvgSpentOnGasDataSetForFuelstation:(FPFuelStation *)fuelstation
+                                           windowDays:(NSInteger)windowDays
+                                          granularity:(FPRollingSeriesGranularity)granularity
+                                                range:(FPStatsRange)range {
+  return [self rollingDataSetForGasLogsOfEntity:fuelstation
+                                        measure:FPGasLogMeasureSpent
+                                         octane:nil
+                                      movingSum:NO
+                                     windowDays:windowDays
+                                    granularity:granularity
+                                          range:range];
+}
+
+- (NSArray *)movingAvgPricePerGallonDataSetForUser:(FPUser *)user
+                                            octane:(NSNumber *)octane
+                                        windowDays:(NSInteger)windowDays
+                                       granularity:(FPRollingSeriesGranularity)granularity
+                                             range:(FPStatsRange)range {
+  return [self rollingDataSetForGasLogsOfEntity:user
+                                        measure:FPGasLogMeasureGallonPrice
+                                         octane:octane
+                                      movingSum:NO
+                                     windowDays:windowDays
+                                    granularity:granularity
+                                          range:range];
+}
+
+- (NSArray *)movingAvgPricePerGallonDataSetForVehicle:(FPVehicle *)vehicle
+                                               octane:(NSNumber *)octane
+                                           windowDays:(NSInteger)windowDays
+                                          granularity:(FPRollingSeriesGranularity)granularity
+                                                range:(FPStatsRange)range {
+  return [self rollingDataSetForGasLogsOfEntity:vehicle
+                                        measure:FPGasLogMeasureGallonPrice
+                                         octane:octane
+                                      movingSum:NO
+                                     windowDays:windowDays
+                                    granularity:granularity
+                                          range:range];
+}
+
+- (NSArray *)movingAvgPricePerGallonDataSetForFuelstation:(FPFuelStation *)fuelstation
+                                                   octane:(NSNumber *)octane
+                                               windowDays:(NSInteger)windowDays
+                                              granularity:(FPRollingSeriesGranularity)granularity
+                                                    range:(FPStatsRange)range {
+  return [self rollingDataSetForGasLogsOfEntity:fuelstation
+                                        measure:FPGasLogMeasureGallonPrice
+                                         octane:octane
+                                      movingSum:NO
+                                     windowDays:windowDays
+                                    granularity:granularity
+                                          range:range];
+}
+
+- (NSArray *)movingAvgReportedMpgDataSetForUser:(FPUser *)user
+                                     windowDays:(NSInteger)windowDays
+                                    granularity:(FPRollingSeriesGranularity)granularity
+                                          range:(FPStatsRange)range {
+  return [self movingAvgReportedMpgDataSetForEntity:user windowDays:windowDays granularity:granularity range:range];
+}
+
+- (NSArray *)movingAvgReportedMpgDataSetForVehicle:(FPVehicle *)vehicle
+                                        windowDays:(NSInteger)windowDays
+                                       granularity:(FPRollingSeriesGranularity)granularity
+                                             range:(FPStatsRange)range {
+  return [self movingAvgReportedMpgDataSetForEntity:vehicle windowDays:windowDays granularity:granularity range:range];
+}
+
 #pragma mark - Miles Recorded
 
 - (NSDecimalNumber *)milesRecordedForVehicle:(FPVehicle *)vehicle {
@@ -2809,4 +3692,16 @@ typedef id (^FPValueBlock)(void);
   return nil;
 }
 
+#pragma mark - Snapshots
+
+- (void)computeSnapshot:(FPStatsSnapshot *)snapshot {
+  [snapshot computeWithGasLogColumnsFetchBlk:^FPLogColumns *(id entity) { return [self gasLogColumnsForEntity:entity]; }
+                        odometerLogsFetchBlk:^NSArray *(id entity) {
+    if ([entity isKindOfClass:[FPUser class]]) {
+      return [_localDao unorderedEnvironmentLogsForUser:entity error:_errorBlk];
+    }
+    return [_localDao unorderedEnvironmentLogsForVehicle:entity error:_errorBlk];
+  }];
+}
+
 @end
@@ -0,0 +1,42 @@
+//
+//  FPStatsRequest.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+/**
+ The cancellation token of an asynchronous stats request (see
+ -[FPStats computeValueAsyncForKey:screen:valueBlk:completionBlk:]).
+ */
+@interface FPStatsRequest : NSObject
+
+#pragma mark - Initializers
+
+- (instancetype)initWithKey:(NSArray *)key screen:(NSString *)screen;
+
+#pragma mark - Properties
+
+/** Identifies the stat; requests with equal keys share a computation. */
+@property (nonatomic, readonly) NSArray *key;
+
+/** Identifies the requester; nil if the request wasn't made for a screen. */
+@property (nonatomic, readonly) NSString *screen;
+
+@property (atomic, readonly, getter=isCancelled) BOOL cancelled;
+
+#pragma mark - Cancelling
+
+/**
+ Keeps the request's completion block from being called.  A computation that
+ hasn't started yet is skipped once every request waiting on it is cancelled;
+ one that has started runs to the end, and its result is dropped.  Cancelling
+ on the completion queue guarantees the block isn't called; from any other
+ queue, a completion already underway may still get through.
+ */
+- (void)cancel;
+
+@end
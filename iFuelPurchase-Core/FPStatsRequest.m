@@ -0,0 +1,34 @@
+//
+//  FPStatsRequest.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPStatsRequest.h"
+
+@interface FPStatsRequest ()
+@property (atomic, readwrite, getter=isCancelled) BOOL cancelled;
+@end
+
+@implementation FPStatsRequest
+
+#pragma mark - Initializers
+
+- (instancetype)initWithKey:(NSArray *)key screen:(NSString *)screen {
+  self = [super init];
+  if (self) {
+    _key = key;
+    _screen = screen;
+  }
+  return self;
+}
+
+#pragma mark - Cancelling
+
+- (void)cancel {
+  self.cancelled = YES;
+}
+
+@end
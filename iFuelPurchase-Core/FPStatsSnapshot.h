@@ -0,0 +1,88 @@
+//
+//  FPStatsSnapshot.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+@class FPLogColumns;
+
+typedef NS_ENUM(NSInteger, FPStatsMetric) {
+  FPStatsMetricReportedAvgMpg,
+  FPStatsMetricReportedAvgMph,
+  FPStatsMetricPricePerGallon,
+  FPStatsMetricSpentOnGas       // num gallons * gallon price
+};
+
+typedef NS_ENUM(NSInteger, FPStatsAggregation) {
+  FPStatsAggregationAvg,
+  FPStatsAggregationMin,
+  FPStatsAggregationMax,
+  FPStatsAggregationTotal
+};
+
+typedef NS_ENUM(NSInteger, FPStatsRange) {
+  FPStatsRangeYearToDate,
+  FPStatsRangeLastYear,
+  FPStatsRangeOverall
+};
+
+/**
+ A batch of stats to be computed together.  Request the (metric, aggregation,
+ range) triples needed for each entity (an FPUser, FPVehicle or FPFuelStation),
+ then hand the snapshot to -[FPStats computeSnapshot:].  Each entity's logs are
+ fetched once (gas logs and/or odometer logs, depending on the metrics
+ requested) and every requested stat is computed from them.  Odometer metrics
+ do not apply to fuel stations and are always nil for them.
+ */
+@interface FPStatsSnapshot : NSObject
+
+#pragma mark - Requesting Stats
+
+- (void)requestMetric:(FPStatsMetric)metric
+          aggregation:(FPStatsAggregation)aggregation
+                range:(FPStatsRange)range
+            forEntity:(id)entity;
+
+/**
+ Requests every combination of the given metrics, aggregations and ranges
+ (arrays of NSNumber-wrapped enum values).
+ */
+- (void)requestMetrics:(NSArray *)metrics
+          aggregations:(NSArray *)aggregations
+                ranges:(NSArray *)ranges
+             forEntity:(id)entity;
+
+#pragma mark - Computing
+
+/**
+ Computes every requested stat.  The blocks fetch an entity's gas log columns
+ or all of its odometer logs; each is invoked at most once per entity.
+ -[FPStats computeSnapshot:] is the usual way to invoke this.
+ */
+- (void)computeWithGasLogColumnsFetchBlk:(FPLogColumns *(^)(id))gasLogColumnsFetchBlk
+                    odometerLogsFetchBlk:(NSArray *(^)(id))odometerLogsFetchBlk;
+
+#pragma mark - Results
+
+- (NSDecimalNumber *)valueOfMetric:(FPStatsMetric)metric
+                       aggregation:(FPStatsAggregation)aggregation
+                             range:(FPStatsRange)range
+                         forEntity:(id)entity;
+
+#pragma mark - Query Report
+
+@property (nonatomic, readonly) NSInteger numRequestedStats;
+
+/**
+ The number of log fetches (fetch block invocations) the last computation
+ made: at most one gas log and one odometer log fetch per entity.  How many
+ statements those run depends on the fetch blocks (FPStats's are memoized,
+ and may run none); -[FPLocalDao numStatementsExecuted] measures that.
+ */
+@property (nonatomic, readonly) NSInteger numLogFetches;
+
+@end
@@ -0,0 +1,275 @@
+//
+//  FPStatsSnapshot.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPStatsSnapshot.h"
+
+#import <PEObjc-Commons/PEUtils.h>
+
+#import "FPEnvironmentLog.h"
+#import "FPFuelStation.h"
+#import "FPLogAggregate.h"
+#import "FPLogColumns.h"
+#import "FPReducer.h"
+
+@interface FPStatsSnapshotAccumulator : NSObject
+- (void)accumulateValue:(NSDecimalNumber *)value;
+- (FPLogAggregate *)aggregate;
+@end
+
+@implementation FPStatsSnapshotAccumulator {
+  NSInteger _numLogs;
+  FPReducer *_reducer;
+}
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _reducer = [FPReducer fusedReducerWithReducers:@[[FPReducer countReducer],
+                                                     [FPReducer sumReducer],
+                                                     [FPReducer minReducer],
+                                                     [FPReducer maxReducer]]];
+  }
+  return self;
+}
+
+- (void)accumulateValue:(NSDecimalNumber *)value {
+  _numLogs++;
+  [_reducer reduceValue:value];
+}
+
+- (FPLogAggregate *)aggregate {
+  NSArray *results = [_reducer result];
+  id (^nilIfNull)(id) = ^id(id result) { return result == [NSNull null] ? nil : result; };
+  return [[FPLogAggregate alloc] initWithNumLogs:_numLogs
+                                           count:[results[0] integerValue]
+                                             sum:nilIfNull(results[1])
+                                             min:nilIfNull(results[2])
+                                             max:nilIfNull(results[3])];
+}
+
+@end
+
+@implementation FPStatsSnapshot {
+  NSMutableArray *_entities;
+  NSMutableArray *_requestsByEntity;
+  NSMutableArray *_valuesByEntity;
+}
+
+#pragma mark - Initializers
+
+- (instancetype)init {
+  self = [super init];
+  if (self) {
+    _entities = [NSMutableArray array];
+    _requestsByEntity = [NSMutableArray array];
+    _valuesByEntity = [NSMutableArray array];
+  }
+  return self;
+}
+
+#pragma mark - Helpers
+
+- (NSArray *)requestKeyForMetric:(FPStatsMetric)metric
+                     aggregation:(FPStatsAggregation)aggregation
+                           range:(FPStatsRange)range {
+  return @[@(metric), @(aggregation), @(range)];
+}
+
+- (BOOL)isGasLogMetric:(FPStatsMetric)metric {
+  return metric == FPStatsMetricPricePerGallon || metric == FPStatsMetricSpentOnGas;
+}
+
+- (NSDecimalNumber *)valueOfMetric:(FPStatsMetric)metric forOdometerLog:(FPEnvironmentLog *)envlog {
+  switch (metric) {
+    case FPStatsMetricReportedAvgMpg:
+      return envlog.reportedAvgMpg;
+    case FPStatsMetricReportedAvgMph:
+      return envlog.reportedAvgMph;
+    case FPStatsMetricPricePerGallon:
+    case FPStatsMetricSpentOnGas:
+      break;
+  }
+  return nil;
+}
+
+- (FPGasLogMeasure)gasLogMeasureForMetric:(FPStatsMetric)metric {
+  return metric == FPStatsMetricPricePerGallon ? FPGasLogMeasureGallonPrice : FPGasLogMeasureSpent;
+}
+
+- (NSDecimalNumber *)valueOfAggregation:(FPStatsAggregation)aggregation aggregate:(FPLogAggregate *)aggregate {
+  switch (aggregation) {
+    case FPStatsAggregationAvg:
+      return [aggregate avg];
+    case FPStatsAggregationMin:
+      return aggregate.min;
+    case FPStatsAggregationMax:
+      return aggregate.max;
+    case FPStatsAggregationTotal:
+      return aggregate.numLogs > 0 ? aggregate.sum : nil;
+  }
+  return nil;
+}
+
+/*
+ Returns, indexed by FPStatsRange, the [beforeDate, onOrAfterDate] bounds of
+ each range; the overall range is unbounded (empty).
+ */
+- (NSArray *)rangeBoundsAsOfDate:(NSDate *)now calendar:(NSCalendar *)calendar {
+  NSArray *lastYearRange = [PEUtils lastYearRangeFromDate:now calendar:calendar];
+  return @[@[now, [PEUtils firstDayOfYearOfDate:now calendar:calendar]],
+           @[lastYearRange[1], lastYearRange[0]],
+           @[]];
+}
+
+- (BOOL)date:(NSDate *)date isWithinBounds:(NSArray *)bounds {
+  if (bounds.count == 0) {
+    return YES;
+  }
+  return date &&
+    [date compare:bounds[0]] == NSOrderedAscending &&
+    [date compare:bounds[1]] != NSOrderedAscending;
+}
+
+- (void)accumulateOdometerLogs:(NSArray *)envlogs
+                  accumulators:(NSDictionary *)accumulators
+                   rangeBounds:(NSArray *)rangeBounds {
+  for (FPEnvironmentLog *envlog in envlogs) {
+    [accumulators enumerateKeysAndObjectsUsingBlock:^(NSArray *accumulatorKey, FPStatsSnapshotAccumulator *accumulator, BOOL *stop) {
+      if ([self date:envlog.logDate isWithinBounds:rangeBounds[[accumulatorKey[1] integerValue]]]) {
+        [accumulator accumulateValue:[self valueOfMetric:[accumulatorKey[0] integerValue] forOdometerLog:envlog]];
+      }
+    }];
+  }
+}
+
+/*
+ Aggregates each requested gas log metric straight off the columns; a range's
+ rows are found by binary search, so the columns are never walked as a whole
+ for every range.
+ */
+- (void)aggregateGasLogColumns:(FPLogColumns *)columns
+                 aggregateKeys:(NSSet *)aggregateKeys
+                    aggregates:(NSMutableDictionary *)aggregates
+                   rangeBounds:(NSArray *)rangeBounds {
+  for (NSArray *aggregateKey in aggregateKeys) {
+    NSArray *bounds = rangeBounds[[aggregateKey[1] integerValue]];
+    NSRange range = bounds.count == 0 ?
+      NSMakeRange(0, columns.count) :
+      [columns rangeOfRowsBeforeDate:bounds[0] onOrAfterDate:bounds[1]];
+    aggregates[aggregateKey] = [columns aggregateOfMeasure:[self gasLogMeasureForMetric:[aggregateKey[0] integerValue]]
+                                                   inRange:range
+                                                    octane:nil
+                                                    diesel:NO];
+  }
+}
+
+#pragma mark - Requesting Stats
+
+- (void)requestMetric:(FPStatsMetric)metric
+          aggregation:(FPStatsAggregation)aggregation
+                range:(FPStatsRange)range
+            forEntity:(id)entity {
+  NSUInteger index = [_entities indexOfObject:entity];
+  if (index == NSNotFound) {
+    index = _entities.count;
+    [_entities addObject:entity];
+    [_requestsByEntity addObject:[NSMutableSet set]];
+    [_valuesByEntity addObject:[NSMutableDictionary dictionary]];
+  }
+  [_requestsByEntity[index] addObject:[self requestKeyForMetric:metric aggregation:aggregation range:range]];
+}
+
+- (void)requestMetrics:(NSArray *)metrics
+          aggregations:(NSArray *)aggregations
+                ranges:(NSArray *)ranges
+             forEntity:(id)entity {
+  for (NSNumber *metric in metrics) {
+    for (NSNumber *aggregation in aggregations) {
+      for (NSNumber *range in ranges) {
+        [self requestMetric:metric.integerValue
+                aggregation:aggregation.integerValue
+                      range:range.integerValue
+                  forEntity:entity];
+      }
+    }
+  }
+}
+
+#pragma mark - Computing
+
+- (void)computeWithGasLogColumnsFetchBlk:(FPLogColumns *(^)(id))gasLogColumnsFetchBlk
+                    odometerLogsFetchBlk:(NSArray *(^)(id))odometerLogsFetchBlk {
+  NSArray *rangeBounds = [self rangeBoundsAsOfDate:[NSDate date] calendar:[NSCalendar currentCalendar]];
+  _numLogFetches = 0;
+  for (NSUInteger i = 0; i < _entities.count; i++) {
+    id entity = _entities[i];
+    NSSet *requests = _requestsByEntity[i];
+    NSMutableDictionary *values = _valuesByEntity[i];
+    [values removeAllObjects];
+    BOOL isFuelstation = [entity isKindOfClass:[FPFuelStation class]];
+    NSMutableSet *gasLogAggregateKeys = [NSMutableSet set];
+    NSMutableDictionary *accumulators = [NSMutableDictionary dictionary];
+    for (NSArray *request in requests) {
+      NSArray *aggregateKey = @[request[0], request[2]];
+      if ([self isGasLogMetric:[request[0] integerValue]]) {
+        [gasLogAggregateKeys addObject:aggregateKey];
+      } else if (!isFuelstation && accumulators[aggregateKey] == nil) {
+        accumulators[aggregateKey] = [[FPStatsSnapshotAccumulator alloc] init];
+      }
+    }
+    NSMutableDictionary *aggregates = [NSMutableDictionary dictionary];
+    if (gasLogAggregateKeys.count > 0) {
+      _numLogFetches++;
+      [self aggregateGasLogColumns:gasLogColumnsFetchBlk(entity)
+                     aggregateKeys:gasLogAggregateKeys
+                        aggregates:aggregates
+                       rangeBounds:rangeBounds];
+    }
+    if (accumulators.count > 0) {
+      _numLogFetches++;
+      [self accumulateOdometerLogs:odometerLogsFetchBlk(entity) accumulators:accumulators rangeBounds:rangeBounds];
+      [accumulators enumerateKeysAndObjectsUsingBlock:^(NSArray *aggregateKey, FPStatsSnapshotAccumulator *accumulator, BOOL *stop) {
+        aggregates[aggregateKey] = [accumulator aggregate];
+      }];
+    }
+    for (NSArray *request in requests) {
+      FPLogAggregate *aggregate = aggregates[@[request[0], request[2]]];
+      if (aggregate) {
+        NSDecimalNumber *value = [self valueOfAggregation:[request[1] integerValue] aggregate:aggregate];
+        if (value) {
+          values[request] = value;
+        }
+      }
+    }
+  }
+}
+
+#pragma mark - Results
+
+- (NSDecimalNumber *)valueOfMetric:(FPStatsMetric)metric
+                       aggregation:(FPStatsAggregation)aggregation
+                             range:(FPStatsRange)range
+                         forEntity:(id)entity {
+  NSUInteger index = [_entities indexOfObject:entity];
+  if (index != NSNotFound) {
+    return _valuesByEntity[index][[self requestKeyForMetric:metric aggregation:aggregation range:range]];
+  }
+  return nil;
+}
+
+#pragma mark - Query Report
+
+- (NSInteger)numRequestedStats {
+  NSInteger numRequestedStats = 0;
+  for (NSSet *requests in _requestsByEntity) {
+    numRequestedStats += requests.count;
+  }
+  return numRequestedStats;
+}
+
+@end
@@ -0,0 +1,162 @@
+//
+//  FPColumnKernelsTests.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPColumnKernels.h"
+#import <CocoaLumberjack/DDLog.h>
+#import "FPLogging.h"
+#import <Kiwi/Kiwi.h>
+
+SPEC_BEGIN(FPColumnKernelsSpec)
+
+describe(@"FPColumnKernels", ^{
+  
+  NSDecimalNumber *(^dn)(NSString *) = ^(NSString *str) { return [NSDecimalNumber decimalNumberWithString:str]; };
+  NSDecimalNumber *(^decimalNumber)(NSDecimal) = ^(NSDecimal decimal) { return [NSDecimalNumber decimalNumberWithDecimal:decimal]; };
+  
+  // gallons of 9.000-17.999 and prices of 1.999-4.998, with every 11th gallons
+  // value and every 13th price null
+  NSMutableData *(^gallonsColumn)(NSUInteger) = ^(NSUInteger numRows) {
+    NSMutableData *column = [NSMutableData dataWithLength:numRows * sizeof(FPMicros)];
+    FPMicros *values = column.mutableBytes;
+    for (NSUInteger i = 0; i < numRows; i++) {
+      values[i] = i % 11 == 0 ? INT64_MIN : (9000 + (i * 7919) % 9000) * 1000;
+    }
+    return column;
+  };
+  NSMutableData *(^pricesColumn)(NSUInteger) = ^(NSUInteger numRows) {
+    NSMutableData *column = [NSMutableData dataWithLength:numRows * sizeof(FPMicros)];
+    FPMicros *values = column.mutableBytes;
+    for (NSUInteger i = 0; i < numRows; i++) {
+      values[i] = i % 13 == 0 ? INT64_MIN : (1999 + (i * 104729) % 3000) * 1000;
+    }
+    return column;
+  };
+  void (^shouldEqualSummary)(FPColumnSummary, FPColumnSummary) = ^(FPColumnSummary summary, FPColumnSummary expected) {
+    [[theValue(summary.sum.count) should] equal:theValue(expected.sum.count)];
+    [[FPSumDecimalNumber(&summary.sum) should] equal:FPSumDecimalNumber(&expected.sum)];
+    [[decimalNumber(summary.min) should] equal:decimalNumber(expected.min)];
+    [[decimalNumber(summary.max) should] equal:decimalNumber(expected.max)];
+  };
+  
+  it(@"Matches the scalar kernels, including on a ragged tail", ^{
+    for (NSUInteger numRows = 0; numRows < 40; numRows++) {
+      NSData *gallons = gallonsColumn(numRows);
+      NSData *prices = pricesColumn(numRows);
+      shouldEqualSummary(FPColumnSummarizeMicros(gallons.bytes, numRows, INT64_MIN),
+                         FPColumnSummarizeMicrosScalar(gallons.bytes, numRows, INT64_MIN));
+      shouldEqualSummary(FPColumnSummarizeMicrosProducts(gallons.bytes, prices.bytes, numRows, INT64_MIN),
+                         FPColumnSummarizeMicrosProductsScalar(gallons.bytes, prices.bytes, numRows, INT64_MIN));
+    }
+  });
+  
+  it(@"Summarizes products exactly", ^{
+    FPMicros gallons[] = {10000000, 5000000, INT64_MIN, 12000000, 4000000, 3333333};
+    FPMicros prices[] = {3099000, 3299000, 3459000, INT64_MIN, 3499000, 3000001};
+    FPColumnSummary summary = FPColumnSummarizeMicrosProducts(gallons, prices, 6, INT64_MIN);
+    [[theValue(summary.sum.count) should] equal:theValue(4)];
+    [[FPSumDecimalNumber(&summary.sum) should] equal:dn(@"71.481002333333")];
+    [[decimalNumber(summary.min) should] equal:dn(@"10.000002333333")];
+    [[decimalNumber(summary.max) should] equal:dn(@"30.99")];
+  });
+  
+  it(@"Falls back to the scalar kernels when a lane could overflow", ^{
+    FPMicros values[] = {INT64_MAX / 2, INT64_MAX / 2, INT64_MAX / 2, 1, 2, 3, 4, 5};
+    FPColumnSummary summary = FPColumnSummarizeMicros(values, 8, INT64_MIN);
+    shouldEqualSummary(summary, FPColumnSummarizeMicrosScalar(values, 8, INT64_MIN));
+    [[theValue(summary.sum.hasInexactSum) should] beYes];
+    FPMicros lhs[] = {INT64_MAX / 4, 2000000, 3000000, 4000000};
+    FPMicros rhs[] = {8000000, 2000000, 3000000, 4000000};
+    shouldEqualSummary(FPColumnSummarizeMicrosProducts(lhs, rhs, 4, INT64_MIN),
+                       FPColumnSummarizeMicrosProductsScalar(lhs, rhs, 4, INT64_MIN));
+  });
+  
+  it(@"Folds the product lanes into the sum as often as large products need", ^{
+    NSUInteger numRows = 10000;
+    NSMutableData *lhsColumn = gallonsColumn(numRows);
+    NSMutableData *rhsColumn = pricesColumn(numRows);
+    FPMicros *lhs = lhsColumn.mutableBytes;
+    FPMicros *rhs = rhsColumn.mutableBytes;
+    // products of up to ~9 x 10^17, so a lane can only take about 10 rows at a
+    // time, and one product too large for an int64 in the second block
+    for (NSUInteger i = 0; i < numRows; i++) {
+      if (lhs[i] != INT64_MIN) {
+        lhs[i] *= 10000;
+      }
+    }
+    lhs[5000] = INT64_MAX / 4;
+    shouldEqualSummary(FPColumnSummarizeMicrosProducts(lhs, rhs, numRows, INT64_MIN),
+                       FPColumnSummarizeMicrosProductsScalar(lhs, rhs, numRows, INT64_MIN));
+  });
+  
+  // Runs only when asked to, with FP_RUN_BENCHMARKS=1
+  if ([[NSProcessInfo processInfo] environment][@"FP_RUN_BENCHMARKS"]) {
+    context(@"Benchmark", ^{
+      it(@"Totals spent and finds min / max price at 1k, 100k and 1M rows", ^{
+        for (NSNumber *rows in @[@1000, @100000, @1000000]) {
+          NSUInteger numRows = rows.unsignedIntegerValue;
+          NSData *gallons = gallonsColumn(numRows);
+          NSData *prices = pricesColumn(numRows);
+          const FPMicros *gallonValues = gallons.bytes;
+          const FPMicros *priceValues = prices.bytes;
+          NSMutableArray *numGallons = [NSMutableArray arrayWithCapacity:numRows];
+          NSMutableArray *gallonPrices = [NSMutableArray arrayWithCapacity:numRows];
+          for (NSUInteger i = 0; i < numRows; i++) {
+            [numGallons addObject:gallonValues[i] == INT64_MIN ? [NSNull null] : FPDecimalNumberFromMicros(gallonValues[i])];
+            [gallonPrices addObject:priceValues[i] == INT64_MIN ? [NSNull null] : FPDecimalNumberFromMicros(priceValues[i])];
+          }
+          
+          NSDate *start = [NSDate date];
+          NSDecimalNumber *decimalTotal = [NSDecimalNumber zero];
+          NSDecimalNumber *decimalMin = nil;
+          NSDecimalNumber *decimalMax = nil;
+          @autoreleasepool {
+            for (NSUInteger i = 0; i < numRows; i++) {
+              if (numGallons[i] != [NSNull null] && gallonPrices[i] != [NSNull null]) {
+                decimalTotal = [decimalTotal decimalNumberByAdding:[numGallons[i] decimalNumberByMultiplyingBy:gallonPrices[i]]];
+              }
+              if (gallonPrices[i] != [NSNull null]) {
+                if (decimalMin == nil || [gallonPrices[i] compare:decimalMin] == NSOrderedAscending) {
+                  decimalMin = gallonPrices[i];
+                }
+                if (decimalMax == nil || [gallonPrices[i] compare:decimalMax] == NSOrderedDescending) {
+                  decimalMax = gallonPrices[i];
+                }
+              }
+            }
+          }
+          NSTimeInterval decimalTime = [[NSDate date] timeIntervalSinceDate:start];
+          
+          start = [NSDate date];
+          FPColumnSummary scalarSpent = FPColumnSummarizeMicrosProductsScalar(gallonValues, priceValues, numRows, INT64_MIN);
+          FPColumnSummary scalarPrices = FPColumnSummarizeMicrosScalar(priceValues, numRows, INT64_MIN);
+          NSTimeInterval scalarTime = [[NSDate date] timeIntervalSinceDate:start];
+          
+          start = [NSDate date];
+          FPColumnSummary spent = FPColumnSummarizeMicrosProducts(gallonValues, priceValues, numRows, INT64_MIN);
+          FPColumnSummary pricesSummary = FPColumnSummarizeMicros(priceValues, numRows, INT64_MIN);
+          NSTimeInterval vectorTime = [[NSDate date] timeIntervalSinceDate:start];
+          
+          DDLogInfo(@"Spent, min and max price over %lu rows.  NSDecimalNumber: %.4fs.  \
+  Scalar kernels: %.4fs.  Vector kernels: %.4fs.",
+                    (unsigned long)numRows,
+                    decimalTime,
+                    scalarTime,
+                    vectorTime);
+          [[FPSumDecimalNumber(&spent.sum) should] equal:decimalTotal];
+          [[FPSumDecimalNumber(&scalarSpent.sum) should] equal:decimalTotal];
+          [[decimalNumber(pricesSummary.min) should] equal:decimalMin];
+          [[decimalNumber(pricesSummary.max) should] equal:decimalMax];
+          [[decimalNumber(scalarPrices.min) should] equal:decimalMin];
+          [[decimalNumber(scalarPrices.max) should] equal:decimalMax];
+        }
+      });
+    });
+  }
+});
+
+SPEC_END
@@ -0,0 +1,106 @@
+//
+//  FPCostPerMileScannerTests.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPCostPerMileScanner.h"
+#import "FPLogColumns.h"
+#import "FPMonthBoundaries.h"
+#import "FPEnvironmentLog.h"
+#import <PEObjc-Commons/PEUtils.h>
+#import <Kiwi/Kiwi.h>
+
+SPEC_BEGIN(FPCostPerMileScannerSpec)
+
+describe(@"FPCostPerMileScanner", ^{
+  
+  NSDecimalNumber *(^dn)(NSString *) = ^(NSString *str) { return [NSDecimalNumber decimalNumberWithString:str]; };
+  NSCalendar *utcCalendar = [[NSCalendar alloc] initWithCalendarIdentifier:NSCalendarIdentifierGregorian];
+  utcCalendar.timeZone = [NSTimeZone timeZoneWithName:@"UTC"];
+  NSDate *(^date)(NSInteger, NSInteger) = ^(NSInteger month, NSInteger day) {
+    NSDateComponents *components = [[NSDateComponents alloc] init];
+    components.year = 2014;
+    components.month = month;
+    components.day = day;
+    return [utcCalendar dateFromComponents:components];
+  };
+  FPEnvironmentLog *(^odometerLog)(NSString *, NSDate *) = ^(NSString *odometer, NSDate *logDate) {
+    return [FPEnvironmentLog envLogWithOdometer:odometer ? dn(odometer) : nil
+                                 reportedAvgMpg:nil
+                                 reportedAvgMph:nil
+                            reportedOutsideTemp:nil
+                                        logDate:logDate
+                                    reportedDte:nil
+                                      mediaType:nil];
+  };
+  FPLogColumns *(^gasLogColumns)(NSArray *) = ^(NSArray *rows) {
+    // rows are [num gallons, gallon price, purchased at], in date order
+    FPLogColumns *columns = [[FPLogColumns alloc] initWithCapacity:rows.count];
+    for (NSArray *row in rows) {
+      [columns appendRowWithPurchasedAtMillis:[[PEUtils millisecondsFromDate:row[2]] longLongValue]
+                                   numGallons:dn(row[0])
+                                  gallonPrice:dn(row[1])
+                                       octane:@87
+                                     isDiesel:NO
+                                     odometer:nil];
+    }
+    return columns;
+  };
+  
+  __block FPCostPerMileScanner *scanner;
+  beforeEach(^{
+    // odometer logs deliberately out of order; February only has a single
+    // odometer reading, so no miles were driven within it
+    NSArray *envlogs = @[odometerLog(@"1500", date(3, 31)),
+                         odometerLog(@"1100", date(1, 20)),
+                         odometerLog(nil, date(1, 1)),
+                         odometerLog(@"1200", date(2, 5)),
+                         odometerLog(@"1000", date(1, 2)),
+                         odometerLog(@"1300", date(3, 1))];
+    FPLogColumns *columns = gasLogColumns(@[@[@"10", @"3", date(1, 1)],
+                                            @[@"5", @"4", date(1, 10)],
+                                            @[@"2", @"5", date(1, 25)],
+                                            @[@"10", @"4", date(3, 15)]]);
+    scanner = [[FPCostPerMileScanner alloc] initWithOdometerLogs:envlogs
+                                                   gasLogColumns:columns
+                                                     gasLogRange:NSMakeRange(0, columns.count)
+                                                  costPerMileBlk:^NSDecimalNumber *(NSDecimalNumber *milesDriven, NSDecimalNumber *spentOnGas) {
+                                                    if (spentOnGas == nil || [milesDriven compare:[NSDecimalNumber zero]] == NSOrderedSame) {
+                                                      return nil;
+                                                    }
+                                                    return [spentOnGas decimalNumberByDividingBy:milesDriven];
+                                                  }];
+  });
+  
+  it(@"Computes the cost per mile across all of the logs", ^{
+    // 500 miles; the January 1st purchase predates the first odometer reading
+    [[[scanner costPerMile] should] equal:dn(@"0.14")];
+  });
+  
+  it(@"Computes a monthly series in a single pass", ^{
+    FPMonthBoundaries *boundaries = [FPMonthBoundaries boundariesForCalendar:utcCalendar];
+    NSArray *dataset = [scanner monthlyDataSetWithBoundaries:boundaries beforeDate:date(4, 1) onOrAfterDate:date(1, 1)];
+    [[dataset should] equal:@[@[date(1, 1), dn(@"0.3")], @[date(3, 1), dn(@"0.2")]]];
+    dataset = [scanner monthlyDataSetWithBoundaries:boundaries beforeDate:date(3, 1) onOrAfterDate:date(1, 15)];
+    [[dataset should] equal:@[@[date(1, 1), dn(@"0.3")]]];
+  });
+  
+  it(@"Has nothing to report without odometer readings", ^{
+    FPLogColumns *columns = gasLogColumns(@[@[@"10", @"3", date(1, 2)]]);
+    FPCostPerMileScanner *emptyScanner = [[FPCostPerMileScanner alloc] initWithOdometerLogs:@[odometerLog(nil, date(1, 1))]
+                                                                              gasLogColumns:columns
+                                                                                gasLogRange:NSMakeRange(0, columns.count)
+                                                                             costPerMileBlk:^NSDecimalNumber *(NSDecimalNumber *milesDriven, NSDecimalNumber *spentOnGas) {
+                                                                               return spentOnGas;
+                                                                             }];
+    [[emptyScanner costPerMile] shouldBeNil];
+    [[[emptyScanner monthlyDataSetWithBoundaries:[FPMonthBoundaries boundariesForCalendar:utcCalendar]
+                                      beforeDate:date(4, 1)
+                                   onOrAfterDate:date(1, 1)] should] beEmpty];
+  });
+});
+
+SPEC_END
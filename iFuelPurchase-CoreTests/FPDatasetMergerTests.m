@@ -0,0 +1,67 @@
+//
+//  FPDatasetMergerTests.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPDatasetMerger.h"
+#import "FPDataset.h"
+#import <Kiwi/Kiwi.h>
+
+SPEC_BEGIN(FPDatasetMergerSpec)
+
+describe(@"FPDatasetMerger", ^{
+  
+  NSDecimalNumber *(^dn)(NSString *) = ^(NSString *str) { return [NSDecimalNumber decimalNumberWithString:str]; };
+  NSDate *(^day)(NSInteger) = ^(NSInteger n) { return [NSDate dateWithTimeIntervalSinceReferenceDate:n * 86400]; };
+  
+  it(@"Merges sorted datasets into a single sorted dataset", ^{
+    NSArray *merged = [FPDatasetMerger averagedMergeOfDatasets:@[@[@[day(1), dn(@"1")], @[day(4), dn(@"4")]],
+                                                                 @[],
+                                                                 @[@[day(2), dn(@"2")], @[day(3), dn(@"3")], @[day(5), dn(@"5")]]]
+                                                      valueBlk:nil];
+    [[merged should] equal:@[@[day(1), dn(@"1")],
+                             @[day(2), dn(@"2")],
+                             @[day(3), dn(@"3")],
+                             @[day(4), dn(@"4")],
+                             @[day(5), dn(@"5")]]];
+  });
+  
+  it(@"Weights every dataset equally when datapoints share a date", ^{
+    NSArray *merged = [FPDatasetMerger averagedMergeOfDatasets:@[@[@[day(1), dn(@"30")]],
+                                                                 @[@[day(1), dn(@"20")]],
+                                                                 @[@[day(1), dn(@"10")], @[day(2), dn(@"7")]]]
+                                                      valueBlk:nil];
+    // pairwise halving would have given ((30 + 20) / 2 + 10) / 2 = 17.5
+    [[merged should] equal:@[@[day(1), dn(@"20")], @[day(2), dn(@"7")]]];
+  });
+  
+  it(@"Maps values through the value block and drops dates without values", ^{
+    NSArray *merged = [FPDatasetMerger averagedMergeOfDatasets:@[@[@[day(1), @3], @[day(2), [NSNull null]]],
+                                                                 @[@[day(1), @4]]]
+                                                      valueBlk:^NSDecimalNumber *(id value) {
+                                                        return value == [NSNull null] ? nil : [NSDecimalNumber decimalNumberWithDecimal:[value decimalValue]];
+                                                      }];
+    [[merged should] equal:@[@[day(1), dn(@"3.5")]]];
+    [[[FPDatasetMerger averagedMergeOfDatasets:@[] valueBlk:nil] should] beEmpty];
+  });
+  
+  it(@"Merges FPDatasets without boxing, to the same result", ^{
+    NSArray *datasets = @[@[@[day(1), dn(@"30")], @[day(3), dn(@"2.5")]],
+                          @[],
+                          @[@[day(1), dn(@"20")], @[day(2), dn(@"7")], @[day(3), dn(@"1")]],
+                          @[@[day(1), dn(@"10")]]];
+    NSMutableArray *typedDatasets = [NSMutableArray array];
+    for (NSArray *dataset in datasets) {
+      [typedDatasets addObject:dataset.count > 0 ? [FPDataset datasetWithDatapoints:dataset] : dataset];
+    }
+    NSArray *merged = [FPDatasetMerger averagedMergeOfDatasets:typedDatasets valueBlk:nil];
+    [[merged should] beKindOfClass:[FPDataset class]];
+    [[merged should] equal:[FPDatasetMerger averagedMergeOfDatasets:datasets valueBlk:nil]];
+    [[merged should] equal:@[@[day(1), dn(@"20")], @[day(2), dn(@"7")], @[day(3), dn(@"1.75")]]];
+  });
+});
+
+SPEC_END
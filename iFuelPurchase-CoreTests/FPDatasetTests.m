@@ -0,0 +1,86 @@
+//
+//  FPDatasetTests.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPDataset.h"
+#import <Kiwi/Kiwi.h>
+
+SPEC_BEGIN(FPDatasetSpec)
+
+describe(@"FPDataset", ^{
+  
+  NSDecimalNumber *(^dn)(NSString *) = ^(NSString *str) { return [NSDecimalNumber decimalNumberWithString:str]; };
+  NSDate *(^day)(NSInteger) = ^(NSInteger n) { return [NSDate dateWithTimeIntervalSince1970:n * 86400]; };
+  
+  __block FPDataset *dataset;
+  beforeEach(^{
+    dataset = [[FPDataset alloc] initWithCapacity:4];
+    [dataset appendValue:dn(@"3.859") date:day(1)];
+    [dataset appendValue:dn(@"2.999") date:day(2)];
+    [dataset appendValue:[dn(@"10") decimalNumberByDividingBy:dn(@"3")] date:day(4)];
+    [dataset appendValue:dn(@"-0.5") date:day(8)];
+  });
+  
+  it(@"Holds its datapoints unboxed, and boxes them on demand", ^{
+    [[theValue(dataset.count) should] equal:theValue(4)];
+    [[theValue([dataset millisAtIndex:1]) should] equal:theValue(2 * 86400 * 1000LL)];
+    [[theValue([dataset millis][3]) should] equal:theValue(8 * 86400 * 1000LL)];
+    [[[dataset dateAtIndex:0] should] equal:day(1)];
+    [[[dataset valueAtIndex:0] should] equal:dn(@"3.859")];
+    // values are kept exactly, as NSDecimalNumber datapoints are
+    [[[dataset valueAtIndex:2] should] equal:[dn(@"10") decimalNumberByDividingBy:dn(@"3")]];
+    [[dataset should] equal:@[@[day(1), dn(@"3.859")],
+                              @[day(2), dn(@"2.999")],
+                              @[day(4), [dn(@"10") decimalNumberByDividingBy:dn(@"3")]],
+                              @[day(8), dn(@"-0.5")]]];
+    [[dataset[3] should] equal:@[day(8), dn(@"-0.5")]];
+    [[[dataset lastObject] should] equal:@[day(8), dn(@"-0.5")]];
+    [[theBlock(^{ [dataset millisAtIndex:4]; }) should] raiseWithName:NSRangeException];
+    [[theBlock(^{ [dataset objectAtIndex:4]; }) should] raiseWithName:NSRangeException];
+  });
+  
+  it(@"Enumerates its datapoints, boxed or not", ^{
+    NSMutableArray *boxed = [NSMutableArray array];
+    for (NSArray *dp in dataset) {
+      [boxed addObject:dp];
+    }
+    [[boxed should] equal:dataset];
+    __block NSUInteger numVisited = 0;
+    [dataset enumerateDatapointsUsingBlock:^(FPEpochMillis millis, NSDecimal value, NSUInteger index, BOOL *stop) {
+      [[theValue(millis) should] equal:theValue([dataset millisAtIndex:index])];
+      [[[NSDecimalNumber decimalNumberWithDecimal:value] should] equal:[dataset valueAtIndex:index]];
+      numVisited++;
+      *stop = index == 2;
+    }];
+    [[theValue(numVisited) should] equal:theValue(3)];
+  });
+  
+  it(@"Slices without copying", ^{
+    FPDataset *slice = [dataset subarrayWithRange:NSMakeRange(1, 2)];
+    [[slice should] beKindOfClass:[FPDataset class]];
+    [[theValue((BOOL)([slice millis] == [dataset millis] + 1)) should] beYes];
+    [[theValue((BOOL)([slice values] == [dataset values] + 1)) should] beYes];
+    [[slice should] equal:@[@[day(2), dn(@"2.999")], @[day(4), [dn(@"10") decimalNumberByDividingBy:dn(@"3")]]]];
+    [[[slice subarrayWithRange:NSMakeRange(1, 1)] should] equal:@[@[day(4), [dn(@"10") decimalNumberByDividingBy:dn(@"3")]]]];
+    [[theBlock(^{ [slice subarrayWithRange:NSMakeRange(1, 2)]; }) should] raiseWithName:NSRangeException];
+    [[[dataset datasetBeforeDate:day(8) onOrAfterDate:day(2)] should] equal:slice];
+    [[[dataset datasetBeforeDate:nil onOrAfterDate:day(3)] should] equal:@[@[day(4), [dn(@"10") decimalNumberByDividingBy:dn(@"3")]],
+                                                                           @[day(8), dn(@"-0.5")]]];
+    [[[dataset datasetBeforeDate:day(1) onOrAfterDate:nil] should] beEmpty];
+    [[[dataset datasetBeforeDate:day(2) onOrAfterDate:day(3)] should] beEmpty];
+    [[[dataset copy] should] equal:dataset];
+  });
+  
+  it(@"Converts legacy datasets", ^{
+    FPDataset *converted = [FPDataset datasetWithDatapoints:@[@[day(1), dn(@"1.5")], @[day(2), [NSNull null]], @[day(3), @4]]];
+    [[converted should] equal:@[@[day(1), dn(@"1.5")], @[day(3), dn(@"4")]]];
+    [[[FPDataset datasetWithDatapoints:dataset] should] beIdenticalTo:dataset];
+    [[[FPDataset datasetWithDatapoints:@[]] should] beEmpty];
+  });
+});
+
+SPEC_END
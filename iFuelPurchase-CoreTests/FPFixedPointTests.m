@@ -0,0 +1,162 @@
+//
+//  FPFixedPointTests.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPFixedPoint.h"
+#import <malloc/malloc.h>
+#import <CocoaLumberjack/DDLog.h>
+#import "FPLogging.h"
+#import <Kiwi/Kiwi.h>
+
+SPEC_BEGIN(FPFixedPointSpec)
+
+NSDecimalNumber *(^_dn)(NSString *) = ^(NSString *str) { return [NSDecimalNumber decimalNumberWithString:str]; };
+
+FPMicros (^_micros)(NSString *) = ^(NSString *str) {
+  FPMicros micros;
+  FPMicrosFromDecimal([_dn(str) decimalValue], &micros);
+  return micros;
+};
+
+describe(@"FPFixedPoint", ^{
+  
+  context(@"Conversions", ^{
+    it(@"Converts decimals with up to 6 places exactly", ^{
+      FPMicros micros;
+      [[theValue(FPMicrosFromDecimal([_dn(@"3.459") decimalValue], &micros)) should] beYes];
+      [[theValue(micros) should] equal:theValue(3459000)];
+      [[theValue(FPMicrosFromDecimal([_dn(@"-0.000001") decimalValue], &micros)) should] beYes];
+      [[theValue(micros) should] equal:theValue(-1)];
+      [[theValue(FPMicrosFromDecimal([_dn(@"1500") decimalValue], &micros)) should] beYes];
+      [[theValue(micros) should] equal:theValue(1500000000)];
+      [[theValue(FPMicrosFromDecimal([[NSDecimalNumber zero] decimalValue], &micros)) should] beYes];
+      [[theValue(micros) should] equal:theValue(0)];
+    });
+    
+    it(@"Rounds half away from zero and reports the conversion as inexact", ^{
+      FPMicros micros;
+      [[theValue(FPMicrosFromDecimal([_dn(@"1.0000005") decimalValue], &micros)) should] beNo];
+      [[theValue(micros) should] equal:theValue(1000001)];
+      [[theValue(FPMicrosFromDecimal([_dn(@"-1.0000005") decimalValue], &micros)) should] beNo];
+      [[theValue(micros) should] equal:theValue(-1000001)];
+      [[theValue(FPMicrosFromDecimal([_dn(@"1.0000004") decimalValue], &micros)) should] beNo];
+      [[theValue(micros) should] equal:theValue(1000000)];
+      [[theValue(FPMicrosFromDecimal([[NSDecimalNumber notANumber] decimalValue], &micros)) should] beNo];
+      [[theValue(FPMicrosFromDecimal([_dn(@"99999999999999999999") decimalValue], &micros)) should] beNo];
+    });
+    
+    it(@"Converts back to decimal numbers", ^{
+      [[FPDecimalNumberFromMicros(54998100) should] equal:_dn(@"54.9981")];
+      [[FPDecimalNumberFromMicros(-1) should] equal:_dn(@"-0.000001")];
+      [[FPDecimalNumberFromMicros(0) should] equal:[NSDecimalNumber zero]];
+    });
+    
+    it(@"Rounds to the decimal places gallons and prices are stored with", ^{
+      [[FPDecimalNumberRoundedToEntryScale(_dn(@"3.4595")) should] equal:_dn(@"3.46")];
+      [[FPDecimalNumberRoundedToEntryScale(_dn(@"12.34549")) should] equal:_dn(@"12.345")];
+      [[FPDecimalNumberRoundedToEntryScale(_dn(@"-0.0005")) should] equal:_dn(@"-0.001")];
+      [[FPDecimalNumberRoundedToEntryScale(_dn(@"3.459")) should] equal:_dn(@"3.459")];
+      [[FPDecimalNumberRoundedToEntryScale(_dn(@"3.459000")) should] equal:_dn(@"3.459")];
+      [FPDecimalNumberRoundedToEntryScale(nil) shouldBeNil];
+    });
+  });
+  
+  context(@"Arithmetic", ^{
+    it(@"Multiplies gallons by price exactly", ^{
+      FPMicros product;
+      [[theValue(FPMicrosMultiply(_micros(@"15.9"), _micros(@"3.459"), &product)) should] beYes];
+      [[FPDecimalNumberFromMicros(product) should] equal:_dn(@"54.9981")];
+      [[theValue(FPMicrosMultiply(_micros(@"0.001"), _micros(@"0.0005"), &product)) should] beNo];
+      [[theValue(product) should] equal:theValue(1)];
+    });
+    
+    it(@"Sums exact and inexact values without losing precision", ^{
+      FPSum sum = FPSumMake();
+      [FPSumAverage(&sum) shouldBeNil];
+      FPSumAddProduct(&sum, _dn(@"15.9"), _dn(@"3.459"));
+      FPSumAddDecimalNumber(&sum, _dn(@"0.1234567"));
+      FPSumAddInteger(&sum, 2);
+      [[theValue(sum.count) should] equal:theValue(3)];
+      [[theValue(sum.hasInexactSum) should] beYes];
+      [[FPSumDecimalNumber(&sum) should] equal:_dn(@"57.1215567")];
+      NSDecimalNumber *expectedAvg = [_dn(@"57.1215567") decimalNumberByDividingBy:_dn(@"3")];
+      [[FPSumAverage(&sum) should] equal:expectedAvg];
+    });
+    
+    it(@"Takes values back out of a sum exactly", ^{
+      FPSum sum = FPSumMake();
+      FPSumAddMicrosProduct(&sum, _micros(@"15.9"), _micros(@"3.459"));
+      FPSumAddMicrosProduct(&sum, _micros(@"0.001"), _micros(@"0.0005"));
+      FPSumAddMicros(&sum, _micros(@"2.5"));
+      FPSumRemoveMicrosProduct(&sum, _micros(@"15.9"), _micros(@"3.459"));
+      [[theValue(sum.count) should] equal:theValue(2)];
+      [[FPSumDecimalNumber(&sum) should] equal:_dn(@"2.5000005")];
+      FPSumRemoveMicrosProduct(&sum, _micros(@"0.001"), _micros(@"0.0005"));
+      FPSumRemoveMicros(&sum, _micros(@"2.5"));
+      [[theValue(sum.count) should] equal:theValue(0)];
+      [[FPSumDecimalNumber(&sum) should] equal:[NSDecimalNumber zero]];
+    });
+  });
+  
+  // Runs only when asked to, with FP_RUN_BENCHMARKS=1
+  if ([[NSProcessInfo processInfo] environment][@"FP_RUN_BENCHMARKS"]) {
+    context(@"Benchmark", ^{
+      it(@"Totals a 100k-log history faster and without per-log allocations", ^{
+        NSInteger numLogs = 100000;
+        NSMutableArray *numGallons = [NSMutableArray arrayWithCapacity:numLogs];
+        NSMutableArray *gallonPrices = [NSMutableArray arrayWithCapacity:numLogs];
+        for (NSInteger i = 0; i < numLogs; i++) {
+          [numGallons addObject:[NSDecimalNumber decimalNumberWithMantissa:(9000 + (i * 7919) % 9000) exponent:-3 isNegative:NO]];
+          [gallonPrices addObject:[NSDecimalNumber decimalNumberWithMantissa:(1999 + (i * 104729) % 3000) exponent:-3 isNegative:NO]];
+        }
+        malloc_statistics_t before, after;
+        
+        NSDecimalNumber *decimalTotal;
+        long decimalBlocks;
+        NSDate *start = [NSDate date];
+        @autoreleasepool {
+          malloc_zone_statistics(NULL, &before);
+          NSDecimalNumber *total = [NSDecimalNumber zero];
+          for (NSInteger i = 0; i < numLogs; i++) {
+            total = [total decimalNumberByAdding:[numGallons[i] decimalNumberByMultiplyingBy:gallonPrices[i]]];
+          }
+          malloc_zone_statistics(NULL, &after);
+          decimalTotal = total;
+          decimalBlocks = (long)after.blocks_in_use - (long)before.blocks_in_use;
+        }
+        NSTimeInterval decimalTime = [[NSDate date] timeIntervalSinceDate:start];
+        
+        NSDecimalNumber *fixedPointTotal;
+        long fixedPointBlocks;
+        start = [NSDate date];
+        @autoreleasepool {
+          malloc_zone_statistics(NULL, &before);
+          FPSum total = FPSumMake();
+          for (NSInteger i = 0; i < numLogs; i++) {
+            FPSumAddProduct(&total, numGallons[i], gallonPrices[i]);
+          }
+          malloc_zone_statistics(NULL, &after);
+          fixedPointTotal = FPSumDecimalNumber(&total);
+          fixedPointBlocks = (long)after.blocks_in_use - (long)before.blocks_in_use;
+        }
+        NSTimeInterval fixedPointTime = [[NSDate date] timeIntervalSinceDate:start];
+        
+        DDLogInfo(@"Total spent over %ld logs.  NSDecimalNumber: %.3fs, %ld live heap blocks.  \
+  FPSum: %.3fs, %ld live heap blocks.",
+                  (long)numLogs,
+                  decimalTime,
+                  decimalBlocks,
+                  fixedPointTime,
+                  fixedPointBlocks);
+        [[fixedPointTotal should] equal:decimalTotal];
+        [[theValue(fixedPointBlocks) should] beLessThan:theValue(decimalBlocks)];
+      });
+    });
+  }
+});
+
+SPEC_END
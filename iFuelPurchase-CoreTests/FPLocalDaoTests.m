@@ -9,17 +9,35 @@
 #import "FPCoordinatorDaoImpl.h"
 #import "FPCoordinatorDao+AdditionsForTesting.h"
 #import "FPLocalDaoImpl.h"
+#import "FPDDLUtils.h"
 #import <FMDB/FMDatabase.h>
+#import <FMDB/FMDatabaseQueue.h>
+#import <FMDB/FMDatabaseAdditions.h>
 #import "FPCoordDaoTestContext.h"
 #import <CocoaLumberjack/DDLog.h>
 #import <CocoaLumberjack/DDASLLogger.h>
 #import <CocoaLumberjack/DDTTYLogger.h>
 #import "FPEnvironmentLog.h"
+#import "FPFuelPurchaseLog.h"
 #import "FPFuelStationType.h"
+#import "FPStats.h"
 #import <Kiwi/Kiwi.h>
 
 //static const int ddLogLevel = LOG_LEVEL_VERBOSE;
 
+@interface FPLocalDaoImpl (PersistDeepForTesting)
+
+- (void)persistDeepFuelPurchaseLogFromRemoteMaster:(FPFuelPurchaseLog *)fuelPurchaseLog
+                                           forUser:(FPUser *)user
+                                                db:(FMDatabase *)db
+                                             error:(PELMDaoErrorBlk)errorBlk;
+
+- (void)refreshMonthlyRollupsWithDb:(FMDatabase *)db error:(PELMDaoErrorBlk)errorBlk;
+
+- (PEUserDbOpBlk)postDeepSaveUserHook;
+
+@end
+
 SPEC_BEGIN(FPLocalDaoSpec)
 
 describe(@"FPLocalDao", ^{
@@ -234,6 +252,332 @@ describe(@"FPLocalDao", ^{
       [[theValue(distance) should] equal:theValue(4)];
     });
   });
+  
+  context(@"Days between fillups", ^{
+    it(@"Counts calendar days between consecutive purchases, in date order", ^{
+      NSTimeZone *newYork = [NSTimeZone timeZoneWithName:@"America/New_York"];
+      NSDateFormatter *dateTimeFormatter = [[NSDateFormatter alloc] init];
+      [dateTimeFormatter setDateFormat:@"MM/dd/yyyy HH:mm"];
+      [dateTimeFormatter setTimeZone:newYork];
+      NSDate *(^saveGasLog)(NSString *) = ^(NSString *purchasedAtStr) {
+        NSDate *purchasedAt = [dateTimeFormatter dateFromString:purchasedAtStr];
+        FPFuelPurchaseLog *fplog = [_coordDao fuelPurchaseLogWithNumGallons:[NSDecimalNumber decimalNumberWithString:@"15.2"]
+                                                                     octane:@87
+                                                                   odometer:nil
+                                                                gallonPrice:[NSDecimalNumber decimalNumberWithString:@"3.85"]
+                                                                 gotCarWash:NO
+                                                   carWashPerGallonDiscount:nil
+                                                                    logDate:purchasedAt
+                                                                   isDiesel:NO];
+        [_coordDao saveNewFuelPurchaseLog:fplog forUser:_user vehicle:_v1 fuelStation:_fs1 error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+        return purchasedAt;
+      };
+      NSDate *d3 = saveGasLog(@"03/20/2015 08:00");
+      saveGasLog(@"04/02/2015 12:00");
+      saveGasLog(@"03/07/2015 10:00");
+      // only 23 hours after the previous fillup (the clocks sprang forward),
+      // but still the next calendar day
+      NSDate *d2 = saveGasLog(@"03/08/2015 10:00");
+      NSArray *dataset = [_coordDao daysBetweenFillupsForVehicle:_v1
+                                                      beforeDate:[dateTimeFormatter dateFromString:@"04/01/2015 00:00"]
+                                                   onOrAfterDate:[dateTimeFormatter dateFromString:@"03/01/2015 00:00"]
+                                                        timeZone:newYork
+                                                           error:[_coordTestCtx newLocalFetchErrBlkMaker]()];
+      [[dataset should] equal:@[@[d2, @1], @[d3, @11]]];
+    });
+  });
+  
+  context(@"Monthly rollups across launches", ^{
+    it(@"Rebuilds the rollups at open when the time zone changed while the app wasn't running", ^{
+      for (NSString *logDateStr in @[@"01/15/2015", @"02/15/2015"]) {
+        FPFuelPurchaseLog *fplog = [_coordDao fuelPurchaseLogWithNumGallons:[NSDecimalNumber decimalNumberWithString:@"15.2"]
+                                                                     octane:@87
+                                                                   odometer:nil
+                                                                gallonPrice:[NSDecimalNumber decimalNumberWithString:@"3.85"]
+                                                                 gotCarWash:NO
+                                                   carWashPerGallonDiscount:nil
+                                                                    logDate:[_dateFormatter dateFromString:logDateStr]
+                                                                   isDiesel:NO];
+        [_coordDao saveNewFuelPurchaseLog:fplog forUser:_user vehicle:_v1 fuelStation:_fs1 error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+      }
+      NSString *timeZoneName = [[NSCalendar currentCalendar] timeZone].name;
+      NSString *countRollupsQry = [NSString stringWithFormat:@"SELECT COUNT(*) FROM %@", TBL_VEHICLE_GAS_MONTHLY_ROLLUP];
+      __block NSInteger numRollups = 0;
+      [_coordDao.databaseQueue inDatabase:^(FMDatabase *db) {
+        numRollups = [db intForQuery:countRollupsQry];
+        // as if the rollups were last keyed while the device was in another
+        // time zone, and their month keys no longer line up
+        [db executeUpdate:[NSString stringWithFormat:@"UPDATE %@ SET %@ = ?", TBL_MONTHLY_ROLLUP_CALENDAR, COL_ROLLUP_TIME_ZONE_NAME],
+         [timeZoneName isEqualToString:@"Asia/Tokyo"] ? @"UTC" : @"Asia/Tokyo"];
+        [db executeUpdate:[NSString stringWithFormat:@"DELETE FROM %@", TBL_VEHICLE_GAS_MONTHLY_ROLLUP]];
+      }];
+      [[theValue(numRollups) should] beGreaterThan:theValue(0)];
+      [_coordDao initializeDatabaseWithError:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+      [_coordDao.databaseQueue inDatabase:^(FMDatabase *db) {
+        [[theValue([db intForQuery:countRollupsQry]) should] equal:theValue(numRollups)];
+        [[[db stringForQuery:[NSString stringWithFormat:@"SELECT %@ FROM %@", COL_ROLLUP_TIME_ZONE_NAME, TBL_MONTHLY_ROLLUP_CALENDAR]] should] equal:timeZoneName];
+      }];
+    });
+  });
+  
+  context(@"Rollup reads between a log write and its rollup refresh", ^{
+    it(@"Finishes the refresh before reading, rather than pair the new logs with old rollups", ^{
+      for (NSString *logDateStr in @[@"01/15/2015", @"02/15/2015"]) {
+        FPFuelPurchaseLog *fplog = [_coordDao fuelPurchaseLogWithNumGallons:[NSDecimalNumber decimalNumberWithString:@"15.2"]
+                                                                     octane:@87
+                                                                   odometer:nil
+                                                                gallonPrice:[NSDecimalNumber decimalNumberWithString:@"3.85"]
+                                                                 gotCarWash:NO
+                                                   carWashPerGallonDiscount:nil
+                                                                    logDate:[_dateFormatter dateFromString:logDateStr]
+                                                                   isDiesel:NO];
+        [_coordDao saveNewFuelPurchaseLog:fplog forUser:_user vehicle:_v1 fuelStation:_fs1 error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+      }
+      // a write committed on its own, its triggers having marked the months
+      // dirty, with the refresh yet to come (as a localModelUtils write leaves it)
+      [_coordDao.databaseQueue inDatabase:^(FMDatabase *db) {
+        [db executeUpdate:[NSString stringWithFormat:@"UPDATE %@ SET %@ = 20", TBL_MAIN_FUELPURCHASE_LOG, COL_FUELPL_NUM_GALLONS]];
+      }];
+      NSDictionary *monthlyGallons = [_coordDao monthlyAggregatesOfGasLogMeasure:FPGasLogMeasureNumGallons
+                                                                      forVehicle:_v1
+                                                                      beforeDate:nil
+                                                                   onOrAfterDate:nil
+                                                                          octane:nil
+                                                                          diesel:NO
+                                                                           error:[_coordTestCtx newLocalFetchErrBlkMaker]()];
+      [[monthlyGallons should] haveCountOf:2];
+      for (FPLogAggregate *aggregate in [monthlyGallons allValues]) {
+        [[aggregate.sum should] equal:[NSDecimalNumber decimalNumberWithString:@"20"]];
+      }
+    });
+  });
+  
+  context(@"Reads during a write transaction", ^{
+    it(@"Reads the last committed state, without waiting, while a deep save is in progress", ^{
+      FPVehicle *vehicle = [_coordDao vehicleWithName:@"Remote Civic"
+                                        defaultOctane:@87
+                                         fuelCapacity:[NSDecimalNumber decimalNumberWithString:@"13.2"]
+                                             isDiesel:NO
+                                        hasDteReadout:NO
+                                        hasMpgReadout:NO
+                                        hasMphReadout:NO
+                                hasOutsideTempReadout:NO
+                                                  vin:nil
+                                                plate:nil];
+      [vehicle setGlobalIdentifier:@"https://example.com/fp/users/1/vehicles/2"];
+      [_coordDao persistDeepVehicleFromRemoteMaster:vehicle forUser:_user error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+      FPFuelStation *fuelstation = [_coordDao fuelStationWithName:@"Remote Sunoco"
+                                                             type:[[FPFuelStationType alloc] initWithIdentifier:@(0) name:@"Other" iconImgName:@""]
+                                                           street:nil
+                                                             city:nil
+                                                            state:nil
+                                                              zip:nil
+                                                         latitude:nil
+                                                        longitude:nil];
+      [fuelstation setGlobalIdentifier:@"https://example.com/fp/users/1/fuelstations/3"];
+      [_coordDao persistDeepFuelStationFromRemoteMaster:fuelstation forUser:_user error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+      NSInteger numLogs = 2000;
+      dispatch_semaphore_t writing = dispatch_semaphore_create(0);
+      dispatch_semaphore_t readsDone = dispatch_semaphore_create(0);
+      dispatch_semaphore_t committed = dispatch_semaphore_create(0);
+      __block BOOL writerGaveUpOnReads = NO;
+      dispatch_async(dispatch_get_global_queue(DISPATCH_QUEUE_PRIORITY_DEFAULT, 0), ^{
+        [_coordDao.databaseQueue inTransaction:^(FMDatabase *db, BOOL *rollback) {
+          for (NSInteger i = 0; i < numLogs; i++) {
+            FPFuelPurchaseLog *fplog = [_coordDao fuelPurchaseLogWithNumGallons:[NSDecimalNumber decimalNumberWithString:@"11.8"]
+                                                                         octane:@87
+                                                                       odometer:nil
+                                                                    gallonPrice:[NSDecimalNumber decimalNumberWithString:@"2.99"]
+                                                                     gotCarWash:NO
+                                                       carWashPerGallonDiscount:nil
+                                                                        logDate:[NSDate dateWithTimeIntervalSince1970:1400000000 + (i * 86400)]
+                                                                       isDiesel:NO];
+            [fplog setGlobalIdentifier:[NSString stringWithFormat:@"https://example.com/fp/users/1/fplogs/%ld", (long)i]];
+            [fplog setVehicleGlobalIdentifier:[vehicle globalIdentifier]];
+            [fplog setFuelStationGlobalIdentifier:[fuelstation globalIdentifier]];
+            [_coordDao persistDeepFuelPurchaseLogFromRemoteMaster:fplog forUser:_user db:db error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+          }
+          [_coordDao refreshMonthlyRollupsWithDb:db error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+          dispatch_semaphore_signal(writing);
+          // the transaction stays open until the reads below are done; were
+          // they queued up behind it, they'd never get done
+          writerGaveUpOnReads = dispatch_semaphore_wait(readsDone, dispatch_time(DISPATCH_TIME_NOW, 30 * NSEC_PER_SEC)) != 0;
+        }];
+        dispatch_semaphore_signal(committed);
+      });
+      FPStats *stats = [[FPStats alloc] initWithLocalDao:_coordDao errorBlk:[_coordTestCtx newLocalFetchErrBlkMaker]()];
+      dispatch_semaphore_wait(writing, DISPATCH_TIME_FOREVER);
+      NSInteger numLogsDuringWrite = [_coordDao numFuelPurchaseLogsForVehicle:vehicle error:[_coordTestCtx newLocalFetchErrBlkMaker]()];
+      NSArray *vehiclesDuringWrite = [_coordDao vehiclesForUser:_user error:[_coordTestCtx newLocalFetchErrBlkMaker]()];
+      // the stats read the rollups, which the writer refreshes in its own
+      // transaction; they mustn't queue up behind it either
+      NSArray *spentDuringWrite = [stats spentOnGasDataSetForVehicle:vehicle year:2014];
+      dispatch_semaphore_signal(readsDone);
+      dispatch_semaphore_wait(committed, DISPATCH_TIME_FOREVER);
+      [[theValue(writerGaveUpOnReads) should] beNo];
+      [[theValue(numLogsDuringWrite) should] equal:theValue(0)];
+      [[vehiclesDuringWrite should] haveCountOf:2];
+      [[spentDuringWrite should] beEmpty];
+      [[[stats spentOnGasDataSetForVehicle:vehicle year:2014] shouldNot] beEmpty];
+      [[theValue([_coordDao numFuelPurchaseLogsForVehicle:vehicle error:[_coordTestCtx newLocalFetchErrBlkMaker]()]) should] equal:theValue(numLogs)];
+    });
+  });
+  
+  context(@"Paging through logs split across the master and main tables", ^{
+    it(@"Returns one page, newest first, merged from both tables", ^{
+      FPVehicle *vehicle = [_coordDao vehicleWithName:@"Remote Civic"
+                                        defaultOctane:@87
+                                         fuelCapacity:[NSDecimalNumber decimalNumberWithString:@"13.2"]
+                                             isDiesel:NO
+                                        hasDteReadout:NO
+                                        hasMpgReadout:NO
+                                        hasMphReadout:NO
+                                hasOutsideTempReadout:NO
+                                                  vin:nil
+                                                plate:nil];
+      [vehicle setGlobalIdentifier:@"https://example.com/fp/users/1/vehicles/2"];
+      [_coordDao persistDeepVehicleFromRemoteMaster:vehicle forUser:_user error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+      FPFuelStation *fuelstation = [_coordDao fuelStationWithName:@"Remote Sunoco"
+                                                             type:[[FPFuelStationType alloc] initWithIdentifier:@(0) name:@"Other" iconImgName:@""]
+                                                           street:nil
+                                                             city:nil
+                                                            state:nil
+                                                              zip:nil
+                                                         latitude:nil
+                                                        longitude:nil];
+      [fuelstation setGlobalIdentifier:@"https://example.com/fp/users/1/fuelstations/3"];
+      [_coordDao persistDeepFuelStationFromRemoteMaster:fuelstation forUser:_user error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+      FPFuelPurchaseLog *(^newLog)(NSInteger) = ^(NSInteger day) {
+        return [_coordDao fuelPurchaseLogWithNumGallons:[NSDecimalNumber decimalNumberWithString:@"11.8"]
+                                                 octane:@87
+                                               odometer:nil
+                                            gallonPrice:[NSDecimalNumber decimalNumberWithString:@"2.99"]
+                                             gotCarWash:NO
+                                carWashPerGallonDiscount:nil
+                                                logDate:[NSDate dateWithTimeIntervalSince1970:1400000000 + (day * 86400)]
+                                               isDiesel:NO];
+      };
+      // odd days are synced (master) logs, even days local (main) ones
+      for (NSInteger day = 1; day <= 6; day++) {
+        FPFuelPurchaseLog *fplog = newLog(day);
+        if (day % 2) {
+          [fplog setGlobalIdentifier:[NSString stringWithFormat:@"https://example.com/fp/users/1/fplogs/%ld", (long)day]];
+          [fplog setVehicleGlobalIdentifier:[vehicle globalIdentifier]];
+          [fplog setFuelStationGlobalIdentifier:[fuelstation globalIdentifier]];
+          [_coordDao persistDeepFuelPurchaseLogFromRemoteMaster:fplog forUser:_user error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+        } else {
+          [_coordDao saveNewFuelPurchaseLog:fplog
+                                    forUser:_user
+                                    vehicle:_v1
+                                fuelStation:_fs1
+                                      error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+        }
+      }
+      NSArray *(^daysOfLogs)(NSArray *) = ^(NSArray *fplogs) {
+        NSMutableArray *days = [NSMutableArray array];
+        for (FPFuelPurchaseLog *fplog in fplogs) {
+          [days addObject:@(((NSInteger)[[fplog purchasedAt] timeIntervalSince1970] - 1400000000) / 86400)];
+        }
+        return days;
+      };
+      NSArray *page = [_coordDao fuelPurchaseLogsForUser:_user pageSize:4 error:[_coordTestCtx newLocalFetchErrBlkMaker]()];
+      [[daysOfLogs(page) should] equal:@[@6, @5, @4, @3]];
+      [[page[1] localMasterIdentifier] shouldNotBeNil];
+      [[page[0] localMainIdentifier] shouldNotBeNil];
+      page = [_coordDao fuelPurchaseLogsForUser:_user
+                                       pageSize:4
+                               beforeDateLogged:[[page lastObject] purchasedAt]
+                                          error:[_coordTestCtx newLocalFetchErrBlkMaker]()];
+      [[daysOfLogs(page) should] equal:@[@2, @1]];
+    });
+  });
+  
+  context(@"Persisting a downloaded account", ^{
+    it(@"Bulk inserts the logs, linked to their vehicles and fuel stations, and keeps the log indexes", ^{
+      FPVehicle *vehicle = [_coordDao vehicleWithName:@"Remote Civic"
+                                        defaultOctane:@87
+                                         fuelCapacity:[NSDecimalNumber decimalNumberWithString:@"13.2"]
+                                             isDiesel:NO
+                                        hasDteReadout:NO
+                                        hasMpgReadout:NO
+                                        hasMphReadout:NO
+                                hasOutsideTempReadout:NO
+                                                  vin:nil
+                                                plate:nil];
+      [vehicle setGlobalIdentifier:@"https://example.com/fp/users/1/vehicles/2"];
+      [_user addVehicle:vehicle];
+      FPFuelStation *fuelstation = [_coordDao fuelStationWithName:@"Remote Sunoco"
+                                                             type:[[FPFuelStationType alloc] initWithIdentifier:@(0) name:@"Other" iconImgName:@""]
+                                                           street:nil
+                                                             city:nil
+                                                            state:nil
+                                                              zip:nil
+                                                         latitude:nil
+                                                        longitude:nil];
+      [fuelstation setGlobalIdentifier:@"https://example.com/fp/users/1/fuelstations/3"];
+      [_user addFuelStation:fuelstation];
+      // enough gas logs for their indexes to be deferred
+      NSInteger numGasLogs = 1200;
+      NSInteger numOdometerLogs = 150;
+      for (NSInteger i = 0; i < numGasLogs; i++) {
+        FPFuelPurchaseLog *fplog = [_coordDao fuelPurchaseLogWithNumGallons:[NSDecimalNumber decimalNumberWithString:@"11.8"]
+                                                                     octane:@87
+                                                                   odometer:nil
+                                                                gallonPrice:[NSDecimalNumber decimalNumberWithString:@"2.99"]
+                                                                 gotCarWash:NO
+                                                   carWashPerGallonDiscount:nil
+                                                                    logDate:[NSDate dateWithTimeIntervalSince1970:1400000000 + (i * 86400)]
+                                                                   isDiesel:NO];
+        [fplog setGlobalIdentifier:[NSString stringWithFormat:@"https://example.com/fp/users/1/fplogs/%ld", (long)i]];
+        [fplog setVehicleGlobalIdentifier:[vehicle globalIdentifier]];
+        [fplog setFuelStationGlobalIdentifier:[fuelstation globalIdentifier]];
+        [_user addFuelPurchaseLog:fplog];
+      }
+      for (NSInteger i = 0; i < numOdometerLogs; i++) {
+        FPEnvironmentLog *envlog = [_coordDao environmentLogWithOdometer:[NSDecimalNumber decimalNumberWithString:[NSString stringWithFormat:@"%ld", (long)(1000 + i)]]
+                                                          reportedAvgMpg:nil
+                                                          reportedAvgMph:nil
+                                                     reportedOutsideTemp:nil
+                                                                 logDate:[NSDate dateWithTimeIntervalSince1970:1400000000 + (i * 86400)]
+                                                             reportedDte:nil];
+        [envlog setGlobalIdentifier:[NSString stringWithFormat:@"https://example.com/fp/users/1/envlogs/%ld", (long)i]];
+        [envlog setVehicleGlobalIdentifier:[vehicle globalIdentifier]];
+        [_user addEnvironmentLog:envlog];
+      }
+      NSArray *(^logIndexes)(void) = ^{
+        NSMutableArray *indexes = [NSMutableArray array];
+        [_coordDao.databaseQueue inDatabase:^(FMDatabase *db) {
+          FMResultSet *rs = [db executeQuery:@"SELECT sql FROM sqlite_master WHERE type = 'index' AND tbl_name IN (?, ?) AND sql IS NOT NULL ORDER BY name",
+                             TBL_MASTER_FUELPURCHASE_LOG, TBL_MASTER_ENV_LOG];
+          while ([rs next]) {
+            [indexes addObject:[rs stringForColumn:@"sql"]];
+          }
+          [rs close];
+        }];
+        return indexes;
+      };
+      NSArray *indexesBefore = logIndexes();
+      [_coordDao.databaseQueue inTransaction:^(FMDatabase *db, BOOL *rollback) {
+        [_coordDao postDeepSaveUserHook](_user, db, [_coordTestCtx newLocalSaveErrBlkMaker]());
+      }];
+      [[indexesBefore shouldNot] beEmpty];
+      [[logIndexes() should] equal:indexesBefore];
+      [[theValue([_coordDao numFuelPurchaseLogsForVehicle:vehicle error:[_coordTestCtx newLocalFetchErrBlkMaker]()]) should] equal:theValue(numGasLogs)];
+      [[theValue([_coordDao numFuelPurchaseLogsForFuelStation:fuelstation error:[_coordTestCtx newLocalFetchErrBlkMaker]()]) should] equal:theValue(numGasLogs)];
+      [[theValue([_coordDao numEnvironmentLogsForVehicle:vehicle error:[_coordTestCtx newLocalFetchErrBlkMaker]()]) should] equal:theValue(numOdometerLogs)];
+      // every log got the local ID of its own row
+      NSMutableSet *localIds = [NSMutableSet set];
+      for (FPFuelPurchaseLog *fplog in [_user fuelPurchaseLogs]) {
+        [[fplog localMasterIdentifier] shouldNotBeNil];
+        [localIds addObject:[fplog localMasterIdentifier]];
+      }
+      [[localIds should] haveCountOf:numGasLogs];
+      FPFuelPurchaseLog *newestLog = [[_coordDao fuelPurchaseLogsForVehicle:vehicle
+                                                                   pageSize:1
+                                                                      error:[_coordTestCtx newLocalFetchErrBlkMaker]()] firstObject];
+      [[[newestLog localMasterIdentifier] should] equal:[[[_user fuelPurchaseLogs] lastObject] localMasterIdentifier]];
+    });
+  });
 });
 
 SPEC_END
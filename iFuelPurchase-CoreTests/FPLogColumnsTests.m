@@ -0,0 +1,83 @@
+//
+//  FPLogColumnsTests.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPLogColumns.h"
+#import <PEObjc-Commons/PEUtils.h>
+#import <Kiwi/Kiwi.h>
+
+SPEC_BEGIN(FPLogColumnsSpec)
+
+describe(@"FPLogColumns", ^{
+  
+  NSDecimalNumber *(^dn)(NSString *) = ^(NSString *str) { return [NSDecimalNumber decimalNumberWithString:str]; };
+  NSDate *(^date)(NSInteger) = ^(NSInteger day) {
+    return [NSDate dateWithTimeIntervalSince1970:(day * 86400)];
+  };
+  
+  __block FPLogColumns *columns;
+  beforeEach(^{
+    columns = [[FPLogColumns alloc] init];
+    void (^append)(NSInteger, NSString *, NSString *, NSNumber *, BOOL) =
+      ^(NSInteger day, NSString *numGallons, NSString *gallonPrice, NSNumber *octane, BOOL isDiesel) {
+        [columns appendRowWithPurchasedAtMillis:[[PEUtils millisecondsFromDate:date(day)] longLongValue]
+                                     numGallons:numGallons ? dn(numGallons) : nil
+                                    gallonPrice:gallonPrice ? dn(gallonPrice) : nil
+                                         octane:octane
+                                       isDiesel:isDiesel
+                                       odometer:nil];
+      };
+    append(1, @"10", @"3.099", @87, NO);
+    append(2, @"5", @"3.299", @89, NO);
+    append(2, @"8.5", nil, @87, NO);
+    append(3, @"12", @"2.899", nil, YES);
+    append(5, @"4", @"3.499", @87, NO);
+  });
+  
+  it(@"Finds date ranges by binary search", ^{
+    [[theValue(columns.count) should] equal:theValue(5)];
+    NSRange range = [columns rangeOfRowsBeforeDate:date(3) onOrAfterDate:date(2)];
+    [[theValue(range) should] equal:theValue(NSMakeRange(1, 2))];
+    range = [columns rangeOfRowsBeforeDate:nil onOrAfterDate:date(3)];
+    [[theValue(range) should] equal:theValue(NSMakeRange(3, 2))];
+    range = [columns rangeOfRowsBeforeDate:date(1) onOrAfterDate:nil];
+    [[theValue(range.length) should] equal:theValue(0)];
+    range = [columns rangeOfRowsBeforeMillis:[[PEUtils millisecondsFromDate:date(5)] longLongValue]
+                                 afterMillis:[[PEUtils millisecondsFromDate:date(1)] longLongValue]];
+    [[theValue(range) should] equal:theValue(NSMakeRange(1, 3))];
+  });
+  
+  it(@"Sums a measure exactly, skipping rows that don't carry it", ^{
+    FPSum sum = [columns sumOfMeasure:FPGasLogMeasureSpent inRange:NSMakeRange(0, columns.count)];
+    [[theValue(sum.count) should] equal:theValue(4)];
+    [[FPSumDecimalNumber(&sum) should] equal:dn(@"96.269")];
+    sum = [columns sumOfMeasure:FPGasLogMeasureNumGallons inRange:NSMakeRange(1, 2)];
+    [[FPSumDecimalNumber(&sum) should] equal:dn(@"13.5")];
+  });
+  
+  it(@"Aggregates with the same octane and diesel filtering as the DAO", ^{
+    NSRange all = NSMakeRange(0, columns.count);
+    FPLogAggregate *aggregate = [columns aggregateOfMeasure:FPGasLogMeasureGallonPrice inRange:all octane:@87 diesel:NO];
+    [[theValue(aggregate.numLogs) should] equal:theValue(3)];
+    [[theValue(aggregate.count) should] equal:theValue(2)];
+    [[aggregate.sum should] equal:dn(@"6.598")];
+    [[aggregate.min should] equal:dn(@"3.099")];
+    [[aggregate.max should] equal:dn(@"3.499")];
+    aggregate = [columns aggregateOfMeasure:FPGasLogMeasureGallonPrice inRange:all octane:nil diesel:YES];
+    [[theValue(aggregate.numLogs) should] equal:theValue(1)];
+    [[aggregate.min should] equal:dn(@"2.899")];
+    aggregate = [columns aggregateOfMeasure:FPGasLogMeasureSpent inRange:all octane:nil diesel:NO];
+    [[theValue(aggregate.numLogs) should] equal:theValue(5)];
+    [[aggregate.min should] equal:dn(@"13.996")];
+    [[aggregate.max should] equal:dn(@"34.788")];
+    aggregate = [columns aggregateOfMeasure:FPGasLogMeasureSpent inRange:NSMakeRange(0, 0) octane:nil diesel:NO];
+    [[theValue(aggregate.numLogs) should] equal:theValue(0)];
+    [aggregate.min shouldBeNil];
+  });
+});
+
+SPEC_END
@@ -0,0 +1,65 @@
+//
+//  FPMonthBoundariesTests.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPMonthBoundaries.h"
+#import <Kiwi/Kiwi.h>
+
+SPEC_BEGIN(FPMonthBoundariesSpec)
+
+describe(@"FPMonthBoundaries", ^{
+  
+  NSCalendar *(^calendarInZone)(NSString *) = ^(NSString *zoneName) {
+    NSCalendar *calendar = [[NSCalendar alloc] initWithCalendarIdentifier:NSCalendarIdentifierGregorian];
+    calendar.timeZone = [NSTimeZone timeZoneWithName:zoneName];
+    return calendar;
+  };
+  NSInteger (^calendarMonthKey)(NSCalendar *, NSDate *) = ^(NSCalendar *calendar, NSDate *date) {
+    NSDateComponents *comps = [calendar components:NSCalendarUnitYear|NSCalendarUnitMonth fromDate:date];
+    return (comps.year * 12) + comps.month;
+  };
+  
+  it(@"Agrees with NSCalendar on month keys and month starts", ^{
+    NSCalendar *calendar = calendarInZone(@"America/New_York");
+    FPMonthBoundaries *boundaries = [FPMonthBoundaries boundariesForCalendar:calendar];
+    for (NSTimeInterval t = 0; t < 4102444800; t += 86400 * 7 + 3599) {
+      NSDate *date = [NSDate dateWithTimeIntervalSince1970:t];
+      [[theValue([boundaries monthKeyForDate:date]) should] equal:theValue(calendarMonthKey(calendar, date))];
+    }
+    NSDateComponents *comps = [[NSDateComponents alloc] init];
+    comps.year = 2014;
+    comps.month = 3;
+    comps.day = 1;
+    NSDate *firstOfMarch = [calendar dateFromComponents:comps];
+    NSInteger monthKey = [boundaries monthKeyForYear:2014 month:3];
+    [[[boundaries firstDayOfMonthKey:monthKey] should] equal:firstOfMarch];
+    [[theValue([boundaries monthKeyForMillis:FPEpochMillisFromDate(firstOfMarch)]) should] equal:theValue(monthKey)];
+    [[theValue([boundaries monthKeyForMillis:FPEpochMillisFromDate(firstOfMarch) - 1]) should] equal:theValue(monthKey - 1)];
+  });
+  
+  it(@"Falls back to NSCalendar outside of the table", ^{
+    NSCalendar *calendar = calendarInZone(@"UTC");
+    FPMonthBoundaries *boundaries = [FPMonthBoundaries boundariesForCalendar:calendar];
+    NSDate *date = [NSDate dateWithTimeIntervalSince1970:-86400 * 400];
+    [[theValue([boundaries monthKeyForDate:date]) should] equal:theValue(calendarMonthKey(calendar, date))];
+    [[theValue([boundaries firstMillisOfMonthKey:[boundaries monthKeyForYear:1969 month:1]]) should]
+     equal:theValue((FPEpochMillis)-31536000000)];
+  });
+  
+  it(@"Rebuilds the shared table when the time zone changes", ^{
+    FPMonthBoundaries *utc = [FPMonthBoundaries boundariesForCalendar:calendarInZone(@"UTC")];
+    [[[FPMonthBoundaries boundariesForCalendar:calendarInZone(@"UTC")] should] beIdenticalTo:utc];
+    FPMonthBoundaries *tokyo = [FPMonthBoundaries boundariesForCalendar:calendarInZone(@"Asia/Tokyo")];
+    [[tokyo shouldNot] beIdenticalTo:utc];
+    [[theValue([tokyo matchesCalendar:utc.calendar]) should] beNo];
+    NSInteger monthKey = [utc monthKeyForYear:2014 month:5];
+    [[theValue([utc firstMillisOfMonthKey:monthKey] - [tokyo firstMillisOfMonthKey:monthKey]) should]
+     equal:theValue((FPEpochMillis)9 * 3600 * 1000)];
+  });
+});
+
+SPEC_END
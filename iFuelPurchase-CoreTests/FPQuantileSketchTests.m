@@ -0,0 +1,109 @@
+//
+//  FPQuantileSketchTests.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPQuantileSketch.h"
+#import <Kiwi/Kiwi.h>
+
+SPEC_BEGIN(FPQuantileSketchSpec)
+
+describe(@"FPQuantileSketch", ^{
+  
+  // gallon prices of 1.999-4.998
+  double (^price)(NSUInteger) = ^(NSUInteger i) { return (1999 + (i * 104729) % 3000) / 1000.0; };
+  
+  // the fraction of the values that are <= value; values must be sorted
+  double (^rankOf)(double, double *, NSUInteger) = ^(double value, double *values, NSUInteger count) {
+    NSUInteger lo = 0, hi = count;
+    while (lo < hi) {
+      NSUInteger mid = (lo + hi) / 2;
+      if (values[mid] <= value) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+    return (double)lo / count;
+  };
+  
+  it(@"Is exact up to k values", ^{
+    FPQuantileSketch *sketch = [[FPQuantileSketch alloc] init];
+    [[theValue((BOOL)isnan([sketch quantile:0.5])) should] beYes];
+    [[sketch decimalNumberForQuantile:0.5] shouldBeNil];
+    for (NSString *value in @[@"3.129", @"2.859", @"3.699", @"3.489", @"3.059", @"3.999"]) {
+      [sketch addValue:[value doubleValue]];
+    }
+    [[theValue(sketch.count) should] equal:theValue(6)];
+    [[[sketch decimalNumberForQuantile:0.1] should] equal:[NSDecimalNumber decimalNumberWithString:@"2.859"]];
+    [[[sketch decimalNumberForQuantile:0.5] should] equal:[NSDecimalNumber decimalNumberWithString:@"3.129"]];
+    [[[sketch decimalNumberForQuantile:0.9] should] equal:[NSDecimalNumber decimalNumberWithString:@"3.999"]];
+    [[[sketch decimalNumberForQuantile:0.0] should] equal:[NSDecimalNumber decimalNumberWithString:@"2.859"]];
+    [[[sketch decimalNumberForQuantile:1.0] should] equal:[NSDecimalNumber decimalNumberWithString:@"3.999"]];
+  });
+  
+  it(@"Stays small and accurate over many values, merged or not", ^{
+    NSUInteger numValues = 100000;
+    NSMutableData *sorted = [NSMutableData dataWithLength:numValues * sizeof(double)];
+    double *values = sorted.mutableBytes;
+    FPQuantileSketch *sketch = [[FPQuantileSketch alloc] init];
+    NSMutableArray *monthSketches = [NSMutableArray array];
+    for (NSUInteger m = 0; m < 12; m++) {
+      [monthSketches addObject:[[FPQuantileSketch alloc] init]];
+    }
+    for (NSUInteger i = 0; i < numValues; i++) {
+      values[i] = price(i);
+      [sketch addValue:values[i]];
+      [monthSketches[i % 12] addValue:values[i]];
+    }
+    FPQuantileSketch *merged = [[FPQuantileSketch alloc] init];
+    for (FPQuantileSketch *monthSketch in monthSketches) {
+      [merged mergeSketch:monthSketch];
+    }
+    qsort_b(values, numValues, sizeof(double), ^int(const void *lhs, const void *rhs) {
+      double a = *(const double *)lhs, b = *(const double *)rhs;
+      return a < b ? -1 : (a > b ? 1 : 0);
+    });
+    [[theValue(merged.count) should] equal:theValue(numValues)];
+    [[theValue(sketch.numRetained) should] beLessThan:theValue(3 * FPQuantileSketchDefaultK)];
+    [[theValue(merged.numRetained) should] beLessThan:theValue(3 * FPQuantileSketchDefaultK)];
+    for (NSNumber *quantile in @[@0.1, @0.5, @0.9]) {
+      double q = quantile.doubleValue;
+      [[theValue(fabs(rankOf([sketch quantile:q], values, numValues) - q)) should] beLessThan:theValue(0.01)];
+      [[theValue(fabs(rankOf([merged quantile:q], values, numValues) - q)) should] beLessThan:theValue(0.01)];
+    }
+    [[theValue([merged quantile:0.0]) should] equal:theValue(values[0])];
+    [[theValue([merged quantile:1.0]) should] equal:theValue(values[numValues - 1])];
+  });
+  
+  it(@"Round-trips through its data representation", ^{
+    FPQuantileSketch *sketch = [[FPQuantileSketch alloc] initWithK:16];
+    for (NSUInteger i = 0; i < 1000; i++) {
+      [sketch addValue:price(i)];
+    }
+    FPQuantileSketch *copy = [[FPQuantileSketch alloc] initWithData:[sketch dataRepresentation]];
+    [[theValue(copy.k) should] equal:theValue(16)];
+    [[theValue(copy.count) should] equal:theValue(1000)];
+    [[theValue(copy.numRetained) should] equal:theValue(sketch.numRetained)];
+    [[[copy dataRepresentation] should] equal:[sketch dataRepresentation]];
+    for (NSNumber *quantile in @[@0.1, @0.5, @0.9]) {
+      [[theValue([copy quantile:quantile.doubleValue]) should] equal:theValue([sketch quantile:quantile.doubleValue])];
+    }
+    // adding to the copy carries on just as adding to the original does
+    [copy addValue:2.5];
+    [sketch addValue:2.5];
+    [[[copy dataRepresentation] should] equal:[sketch dataRepresentation]];
+  });
+  
+  it(@"Rejects data that isn't a sketch", ^{
+    NSData *data = [[[FPQuantileSketch alloc] init] dataRepresentation];
+    [[[FPQuantileSketch alloc] initWithData:[data subdataWithRange:NSMakeRange(0, data.length - 1)]] shouldBeNil];
+    [[[FPQuantileSketch alloc] initWithData:[@"not a sketch" dataUsingEncoding:NSUTF8StringEncoding]] shouldBeNil];
+    [[[FPQuantileSketch alloc] initWithData:[NSData data]] shouldBeNil];
+  });
+});
+
+SPEC_END
@@ -0,0 +1,161 @@
+//
+//  FPQueryPlanTests.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPCoordinatorDaoImpl.h"
+#import "FPCoordDaoTestContext.h"
+#import "FPSyntheticDataGenerator.h"
+#import "FPStatsBenchmark.h"
+#import "FPStats.h"
+#import "FPFuelPurchaseLog.h"
+#import "FPEnvironmentLog.h"
+#import "FPDDLUtils.h"
+#import <FMDB/FMDatabase.h>
+#import <FMDB/FMDatabaseQueue.h>
+#import <PELocal-Data/PELMDDL.h>
+#import <Kiwi/Kiwi.h>
+
+SPEC_BEGIN(FPQueryPlanSpec)
+
+describe(@"FPLocalDao query plans", ^{
+  
+  __block FPCoordDaoTestContext *coordTestCtx;
+  __block FPCoordinatorDaoImpl *coordDao;
+  __block FPUser *user;
+  __block NSMutableSet *statements;
+  
+  // Runs every query the DAO issues for the stats (and for saving logs), and
+  // its other fetches (the log lists' pages, the sync and changelog lookups,
+  // the export), over a small fleet, collecting the distinct statements run.
+  beforeAll(^{
+    coordTestCtx = [[FPCoordDaoTestContext alloc] initWithTestBundle:[NSBundle bundleForClass:[self class]]];
+    coordDao = [coordTestCtx newStoreCoord];
+    [coordDao deleteUser:^(NSError *error, int code, NSString *msg) { [coordTestCtx setErrorDeletingUser:YES]; }];
+    user = [coordTestCtx newFreshJoeSmithMaker](coordDao, ^{
+      [[expectFutureValue(theValue([coordTestCtx authTokenReceived])) shouldEventuallyBeforeTimingOutAfter(60)] beYes];
+    });
+    statements = [NSMutableSet set];
+    coordDao.statementObserver = ^(NSString *sql) {
+      @synchronized(statements) {
+        [statements addObject:sql];
+      }
+    };
+    FPSyntheticDataGenerator *generator = [[FPSyntheticDataGenerator alloc] initWithSeed:7];
+    generator.numVehicles = 3;
+    generator.numYears = 2;
+    generator.numFuelStations = 4;
+    [generator populateLocalDao:coordDao forUser:user error:[coordTestCtx newLocalSaveErrBlkMaker]()];
+    PELMDaoErrorBlk errorBlk = [coordTestCtx newLocalFetchErrBlkMaker]();
+    FPStatsBenchmark *benchmark = [[FPStatsBenchmark alloc] initWithStats:[[FPStats alloc] initWithLocalDao:coordDao errorBlk:errorBlk]
+                                                                 localDao:coordDao
+                                                                     user:user
+                                                                  vehicle:[[coordDao vehiclesForUser:user error:errorBlk] firstObject]
+                                                              fuelstation:[[coordDao fuelStationsForUser:user error:errorBlk] firstObject]];
+    benchmark.numIterations = 1;
+    [benchmark run];
+    FPVehicle *vehicle = [[coordDao vehiclesForUser:user error:errorBlk] firstObject];
+    FPFuelStation *fuelstation = [[coordDao fuelStationsForUser:user error:errorBlk] firstObject];
+    // the log lists, a page at a time
+    NSArray *fplogs = [coordDao fuelPurchaseLogsForUser:user pageSize:10 error:errorBlk];
+    [coordDao fuelPurchaseLogsForUser:user pageSize:10 beforeDateLogged:[[fplogs lastObject] purchasedAt] error:errorBlk];
+    fplogs = [coordDao fuelPurchaseLogsForVehicle:vehicle pageSize:10 error:errorBlk];
+    [coordDao fuelPurchaseLogsForVehicle:vehicle pageSize:10 beforeDateLogged:[[fplogs lastObject] purchasedAt] error:errorBlk];
+    fplogs = [coordDao fuelPurchaseLogsForFuelStation:fuelstation pageSize:10 error:errorBlk];
+    [coordDao fuelPurchaseLogsForFuelStation:fuelstation pageSize:10 beforeDateLogged:[[fplogs lastObject] purchasedAt] error:errorBlk];
+    NSArray *envlogs = [coordDao environmentLogsForUser:user pageSize:10 error:errorBlk];
+    [coordDao environmentLogsForUser:user pageSize:10 beforeDateLogged:[[envlogs lastObject] logDate] error:errorBlk];
+    envlogs = [coordDao environmentLogsForVehicle:vehicle pageSize:10 error:errorBlk];
+    [coordDao environmentLogsForVehicle:vehicle pageSize:10 beforeDateLogged:[[envlogs lastObject] logDate] error:errorBlk];
+    // what a sync looks for
+    [coordDao totalNumUnsyncedEntitiesForUser:user];
+    [coordDao totalNumSyncNeededEntitiesForUser:user];
+    [coordDao unsyncedVehiclesForUser:user error:errorBlk];
+    [coordDao unsyncedFuelStationsForUser:user error:errorBlk];
+    [coordDao unsyncedFuelPurchaseLogsForUser:user error:errorBlk];
+    [coordDao unsyncedEnvironmentLogsForUser:user error:errorBlk];
+    [coordDao markVehiclesAsSyncInProgressForUser:user error:errorBlk];
+    [coordDao markFuelStationsAsSyncInProgressForUser:user error:errorBlk];
+    [coordDao markFuelPurchaseLogsAsSyncInProgressForUser:user error:errorBlk];
+    [coordDao markEnvironmentLogsAsSyncInProgressForUser:user error:errorBlk];
+    // what applying a changelog looks up (each entity's master copy, by its
+    // global id)
+    NSString *globalId = @"http://example.com/gasjot/d/users/1/unknown/1";
+    [coordDao masterVehicleWithGlobalId:globalId error:errorBlk];
+    [coordDao masterFuelstationWithGlobalId:globalId error:errorBlk];
+    [coordDao masterFplogWithGlobalId:globalId error:errorBlk];
+    [coordDao masterEnvlogWithGlobalId:globalId error:errorBlk];
+    // the export
+    NSString *exportDir = NSTemporaryDirectory();
+    [coordDao exportWithPathToVehiclesFile:[exportDir stringByAppendingPathComponent:@"vehicles.csv"]
+                           gasStationsFile:[exportDir stringByAppendingPathComponent:@"gasstations.csv"]
+                               gasLogsFile:[exportDir stringByAppendingPathComponent:@"gaslogs.csv"]
+                          odometerLogsFile:[exportDir stringByAppendingPathComponent:@"odometerlogs.csv"]
+                                      user:user
+                                     error:errorBlk];
+    coordDao.statementObserver = nil;
+  });
+  
+  it(@"Never scans a log or rollup table in full", ^{
+    // the entity tables hold a row per vehicle / station / user, the dirty
+    // table only the months touched since the last refresh, which it's read whole
+    // to find, and the calendar table a single row; scanning those is fine
+    NSSet *smallTables = [NSSet setWithObjects:TBL_MASTER_USER, TBL_MAIN_USER,
+                          TBL_MASTER_VEHICLE, TBL_MAIN_VEHICLE,
+                          TBL_MASTER_FUEL_STATION, TBL_MAIN_FUEL_STATION,
+                          TBL_FUEL_STATION_TYPE, TBL_MONTHLY_ROLLUP_DIRTY,
+                          TBL_MONTHLY_ROLLUP_CALENDAR, nil];
+    // a full scan's plan line is "SCAN TABLE <table> [AS <alias>]" (or, from
+    // SQLite 3.36, "SCAN <table or alias>"), with no "USING ... INDEX"
+    NSString *(^fullyScannedTable)(NSString *) = ^NSString *(NSString *detail) {
+      if (![detail hasPrefix:@"SCAN "] || [detail rangeOfString:@" USING "].location != NSNotFound) {
+        return nil;
+      }
+      NSArray *words = [[detail substringFromIndex:5] componentsSeparatedByString:@" "];
+      NSString *scanned = [words[0] isEqualToString:@"TABLE"] && words.count > 1 ? words[1] : words[0];
+      if ([scanned isEqualToString:@"SUBQUERY"] || [scanned isEqualToString:@"CONSTANT"] || [scanned hasPrefix:@"("]) {
+        return nil;
+      }
+      return scanned;
+    };
+    [[theValue(statements.count) should] beGreaterThan:theValue(20)];
+    NSMutableArray *fullScans = [NSMutableArray array];
+    [coordDao.databaseQueue inDatabase:^(FMDatabase *db) {
+      for (NSString *sql in statements) {
+        FMResultSet *rs = [db executeQuery:[@"EXPLAIN QUERY PLAN " stringByAppendingString:sql]];
+        if (!rs) {
+          [fullScans addObject:[NSString stringWithFormat:@"%@ (couldn't explain: %@)", sql, [db lastErrorMessage]]];
+          continue;
+        }
+        while ([rs next]) {
+          NSString *scanned = fullyScannedTable([rs stringForColumn:@"detail"]);
+          if (scanned && ![smallTables containsObject:scanned]) {
+            [fullScans addObject:[NSString stringWithFormat:@"%@ (scans %@)", sql, scanned]];
+          }
+        }
+        [rs close];
+      }
+    }];
+    [[fullScans should] beEmpty];
+  });
+  
+  it(@"Prepares a query once per connection and then reuses it", ^{
+    PELMDaoErrorBlk errorBlk = [coordTestCtx newLocalFetchErrBlkMaker]();
+    [coordDao firstGasLogForUser:user octane:@87 error:errorBlk];
+    int64_t numStatementsBefore = [coordDao numStatementsExecuted];
+    int64_t numHitsBefore = [coordDao numStatementCacheHits];
+    int64_t numMissesBefore = [coordDao numStatementCacheMisses];
+    // same shape, different arguments
+    [coordDao firstGasLogForUser:user octane:@87 error:errorBlk];
+    [coordDao firstGasLogForUser:user octane:@93 error:errorBlk];
+    int64_t numStatements = [coordDao numStatementsExecuted] - numStatementsBefore;
+    [[theValue(numStatements) should] beGreaterThan:theValue(0)];
+    [[theValue([coordDao numStatementCacheMisses] - numMissesBefore) should] equal:theValue(0)];
+    [[theValue([coordDao numStatementCacheHits] - numHitsBefore) should] equal:theValue(numStatements)];
+  });
+});
+
+SPEC_END
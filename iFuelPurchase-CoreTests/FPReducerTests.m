@@ -0,0 +1,92 @@
+//
+//  FPReducerTests.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPReducer.h"
+#import "FPDataset.h"
+#import <Kiwi/Kiwi.h>
+
+SPEC_BEGIN(FPReducerSpec)
+
+describe(@"FPReducer", ^{
+  
+  NSDecimalNumber *(^dn)(NSString *) = ^(NSString *str) { return [NSDecimalNumber decimalNumberWithString:str]; };
+  NSArray *(^dp)(id) = ^(id value) { return @[[NSDate date], value]; };
+  
+  context(@"Individual reducers", ^{
+    __block NSArray *dataset;
+    beforeEach(^{
+      dataset = @[dp(dn(@"4.5")), dp([NSNull null]), dp(dn(@"1.25")), dp(dn(@"9")), dp(dn(@"3"))];
+    });
+    
+    it(@"Compute their results, skipping null values", ^{
+      [[[[[FPReducer sumReducer] reduceDataset:dataset] result] should] equal:dn(@"17.75")];
+      [[[[[FPReducer countReducer] reduceDataset:dataset] result] should] equal:@4];
+      [[[[[FPReducer avgReducer] reduceDataset:dataset] result] should] equal:dn(@"4.4375")];
+      [[[[[FPReducer minReducer] reduceDataset:dataset] result] should] equal:dn(@"1.25")];
+      [[[[[FPReducer maxReducer] reduceDataset:dataset] result] should] equal:dn(@"9")];
+      [[[[[FPReducer lastReducer] reduceDataset:dataset] result] should] equal:dn(@"3")];
+    });
+    
+    it(@"Have empty results when nothing was reduced", ^{
+      [[[[FPReducer sumReducer] reduceDataset:@[]] result] shouldBeNil];
+      [[[[[FPReducer countReducer] reduceDataset:@[]] result] should] equal:@0];
+      [[[[FPReducer avgReducer] reduceDataset:@[]] result] shouldBeNil];
+      [[[[FPReducer minReducer] reduceDataset:@[]] result] shouldBeNil];
+      [[[[FPReducer maxReducer] reduceDataset:@[]] result] shouldBeNil];
+      [[[[FPReducer lastReducer] reduceDataset:@[]] result] shouldBeNil];
+    });
+    
+    it(@"Work with integer values", ^{
+      NSArray *days = @[dp(@3), dp(@10), dp(@4)];
+      [[[[[FPReducer avgReducer] reduceDataset:days] result] should] equal:[dn(@"17") decimalNumberByDividingBy:dn(@"3")]];
+      [[[[[FPReducer maxReducer] reduceDataset:days] result] should] equal:@10];
+    });
+    
+    it(@"Reduce an FPDataset's buffer to the same results", ^{
+      FPDataset *typedDataset = [FPDataset datasetWithDatapoints:dataset];
+      [[theValue(typedDataset.count) should] equal:theValue(4)];
+      void (^reducesAlike)(FPReducer *(^)(void)) = ^(FPReducer *(^reducerBlk)(void)) {
+        [[[[reducerBlk() reduceDataset:typedDataset] result] should] equal:[[reducerBlk() reduceDataset:dataset] result]];
+      };
+      reducesAlike(^{ return [FPReducer sumReducer]; });
+      reducesAlike(^{ return [FPReducer countReducer]; });
+      reducesAlike(^{ return [FPReducer avgReducer]; });
+      reducesAlike(^{ return [FPReducer minReducer]; });
+      reducesAlike(^{ return [FPReducer maxReducer]; });
+      reducesAlike(^{ return [FPReducer lastReducer]; });
+      NSArray *results = [[[FPReducer fusedReducerWithReducers:@[[FPReducer minReducer], [FPReducer maxReducer]]]
+                           reduceDataset:typedDataset] result];
+      [[results should] equal:@[dn(@"1.25"), dn(@"9")]];
+    });
+  });
+  
+  context(@"Fused reducers", ^{
+    it(@"Produce every result from a single pass over log rows", ^{
+      NSArray *rows = @[@{@"mpg" : dn(@"31.2")}, @{}, @{@"mpg" : dn(@"28.8")}];
+      __block NSInteger numValueReads = 0;
+      FPReducer *reducer = [FPReducer fusedReducerWithReducers:@[[FPReducer avgReducer],
+                                                                 [FPReducer minReducer],
+                                                                 [FPReducer maxReducer],
+                                                                 [FPReducer countReducer]]];
+      NSArray *results = [[reducer reduceItems:rows valueBlk:^id(NSDictionary *row) {
+        numValueReads++;
+        return row[@"mpg"];
+      }] result];
+      [[theValue(numValueReads) should] equal:theValue(3)];
+      [[results should] equal:@[dn(@"30"), dn(@"28.8"), dn(@"31.2"), @2]];
+    });
+    
+    it(@"Report nil results as NSNull", ^{
+      NSArray *results = [[[FPReducer fusedReducerWithReducers:@[[FPReducer avgReducer], [FPReducer countReducer]]]
+                           reduceDataset:@[]] result];
+      [[results should] equal:@[[NSNull null], @0]];
+    });
+  });
+});
+
+SPEC_END
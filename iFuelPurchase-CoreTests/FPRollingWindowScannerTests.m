@@ -0,0 +1,192 @@
+//
+//  FPRollingWindowScannerTests.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPRollingWindowScanner.h"
+#import "FPLogColumns.h"
+#import "FPEnvironmentLog.h"
+#import <PEObjc-Commons/PEUtils.h>
+#import <Kiwi/Kiwi.h>
+
+SPEC_BEGIN(FPRollingWindowScannerSpec)
+
+describe(@"FPRollingWindowScanner", ^{
+  
+  NSDecimalNumber *(^dn)(NSString *) = ^(NSString *str) { return [NSDecimalNumber decimalNumberWithString:str]; };
+  NSCalendar *utcCalendar = [[NSCalendar alloc] initWithCalendarIdentifier:NSCalendarIdentifierGregorian];
+  utcCalendar.timeZone = [NSTimeZone timeZoneWithName:@"UTC"];
+  NSDate *(^date)(NSInteger, NSInteger) = ^(NSInteger month, NSInteger day) {
+    NSDateComponents *components = [[NSDateComponents alloc] init];
+    components.year = 2014;
+    components.month = month;
+    components.day = day;
+    return [utcCalendar dateFromComponents:components];
+  };
+  FPEnvironmentLog *(^mpgLog)(NSString *, NSDate *) = ^(NSString *mpg, NSDate *logDate) {
+    return [FPEnvironmentLog envLogWithOdometer:nil
+                                 reportedAvgMpg:mpg ? dn(mpg) : nil
+                                 reportedAvgMph:nil
+                            reportedOutsideTemp:nil
+                                        logDate:logDate
+                                    reportedDte:nil
+                                      mediaType:nil];
+  };
+  
+  context(@"Odometer logs", ^{
+    __block FPRollingWindowScanner *scanner;
+    beforeEach(^{
+      // deliberately out of order, and with a log that doesn't carry an MPG
+      scanner = [[FPRollingWindowScanner alloc] initWithEnvironmentLogs:@[mpgLog(@"29", date(2, 10)),
+                                                                          mpgLog(@"25", date(1, 1)),
+                                                                          mpgLog(nil, date(1, 20)),
+                                                                          mpgLog(@"27", date(1, 15))]
+                                                               valueBlk:^NSDecimalNumber *(FPEnvironmentLog *envlog) {
+                                                                 return envlog.reportedAvgMpg;
+                                                               }];
+    });
+    
+    it(@"Computes a datapoint per log", ^{
+      [[theValue(scanner.count) should] equal:theValue(3)];
+      // the Feb 10 window starts on Jan 12
+      [[[scanner movingAvgDataSetWithWindowDays:30
+                                    granularity:FPRollingSeriesGranularityPerLog
+                                       calendar:utcCalendar
+                                     beforeDate:nil
+                                  onOrAfterDate:nil] should] equal:@[@[date(1, 1), dn(@"25")],
+                                                                     @[date(1, 15), dn(@"26")],
+                                                                     @[date(2, 10), dn(@"28")]]];
+      // windows reach back before the range
+      [[[scanner movingSumDataSetWithWindowDays:90
+                                    granularity:FPRollingSeriesGranularityPerLog
+                                       calendar:utcCalendar
+                                     beforeDate:date(2, 10)
+                                  onOrAfterDate:date(1, 2)] should] equal:@[@[date(1, 15), dn(@"52")]]];
+    });
+    
+    it(@"Computes a datapoint per day", ^{
+      NSArray *dataset = [scanner movingAvgDataSetWithWindowDays:30
+                                                     granularity:FPRollingSeriesGranularityDaily
+                                                        calendar:utcCalendar
+                                                      beforeDate:nil
+                                                   onOrAfterDate:nil];
+      // Jan 1 through Feb 10, none of whose windows is empty
+      [[dataset should] haveCountOf:41];
+      [[dataset[0] should] equal:@[date(1, 1), dn(@"25")]];
+      [[dataset[29] should] equal:@[date(1, 30), dn(@"26")]];
+      [[dataset[30] should] equal:@[date(1, 31), dn(@"27")]];
+      [[[dataset lastObject] should] equal:@[date(2, 10), dn(@"28")]];
+      // a 1-day window only holds that day's logs
+      [[[scanner movingSumDataSetWithWindowDays:1
+                                    granularity:FPRollingSeriesGranularityDaily
+                                       calendar:utcCalendar
+                                     beforeDate:date(3, 1)
+                                  onOrAfterDate:date(1, 10)] should] equal:@[@[date(1, 15), dn(@"27")],
+                                                                             @[date(2, 10), dn(@"29")]]];
+    });
+  });
+  
+  it(@"Matches summing each window from scratch", ^{
+    // 600 gas logs over about a year, some on the same day (and some at the
+    // same instant), with every 11th gallons value and every 13th price null
+    FPLogColumns *columns = [[FPLogColumns alloc] initWithCapacity:600];
+    NSMutableArray *rows = [NSMutableArray array];
+    int64_t millis = [[PEUtils millisecondsFromDate:date(1, 1)] longLongValue];
+    for (NSUInteger i = 0; i < 600; i++) {
+      millis += ((i * 7919) % 5) * 7 * 3600 * 1000;
+      NSDecimalNumber *numGallons = i % 11 == 0 ? nil : dn([NSString stringWithFormat:@"%lu.%lu", (unsigned long)(9 + (i * 31) % 9), (unsigned long)((i * 7) % 10)]);
+      NSDecimalNumber *gallonPrice = i % 13 == 0 ? nil : dn([NSString stringWithFormat:@"%lu.%03lu", (unsigned long)(2 + (i * 17) % 3), (unsigned long)((i * 104729) % 1000)]);
+      NSNumber *octane = i % 3 == 0 ? @93 : @87;
+      [columns appendRowWithPurchasedAtMillis:millis
+                                   numGallons:numGallons
+                                  gallonPrice:gallonPrice
+                                       octane:octane
+                                     isDiesel:NO
+                                     odometer:nil];
+      [rows addObject:@[@(millis), numGallons ? numGallons : [NSNull null], gallonPrice ? gallonPrice : [NSNull null], octane]];
+    }
+    NSDecimalNumber *(^rowValue)(NSArray *, FPGasLogMeasure) = ^NSDecimalNumber *(NSArray *row, FPGasLogMeasure measure) {
+      if (measure == FPGasLogMeasureSpent) {
+        return row[1] == [NSNull null] || row[2] == [NSNull null] ? nil : [row[1] decimalNumberByMultiplyingBy:row[2]];
+      }
+      return row[2] == [NSNull null] ? nil : row[2];
+    };
+    NSDate *beforeDate = date(11, 1);
+    NSDate *onOrAfterDate = date(3, 1);
+    for (NSNumber *windowDays in @[@1, @30, @90, @365]) {
+      for (NSNumber *measure in @[@(FPGasLogMeasureSpent), @(FPGasLogMeasureGallonPrice)]) {
+        NSNumber *octane = [measure integerValue] == FPGasLogMeasureGallonPrice ? @87 : nil;
+        FPRollingWindowScanner *scanner = [[FPRollingWindowScanner alloc] initWithGasLogColumns:columns
+                                                                                        measure:[measure integerValue]
+                                                                                         octane:octane
+                                                                                         diesel:NO];
+        NSDecimalNumber *(^expectedSum)(NSDate *, NSDate *, NSInteger *) = ^NSDecimalNumber *(NSDate *windowStart, NSDate *windowEnd, NSInteger *count) {
+          NSDecimalNumber *sum = [NSDecimalNumber zero];
+          *count = 0;
+          for (NSArray *row in rows) {
+            NSDate *rowDate = [NSDate dateWithTimeIntervalSince1970:[row[0] longLongValue] / 1000.0];
+            NSDecimalNumber *value = rowValue(row, [measure integerValue]);
+            if (value && (!octane || [row[3] isEqual:octane]) &&
+                [rowDate compare:windowStart] != NSOrderedAscending && [rowDate compare:windowEnd] == NSOrderedAscending) {
+              sum = [sum decimalNumberByAdding:value];
+              (*count)++;
+            }
+          }
+          return sum;
+        };
+        NSDate *(^windowStartForDay)(NSDate *) = ^(NSDate *day) {
+          return [utcCalendar dateByAddingUnit:NSCalendarUnitDay
+                                         value:-([windowDays integerValue] - 1)
+                                        toDate:[utcCalendar startOfDayForDate:day]
+                                       options:0];
+        };
+        
+        NSArray *perLogSums = [scanner movingSumDataSetWithWindowDays:[windowDays integerValue]
+                                                          granularity:FPRollingSeriesGranularityPerLog
+                                                             calendar:utcCalendar
+                                                           beforeDate:beforeDate
+                                                        onOrAfterDate:onOrAfterDate];
+        NSArray *perLogAvgs = [scanner movingAvgDataSetWithWindowDays:[windowDays integerValue]
+                                                          granularity:FPRollingSeriesGranularityPerLog
+                                                             calendar:utcCalendar
+                                                           beforeDate:beforeDate
+                                                        onOrAfterDate:onOrAfterDate];
+        NSInteger numLogsInRange;
+        expectedSum(onOrAfterDate, beforeDate, &numLogsInRange);
+        [[theValue(numLogsInRange) should] beGreaterThan:theValue(0)];
+        [[theValue(perLogSums.count) should] equal:theValue(numLogsInRange)];
+        [[theValue(perLogAvgs.count) should] equal:theValue(numLogsInRange)];
+        for (NSUInteger i = 0; i < perLogSums.count; i++) {
+          NSDate *logDate = perLogSums[i][0];
+          NSInteger count;
+          NSDecimalNumber *sum = expectedSum(windowStartForDay(logDate), [logDate dateByAddingTimeInterval:0.001], &count);
+          [[perLogSums[i][1] should] equal:sum];
+          [[perLogAvgs[i][1] should] equal:[sum decimalNumberByDividingBy:[NSDecimalNumber decimalNumberWithMantissa:count exponent:0 isNegative:NO]]];
+        }
+        
+        NSArray *dailySums = [scanner movingSumDataSetWithWindowDays:[windowDays integerValue]
+                                                         granularity:FPRollingSeriesGranularityDaily
+                                                            calendar:utcCalendar
+                                                          beforeDate:beforeDate
+                                                       onOrAfterDate:onOrAfterDate];
+        NSUInteger d = 0;
+        for (NSDate *day = onOrAfterDate; [day compare:beforeDate] == NSOrderedAscending; day = [utcCalendar dateByAddingUnit:NSCalendarUnitDay value:1 toDate:day options:0]) {
+          NSInteger count;
+          NSDecimalNumber *sum = expectedSum(windowStartForDay(day),
+                                             [utcCalendar dateByAddingUnit:NSCalendarUnitDay value:1 toDate:day options:0],
+                                             &count);
+          if (count > 0 && [day compare:[dailySums[0] firstObject]] != NSOrderedAscending) {
+            [[dailySums[d] should] equal:@[day, sum]];
+            d++;
+          }
+        }
+        [[theValue(dailySums.count) should] equal:theValue(d)];
+      }
+    }
+  });
+});
+
+SPEC_END
@@ -0,0 +1,76 @@
+//
+//  FPStatsBenchmark.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+@import Foundation;
+#import "FPLocalDao.h"
+
+@class FPStats;
+@class FPUser;
+@class FPVehicle;
+@class FPFuelStation;
+
+/**
+ Times the FPStats methods against whatever data the local DAO holds (see
+ FPSyntheticDataGenerator), and reports, per method, the p50 and p99 latency,
+ the number of SQL statements a call runs, and how far a call pushed the
+ process's peak resident memory.
+
+ The methods are found at run time: every FPStats method taking a user,
+ vehicle or fuel station whose other arguments are all of a kind the benchmark
+ knows how to fill in (a quantile, octane, range, window, granularity, year,
+ date range, calendar or days variance) is timed; any other method taking an
+ entity is reported as skipped.  The stats cache is cleared before every call,
+ so each timing is of a computation from scratch.
+ */
+@interface FPStatsBenchmark : NSObject
+
+#pragma mark - Initializers
+
+- (instancetype)initWithStats:(FPStats *)stats
+                     localDao:(id<FPLocalDao>)localDao
+                         user:(FPUser *)user
+                      vehicle:(FPVehicle *)vehicle
+                  fuelstation:(FPFuelStation *)fuelstation;
+
+#pragma mark - Properties
+
+/** The number of timed calls per method; defaults to 20. */
+@property (nonatomic) NSUInteger numIterations;
+
+/** Included in the report as-is (e.g., the generator's counts). */
+@property (nonatomic) NSDictionary *scale;
+
+#pragma mark - Running
+
+/**
+ Returns a report of the form:
+
+ { "scale": {...}, "iterations": n, "peakResidentBytes": n,
+   "methods": { "<selector>": { "p50Millis": x, "p99Millis": x,
+                                "statementsPerCall": n,
+                                "peakResidentGrowthBytes": n }, ... },
+   "skipped": ["<selector>", ...] }
+ */
+- (NSDictionary *)run;
+
+#pragma mark - Reports
+
+/**
+ The selectors of report whose p50 latency is more than tolerance (e.g., 0.25)
+ above that of baseline, or that run more statements per call than they do in
+ baseline; selectors missing from baseline are ignored.
+ */
++ (NSArray *)regressionsInReport:(NSDictionary *)report
+                        baseline:(NSDictionary *)baseline
+                       tolerance:(double)tolerance;
+
++ (BOOL)writeReport:(NSDictionary *)report toPath:(NSString *)path error:(NSError **)error;
+
++ (NSDictionary *)reportAtPath:(NSString *)path error:(NSError **)error;
+
+@end
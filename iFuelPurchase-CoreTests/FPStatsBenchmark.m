@@ -0,0 +1,270 @@
+//
+//  FPStatsBenchmark.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPStatsBenchmark.h"
+#import <objc/runtime.h>
+#import <mach/mach_time.h>
+#import <sys/resource.h>
+#import "FPStats.h"
+#import "FPStatsSnapshot.h"
+#import "FPRollingWindowScanner.h"
+#import "FPUser.h"
+#import "FPVehicle.h"
+#import "FPFuelStation.h"
+
+/*
+ Below this, a p50 latency difference is mostly timer and scheduling noise, so
+ it's never reported as a regression.
+ */
+static double const FP_BENCHMARK_NOISE_FLOOR_MILLIS = 0.5;
+
+/*
+ The process's peak resident set size so far (ru_maxrss is in bytes on Darwin).
+ */
+static int64_t FPPeakResidentBytes(void) {
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  return (int64_t)usage.ru_maxrss;
+}
+
+static double FPMillisFromMachTime(uint64_t machTime) {
+  static mach_timebase_info_data_t timebase;
+  if (timebase.denom == 0) {
+    mach_timebase_info(&timebase);
+  }
+  return ((double)machTime * timebase.numer / timebase.denom) / 1000000.0;
+}
+
+/* Nearest-rank percentile of sortedValues. */
+static double FPPercentile(NSArray *sortedValues, double percentile) {
+  NSUInteger rank = (NSUInteger)ceil(percentile * sortedValues.count);
+  return [sortedValues[MAX(rank, 1) - 1] doubleValue];
+}
+
+@implementation FPStatsBenchmark {
+  FPStats *_stats;
+  id<FPLocalDao> _localDao;
+  FPUser *_user;
+  FPVehicle *_vehicle;
+  FPFuelStation *_fuelstation;
+  NSDate *_now;
+}
+
+#pragma mark - Initializers
+
+- (instancetype)initWithStats:(FPStats *)stats
+                     localDao:(id<FPLocalDao>)localDao
+                         user:(FPUser *)user
+                      vehicle:(FPVehicle *)vehicle
+                  fuelstation:(FPFuelStation *)fuelstation {
+  self = [super init];
+  if (self) {
+    _stats = stats;
+    _localDao = localDao;
+    _user = user;
+    _vehicle = vehicle;
+    _fuelstation = fuelstation;
+    _numIterations = 20;
+  }
+  return self;
+}
+
+#pragma mark - Helpers
+
+/*
+ The entity for a selector part naming one (e.g., "overallSpentOnGasForVehicle"
+ or "forUser"), or nil.
+ */
+- (id)entityForSelectorPart:(NSString *)part {
+  NSString *lowercasePart = [part lowercaseString];
+  if ([lowercasePart hasSuffix:@"user"]) {
+    return _user;
+  } else if ([lowercasePart hasSuffix:@"vehicle"]) {
+    return _vehicle;
+  } else if ([lowercasePart hasSuffix:@"fuelstation"] || [lowercasePart hasSuffix:@"gasstation"]) {
+    return _fuelstation;
+  }
+  return nil;
+}
+
+/*
+ The argument for a (non-entity) selector part the benchmark knows how to fill
+ in, or nil.  Scalars are boxed.
+ */
+- (id)argumentForSelectorPart:(NSString *)part {
+  NSString *lowercasePart = [part lowercaseString];
+  if ([lowercasePart hasSuffix:@"quantile"]) {
+    return @(0.9);
+  } else if ([lowercasePart hasSuffix:@"octane"]) {
+    return @87;
+  } else if ([lowercasePart hasSuffix:@"range"]) {
+    return @(FPStatsRangeOverall);
+  } else if ([lowercasePart hasSuffix:@"windowdays"]) {
+    return @30;
+  } else if ([lowercasePart hasSuffix:@"granularity"]) {
+    return @(FPRollingSeriesGranularityDaily);
+  } else if ([lowercasePart hasSuffix:@"year"]) {
+    return @([[NSCalendar currentCalendar] component:NSCalendarUnitYear fromDate:_now] - 1);
+  } else if ([lowercasePart hasSuffix:@"beforedate"] || [lowercasePart hasSuffix:@"oneyearagofromdate"]) {
+    return _now;
+  } else if ([lowercasePart hasSuffix:@"onorafterdate"]) {
+    return [[NSCalendar currentCalendar] dateByAddingUnit:NSCalendarUnitYear value:-1 toDate:_now options:0];
+  } else if ([lowercasePart hasSuffix:@"calendar"]) {
+    return [NSCalendar currentCalendar];
+  } else if ([lowercasePart hasSuffix:@"daysvariance"]) {
+    return @15;
+  }
+  return nil;
+}
+
+/*
+ Sets the invocation's argument at index from value, as the type the method
+ declares; returns NO if value doesn't fit that type.
+ */
+- (BOOL)setArgument:(id)value atIndex:(NSInteger)index ofInvocation:(NSInvocation *)invocation {
+  const char *type = [invocation.methodSignature getArgumentTypeAtIndex:index];
+  if (type[0] == _C_ID) {
+    [invocation setArgument:&value atIndex:index];
+    return YES;
+  }
+  if (![value isKindOfClass:[NSNumber class]]) {
+    return NO;
+  }
+  if (strcmp(type, @encode(double)) == 0) {
+    double d = [value doubleValue];
+    [invocation setArgument:&d atIndex:index];
+  } else if (strcmp(type, @encode(NSInteger)) == 0 || strcmp(type, @encode(NSUInteger)) == 0) {
+    NSInteger i = [value integerValue];
+    [invocation setArgument:&i atIndex:index];
+  } else {
+    return NO;
+  }
+  return YES;
+}
+
+/*
+ A ready-to-invoke invocation of selector against the benchmark's entities, or
+ nil if one of its arguments can't be filled in.
+ */
+- (NSInvocation *)invocationForSelector:(SEL)selector {
+  NSArray *parts = [NSStringFromSelector(selector) componentsSeparatedByString:@":"];
+  NSMethodSignature *signature = [FPStats instanceMethodSignatureForSelector:selector];
+  NSInvocation *invocation = [NSInvocation invocationWithMethodSignature:signature];
+  invocation.selector = selector;
+  invocation.target = _stats;
+  for (NSUInteger i = 0; i + 1 < parts.count; i++) {
+    id argument = [self entityForSelectorPart:parts[i]];
+    if (!argument) {
+      argument = [self argumentForSelectorPart:parts[i]];
+    }
+    if (!argument || ![self setArgument:argument atIndex:i + 2 ofInvocation:invocation]) {
+      return nil;
+    }
+  }
+  [invocation retainArguments];
+  return invocation;
+}
+
+/* Whether any part of selector names an entity. */
+- (BOOL)isEntitySelector:(SEL)selector {
+  NSArray *parts = [NSStringFromSelector(selector) componentsSeparatedByString:@":"];
+  for (NSUInteger i = 0; i + 1 < parts.count; i++) {
+    if ([self entityForSelectorPart:parts[i]]) {
+      return YES;
+    }
+  }
+  return NO;
+}
+
+- (NSArray *)entitySelectorNames {
+  NSMutableArray *names = [NSMutableArray array];
+  unsigned int numMethods = 0;
+  Method *methods = class_copyMethodList([FPStats class], &numMethods);
+  for (unsigned int i = 0; i < numMethods; i++) {
+    SEL selector = method_getName(methods[i]);
+    if ([self isEntitySelector:selector]) {
+      [names addObject:NSStringFromSelector(selector)];
+    }
+  }
+  free(methods);
+  return [names sortedArrayUsingSelector:@selector(compare:)];
+}
+
+- (NSDictionary *)measureInvocation:(NSInvocation *)invocation {
+  NSMutableArray *millis = [NSMutableArray arrayWithCapacity:_numIterations];
+  int64_t peakResidentBefore = FPPeakResidentBytes();
+  int64_t numStatementsBefore = [_localDao numStatementsExecuted];
+  for (NSUInteger i = 0; i < _numIterations; i++) {
+    @autoreleasepool {
+      [_stats clearCache];
+      uint64_t start = mach_absolute_time();
+      [invocation invoke];
+      [millis addObject:@(FPMillisFromMachTime(mach_absolute_time() - start))];
+    }
+  }
+  int64_t numStatements = [_localDao numStatementsExecuted] - numStatementsBefore;
+  [millis sortUsingSelector:@selector(compare:)];
+  return @{@"p50Millis" : @(FPPercentile(millis, 0.50)),
+           @"p99Millis" : @(FPPercentile(millis, 0.99)),
+           @"statementsPerCall" : @(numStatements / (int64_t)MAX(_numIterations, 1)),
+           @"peakResidentGrowthBytes" : @(FPPeakResidentBytes() - peakResidentBefore)};
+}
+
+#pragma mark - Running
+
+- (NSDictionary *)run {
+  _now = [NSDate date];
+  NSMutableDictionary *methods = [NSMutableDictionary dictionary];
+  NSMutableArray *skipped = [NSMutableArray array];
+  for (NSString *selectorName in [self entitySelectorNames]) {
+    NSInvocation *invocation = [self invocationForSelector:NSSelectorFromString(selectorName)];
+    if (invocation && _numIterations > 0) {
+      methods[selectorName] = [self measureInvocation:invocation];
+    } else {
+      [skipped addObject:selectorName];
+    }
+  }
+  return @{@"scale" : _scale ? _scale : @{},
+           @"iterations" : @(_numIterations),
+           @"peakResidentBytes" : @(FPPeakResidentBytes()),
+           @"methods" : methods,
+           @"skipped" : skipped};
+}
+
+#pragma mark - Reports
+
++ (NSArray *)regressionsInReport:(NSDictionary *)report
+                        baseline:(NSDictionary *)baseline
+                       tolerance:(double)tolerance {
+  NSMutableArray *regressions = [NSMutableArray array];
+  NSDictionary *baselineMethods = baseline[@"methods"];
+  [report[@"methods"] enumerateKeysAndObjectsUsingBlock:^(NSString *selectorName, NSDictionary *measures, BOOL *stop) {
+    NSDictionary *baselineMeasures = baselineMethods[selectorName];
+    if (baselineMeasures) {
+      double p50 = [measures[@"p50Millis"] doubleValue];
+      double baselineP50 = [baselineMeasures[@"p50Millis"] doubleValue];
+      if ((p50 > baselineP50 * (1.0 + tolerance) && p50 - baselineP50 > FP_BENCHMARK_NOISE_FLOOR_MILLIS) ||
+          [measures[@"statementsPerCall"] longLongValue] > [baselineMeasures[@"statementsPerCall"] longLongValue]) {
+        [regressions addObject:selectorName];
+      }
+    }
+  }];
+  return [regressions sortedArrayUsingSelector:@selector(compare:)];
+}
+
++ (BOOL)writeReport:(NSDictionary *)report toPath:(NSString *)path error:(NSError **)error {
+  NSData *data = [NSJSONSerialization dataWithJSONObject:report options:NSJSONWritingPrettyPrinted error:error];
+  return data && [data writeToFile:path options:NSDataWritingAtomic error:error];
+}
+
++ (NSDictionary *)reportAtPath:(NSString *)path error:(NSError **)error {
+  NSData *data = [NSData dataWithContentsOfFile:path options:0 error:error];
+  return data ? [NSJSONSerialization JSONObjectWithData:data options:0 error:error] : nil;
+}
+
+@end
@@ -0,0 +1,143 @@
+//
+//  FPStatsBenchmarkTests.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPCoordinatorDaoImpl.h"
+#import "FPCoordDaoTestContext.h"
+#import "FPSyntheticDataGenerator.h"
+#import "FPStatsBenchmark.h"
+#import "FPStats.h"
+#import "FPUser.h"
+#import "FPVehicle.h"
+#import "FPFuelStation.h"
+#import "FPFuelPurchaseLog.h"
+#import "FPEnvironmentLog.h"
+#import <CocoaLumberjack/DDLog.h>
+#import "FPLogging.h"
+#import <Kiwi/Kiwi.h>
+
+SPEC_BEGIN(FPStatsBenchmarkSpec)
+
+describe(@"FPStatsBenchmark", ^{
+  
+  NSDictionary *env = [[NSProcessInfo processInfo] environment];
+  
+  NSArray *(^flattenedLogs)(FPSyntheticDataGenerator *, NSUInteger) = ^(FPSyntheticDataGenerator *generator, NSUInteger vehicleIndex) {
+    NSMutableArray *logs = [NSMutableArray array];
+    [generator enumerateLogsForVehicleAtIndex:vehicleIndex usingBlock:^(FPFuelPurchaseLog *gasLog, NSUInteger fuelStationIndex, FPEnvironmentLog *odometerLog) {
+      [logs addObject:@[gasLog.purchasedAt, gasLog.numGallons, gasLog.gallonPrice, gasLog.odometer,
+                        gasLog.octane ? gasLog.octane : [NSNull null], @(fuelStationIndex),
+                        odometerLog ? odometerLog.reportedAvgMpg : [NSNull null]]];
+    }];
+    return logs;
+  };
+  
+  it(@"Generates the same fleet from the same seed", ^{
+    FPSyntheticDataGenerator *(^newGenerator)(uint64_t) = ^(uint64_t seed) {
+      FPSyntheticDataGenerator *generator = [[FPSyntheticDataGenerator alloc] initWithSeed:seed];
+      generator.numVehicles = 3;
+      generator.numYears = 1;
+      generator.numFuelStations = 4;
+      generator.fillupsPerOdometerLog = 2;
+      generator.endDate = [NSDate dateWithTimeIntervalSince1970:1700000000];
+      return generator;
+    };
+    FPSyntheticDataGenerator *generator = newGenerator(42);
+    FPSyntheticDataGenerator *twin = newGenerator(42);
+    FPSyntheticDataGenerator *other = newGenerator(43);
+    for (NSUInteger i = 0; i < 3; i++) {
+      [[[generator vehicleAtIndex:i].name should] equal:[twin vehicleAtIndex:i].name];
+      [[[generator vehicleAtIndex:i].fuelCapacity should] equal:[twin vehicleAtIndex:i].fuelCapacity];
+      NSArray *logs = flattenedLogs(generator, i);
+      [[logs should] haveCountOf:52];
+      [[logs should] equal:flattenedLogs(twin, i)];
+      [[logs shouldNot] equal:flattenedLogs(other, i)];
+      // logs are oldest first, end before the end date, and odometers only go up
+      for (NSUInteger j = 1; j < logs.count; j++) {
+        [[theValue([logs[j][0] compare:logs[j - 1][0]]) should] equal:theValue(NSOrderedDescending)];
+        [[theValue([logs[j][3] compare:logs[j - 1][3]]) should] equal:theValue(NSOrderedDescending)];
+      }
+      [[theValue([[logs lastObject][0] compare:generator.endDate]) should] equal:theValue(NSOrderedAscending)];
+      NSUInteger numOdometerLogs = [[logs filteredArrayUsingPredicate:[NSPredicate predicateWithBlock:^BOOL(NSArray *log, NSDictionary *bindings) {
+        return log[6] != [NSNull null];
+      }]] count];
+      [[theValue(numOdometerLogs) should] equal:theValue(26)];
+    }
+    // a vehicle's logs don't depend on the size of the fleet
+    FPSyntheticDataGenerator *biggerFleet = newGenerator(42);
+    biggerFleet.numVehicles = 10;
+    [[flattenedLogs(biggerFleet, 2) should] equal:flattenedLogs(generator, 2)];
+  });
+  
+  it(@"Flags latency and query regressions against a baseline", ^{
+    NSDictionary *(^report)(double, NSInteger, double, NSInteger) = ^(double p50a, NSInteger stmtsa, double p50b, NSInteger stmtsb) {
+      return @{@"methods" : @{@"a" : @{@"p50Millis" : @(p50a), @"statementsPerCall" : @(stmtsa)},
+                              @"b" : @{@"p50Millis" : @(p50b), @"statementsPerCall" : @(stmtsb)}}};
+    };
+    NSDictionary *baseline = report(10.0, 4, 0.1, 2);
+    // a is within tolerance, and b tripled by less than timing noise
+    [[[FPStatsBenchmark regressionsInReport:report(12.0, 4, 0.3, 2) baseline:baseline tolerance:0.25] should] beEmpty];
+    [[[FPStatsBenchmark regressionsInReport:report(13.0, 4, 0.3, 2) baseline:baseline tolerance:0.25] should] equal:@[@"a"]];
+    [[[FPStatsBenchmark regressionsInReport:report(9.0, 4, 0.1, 3) baseline:baseline tolerance:0.25] should] equal:@[@"b"]];
+    [[[FPStatsBenchmark regressionsInReport:report(9.0, 4, 0.1, 3) baseline:@{} tolerance:0.25] should] beEmpty];
+  });
+  
+  // Runs against a generated fleet only when asked to, e.g.:
+  //   FP_RUN_BENCHMARKS=1 [FP_BENCHMARK_VEHICLES=50] [FP_BENCHMARK_YEARS=15]
+  //   [FP_BENCHMARK_OUTPUT=report.json] [FP_BENCHMARK_BASELINE=baseline.json]
+  if (env[@"FP_RUN_BENCHMARKS"]) {
+    context(@"A generated fleet", ^{
+      __block FPCoordDaoTestContext *coordTestCtx;
+      __block FPCoordinatorDaoImpl *coordDao;
+      __block FPUser *user;
+      __block NSDictionary *scale;
+      beforeAll(^{
+        coordTestCtx = [[FPCoordDaoTestContext alloc] initWithTestBundle:[NSBundle bundleForClass:[self class]]];
+        coordDao = [coordTestCtx newStoreCoord];
+        [coordDao deleteUser:^(NSError *error, int code, NSString *msg) { [coordTestCtx setErrorDeletingUser:YES]; }];
+        user = [coordTestCtx newFreshJoeSmithMaker](coordDao, ^{
+          [[expectFutureValue(theValue([coordTestCtx authTokenReceived])) shouldEventuallyBeforeTimingOutAfter(60)] beYes];
+        });
+        FPSyntheticDataGenerator *generator = [[FPSyntheticDataGenerator alloc] initWithSeed:20151013];
+        if (env[@"FP_BENCHMARK_VEHICLES"]) {
+          generator.numVehicles = [env[@"FP_BENCHMARK_VEHICLES"] integerValue];
+        }
+        if (env[@"FP_BENCHMARK_YEARS"]) {
+          generator.numYears = [env[@"FP_BENCHMARK_YEARS"] integerValue];
+        }
+        scale = [generator populateLocalDao:coordDao forUser:user error:[coordTestCtx newLocalSaveErrBlkMaker]()];
+      });
+      
+      it(@"Times every stats method", ^{
+        PELMDaoErrorBlk errorBlk = [coordTestCtx newLocalFetchErrBlkMaker]();
+        FPStats *stats = [[FPStats alloc] initWithLocalDao:coordDao errorBlk:errorBlk];
+        FPStatsBenchmark *benchmark = [[FPStatsBenchmark alloc] initWithStats:stats
+                                                                     localDao:coordDao
+                                                                         user:user
+                                                                      vehicle:[[coordDao vehiclesForUser:user error:errorBlk] firstObject]
+                                                                  fuelstation:[[coordDao fuelStationsForUser:user error:errorBlk] firstObject]];
+        benchmark.scale = scale;
+        NSDictionary *report = [benchmark run];
+        [[report[@"methods"] shouldNot] beEmpty];
+        NSString *outputPath = env[@"FP_BENCHMARK_OUTPUT"];
+        if (!outputPath) {
+          outputPath = [NSTemporaryDirectory() stringByAppendingPathComponent:@"fp-stats-benchmark.json"];
+        }
+        NSError *error = nil;
+        [[theValue([FPStatsBenchmark writeReport:report toPath:outputPath error:&error]) should] beYes];
+        DDLogInfo(@"FPStats benchmark report written to: [%@]", outputPath);
+        if (env[@"FP_BENCHMARK_BASELINE"]) {
+          NSDictionary *baseline = [FPStatsBenchmark reportAtPath:env[@"FP_BENCHMARK_BASELINE"] error:&error];
+          [baseline shouldNotBeNil];
+          [[[FPStatsBenchmark regressionsInReport:report baseline:baseline tolerance:0.25] should] beEmpty];
+        }
+      });
+    });
+  }
+});
+
+SPEC_END
@@ -19,7 +19,14 @@
 #import "FPToggler.h"
 #import "FPCoordDaoTestContext.h"
 #import "FPStats.h"
+#import "FPStatsSnapshot.h"
+#import "FPStatsRequest.h"
+#import "FPOctanePriceStats.h"
+#import "FPLogAggregate.h"
+#import "FPLogColumns.h"
+#import "FPFixedPoint.h"
 #import "FPFuelStationType.h"
+#import "FPLogging.h"
 #import <Kiwi/Kiwi.h>
 
 SPEC_BEGIN(FPStatsSpec)
@@ -509,6 +516,307 @@ describe(@"FPStats", ^{
       [[[_stats lastYearSpentOnGasForFuelstation:fs2] should] equal:[NSDecimalNumber decimalNumberWithString:@"258.3863"]];
       [[[_stats overallSpentOnGasForFuelstation:fs2] should] equal:[NSDecimalNumber decimalNumberWithString:@"373.682"]];
     });
+    
+    it(@"Snapshot stats match the individual stats and save queries", ^{
+      FPStatsSnapshot *snapshot = [[FPStatsSnapshot alloc] init];
+      NSArray *allRanges = @[@(FPStatsRangeYearToDate), @(FPStatsRangeLastYear), @(FPStatsRangeOverall)];
+      for (id entity in @[_user, _v1, v2, v3, _fs1, fs2]) {
+        [snapshot requestMetrics:@[@(FPStatsMetricSpentOnGas)]
+                    aggregations:@[@(FPStatsAggregationTotal)]
+                          ranges:allRanges
+                       forEntity:entity];
+      }
+      for (id entity in @[_user, _v1]) {
+        [snapshot requestMetrics:@[@(FPStatsMetricPricePerGallon)]
+                    aggregations:@[@(FPStatsAggregationAvg), @(FPStatsAggregationMin), @(FPStatsAggregationMax)]
+                          ranges:allRanges
+                       forEntity:entity];
+      }
+      [snapshot requestMetrics:@[@(FPStatsMetricReportedAvgMpg)]
+                  aggregations:@[@(FPStatsAggregationAvg)]
+                        ranges:allRanges
+                     forEntity:_user];
+      [snapshot requestMetric:FPStatsMetricReportedAvgMpg
+                  aggregation:FPStatsAggregationAvg
+                        range:FPStatsRangeOverall
+                    forEntity:fs2];
+      [_stats clearCache];
+      int64_t numStatementsBefore = [_coordDao numStatementsExecuted];
+      [_stats computeSnapshot:snapshot];
+      int64_t numSnapshotStatements = [_coordDao numStatementsExecuted] - numStatementsBefore;
+      
+      // the individual stats below, computed from scratch
+      [_stats clearCache];
+      numStatementsBefore = [_coordDao numStatementsExecuted];
+      NSDecimalNumber *(^value)(FPStatsMetric, FPStatsAggregation, FPStatsRange, id) =
+      ^(FPStatsMetric metric, FPStatsAggregation aggregation, FPStatsRange range, id entity) {
+        return [snapshot valueOfMetric:metric aggregation:aggregation range:range forEntity:entity];
+      };
+      [[value(FPStatsMetricSpentOnGas, FPStatsAggregationTotal, FPStatsRangeYearToDate, _user) should] equal:[_stats yearToDateSpentOnGasForUser:_user]];
+      [[value(FPStatsMetricSpentOnGas, FPStatsAggregationTotal, FPStatsRangeLastYear, _user) should] equal:[_stats lastYearSpentOnGasForUser:_user]];
+      [[value(FPStatsMetricSpentOnGas, FPStatsAggregationTotal, FPStatsRangeOverall, _user) should] equal:[_stats overallSpentOnGasForUser:_user]];
+      for (FPVehicle *vehicle in @[_v1, v2, v3]) {
+        [[value(FPStatsMetricSpentOnGas, FPStatsAggregationTotal, FPStatsRangeYearToDate, vehicle) should] equal:[_stats yearToDateSpentOnGasForVehicle:vehicle]];
+        [[value(FPStatsMetricSpentOnGas, FPStatsAggregationTotal, FPStatsRangeLastYear, vehicle) should] equal:[_stats lastYearSpentOnGasForVehicle:vehicle]];
+        [[value(FPStatsMetricSpentOnGas, FPStatsAggregationTotal, FPStatsRangeOverall, vehicle) should] equal:[_stats overallSpentOnGasForVehicle:vehicle]];
+      }
+      for (FPFuelStation *fuelstation in @[_fs1, fs2]) {
+        [[value(FPStatsMetricSpentOnGas, FPStatsAggregationTotal, FPStatsRangeYearToDate, fuelstation) should] equal:[_stats yearToDateSpentOnGasForFuelstation:fuelstation]];
+        [[value(FPStatsMetricSpentOnGas, FPStatsAggregationTotal, FPStatsRangeLastYear, fuelstation) should] equal:[_stats lastYearSpentOnGasForFuelstation:fuelstation]];
+        [[value(FPStatsMetricSpentOnGas, FPStatsAggregationTotal, FPStatsRangeOverall, fuelstation) should] equal:[_stats overallSpentOnGasForFuelstation:fuelstation]];
+      }
+      [[value(FPStatsMetricPricePerGallon, FPStatsAggregationAvg, FPStatsRangeYearToDate, _user) should] equal:[_stats yearToDateAvgPricePerGallonForUser:_user]];
+      [[value(FPStatsMetricPricePerGallon, FPStatsAggregationAvg, FPStatsRangeLastYear, _user) should] equal:[_stats lastYearAvgPricePerGallonForUser:_user]];
+      [[value(FPStatsMetricPricePerGallon, FPStatsAggregationAvg, FPStatsRangeOverall, _user) should] equal:[_stats overallAvgPricePerGallonForUser:_user]];
+      [[value(FPStatsMetricPricePerGallon, FPStatsAggregationMin, FPStatsRangeLastYear, _user) should] equal:[_stats lastYearMinPricePerGallonForUser:_user]];
+      [[value(FPStatsMetricPricePerGallon, FPStatsAggregationMax, FPStatsRangeOverall, _user) should] equal:[_stats overallMaxPricePerGallonForUser:_user]];
+      [[value(FPStatsMetricPricePerGallon, FPStatsAggregationMin, FPStatsRangeOverall, _v1) should] equal:[_stats overallMinPricePerGallonForVehicle:_v1]];
+      [[value(FPStatsMetricPricePerGallon, FPStatsAggregationMax, FPStatsRangeLastYear, _v1) should] equal:[_stats lastYearMaxPricePerGallonForVehicle:_v1]];
+      [value(FPStatsMetricReportedAvgMpg, FPStatsAggregationAvg, FPStatsRangeOverall, _user) shouldBeNil];
+      [value(FPStatsMetricReportedAvgMpg, FPStatsAggregationAvg, FPStatsRangeOverall, fs2) shouldBeNil];
+      
+      int64_t numIndividualStatements = [_coordDao numStatementsExecuted] - numStatementsBefore;
+      
+      // one gas log fetch per entity, plus one odometer log fetch for the user
+      [[theValue(snapshot.numRequestedStats) should] equal:theValue(40)];
+      [[theValue(snapshot.numLogFetches) should] equal:theValue(7)];
+      [[theValue(numSnapshotStatements) should] beGreaterThan:theValue(0)];
+      [[theValue(numSnapshotStatements) should] beLessThan:theValue(numIndividualStatements)];
+    });
+    
+    it(@"Async requests coalesce, and a screen's new round cancels its old requests but not each other", ^{
+      // holds the stats queue until every request below has been made
+      dispatch_semaphore_t gate = dispatch_semaphore_create(0);
+      [_stats computeValueAsyncForKey:nil
+                               screen:nil
+                             valueBlk:^id(FPStats *stats) {
+                               dispatch_semaphore_wait(gate, DISPATCH_TIME_FOREVER);
+                               return nil;
+                             }
+                        completionBlk:nil];
+      NSInteger numCoalescedRequests = _stats.numCoalescedRequests;
+      __block NSInteger numSpentComputations = 0;
+      __block NSMutableArray *spentValues = [NSMutableArray array];
+      id (^spentValueBlk)(FPStats *) = ^id(FPStats *stats) {
+        numSpentComputations++;
+        return [stats overallSpentOnGasForUser:_user];
+      };
+      void (^spentCompletionBlk)(id) = ^(NSDecimalNumber *spent) { [spentValues addObject:spent]; };
+      NSArray *spentKey = @[@"overallSpentOnGas", _user.localMainIdentifier];
+      [_stats computeValueAsyncForKey:spentKey screen:nil valueBlk:spentValueBlk completionBlk:spentCompletionBlk];
+      [_stats computeValueAsyncForKey:spentKey screen:@"Home" valueBlk:spentValueBlk completionBlk:spentCompletionBlk];
+      [[theValue(_stats.numCoalescedRequests) should] equal:theValue(numCoalescedRequests + 1)];
+      
+      __block NSDecimalNumber *v1Spent = nil;
+      __block NSDecimalNumber *v1AvgPrice = nil;
+      __block BOOL outdatedCompleted = NO;
+      [_stats beginRoundForScreen:@"VehicleDetail"];
+      FPStatsRequest *outdatedRequest = [_stats computeValueAsyncForKey:@[@"overallSpentOnGas", v2.localMainIdentifier]
+                                                                 screen:@"VehicleDetail"
+                                                               valueBlk:^id(FPStats *stats) { return [stats overallSpentOnGasForVehicle:v2]; }
+                                                          completionBlk:^(id value) { outdatedCompleted = YES; }];
+      [_stats beginRoundForScreen:@"VehicleDetail"];
+      FPStatsRequest *currentRequest = [_stats computeValueAsyncForKey:@[@"overallSpentOnGas", _v1.localMainIdentifier]
+                                                                 screen:@"VehicleDetail"
+                                                               valueBlk:^id(FPStats *stats) { return [stats overallSpentOnGasForVehicle:_v1]; }
+                                                          completionBlk:^(NSDecimalNumber *spent) { v1Spent = spent; }];
+      FPStatsRequest *siblingRequest = [_stats computeValueAsyncForKey:@[@"overallAvgPricePerGallon", _v1.localMainIdentifier]
+                                                                 screen:@"VehicleDetail"
+                                                               valueBlk:^id(FPStats *stats) { return [stats overallAvgPricePerGallonForVehicle:_v1]; }
+                                                          completionBlk:^(NSDecimalNumber *avgPrice) { v1AvgPrice = avgPrice; }];
+      [[theValue(outdatedRequest.isCancelled) should] beYes];
+      [[theValue(currentRequest.isCancelled) should] beNo];
+      [[theValue(siblingRequest.isCancelled) should] beNo];
+      
+      __block BOOL cancelledComputed = NO;
+      FPStatsRequest *cancelledRequest = [_stats computeValueAsyncForKey:nil
+                                                                  screen:nil
+                                                                valueBlk:^id(FPStats *stats) {
+                                                                  cancelledComputed = YES;
+                                                                  return nil;
+                                                                }
+                                                           completionBlk:nil];
+      [cancelledRequest cancel];
+      __block FPStatsSnapshot *completedSnapshot = nil;
+      FPStatsSnapshot *snapshot = [[FPStatsSnapshot alloc] init];
+      [snapshot requestMetric:FPStatsMetricSpentOnGas aggregation:FPStatsAggregationTotal range:FPStatsRangeOverall forEntity:_fs1];
+      [_stats computeSnapshotAsync:snapshot screen:nil completionBlk:^(FPStatsSnapshot *computed) { completedSnapshot = computed; }];
+      dispatch_semaphore_signal(gate);
+      
+      [[expectFutureValue(completedSnapshot) shouldEventually] beNonNil];
+      [[spentValues should] equal:@[[_stats overallSpentOnGasForUser:_user], [_stats overallSpentOnGasForUser:_user]]];
+      [[theValue(numSpentComputations) should] equal:theValue(1)];
+      [[v1Spent should] equal:[_stats overallSpentOnGasForVehicle:_v1]];
+      [[v1AvgPrice should] equal:[_stats overallAvgPricePerGallonForVehicle:_v1]];
+      [[theValue(outdatedCompleted) should] beNo];
+      [[theValue(cancelledComputed) should] beNo];
+      [[[completedSnapshot valueOfMetric:FPStatsMetricSpentOnGas
+                             aggregation:FPStatsAggregationTotal
+                                   range:FPStatsRangeOverall
+                               forEntity:_fs1] should] equal:[_stats overallSpentOnGasForFuelstation:_fs1]];
+    });
+  });
+  
+  context(@"Gas logs of several octanes and of diesel", ^{
+    beforeAll(^{
+      resetUser();
+      NSDateComponents *comps = [[NSCalendar currentCalendar] components:NSCalendarUnitYear fromDate:[NSDate date]];
+      saveGasLog(_v1, _fs1, @"15.0", 87, @"10582", @"3.129", NO, nil, [NSString stringWithFormat:@"02/10/%ld", (long)comps.year-1]);
+      saveGasLog(_v1, _fs1, @"15.2", 87, @"10584", @"2.859", NO, nil, [NSString stringWithFormat:@"02/24/%ld", (long)comps.year-1]);
+      saveGasLog(_v1, _fs1, @"15.1", 93, @"10586", @"3.699", NO, nil, [NSString stringWithFormat:@"05/16/%ld", (long)comps.year-1]);
+      saveGasLog(_v1, _fs1, @"14.7", 93, @"10588", @"3.489", NO, nil, [NSString stringWithFormat:@"09/23/%ld", (long)comps.year-1]);
+      saveGasLog(_v1, _fs1, @"15.9", 87, @"10590", @"3.059", NO, nil, [NSString stringWithFormat:@"01/03/%ld", (long)comps.year]);
+      FPFuelPurchaseLog *dieselLog = [_coordDao fuelPurchaseLogWithNumGallons:[NSDecimalNumber decimalNumberWithString:@"16.2"]
+                                                                       octane:nil
+                                                                     odometer:[NSDecimalNumber decimalNumberWithString:@"10592"]
+                                                                  gallonPrice:[NSDecimalNumber decimalNumberWithString:@"3.999"]
+                                                                   gotCarWash:NO
+                                                     carWashPerGallonDiscount:nil
+                                                                      logDate:_d([NSString stringWithFormat:@"07/04/%ld", (long)comps.year-1])
+                                                                     isDiesel:YES];
+      [_coordDao saveNewFuelPurchaseLog:dieselLog forUser:_user vehicle:_v1 fuelStation:_fs1 error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+      saveOdometerLog(_v1, @"10582", @"24.1", nil, 40, [NSString stringWithFormat:@"02/10/%ld", (long)comps.year-1], nil);
+      saveOdometerLog(_v1, @"10588", @"27.5", nil, 40, [NSString stringWithFormat:@"09/23/%ld", (long)comps.year-1], nil);
+      saveOdometerLog(_v1, @"10590", @"25.2", nil, 40, [NSString stringWithFormat:@"01/03/%ld", (long)comps.year], nil);
+    });
+    
+    it(@"Grouped price per gallon stats match the per-octane stats", ^{
+      NSDictionary *overallStats = [_stats pricePerGallonStatsByOctaneForUser:_user range:FPStatsRangeOverall];
+      [[overallStats should] haveCountOf:3];
+      for (NSNumber *octane in @[@87, @93]) {
+        FPOctanePriceStats *octaneStats = overallStats[octane];
+        [[octaneStats.avg should] equal:[_stats overallAvgPricePerGallonForUser:_user octane:octane]];
+        [[octaneStats.min should] equal:[_stats overallMinPricePerGallonForUser:_user octane:octane]];
+        [[octaneStats.max should] equal:[_stats overallMaxPricePerGallonForUser:_user octane:octane]];
+        [[octaneStats.dataSet should] equal:[_stats overallAvgPricePerGallonDataSetForUser:_user octane:octane]];
+      }
+      FPOctanePriceStats *dieselStats = overallStats[@(FPOctaneKeyDiesel)];
+      [[dieselStats.avg should] equal:[_stats overallAvgPricePerDieselGallonForUser:_user]];
+      [[dieselStats.dataSet should] equal:[_stats overallAvgPricePerDieselGallonDataSetForUser:_user]];
+      
+      NSDictionary *lastYearStats = [_stats pricePerGallonStatsByOctaneForVehicle:_v1 range:FPStatsRangeLastYear];
+      [[lastYearStats should] haveCountOf:3];
+      [[[lastYearStats[@87] avg] should] equal:[_stats lastYearAvgPricePerGallonForVehicle:_v1 octane:@87]];
+      [[[lastYearStats[@87] dataSet] should] equal:[_stats lastYearAvgPricePerGallonDataSetForVehicle:_v1 octane:@87]];
+      [[[lastYearStats[@93] max] should] equal:[_stats lastYearMaxPricePerGallonForVehicle:_v1 octane:@93]];
+      
+      NSDictionary *yearToDateStats = [_stats pricePerGallonStatsByOctaneForFuelstation:_fs1 range:FPStatsRangeYearToDate];
+      [[yearToDateStats should] haveCountOf:1];
+      [[[yearToDateStats[@87] avg] should] equal:[_stats yearToDateAvgPricePerGallonForFuelstation:_fs1 octane:@87]];
+      [[[yearToDateStats[@87] min] should] equal:[NSDecimalNumber decimalNumberWithString:@"3.059"]];
+    });
+    
+    it(@"Moving sums and averages slide over the logs", ^{
+      NSDecimalNumber *(^dn)(NSString *) = ^(NSString *str) { return [NSDecimalNumber decimalNumberWithString:str]; };
+      NSDateComponents *comps = [[NSCalendar currentCalendar] components:NSCalendarUnitYear fromDate:[NSDate date]];
+      NSDate *(^lastYearDate)(NSString *) = ^(NSString *monthDay) {
+        return _d([NSString stringWithFormat:@"%@/%ld", monthDay, (long)comps.year-1]);
+      };
+      NSDate *jan3 = _d([NSString stringWithFormat:@"01/03/%ld", (long)comps.year]);
+      id (^valueOn)(NSArray *, NSDate *) = ^id(NSArray *dataset, NSDate *date) {
+        for (NSArray *datapoint in dataset) {
+          if ([datapoint[0] isEqualToDate:date]) {
+            return datapoint[1];
+          }
+        }
+        return nil;
+      };
+      
+      // per log; the 87 logs all fall within 365 days of each other
+      NSArray *priceDataSet = [_stats movingAvgPricePerGallonDataSetForVehicle:_v1
+                                                                        octane:@87
+                                                                    windowDays:365
+                                                                   granularity:FPRollingSeriesGranularityPerLog
+                                                                         range:FPStatsRangeOverall];
+      [[priceDataSet should] equal:@[@[lastYearDate(@"02/10"), dn(@"3.129")],
+                                     @[lastYearDate(@"02/24"), dn(@"2.994")],
+                                     @[jan3, [dn(@"9.047") decimalNumberByDividingBy:dn(@"3")]]]];
+      NSArray *yearToDatePriceDataSet = [_stats movingAvgPricePerGallonDataSetForUser:_user
+                                                                               octane:@87
+                                                                           windowDays:30
+                                                                          granularity:FPRollingSeriesGranularityPerLog
+                                                                                range:FPStatsRangeYearToDate];
+      [[yearToDatePriceDataSet should] equal:@[@[jan3, dn(@"3.059")]]];
+      [[[_stats movingAvgReportedMpgDataSetForVehicle:_v1
+                                           windowDays:365
+                                          granularity:FPRollingSeriesGranularityPerLog
+                                                range:FPStatsRangeOverall] should] equal:@[@[lastYearDate(@"02/10"), dn(@"24.1")],
+                                                                                           @[lastYearDate(@"09/23"), dn(@"25.8")],
+                                                                                           @[jan3, dn(@"25.6")]]];
+      
+      // per day; a log stays in the 30-day sum for 30 days, and days with an
+      // empty window are skipped
+      NSArray *spentDataSet = [_stats movingSumSpentOnGasDataSetForFuelstation:_fs1
+                                                                    windowDays:30
+                                                                   granularity:FPRollingSeriesGranularityDaily
+                                                                         range:FPStatsRangeLastYear];
+      [[spentDataSet[0] should] equal:@[lastYearDate(@"02/10"), dn(@"46.935")]];
+      [[valueOn(spentDataSet, lastYearDate(@"02/24")) should] equal:dn(@"90.3918")];
+      [[valueOn(spentDataSet, lastYearDate(@"03/12")) should] equal:dn(@"43.4568")];
+      [valueOn(spentDataSet, lastYearDate(@"04/30")) shouldBeNil];
+      [[[spentDataSet lastObject] should] equal:@[lastYearDate(@"10/22"), dn(@"51.2883")]];
+      NSArray *avgSpentDataSet = [_stats movingAvgSpentOnGasDataSetForUser:_user
+                                                                windowDays:90
+                                                               granularity:FPRollingSeriesGranularityDaily
+                                                                     range:FPStatsRangeLastYear];
+      [[valueOn(avgSpentDataSet, lastYearDate(@"03/01")) should] equal:dn(@"45.1959")];
+    });
+    
+    it(@"Price and MPG percentiles come from the monthly sketches", ^{
+      NSDecimalNumber *(^dn)(NSString *) = ^(NSString *str) { return [NSDecimalNumber decimalNumberWithString:str]; };
+      // every fuel: 2.859, 3.059, 3.129, 3.489, 3.699, 3.999
+      [[[_stats pricePerGallonQuantile:0.1 forVehicle:_v1 octane:nil range:FPStatsRangeOverall] should] equal:dn(@"2.859")];
+      [[[_stats pricePerGallonQuantile:0.5 forVehicle:_v1 octane:nil range:FPStatsRangeOverall] should] equal:dn(@"3.129")];
+      [[[_stats pricePerGallonQuantile:0.9 forVehicle:_v1 octane:nil range:FPStatsRangeOverall] should] equal:dn(@"3.999")];
+      [[[_stats pricePerGallonQuantile:0.5 forUser:_user octane:@87 range:FPStatsRangeOverall] should] equal:dn(@"3.059")];
+      [[[_stats pricePerGallonQuantile:0.5 forUser:_user octane:@87 range:FPStatsRangeLastYear] should] equal:dn(@"2.859")];
+      [[[_stats pricePerGallonQuantile:0.9 forFuelstation:_fs1 octane:@93 range:FPStatsRangeOverall] should] equal:dn(@"3.699")];
+      [[[_stats pricePerGallonQuantile:0.5 forFuelstation:_fs1 octane:@(FPOctaneKeyDiesel) range:FPStatsRangeOverall] should] equal:dn(@"3.999")];
+      [[_stats pricePerGallonQuantile:0.5 forFuelstation:_fs1 octane:@93 range:FPStatsRangeYearToDate] shouldBeNil];
+      [[[_stats reportedAvgMpgQuantile:0.5 forVehicle:_v1 range:FPStatsRangeOverall] should] equal:dn(@"25.2")];
+      [[[_stats reportedAvgMpgQuantile:0.9 forUser:_user range:FPStatsRangeLastYear] should] equal:dn(@"27.5")];
+      
+      // a new log lands in its month's sketch
+      saveGasLog(_v1, _fs1, @"15.0", 93, @"10594", @"4.299", NO, nil, [NSDate date]);
+      [[[_stats pricePerGallonQuantile:0.5 forFuelstation:_fs1 octane:@93 range:FPStatsRangeYearToDate] should] equal:dn(@"4.299")];
+      [[[_stats pricePerGallonQuantile:1.0 forVehicle:_v1 octane:nil range:FPStatsRangeOverall] should] equal:dn(@"4.299")];
+    });
+  });
+  
+  context(@"A diesel-flagged gas log that also has an octane", ^{
+    beforeAll(^{
+      resetUser();
+      saveGasLog(_v1, _fs1, @"15.0", 87, @"10582", @"3.129", NO, nil, @"02/10/2014");
+      FPFuelPurchaseLog *(^dieselLog)(NSNumber *, NSString *, NSString *) = ^(NSNumber *octane, NSString *gallonPrice, NSString *date) {
+        FPFuelPurchaseLog *fplog = [_coordDao fuelPurchaseLogWithNumGallons:[NSDecimalNumber decimalNumberWithString:@"16.2"]
+                                                                     octane:octane
+                                                                   odometer:[NSDecimalNumber decimalNumberWithString:@"10592"]
+                                                                gallonPrice:[NSDecimalNumber decimalNumberWithString:gallonPrice]
+                                                                 gotCarWash:NO
+                                                   carWashPerGallonDiscount:nil
+                                                                    logDate:_d(date)
+                                                                   isDiesel:YES];
+        [_coordDao saveNewFuelPurchaseLog:fplog forUser:_user vehicle:_v1 fuelStation:_fs1 error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+        return fplog;
+      };
+      dieselLog(@87, @"2.859", @"02/24/2014");
+      dieselLog(nil, @"3.999", @"03/04/2014");
+    });
+    
+    it(@"Is grouped with its octane, like the octane and diesel filters have it", ^{
+      NSDecimalNumber *(^dn)(NSString *) = ^(NSString *str) { return [NSDecimalNumber decimalNumberWithString:str]; };
+      NSDictionary *overallStats = [_stats pricePerGallonStatsByOctaneForUser:_user range:FPStatsRangeOverall];
+      [[overallStats should] haveCountOf:2];
+      FPOctanePriceStats *octaneStats = overallStats[@87];
+      [[octaneStats.avg should] equal:[_stats overallAvgPricePerGallonForUser:_user octane:@87]];
+      [[octaneStats.avg should] equal:dn(@"2.994")];
+      [[octaneStats.dataSet should] equal:[_stats overallAvgPricePerGallonDataSetForUser:_user octane:@87]];
+      FPOctanePriceStats *dieselStats = overallStats[@(FPOctaneKeyDiesel)];
+      [[dieselStats.avg should] equal:[_stats overallAvgPricePerDieselGallonForUser:_user]];
+      [[dieselStats.avg should] equal:dn(@"3.999")];
+      [[dieselStats.dataSet should] equal:[_stats overallAvgPricePerDieselGallonDataSetForUser:_user]];
+      [[[_stats pricePerGallonQuantile:1.0 forVehicle:_v1 octane:@87 range:FPStatsRangeOverall] should] equal:dn(@"3.129")];
+    });
   });
   
   context(@"Various odometer logs occuring over various time ranges", ^{
@@ -900,6 +1208,187 @@ describe(@"FPStats", ^{
       });
     });
   });
+  
+  context(@"Monthly rollups follow edits and deletes of gas logs", ^{
+    __block FPFuelPurchaseLog *fplog1;
+    __block FPFuelPurchaseLog *fplog2;
+    beforeAll(^{
+      resetUser();
+      fplog1 = saveGasLog(_v1, _fs1, @"10.0", 87, @"100", @"3.00", NO, nil, @"05/03/2014");
+      fplog2 = saveGasLog(_v1, _fs1, @"5.0",  87, @"200", @"4.00", NO, nil, @"05/20/2014");
+    });
+    
+    it(@"Spent on gas and avg price data sets reflect saves, edits and deletes", ^{
+      NSArray *ds = [_stats spentOnGasDataSetForVehicle:_v1 year:2014];
+      [[ds should] haveCountOf:1];
+      [[ds[0][0] should] equal:_d(@"05/01/2014")];
+      [[ds[0][1] should] equal:[NSDecimalNumber decimalNumberWithString:@"50"]];
+      [fplog1 setGallonPrice:[NSDecimalNumber decimalNumberWithString:@"3.50"]];
+      [_coordDao saveFuelPurchaseLog:fplog1
+                             forUser:_user
+                             vehicle:_v1
+                         fuelStation:_fs1
+                               error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+      ds = [_stats overallSpentOnGasDataSetForFuelstation:_fs1];
+      [[ds should] haveCountOf:1];
+      [[ds[0][1] should] equal:[NSDecimalNumber decimalNumberWithString:@"55"]];
+      [_coordDao deleteFuelPurchaseLog:fplog2 error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+      ds = [_stats spentOnGasDataSetForVehicle:_v1 year:2014];
+      [[ds[0][1] should] equal:[NSDecimalNumber decimalNumberWithString:@"35"]];
+      ds = [_stats overallAvgPricePerGallonDataSetForVehicle:_v1 octane:@87];
+      [[ds[0][1] should] equal:[NSDecimalNumber decimalNumberWithString:@"3.5"]];
+    });
+  });
+  
+  context(@"Memoized stats", ^{
+    __block FPFuelPurchaseLog *fplog;
+    beforeAll(^{
+      resetUser();
+      fplog = saveGasLog(_v1, _fs1, @"10.0", 87, @"100", @"3.00", NO, nil, @"05/03/2014");
+    });
+    
+    it(@"Repeat reads are cache hits until the logs change", ^{
+      NSInteger hits = [_stats cacheHits];
+      NSInteger misses = [_stats cacheMisses];
+      [[[_stats overallSpentOnGasForVehicle:_v1] should] equal:[NSDecimalNumber decimalNumberWithString:@"30"]];
+      [[theValue([_stats cacheMisses]) should] equal:theValue(misses + 1)];
+      [[[_stats overallSpentOnGasForVehicle:_v1] should] equal:[NSDecimalNumber decimalNumberWithString:@"30"]];
+      [[theValue([_stats cacheHits]) should] equal:theValue(hits + 1)];
+      [[theValue([_stats cacheMisses]) should] equal:theValue(misses + 1)];
+      [fplog setGallonPrice:[NSDecimalNumber decimalNumberWithString:@"3.50"]];
+      [_coordDao saveFuelPurchaseLog:fplog
+                             forUser:_user
+                             vehicle:_v1
+                         fuelStation:_fs1
+                               error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+      [[[_stats overallSpentOnGasForVehicle:_v1] should] equal:[NSDecimalNumber decimalNumberWithString:@"35"]];
+      [[theValue([_stats cacheHits]) should] equal:theValue(hits + 1)];
+      [[theValue([_stats cacheMisses]) should] equal:theValue(misses + 2)];
+    });
+    
+    it(@"Memoizes stats by their scope and values, but not calls given dates", ^{
+      NSInteger hits = [_stats cacheHits];
+      NSInteger misses = [_stats cacheMisses];
+      [_stats overallAvgPricePerGallonForVehicle:_v1 octane:@87];
+      [_stats overallAvgPricePerGallonForVehicle:_v1 octane:@87];
+      [_stats overallAvgPricePerGallonForVehicle:_v1 octane:@93];
+      [[theValue([_stats cacheHits]) should] equal:theValue(hits + 1)];
+      [[theValue([_stats cacheMisses]) should] equal:theValue(misses + 2)];
+      [_stats milesRecordedForVehicle:_v1 beforeDate:[NSDate date] onOrAfterDate:[NSDate dateWithTimeIntervalSince1970:0]];
+      [[theValue([_stats cacheHits]) should] equal:theValue(hits + 1)];
+      [[theValue([_stats cacheMisses]) should] equal:theValue(misses + 2)];
+    });
+    
+    it(@"Cached stats are dropped when the day changes", ^{
+      [[[_stats overallSpentOnGasForVehicle:_v1] should] equal:[NSDecimalNumber decimalNumberWithString:@"35"]];
+      NSInteger misses = [_stats cacheMisses];
+      [NSDate stub:@selector(date) andReturn:[NSDate dateWithTimeIntervalSinceNow:24 * 60 * 60]];
+      [[[_stats overallSpentOnGasForVehicle:_v1] should] equal:[NSDecimalNumber decimalNumberWithString:@"35"]];
+      [[theValue([_stats cacheMisses]) should] equal:theValue(misses + 1)];
+    });
+  });
+  
+  context(@"A fleet of 20 vehicles with a year of logs each", ^{
+    beforeAll(^{
+      resetUser();
+      for (NSInteger i = 0; i < 20; i++) {
+        FPVehicle *vehicle = [_coordDao vehicleWithName:[NSString stringWithFormat:@"Fleet vehicle %ld", (long)i]
+                                          defaultOctane:@87
+                                           fuelCapacity:[NSDecimalNumber decimalNumberWithString:@"20.5"]
+                                               isDiesel:NO
+                                          hasDteReadout:NO
+                                          hasMpgReadout:NO
+                                          hasMphReadout:NO
+                                  hasOutsideTempReadout:NO
+                                                    vin:nil
+                                                  plate:nil];
+        [_coordDao saveNewVehicle:vehicle forUser:_user error:[_coordTestCtx newLocalSaveErrBlkMaker]()];
+        for (NSInteger month = 1; month <= 12; month++) {
+          NSInteger odometer = month * 1000;
+          NSString *(^date)(NSInteger) = ^(NSInteger day) { return [NSString stringWithFormat:@"%02ld/%02ld/2014", (long)month, (long)day]; };
+          saveOdometerLog(vehicle, [@(odometer) stringValue], @"28.5", @"31", 60, date(3), nil);
+          saveGasLog(vehicle, _fs1, @"12.0", 87, [@(odometer + 150) stringValue], @"3.299", NO, nil, date(14));
+          saveOdometerLog(vehicle, [@(odometer + 300 + (i * 10)) stringValue], @"28.5", @"31", 60, date(25), nil);
+        }
+      }
+    });
+    
+    afterAll(^{
+      [_stats setComputesDatasetsConcurrently:YES];
+    });
+    
+    it(@"Computes the per-vehicle datasets concurrently with the same result", ^{
+      NSArray *(^timedDataset)(BOOL, NSTimeInterval *) = ^(BOOL concurrently, NSTimeInterval *elapsed) {
+        [_stats setComputesDatasetsConcurrently:concurrently];
+        [_stats clearCache];
+        NSDate *start = [NSDate date];
+        NSArray *dataset = [_stats overallAvgGasCostPerMileDataSetForUser:_user];
+        *elapsed = [[NSDate date] timeIntervalSinceDate:start];
+        return dataset;
+      };
+      NSTimeInterval serialTime, concurrentTime;
+      NSArray *serialDataset = timedDataset(NO, &serialTime);
+      NSArray *concurrentDataset = timedDataset(YES, &concurrentTime);
+      DDLogInfo(@"Gas cost per mile dataset for 20 vehicles.  Serial: %.3fs, concurrent: %.3fs (%lu active cores).",
+                serialTime,
+                concurrentTime,
+                (unsigned long)[[NSProcessInfo processInfo] activeProcessorCount]);
+      [[serialDataset should] haveCountOf:12];
+      [[concurrentDataset should] equal:serialDataset];
+    });
+  });
+  
+  context(@"Many gas logs whose spend doesn't sum exactly in floating point", ^{
+    __block NSDecimalNumber *expectedSpend;
+    beforeAll(^{
+      resetUser();
+      expectedSpend = [NSDecimalNumber zero];
+      NSDate *firstPurchasedAt = _d(@"01/01/2013");
+      for (NSInteger i = 0; i < 1000; i++) {
+        NSString *numGallons = [NSString stringWithFormat:@"%ld.%03ld", (long)(12 + (i % 13)), (long)((i * 379 + 7) % 1000)];
+        NSString *gallonPrice = [NSString stringWithFormat:@"%ld.%03ld", (long)(3 + (i % 3)), (long)((i * 617 + 1) % 1000)];
+        saveGasLog(_v1, _fs1, numGallons, 87, [NSString stringWithFormat:@"%ld", (long)(10000 + i)], gallonPrice, NO, nil,
+                   [firstPurchasedAt dateByAddingTimeInterval:i * 3600]);
+        expectedSpend = [expectedSpend decimalNumberByAdding:[[NSDecimalNumber decimalNumberWithString:numGallons]
+                                                              decimalNumberByMultiplyingBy:[NSDecimalNumber decimalNumberWithString:gallonPrice]]];
+      }
+    });
+    
+    it(@"Total spend on gas is exact", ^{
+      // summed in doubles, this comes to 83241.9804999998
+      [[expectedSpend should] equal:[NSDecimalNumber decimalNumberWithString:@"83241.9805"]];
+      [[[_stats overallSpentOnGasForVehicle:_v1] should] equal:expectedSpend];
+      [[[_stats overallSpentOnGasForUser:_user] should] equal:expectedSpend];
+    });
+    
+    it(@"Monthly spend on gas, from the rollups, is exact", ^{
+      NSArray *ds = [_stats spentOnGasDataSetForVehicle:_v1 year:2013];
+      [[ds should] haveCountOf:2];
+      NSDecimalNumber *monthlySpend = [ds[0][1] decimalNumberByAdding:ds[1][1]];
+      [[monthlySpend should] equal:expectedSpend];
+    });
+  });
+  
+  context(@"A gas log with more decimal places than gallons and prices are stored with", ^{
+    beforeAll(^{
+      resetUser();
+      saveGasLog(_v1, _fs1, @"12.3456", 87, @"10000", @"3.4567", NO, nil, @"03/10/2013");
+    });
+    
+    it(@"Is stored rounded, so the SQL aggregates, the rollups and the log columns agree to the digit", ^{
+      FPFuelPurchaseLog *storedLog = [[_coordDao fuelPurchaseLogsForVehicle:_v1 error:[_coordTestCtx newLocalFetchErrBlkMaker]()] firstObject];
+      [[storedLog.numGallons should] equal:[NSDecimalNumber decimalNumberWithString:@"12.346"]];
+      [[storedLog.gallonPrice should] equal:[NSDecimalNumber decimalNumberWithString:@"3.457"]];
+      NSDecimalNumber *expectedSpend = [NSDecimalNumber decimalNumberWithString:@"42.680122"]; // 12.346 * 3.457
+      [[[_stats overallSpentOnGasForVehicle:_v1] should] equal:expectedSpend];
+      NSArray *ds = [_stats spentOnGasDataSetForVehicle:_v1 year:2013];
+      [[ds should] haveCountOf:1];
+      [[ds[0][1] should] equal:expectedSpend];
+      FPLogColumns *columns = [_coordDao gasLogColumnsForVehicle:_v1 error:[_coordTestCtx newLocalFetchErrBlkMaker]()];
+      FPSum columnsSpend = [columns sumOfMeasure:FPGasLogMeasureSpent inRange:NSMakeRange(0, columns.count)];
+      [[FPSumDecimalNumber(&columnsSpend) should] equal:expectedSpend];
+    });
+  });
 });
 
 SPEC_END
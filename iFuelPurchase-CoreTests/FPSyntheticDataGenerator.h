@@ -0,0 +1,92 @@
+//
+//  FPSyntheticDataGenerator.h
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+@import Foundation;
+#import "FPLocalDao.h"
+
+@class FPUser;
+@class FPVehicle;
+@class FPFuelStation;
+@class FPFuelPurchaseLog;
+@class FPEnvironmentLog;
+
+FOUNDATION_EXPORT NSString * const FPSyntheticNumVehiclesKey;
+FOUNDATION_EXPORT NSString * const FPSyntheticNumFuelStationsKey;
+FOUNDATION_EXPORT NSString * const FPSyntheticNumGasLogsKey;
+FOUNDATION_EXPORT NSString * const FPSyntheticNumOdometerLogsKey;
+
+/**
+ Generates a fleet's worth of vehicles, fuel stations, gas logs and odometer
+ logs, for benchmarking the stats at scale (by default, 50 vehicles with 15
+ years of weekly fill-ups each: 39,000 gas logs).  Everything generated is a
+ function of the seed and end date alone, so two generators configured alike
+ produce identical data.
+
+ Each vehicle draws from its own random stream, so a vehicle's logs don't
+ depend on how many vehicles there are.  A vehicle mostly fills up at its
+ "home" station, fills up every daysBetweenFillups days (at a random time of
+ day) up to endDate, drives 120 to 450 miles between fill-ups, and records an
+ odometer log (with a reported average MPG and MPH and an outside temperature)
+ at every fillupsPerOdometerLog-th fill-up.
+ */
+@interface FPSyntheticDataGenerator : NSObject
+
+#pragma mark - Initializers
+
+- (instancetype)initWithSeed:(uint64_t)seed;
+
+#pragma mark - Properties
+
+@property (nonatomic, readonly) uint64_t seed;
+
+/** Defaults to 50. */
+@property (nonatomic) NSUInteger numVehicles;
+
+/** Defaults to 15. */
+@property (nonatomic) NSUInteger numYears;
+
+/** Defaults to 7. */
+@property (nonatomic) NSUInteger daysBetweenFillups;
+
+/** Defaults to 25. */
+@property (nonatomic) NSUInteger numFuelStations;
+
+/** Defaults to 1 (an odometer log at every fill-up); 0 generates none. */
+@property (nonatomic) NSUInteger fillupsPerOdometerLog;
+
+/** The day the logs run up to; defaults to the start of today. */
+@property (nonatomic) NSDate *endDate;
+
+#pragma mark - Generating
+
+- (FPVehicle *)vehicleAtIndex:(NSUInteger)index;
+
+- (FPFuelStation *)fuelStationAtIndex:(NSUInteger)index;
+
+/**
+ Calls blk with each of the vehicle's gas logs, oldest first, along with the
+ index of the fuel station it was purchased at and the odometer log recorded
+ with it (or nil).
+ */
+- (void)enumerateLogsForVehicleAtIndex:(NSUInteger)index
+                            usingBlock:(void(^)(FPFuelPurchaseLog *gasLog,
+                                                NSUInteger fuelStationIndex,
+                                                FPEnvironmentLog *odometerLog))blk;
+
+#pragma mark - Populating
+
+/**
+ Saves the generated fuel stations, vehicles and logs for user (who must
+ already be saved), and returns the number of each saved, keyed by the
+ FPSynthetic...Key constants.
+ */
+- (NSDictionary *)populateLocalDao:(id<FPLocalDao>)localDao
+                           forUser:(FPUser *)user
+                             error:(PELMDaoErrorBlk)errorBlk;
+
+@end
@@ -0,0 +1,229 @@
+//
+//  FPSyntheticDataGenerator.m
+//  Gas Jot Model
+//
+//  Created by Paul Evans on 10/17/26.
+//  Copyright © 2026 Paul Evans. All rights reserved.
+//
+
+#import "FPSyntheticDataGenerator.h"
+#import "FPUser.h"
+#import "FPVehicle.h"
+#import "FPFuelStation.h"
+#import "FPFuelStationType.h"
+#import "FPFuelPurchaseLog.h"
+#import "FPEnvironmentLog.h"
+#import "FPKnownMediaTypes.h"
+
+NSString * const FPSyntheticNumVehiclesKey = @"vehicles";
+NSString * const FPSyntheticNumFuelStationsKey = @"fuelStations";
+NSString * const FPSyntheticNumGasLogsKey = @"gasLogs";
+NSString * const FPSyntheticNumOdometerLogsKey = @"odometerLogs";
+
+static NSString * const FPSyntheticMtVersion = @"0.0.1";
+
+#pragma mark - Random Streams
+
+/*
+ splitmix64; used to derive a well-mixed, non-zero starting state for each
+ vehicle's (and station's) stream from the seed.
+ */
+static uint64_t FPSyntheticMix(uint64_t x) {
+  x += 0x9E3779B97F4A7C15ULL;
+  x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+  x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+  x = x ^ (x >> 31);
+  return x ? x : 1;
+}
+
+/* xorshift64* */
+static uint64_t FPSyntheticNext(uint64_t *state) {
+  uint64_t x = *state;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *state = x;
+  return x * 0x2545F4914F6CDD1DULL;
+}
+
+/* Uniform over [low, high]. */
+static NSInteger FPSyntheticUniform(uint64_t *state, NSInteger low, NSInteger high) {
+  return low + (NSInteger)(FPSyntheticNext(state) % (uint64_t)(high - low + 1));
+}
+
+static NSDecimalNumber *FPSyntheticDecimal(NSInteger mantissa, short exponent) {
+  return [NSDecimalNumber decimalNumberWithMantissa:ABS(mantissa) exponent:exponent isNegative:mantissa < 0];
+}
+
+/*
+ What's drawn for a vehicle before any of its logs; drawn first off the
+ vehicle's stream, so the vehicle and its logs agree.
+ */
+typedef struct {
+  BOOL isDiesel;
+  NSInteger octane;
+  NSInteger fuelCapacityTenths;
+  NSUInteger homeFuelStationIndex;
+  NSInteger phaseDays;
+  NSInteger baseMpgTenths;
+} FPSyntheticVehicleTraits;
+
+@implementation FPSyntheticDataGenerator
+
+#pragma mark - Initializers
+
+- (instancetype)initWithSeed:(uint64_t)seed {
+  self = [super init];
+  if (self) {
+    _seed = seed;
+    _numVehicles = 50;
+    _numYears = 15;
+    _daysBetweenFillups = 7;
+    _numFuelStations = 25;
+    _fillupsPerOdometerLog = 1;
+    _endDate = [[NSCalendar currentCalendar] startOfDayForDate:[NSDate date]];
+  }
+  return self;
+}
+
+#pragma mark - Helpers
+
+- (uint64_t)streamForIndex:(NSUInteger)index salt:(uint64_t)salt {
+  return FPSyntheticMix(FPSyntheticMix(_seed ^ salt) + index);
+}
+
+- (FPSyntheticVehicleTraits)traitsForVehicleAtIndex:(NSUInteger)index stream:(uint64_t *)stream {
+  FPSyntheticVehicleTraits traits;
+  traits.isDiesel = FPSyntheticUniform(stream, 1, 100) <= 5;
+  static NSInteger const octanes[] = {87, 87, 87, 89, 93};
+  traits.octane = octanes[FPSyntheticUniform(stream, 0, 4)];
+  traits.fuelCapacityTenths = FPSyntheticUniform(stream, 120, 260);
+  traits.homeFuelStationIndex = _numFuelStations > 0 ? (NSUInteger)FPSyntheticUniform(stream, 0, _numFuelStations - 1) : 0;
+  traits.phaseDays = FPSyntheticUniform(stream, 0, MAX(_daysBetweenFillups, 1) - 1);
+  traits.baseMpgTenths = traits.isDiesel ? FPSyntheticUniform(stream, 200, 320) : FPSyntheticUniform(stream, 180, 380);
+  return traits;
+}
+
+/*
+ A fleet-wide price (in thousandths of a dollar), drifting with the date, that
+ each purchase's price varies around.
+ */
+- (NSInteger)basePriceThousandthsForDay:(NSInteger)day {
+  return 2600 + (NSInteger)(700.0 * sin(day / 180.0));
+}
+
+#pragma mark - Generating
+
+- (FPVehicle *)vehicleAtIndex:(NSUInteger)index {
+  uint64_t stream = [self streamForIndex:index salt:'v'];
+  FPSyntheticVehicleTraits traits = [self traitsForVehicleAtIndex:index stream:&stream];
+  return [FPVehicle vehicleWithName:[NSString stringWithFormat:@"Vehicle %03lu", (unsigned long)index]
+                      defaultOctane:traits.isDiesel ? nil : @(traits.octane)
+                       fuelCapacity:FPSyntheticDecimal(traits.fuelCapacityTenths, -1)
+                           isDiesel:traits.isDiesel
+                      hasDteReadout:NO
+                      hasMpgReadout:YES
+                      hasMphReadout:YES
+              hasOutsideTempReadout:YES
+                                vin:nil
+                              plate:[NSString stringWithFormat:@"SYN-%04lu", (unsigned long)index]
+                          mediaType:[FPKnownMediaTypes vehicleMediaTypeWithVersion:FPSyntheticMtVersion]];
+}
+
+- (FPFuelStation *)fuelStationAtIndex:(NSUInteger)index {
+  uint64_t stream = [self streamForIndex:index salt:'f'];
+  return [FPFuelStation fuelStationWithName:[NSString stringWithFormat:@"Station %02lu", (unsigned long)index]
+                                       type:[[FPFuelStationType alloc] initWithIdentifier:@(0) name:@"Other" iconImgName:@""]
+                                     street:nil
+                                       city:nil
+                                      state:nil
+                                        zip:nil
+                                   latitude:FPSyntheticDecimal(39000000 + FPSyntheticUniform(&stream, 0, 999999), -6)
+                                  longitude:FPSyntheticDecimal(-77000000 - FPSyntheticUniform(&stream, 0, 999999), -6)
+                                  mediaType:[FPKnownMediaTypes fuelStationMediaTypeWithVersion:FPSyntheticMtVersion]];
+}
+
+- (void)enumerateLogsForVehicleAtIndex:(NSUInteger)index
+                            usingBlock:(void(^)(FPFuelPurchaseLog *, NSUInteger, FPEnvironmentLog *))blk {
+  uint64_t stream = [self streamForIndex:index salt:'v'];
+  FPSyntheticVehicleTraits traits = [self traitsForVehicleAtIndex:index stream:&stream];
+  NSInteger daysBetweenFillups = MAX((NSInteger)_daysBetweenFillups, 1);
+  NSInteger numFillups = ((NSInteger)_numYears * 365) / daysBetweenFillups;
+  NSInteger odometerTenths = FPSyntheticUniform(&stream, 0, 400000);
+  for (NSInteger i = 0; i < numFillups; i++) {
+    NSInteger daysBeforeEnd = ((numFillups - i) * daysBetweenFillups) + traits.phaseDays;
+    NSDate *purchasedAt = [_endDate dateByAddingTimeInterval:(daysBeforeEnd * -86400.0) + (FPSyntheticUniform(&stream, 6 * 60, 22 * 60) * 60.0)];
+    odometerTenths += FPSyntheticUniform(&stream, 1200, 4500);
+    NSInteger gallonsThousandths = (traits.fuelCapacityTenths * 100 * FPSyntheticUniform(&stream, 55, 95)) / 100;
+    NSInteger priceThousandths = [self basePriceThousandthsForDay:-daysBeforeEnd] + FPSyntheticUniform(&stream, -150, 150);
+    priceThousandths += traits.isDiesel ? 300 : (traits.octane == 93 ? 400 : (traits.octane == 89 ? 150 : 0));
+    priceThousandths = ((priceThousandths / 10) * 10) + 9;
+    BOOL gotCarWash = FPSyntheticUniform(&stream, 1, 10) == 1;
+    NSUInteger fuelStationIndex = traits.homeFuelStationIndex;
+    if (_numFuelStations > 0 && FPSyntheticUniform(&stream, 1, 10) > 7) {
+      fuelStationIndex = (NSUInteger)FPSyntheticUniform(&stream, 0, _numFuelStations - 1);
+    }
+    NSDecimalNumber *odometer = FPSyntheticDecimal(odometerTenths, -1);
+    FPFuelPurchaseLog *gasLog =
+      [FPFuelPurchaseLog fuelPurchaseLogWithNumGallons:FPSyntheticDecimal(gallonsThousandths, -3)
+                                                octane:traits.isDiesel ? nil : @(traits.octane)
+                                              odometer:odometer
+                                           gallonPrice:FPSyntheticDecimal(priceThousandths, -3)
+                                            gotCarWash:gotCarWash
+                              carWashPerGallonDiscount:gotCarWash ? FPSyntheticDecimal(8, -2) : nil
+                                           purchasedAt:purchasedAt
+                                              isDiesel:traits.isDiesel
+                                             mediaType:[FPKnownMediaTypes fuelPurchaseLogMediaTypeWithVersion:FPSyntheticMtVersion]];
+    FPEnvironmentLog *odometerLog = nil;
+    if (_fillupsPerOdometerLog > 0 && ((NSUInteger)i % _fillupsPerOdometerLog) == 0) {
+      odometerLog =
+        [FPEnvironmentLog envLogWithOdometer:odometer
+                              reportedAvgMpg:FPSyntheticDecimal(traits.baseMpgTenths + FPSyntheticUniform(&stream, -30, 30), -1)
+                              reportedAvgMph:FPSyntheticDecimal(FPSyntheticUniform(&stream, 220, 550), -1)
+                         reportedOutsideTemp:@(FPSyntheticUniform(&stream, -5, 100))
+                                     logDate:[purchasedAt dateByAddingTimeInterval:5 * 60]
+                                 reportedDte:nil
+                                   mediaType:[FPKnownMediaTypes environmentLogMediaTypeWithVersion:FPSyntheticMtVersion]];
+    }
+    blk(gasLog, fuelStationIndex, odometerLog);
+  }
+}
+
+#pragma mark - Populating
+
+- (NSDictionary *)populateLocalDao:(id<FPLocalDao>)localDao
+                           forUser:(FPUser *)user
+                             error:(PELMDaoErrorBlk)errorBlk {
+  NSMutableArray *fuelStations = [NSMutableArray arrayWithCapacity:_numFuelStations];
+  for (NSUInteger i = 0; i < _numFuelStations; i++) {
+    FPFuelStation *fuelStation = [self fuelStationAtIndex:i];
+    [localDao saveNewFuelStation:fuelStation forUser:user error:errorBlk];
+    [fuelStations addObject:fuelStation];
+  }
+  __block NSUInteger numGasLogs = 0;
+  __block NSUInteger numOdometerLogs = 0;
+  for (NSUInteger i = 0; i < _numVehicles; i++) {
+    FPVehicle *vehicle = [self vehicleAtIndex:i];
+    [localDao saveNewVehicle:vehicle forUser:user error:errorBlk];
+    [self enumerateLogsForVehicleAtIndex:i usingBlock:^(FPFuelPurchaseLog *gasLog, NSUInteger fuelStationIndex, FPEnvironmentLog *odometerLog) {
+      @autoreleasepool {
+        [localDao saveNewFuelPurchaseLog:gasLog
+                                 forUser:user
+                                 vehicle:vehicle
+                             fuelStation:fuelStations.count > 0 ? fuelStations[fuelStationIndex] : nil
+                                   error:errorBlk];
+        numGasLogs++;
+        if (odometerLog) {
+          [localDao saveNewEnvironmentLog:odometerLog forUser:user vehicle:vehicle error:errorBlk];
+          numOdometerLogs++;
+        }
+      }
+    }];
+  }
+  return @{FPSyntheticNumVehiclesKey : @(_numVehicles),
+           FPSyntheticNumFuelStationsKey : @(_numFuelStations),
+           FPSyntheticNumGasLogsKey : @(numGasLogs),
+           FPSyntheticNumOdometerLogsKey : @(numOdometerLogs)};
+}
+
+@end